@@ -0,0 +1,530 @@
+// Allocations PACE BMS.cpp : heap allocations made by the ESPHome component over full poll cycles, with the real hub, sensor
+//     and text_sensor platforms built on the host (see: "Host ESPHome/host_esphome.h") and talking to a simulated pack,
+//     broken down by stage and checked against a stored budget so that once the long-uptime heap fragmentation is fixed
+//     it stays fixed
+//
+// each loop() call is recorded as a list of allocations along with where in that list things happened (a sensor was
+//     published, a request was written to the UART, a response had been decoded) and is split up at those points:
+//     queueing         update() and the fast poll interval filling the queues
+//     request_build    popping a command and building and sending its request
+//     response_copy    the copy of the frame out of the receive buffer that's handed to the response handler
+//     decode           the protocol class decoding a response
+//     status_text      decoding the status information response, which is where the status text gets built
+//     dispatch         the child callbacks, mostly queueing up the publish closures
+//     publish          running a queued publish closure
+//     other            anything else loop() did, such as giving up on a response
+// which relies on loop_internal_() doing one publish and then at most one of send or receive per call
+//
+// only operator new is counted, nothing in the component calls malloc directly, and the simulated pack and the rest of the
+//     host stand-in are left out (see: host_esphome::HostScope)
+//
+// counts are for whichever standard library this was built with, so write the budget on the platform that checks it
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "host_esphome.h"
+#include "host_uart.h"
+#include "../../components/pace_bms/pace_bms_component.h"
+#include "../../components/pace_bms/sensor/pace_bms_sensor.h"
+#include "../../components/pace_bms/text_sensor/pace_bms_text_sensor.h"
+
+using namespace esphome;
+using namespace esphome::pace_bms;
+
+enum Stage
+{
+	STAGE_QUEUEING,
+	STAGE_REQUEST_BUILD,
+	STAGE_RESPONSE_COPY,
+	STAGE_DECODE,
+	STAGE_STATUS_TEXT,
+	STAGE_DISPATCH,
+	STAGE_PUBLISH,
+	STAGE_OTHER,
+	STAGE_COUNT,
+};
+static const char* const stageNames[STAGE_COUNT] = { "queueing", "request_build", "response_copy", "decode", "status_text", "dispatch", "publish", "other" };
+
+// ============================================================================
+// every heap allocation in the process goes through here, while recording the ones made by the code under test are logged
+static const size_t NOT_YET = SIZE_MAX;
+static const size_t MAX_RECORDED_ALLOCATIONS = 8192;
+static bool recording = false;
+static size_t recordedSizes[MAX_RECORDED_ALLOCATIONS];
+static size_t recordedCount = 0;
+
+void* operator new(size_t size)
+{
+	if (recording && !host_esphome::in_host_scope())
+	{
+		if (recordedCount < MAX_RECORDED_ALLOCATIONS)
+			recordedSizes[recordedCount] = size;
+		recordedCount++;
+	}
+	void* p = malloc(size == 0 ? 1 : size);
+	if (p == nullptr)
+		throw std::bad_alloc();
+	return p;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+// where in the recording things happened, as the number of allocations recorded by then
+struct RecordingEvents
+{
+	size_t published = NOT_YET;  // the publish at the top of loop(), not one made directly from a callback
+	size_t requested = NOT_YET;
+	size_t decoded = NOT_YET;
+	bool decodedStatusInformation = false;
+};
+static RecordingEvents events;
+// the response is queued by the loop() that sends the request, and copied out by a later one
+static size_t responseLength = 0;
+
+static void OnPublish()
+{
+	if (events.published == NOT_YET && events.requested == NOT_YET && events.decoded == NOT_YET)
+		events.published = recordedCount;
+}
+
+struct StageTotals
+{
+	uint64_t allocations[STAGE_COUNT]{ };
+	uint64_t bytes[STAGE_COUNT]{ };
+};
+
+static void StartRecording()
+{
+	recordedCount = 0;
+	events = RecordingEvents();
+	recording = true;
+}
+
+static bool StopRecording()
+{
+	recording = false;
+	if (recordedCount > MAX_RECORDED_ALLOCATIONS)
+	{
+		std::cerr << "FAIL: more than " << MAX_RECORDED_ALLOCATIONS << " allocations in a single call" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+static void AddRecording(StageTotals& totals, Stage stage)
+{
+	for (size_t i = 0; i < recordedCount; i++)
+	{
+		totals.allocations[stage]++;
+		totals.bytes[stage] += recordedSizes[i];
+	}
+}
+
+static void AddLoopRecording(StageTotals& totals)
+{
+	size_t publishEnd = events.published == NOT_YET ? 0 : events.published;
+	bool copyFound = false;
+	for (size_t i = 0; i < recordedCount; i++)
+	{
+		Stage stage;
+		if (i < publishEnd)
+			stage = STAGE_PUBLISH;
+		else if (events.requested != NOT_YET)
+			stage = STAGE_REQUEST_BUILD;
+		else if (events.decoded != NOT_YET && i >= events.decoded)
+			stage = STAGE_DISPATCH;
+		else if (events.decoded != NOT_YET && !copyFound && recordedSizes[i] == responseLength)
+		{
+			copyFound = true;
+			stage = STAGE_RESPONSE_COPY;
+		}
+		else if (events.decoded != NOT_YET)
+			stage = events.decodedStatusInformation ? STAGE_STATUS_TEXT : STAGE_DECODE;
+		else
+			stage = STAGE_OTHER;
+		totals.allocations[stage]++;
+		totals.bytes[stage] += recordedSizes[i];
+	}
+}
+
+// ============================================================================
+// a configuration much like a typical YAML: per cell and per temperature sensors, the pack totals, the raw status values,
+//     the status text, the packed cell values, versions, and a couple of bus metrics
+struct Node
+{
+	host_esphome::SimulatedUart uart;
+	PaceBms hub;
+	PaceBmsSensor sensors;
+	PaceBmsTextSensor textSensors;
+	std::vector<std::unique_ptr<sensor::Sensor>> sensorObjects;
+	std::vector<std::unique_ptr<text_sensor::TextSensor>> textSensorObjects;
+
+	sensor::Sensor* NewSensor()
+	{
+		this->sensorObjects.emplace_back(new sensor::Sensor());
+		this->sensorObjects.back()->add_on_state_callback([](float) { OnPublish(); });
+		return this->sensorObjects.back().get();
+	}
+	text_sensor::TextSensor* NewTextSensor()
+	{
+		this->textSensorObjects.emplace_back(new text_sensor::TextSensor());
+		this->textSensorObjects.back()->add_on_state_callback([](const std::string&) { OnPublish(); });
+		return this->textSensorObjects.back().get();
+	}
+};
+
+static void Configure(Node& node, int commandset, const char* variant)
+{
+	node.uart.add_pack(1);
+	node.uart.set_latency_ms(20);
+	node.uart.on_request = [](const std::vector<uint8_t>&) { events.requested = recordedCount; };
+	node.uart.on_response = [](const std::vector<uint8_t>& response) { responseLength = response.size(); };
+
+	node.hub.set_uart_parent(&node.uart);
+	node.hub.set_address(1);
+	node.hub.set_protocol_commandset(commandset);
+	if (variant != nullptr)
+		node.hub.set_protocol_variant(variant);
+	node.hub.set_request_throttle(50);
+	node.hub.set_response_timeout(200);
+	node.hub.set_update_interval(10000);
+
+	PaceBmsSensor& s = node.sensors;
+	s.set_parent(&node.hub);
+	s.set_cell_count_sensor(node.NewSensor());
+	for (int i = 0; i < PACE_BMS_MAX_CELL_COUNT; i++)
+		s.set_cell_voltage_sensor(i, node.NewSensor());
+	s.set_temperature_count_sensor(node.NewSensor());
+	for (int i = 0; i < PACE_BMS_MAX_TEMP_COUNT; i++)
+		s.set_temperature_sensor(i, node.NewSensor());
+	s.set_current_sensor(node.NewSensor());
+	s.set_total_voltage_sensor(node.NewSensor());
+	s.set_remaining_capacity_sensor(node.NewSensor());
+	s.set_full_capacity_sensor(node.NewSensor());
+	s.set_design_capacity_sensor(node.NewSensor());
+	s.set_cycle_count_sensor(node.NewSensor());
+	s.set_state_of_charge_sensor(node.NewSensor());
+	s.set_state_of_health_sensor(node.NewSensor());
+	s.set_power_sensor(node.NewSensor());
+	s.set_min_cell_voltage_sensor(node.NewSensor());
+	s.set_max_cell_voltage_sensor(node.NewSensor());
+	s.set_avg_cell_voltage_sensor(node.NewSensor());
+	s.set_max_cell_differential_sensor(node.NewSensor());
+	s.set_warning_status_value_charge_current_sensor(node.NewSensor());
+	s.set_warning_status_value_total_voltage_sensor(node.NewSensor());
+	s.set_warning_status_value_discharge_current_sensor(node.NewSensor());
+	s.set_balancing_status_value_sensor(node.NewSensor());
+	s.set_system_status_value_sensor(node.NewSensor());
+	if (commandset == 0x25)
+	{
+		s.set_warning_status_value_1_sensor(node.NewSensor());
+		s.set_warning_status_value_2_sensor(node.NewSensor());
+		s.set_configuration_status_value_sensor(node.NewSensor());
+		s.set_protection_status_value_1_sensor(node.NewSensor());
+		s.set_protection_status_value_2_sensor(node.NewSensor());
+		s.set_fault_status_value_sensor(node.NewSensor());
+	}
+	s.set_requests_sent_sensor(node.NewSensor());
+	s.set_responses_ok_sensor(node.NewSensor());
+
+	PaceBmsTextSensor& t = node.textSensors;
+	t.set_parent(&node.hub);
+	t.set_warning_status_sensor(node.NewTextSensor());
+	t.set_balancing_status_sensor(node.NewTextSensor());
+	t.set_system_status_sensor(node.NewTextSensor());
+	t.set_configuration_status_sensor(node.NewTextSensor());
+	t.set_protection_status_sensor(node.NewTextSensor());
+	t.set_fault_status_sensor(node.NewTextSensor());
+	t.set_hardware_version_sensor(node.NewTextSensor());
+	// the simulated pack has no v20 serial number example to answer with
+	if (commandset == 0x25)
+		t.set_serial_number_sensor(node.NewTextSensor());
+	t.set_cell_voltages_sensor(node.NewTextSensor());
+	t.set_cell_warning_values_sensor(node.NewTextSensor());
+
+	// registered ahead of the platforms so that these are the first callbacks dispatched to, which marks where decoding ended
+	//     a response can be dispatched to more than one set of callbacks (capacity taken from the analog information), only
+	//     the first counts
+	auto decoded = []() { if (events.decoded == NOT_YET) events.decoded = recordedCount; };
+	auto decodedStatus = []() { events.decoded = recordedCount; events.decodedStatusInformation = true; };
+	if (commandset == 0x25)
+	{
+		node.hub.register_analog_information_callback_v25([decoded](PaceBmsProtocolV25::AnalogInformation&) { decoded(); }, PaceBmsProtocolBase::AIF_None);
+		node.hub.register_status_information_callback_v25([decodedStatus](PaceBmsProtocolV25::StatusInformation&) { decodedStatus(); }, PaceBmsProtocolBase::SIF_None);
+		node.hub.register_hardware_version_callback_v25([decoded](std::string&) { decoded(); });
+		node.hub.register_serial_number_callback_v25([decoded](std::string&) { decoded(); });
+		node.hub.register_remaining_capacity_callback_v25([decoded](uint32_t&, uint32_t&, uint32_t&) { decoded(); });
+	}
+	else
+	{
+		node.hub.register_analog_information_callback_v20([decoded](PaceBmsProtocolV20::AnalogInformation&) { decoded(); }, PaceBmsProtocolBase::AIF_None);
+		node.hub.register_status_information_callback_v20([decodedStatus](PaceBmsProtocolV20::StatusInformation&) { decodedStatus(); }, PaceBmsProtocolBase::SIF_None);
+		node.hub.register_hardware_version_callback_v20([decoded](std::string&) { decoded(); });
+	}
+
+	// in setup priority order, as the generated main.cpp would
+	node.sensors.setup();
+	node.textSensors.setup();
+	node.hub.setup();
+}
+
+// ============================================================================
+struct CycleOptions
+{
+	int warmupCycles = 3;
+	int cycles = 10;
+	uint32_t loopIntervalMs = 16;
+};
+
+// one update() and then loop() until the next one is due
+static bool RunCycle(Node& node, const CycleOptions& options, StageTotals* totals)
+{
+	StageTotals discard;
+	StageTotals& into = totals != nullptr ? *totals : discard;
+
+	StartRecording();
+	node.hub.update();
+	if (!StopRecording())
+		return false;
+	AddRecording(into, STAGE_QUEUEING);
+
+	for (uint32_t elapsed = 0; elapsed < node.hub.get_update_interval(); elapsed += options.loopIntervalMs)
+	{
+		host_esphome::advance_ms(options.loopIntervalMs);
+
+		StartRecording();
+		host_esphome::run_scheduler();
+		if (!StopRecording())
+			return false;
+		AddRecording(into, STAGE_QUEUEING);
+
+		StartRecording();
+		node.hub.loop();
+		if (!StopRecording())
+			return false;
+		AddLoopRecording(into);
+	}
+	return true;
+}
+
+struct ConfigurationResult
+{
+	std::string name;
+	bool ok = true;
+	uint32_t requestsPerCycle = 0;
+	StageTotals totals;
+	int cycles = 0;
+};
+
+static ConfigurationResult RunConfiguration(const std::string& name, int commandset, const char* variant, const CycleOptions& options)
+{
+	ConfigurationResult result;
+	result.name = name;
+	result.cycles = options.cycles;
+
+	uint32_t warningsBefore = host_esphome::get_warning_count();
+	uint32_t errorsBefore = host_esphome::get_error_count();
+
+	Node node;
+	Configure(node, commandset, variant);
+
+	// the first few cycles grow buffers and fill in maps that are then reused, that's not what this is looking for
+	for (int i = 0; i < options.warmupCycles; i++)
+		result.ok = RunCycle(node, options, nullptr) && result.ok;
+
+	for (int i = 0; i < options.cycles; i++)
+	{
+		uint32_t requestsBefore = node.uart.get_request_count();
+		uint32_t responsesBefore = node.uart.get_response_count();
+		result.ok = RunCycle(node, options, &result.totals) && result.ok;
+		uint32_t requests = node.uart.get_request_count() - requestsBefore;
+		uint32_t responses = node.uart.get_response_count() - responsesBefore;
+		if (requests == 0 || responses != requests || (i != 0 && requests != result.requestsPerCycle))
+		{
+			std::cerr << "FAIL: " << name << " cycle " << i << " sent " << requests << " requests and got " << responses << " responses" << std::endl;
+			result.ok = false;
+		}
+		result.requestsPerCycle = requests;
+	}
+
+	// a complete cycle that decodes cleanly has nothing to warn about
+	if (host_esphome::get_warning_count() != warningsBefore || host_esphome::get_error_count() != errorsBefore)
+	{
+		std::cerr << "FAIL: " << name << " logged " << (host_esphome::get_warning_count() - warningsBefore) << " warnings and " << (host_esphome::get_error_count() - errorsBefore) << " errors, run with --verbose to see them" << std::endl;
+		result.ok = false;
+	}
+	return result;
+}
+
+// ============================================================================
+struct BudgetEntry
+{
+	double allocationsPerCycle;
+	double bytesPerCycle;
+};
+
+static std::map<std::string, BudgetEntry> ReadBudget(const std::string& path)
+{
+	std::map<std::string, BudgetEntry> budget;
+	std::ifstream file(path);
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (line.empty() || line[0] == '#')
+			continue;
+		std::istringstream fields(line);
+		std::string configuration;
+		std::string stage;
+		BudgetEntry entry;
+		if (fields >> configuration >> stage >> entry.allocationsPerCycle >> entry.bytesPerCycle)
+			budget[configuration + "." + stage] = entry;
+	}
+	return budget;
+}
+
+struct ReportLine
+{
+	std::string configuration;
+	std::string stage;
+	double allocationsPerCycle;
+	double bytesPerCycle;
+};
+
+static bool WriteBudget(const std::string& path, const std::vector<ReportLine>& lines)
+{
+	std::ofstream file(path);
+	if (!file)
+		return false;
+	file << "# configuration stage allocations_per_cycle bytes_per_cycle" << std::endl;
+	file << "# written by allocations_pace_bms --write-budget, a run that allocates more than this per cycle fails" << std::endl;
+	char text[256];
+	for (const ReportLine& line : lines)
+	{
+		snprintf(text, sizeof(text), "%s %s %.2f %.1f", line.configuration.c_str(), line.stage.c_str(), line.allocationsPerCycle, line.bytesPerCycle);
+		file << text << std::endl;
+	}
+	return true;
+}
+
+static void Usage()
+{
+	std::cerr <<
+		"usage: allocations_pace_bms [options]\n"
+		"  --budget PATH         budget to check against (default: the checked in budget.txt)\n"
+		"  --write-budget        replace the budget with this run's results\n"
+		"  --cycles N            measure N update cycles of each configuration (default 10)\n"
+		"  --warmup N            run N update cycles of each configuration before measuring (default 3)\n"
+		"  --verbose             show the component's log (at DEBUG) on stderr\n";
+}
+
+int main(int argc, char* argv[])
+{
+#ifdef ALLOCATIONS_BUDGET
+	std::string budgetPath = ALLOCATIONS_BUDGET;
+#else
+	std::string budgetPath = "budget.txt";
+#endif
+	bool writeBudget = false;
+	CycleOptions options;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--budget" && hasValue)
+			budgetPath = argv[++i];
+		else if (arg == "--write-budget")
+			writeBudget = true;
+		else if (arg == "--cycles" && hasValue)
+			options.cycles = atoi(argv[++i]);
+		else if (arg == "--warmup" && hasValue)
+			options.warmupCycles = atoi(argv[++i]);
+		else if (arg == "--verbose")
+			host_esphome::set_log_level(ESPHOME_LOG_LEVEL_DEBUG);
+		else
+		{
+			Usage();
+			return 2;
+		}
+	}
+	if (options.cycles < 1)
+		options.cycles = 1;
+
+	std::vector<ConfigurationResult> results;
+	results.push_back(RunConfiguration("v25", 0x25, nullptr, options));
+	results.push_back(RunConfiguration("v20.EG4", 0x20, "EG4", options));
+
+	std::vector<ReportLine> lines;
+	for (const ConfigurationResult& result : results)
+	{
+		uint64_t totalAllocations = 0;
+		uint64_t totalBytes = 0;
+		for (int stage = 0; stage < STAGE_COUNT; stage++)
+		{
+			lines.push_back({ result.name, stageNames[stage], (double)result.totals.allocations[stage] / result.cycles, (double)result.totals.bytes[stage] / result.cycles });
+			totalAllocations += result.totals.allocations[stage];
+			totalBytes += result.totals.bytes[stage];
+		}
+		lines.push_back({ result.name, "total", (double)totalAllocations / result.cycles, (double)totalBytes / result.cycles });
+	}
+
+	std::map<std::string, BudgetEntry> budget = ReadBudget(budgetPath);
+	bool exceeded = false;
+	printf("%-12s %-14s %12s %12s %14s %13s\n", "config", "stage", "allocs/cycle", "bytes/cycle", "budget allocs", "budget bytes");
+	for (const ReportLine& line : lines)
+	{
+		printf("%-12s %-14s %12.2f %12.1f", line.configuration.c_str(), line.stage.c_str(), line.allocationsPerCycle, line.bytesPerCycle);
+		auto found = budget.find(line.configuration + "." + line.stage);
+		if (found == budget.end())
+		{
+			printf(" %14s\n", "new");
+			continue;
+		}
+		printf(" %14.2f %13.1f", found->second.allocationsPerCycle, found->second.bytesPerCycle);
+		if (line.allocationsPerCycle > found->second.allocationsPerCycle + 0.005 || line.bytesPerCycle > found->second.bytesPerCycle + 0.05)
+		{
+			printf("  over budget");
+			exceeded = true;
+		}
+		else if (line.allocationsPerCycle < found->second.allocationsPerCycle - 0.005)
+		{
+			printf("  under budget, lower it with --write-budget");
+		}
+		printf("\n");
+	}
+	for (const ConfigurationResult& result : results)
+		printf("%s: %u requests per cycle\n", result.name.c_str(), (unsigned)result.requestsPerCycle);
+
+	bool ok = true;
+	for (const ConfigurationResult& result : results)
+		ok = ok && result.ok;
+
+	if (writeBudget)
+	{
+		if (!ok)
+		{
+			std::cerr << "Not writing a budget from a run that failed" << std::endl;
+			return 1;
+		}
+		if (!WriteBudget(budgetPath, lines))
+		{
+			std::cerr << "Unable to write " << budgetPath << std::endl;
+			return 1;
+		}
+		std::cout << "wrote " << budgetPath << std::endl;
+		return 0;
+	}
+
+	return ok && !exceeded ? 0 : 1;
+}
@@ -0,0 +1,225 @@
+// Bank PACE BMS.cpp : the pace_bms_bank aggregator over several hubs, each polling its own simulated v25 pack on the host
+//     clock, with the packs' analog and status answers rewritten so that what the bank works out from them is known ahead
+//     of time: the capacity weighted state of charge, which pack and cell has the lowest and highest cell voltage, how
+//     many packs are in a protection state, and a pack that stops answering dropping out once pack_timeout has passed
+//
+// each scenario prints PASS: or FAIL:, along with what it measured
+//     build/bank_pace_bms --verbose      show the components' log (at DEBUG) on stderr
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "host_esphome.h"
+#include "host_uart.h"
+#include "../../components/pace_bms/pace_bms_component.h"
+#include "../../components/pace_bms_bank/pace_bms_bank.h"
+
+using namespace esphome;
+using namespace esphome::pace_bms;
+
+// ============================================================================
+static const uint32_t loopIntervalMs = 1;
+static const uint32_t updateIntervalMs = 2000;
+static const uint32_t packTimeoutMs = 5000;
+
+// what one pack reports, everything else is left as it is in the example responses
+struct PackValues
+{
+	uint32_t remainingMilliampHours;
+	uint32_t fullMilliampHours;
+	// 1-based, the rest of the 16 cells read baseCellMillivolts
+	uint8_t oddCell;
+	uint16_t oddCellMillivolts;
+	uint8_t protection;
+	bool answering = true;
+};
+static const uint16_t baseCellMillivolts = 3300;
+
+// where the values are in the v25 example analog information response: 16 cells then 6 temperatures, and after those
+//     current, total voltage, remaining capacity, a constant, full capacity
+static const int analogCellOffset = 19;
+static const int analogRemainingOffset = 117;
+static const int analogFullOffset = 123;
+// and in the v25 example status information response, 16 cell and 6 temperature warnings then 3 more warnings first
+static const int statusProtection1Offset = 71;
+
+static void WriteHex(std::vector<uint8_t>& frame, int offset, int digits, uint32_t value)
+{
+	static const char hex[] = "0123456789ABCDEF";
+	for (int i = digits - 1; i >= 0; i--, value >>= 4)
+		frame[offset + i] = hex[value & 0x0F];
+}
+
+static void RewriteResponse(const PackValues& values, const std::vector<uint8_t>& request, std::vector<uint8_t>& response)
+{
+	if (!values.answering)
+	{
+		response.clear();
+		return;
+	}
+	int cid2 = std::stoi(std::string(request.begin() + 7, request.begin() + 9), nullptr, 16);
+	if (cid2 == 0x42)
+	{
+		const char* example = (const char*)PaceBmsProtocolV25::exampleReadAnalogInformationResponseV25;
+		response.assign(example, example + strlen(example));
+		for (int i = 0; i < 16; i++)
+			WriteHex(response, analogCellOffset + i * 4, 4, i + 1 == values.oddCell ? values.oddCellMillivolts : baseCellMillivolts);
+		WriteHex(response, analogRemainingOffset, 4, values.remainingMilliampHours / 10);
+		WriteHex(response, analogFullOffset, 4, values.fullMilliampHours / 10);
+		UpdateSimulatedResponseChecksum(response);
+	}
+	else if (cid2 == 0x44)
+	{
+		const char* example = (const char*)PaceBmsProtocolV25::exampleReadStatusInformationResponseV25;
+		response.assign(example, example + strlen(example));
+		WriteHex(response, statusProtection1Offset, 2, values.protection);
+		UpdateSimulatedResponseChecksum(response);
+	}
+}
+
+// a hub per pack, each on its own bus, and the bank over all of them
+struct Bank
+{
+	std::vector<PackValues> values;
+	std::vector<std::unique_ptr<host_esphome::SimulatedUart>> uarts;
+	std::vector<std::unique_ptr<PaceBms>> hubs;
+	PaceBmsBank bank;
+	PaceBmsBank::bank_information latest;
+	int published = 0;
+
+	explicit Bank(const std::vector<PackValues>& packValues) : values(packValues)
+	{
+		for (size_t i = 0; i < this->values.size(); i++)
+		{
+			this->uarts.emplace_back(new host_esphome::SimulatedUart());
+			this->uarts[i]->add_pack(1);
+			this->uarts[i]->rewrite_response = [this, i](const std::vector<uint8_t>& request, std::vector<uint8_t>& response) { RewriteResponse(this->values[i], request, response); };
+
+			this->hubs.emplace_back(new PaceBms());
+			PaceBms& hub = *this->hubs[i];
+			hub.set_uart_parent(this->uarts[i].get());
+			hub.set_address(1);
+			hub.set_protocol_commandset(0x25);
+			hub.set_request_throttle(50);
+			hub.set_response_timeout(200);
+			hub.set_update_interval(updateIntervalMs);
+			this->bank.add_pack(&hub);
+		}
+		this->bank.set_pack_timeout(packTimeoutMs);
+		this->bank.set_update_interval(updateIntervalMs);
+		this->bank.register_bank_information_callback([this](PaceBmsBank::bank_information& bank_information) {
+			this->latest = bank_information;
+			this->published++;
+		});
+
+		// in setup priority order, the bank (DATA) registers with the hubs (LATE) before they set up
+		this->bank.setup();
+		this->bank.enable_alarm_tracking();
+		for (std::unique_ptr<PaceBms>& hub : this->hubs)
+			hub->setup();
+	}
+
+	void Run(int intervals)
+	{
+		for (int interval = 0; interval < intervals; interval++)
+		{
+			for (std::unique_ptr<PaceBms>& hub : this->hubs)
+				hub->update();
+			for (uint32_t elapsed = 0; elapsed < updateIntervalMs; elapsed += loopIntervalMs)
+			{
+				host_esphome::advance_ms(loopIntervalMs);
+				host_esphome::run_scheduler();
+				for (std::unique_ptr<PaceBms>& hub : this->hubs)
+					hub->loop();
+				this->bank.loop();
+			}
+			this->bank.update();
+		}
+	}
+};
+
+static bool Near(float value, float expected) { return std::fabs(value - expected) < 0.001f; }
+
+static bool Report(bool pass, const char* name, const PaceBmsBank::bank_information& bank)
+{
+	printf("%s: %s, %i packs (%i in alarm), %.3f%% SoC, %.3f V, min cell %.3f V (pack %i cell %i), max cell %.3f V (pack %i cell %i)\n",
+		pass ? "PASS" : "FAIL", name, bank.pack_count_, bank.alarm_pack_count_, bank.state_of_charge_, bank.voltage_volts_,
+		bank.min_cell_voltage_volts_, bank.min_cell_voltage_pack_, bank.min_cell_voltage_cell_,
+		bank.max_cell_voltage_volts_, bank.max_cell_voltage_pack_, bank.max_cell_voltage_cell_);
+	return pass;
+}
+
+// a small pack half full and two large ones, one of them nearly full and in a protection state: the state of charge is
+//     weighted by capacity (150 of 220 Ah, rather than the 63.3% average of the three), the lowest cell is cell 5 of pack 2
+//     and the highest cell 12 of pack 3
+static bool TestBank()
+{
+	Bank bank({
+		{ 10000, 20000, 3, 3350, 0x00 },
+		{ 90000, 100000, 5, 3000, 0x01 },
+		{ 50000, 100000, 12, 3500, 0x00 },
+	});
+	bank.Run(3);
+
+	bool ok = true;
+	const PaceBmsBank::bank_information& all = bank.latest;
+	ok &= Report(bank.published > 0 && all.pack_count_ == 3 && all.alarm_pack_count_ == 1 && Near(all.state_of_charge_, 150.0f / 220.0f * 100.0f) &&
+		Near(all.full_capacity_amp_hours_, 220.0f) && Near(all.voltage_volts_, 52.429f) &&
+		Near(all.min_cell_voltage_volts_, 3.0f) && all.min_cell_voltage_pack_ == 2 && all.min_cell_voltage_cell_ == 5 &&
+		Near(all.max_cell_voltage_volts_, 3.5f) && all.max_cell_voltage_pack_ == 3 && all.max_cell_voltage_cell_ == 12 &&
+		Near(all.max_cell_differential_volts_, 0.5f),
+		"three packs, weighted SoC 68.182%, min pack 2 cell 5, max pack 3 cell 12, 1 in alarm", all);
+
+	// pack 3 goes quiet, it's still counted until pack_timeout has passed since it last answered and then it's left out
+	bank.values[2].answering = false;
+	bank.Run(1);
+	ok &= Report(bank.latest.pack_count_ == 3, "pack 3 quiet for less than pack_timeout, still counted", bank.latest);
+	bank.Run((packTimeoutMs / updateIntervalMs) + 1);
+	const PaceBmsBank::bank_information& two = bank.latest;
+	ok &= Report(two.pack_count_ == 2 && two.alarm_pack_count_ == 1 && Near(two.state_of_charge_, 100.0f / 120.0f * 100.0f) &&
+		Near(two.min_cell_voltage_volts_, 3.0f) && two.min_cell_voltage_pack_ == 2 && two.min_cell_voltage_cell_ == 5 &&
+		Near(two.max_cell_voltage_volts_, 3.35f) && two.max_cell_voltage_pack_ == 1 && two.max_cell_voltage_cell_ == 3,
+		"pack 3 quiet for longer than pack_timeout, left out, weighted SoC 83.333%, max pack 1 cell 3", two);
+
+	// and pack 2 coming out of protection clears the alarm count
+	bank.values[1].protection = 0x00;
+	bank.Run(1);
+	ok &= Report(bank.latest.pack_count_ == 2 && bank.latest.alarm_pack_count_ == 0, "pack 2 out of protection, none in alarm", bank.latest);
+	return ok;
+}
+
+static void Usage()
+{
+	std::cerr <<
+		"usage: bank_pace_bms [options]\n"
+		"  --verbose        show the components' log (at DEBUG) on stderr\n";
+}
+
+int main(int argc, char* argv[])
+{
+	bool verbose = false;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--verbose")
+			verbose = true;
+		else
+		{
+			Usage();
+			return 2;
+		}
+	}
+	// a pack that stops answering times out, which is a warning
+	host_esphome::set_log_level(verbose ? ESPHOME_LOG_LEVEL_DEBUG : ESPHOME_LOG_LEVEL_NONE);
+
+	// on a device the first update() comes well after boot
+	host_esphome::advance_ms(updateIntervalMs);
+
+	bool ok = true;
+	ok &= TestBank();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,250 @@
+// Benchmark Component PACE BMS.cpp : the whole v25 ESPHome component, the hub with its sensor, text_sensor, number, switch
+//     and select platforms and every entity they offer configured, built on the host (see: "Host ESPHome/host_esphome.h")
+//     and polling a simulated pack, timed end to end so that changes to how the hub schedules its work can be compared
+//     without flashing anything
+//
+// by default the pack is simulated in-process on the host clock (see: host_uart.h), so everything other than the wall clock
+//     timings is exactly repeatable from run to run, with --port the component talks to a serial port on the real time
+//     clock instead, normally the pseudo-terminal that simulate_pace_bms prints the name of:
+//     build/simulate_pace_bms --latency-ms 20 --baud 9600 -- build/benchmark_component_pace_bms --port {} --update-interval-ms 6000
+//
+// reported:
+//     cycle ms         from update() to the last publish it led to, on the host clock
+//     requests         sent per cycle, and how many of those were answered or timed out
+//     publishes        entity state publishes per cycle, per host clock second and per wall clock second spent in loop()
+//     loop() us        wall clock time of each loop() call, which is how long the rest of the device was held up by it
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "host_esphome.h"
+#include "host_node.h"
+#include "host_uart.h"
+#ifndef _WIN32
+#include "host_serial_uart.h"
+#endif
+
+using namespace esphome;
+using namespace esphome::pace_bms;
+using host_esphome::HostNode;
+
+// ============================================================================
+struct Options
+{
+	int warmupCycles = 2;
+	int cycles = 20;
+	uint32_t latencyMs = 20;
+	uint32_t baudRate = 9600;
+	uint32_t updateIntervalMs = 10000;
+	uint32_t loopIntervalMs = 16;
+	uint32_t requestThrottleMs = 50;
+	uint32_t responseTimeoutMs = 200;
+	std::string port;
+};
+
+static bool Configure(HostNode& node, const Options& options)
+{
+	uart::UARTComponent* uart;
+	if (options.port.empty())
+	{
+		host_esphome::SimulatedUart* simulated = new host_esphome::SimulatedUart();
+		simulated->add_pack(1);
+		simulated->set_latency_ms(options.latencyMs);
+		uart = simulated;
+	}
+	else
+	{
+#ifndef _WIN32
+		host_esphome::SerialPortUart* serial = new host_esphome::SerialPortUart();
+		serial->set_baud_rate(options.baudRate);
+		if (!serial->open(options.port))
+		{
+			delete serial;
+			return false;
+		}
+		host_esphome::use_real_time_clock();
+		uart = serial;
+#else
+		std::cerr << "--port is not supported on Windows" << std::endl;
+		return false;
+#endif
+	}
+	uart->set_baud_rate(options.baudRate);
+
+	host_esphome::HostNodeSettings settings;
+	settings.requestThrottleMs = options.requestThrottleMs;
+	settings.responseTimeoutMs = options.responseTimeoutMs;
+	settings.updateIntervalMs = options.updateIntervalMs;
+	node.Configure(uart, settings);
+	return true;
+}
+
+// ============================================================================
+struct Results
+{
+	std::vector<double> cycleMs;
+	std::vector<double> loopUs;
+	uint64_t publishes = 0;
+	uint32_t requestsSent = 0;
+	uint32_t responsesOk = 0;
+	uint32_t timeouts = 0;
+	double hostSeconds = 0;
+	double loopSeconds = 0;
+};
+
+// one update() and then loop() until the next one is due
+static void RunCycle(HostNode& node, const Options& options, Results* results)
+{
+	uint64_t startUs = host_esphome::now_us();
+	uint64_t publishesBefore = node.counter.publishes;
+	node.counter.lastPublishUs = startUs;
+	node.hub.update();
+
+	for (uint32_t elapsed = 0; elapsed < options.updateIntervalMs; elapsed += options.loopIntervalMs)
+	{
+		host_esphome::advance_ms(options.loopIntervalMs);
+		host_esphome::run_scheduler();
+
+		auto start = std::chrono::steady_clock::now();
+		node.hub.loop();
+		auto end = std::chrono::steady_clock::now();
+		if (results != nullptr)
+			results->loopUs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1000.0);
+	}
+
+	if (results != nullptr)
+	{
+		results->cycleMs.push_back((node.counter.lastPublishUs - startUs) / 1000.0);
+		results->publishes += node.counter.publishes - publishesBefore;
+		results->hostSeconds += (host_esphome::now_us() - startUs) / 1000000.0;
+	}
+}
+
+static double Percentile(std::vector<double> values, double percent)
+{
+	if (values.empty())
+		return 0;
+	size_t index = (size_t)(values.size() * percent / 100.0);
+	if (index >= values.size())
+		index = values.size() - 1;
+	std::nth_element(values.begin(), values.begin() + index, values.end());
+	return values[index];
+}
+
+static void Usage()
+{
+	std::cerr <<
+		"usage: benchmark_component_pace_bms [options]\n"
+		"  --cycles N                measure N update cycles (default 20)\n"
+		"  --warmup N                run N update cycles before measuring (default 2)\n"
+		"  --update-interval-ms N    the hub's update_interval (default 10000)\n"
+		"  --loop-interval-ms N      time between loop() calls, ESPHome's default is 16\n"
+		"  --request-throttle-ms N   the hub's request_throttle (default 50)\n"
+		"  --response-timeout-ms N   the hub's response_timeout (default 200)\n"
+		"  --latency-ms N            the simulated pack waits N milliseconds before answering (default 20)\n"
+		"  --baud N                  bus speed, the simulated pack trickles its answer in at this rate (default 9600)\n"
+#ifndef _WIN32
+		"  --port PATH               talk to a serial port (or simulate_pace_bms) on the real time clock instead\n"
+#endif
+		"  --verbose                 show the component's log (at DEBUG) on stderr\n";
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--cycles" && hasValue)
+			options.cycles = atoi(argv[++i]);
+		else if (arg == "--warmup" && hasValue)
+			options.warmupCycles = atoi(argv[++i]);
+		else if (arg == "--update-interval-ms" && hasValue)
+			options.updateIntervalMs = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--loop-interval-ms" && hasValue)
+			options.loopIntervalMs = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--request-throttle-ms" && hasValue)
+			options.requestThrottleMs = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--response-timeout-ms" && hasValue)
+			options.responseTimeoutMs = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--latency-ms" && hasValue)
+			options.latencyMs = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--baud" && hasValue)
+			options.baudRate = (uint32_t)atoi(argv[++i]);
+#ifndef _WIN32
+		else if (arg == "--port" && hasValue)
+			options.port = argv[++i];
+#endif
+		else if (arg == "--verbose")
+			host_esphome::set_log_level(ESPHOME_LOG_LEVEL_DEBUG);
+		else
+		{
+			Usage();
+			return 2;
+		}
+	}
+	if (options.cycles < 1)
+		options.cycles = 1;
+	if (options.loopIntervalMs < 1)
+		options.loopIntervalMs = 1;
+
+	HostNode node;
+	if (!Configure(node, options))
+	{
+		std::cerr << "FAIL: unable to set up the component" << std::endl;
+		return 1;
+	}
+
+	for (int i = 0; i < options.warmupCycles; i++)
+		RunCycle(node, options, nullptr);
+
+	// the bus metrics are handed out at the top of each update(), so the totals are taken from one update() to the next
+	uint32_t warningsBefore = host_esphome::get_warning_count();
+	uint32_t errorsBefore = host_esphome::get_error_count();
+	PaceBms::bus_metrics metricsBefore = node.metrics;
+	std::vector<uint32_t> publishedBefore = node.counter.perEntity;
+	Results results;
+	for (int i = 0; i < options.cycles; i++)
+		RunCycle(node, options, &results);
+	node.hub.update();
+	results.requestsSent = node.metrics.requests_sent_ - metricsBefore.requests_sent_;
+	results.responsesOk = node.metrics.responses_ok_ - metricsBefore.responses_ok_;
+	results.timeouts = node.metrics.timeouts_ - metricsBefore.timeouts_;
+	for (double us : results.loopUs)
+		results.loopSeconds += us / 1000000.0;
+
+	double loopMean = results.loopUs.empty() ? 0 : results.loopSeconds * 1000000.0 / results.loopUs.size();
+	printf("%s, %d cycles of %u ms, %u entities\n", options.port.empty() ? "simulated pack on the host clock" : options.port.c_str(), options.cycles, (unsigned)options.updateIntervalMs, (unsigned)node.entityNames.size());
+	printf("%-24s %10.1f p50 %10.1f max\n", "cycle ms", Percentile(results.cycleMs, 50), *std::max_element(results.cycleMs.begin(), results.cycleMs.end()));
+	printf("%-24s %10.2f sent/cycle %10u answered %10u timed out\n", "requests", (double)results.requestsSent / options.cycles, (unsigned)results.responsesOk, (unsigned)results.timeouts);
+	printf("%-24s %10.2f per cycle %10.1f per host s %10.0f per loop() s\n", "publishes", (double)results.publishes / options.cycles, results.publishes / results.hostSeconds, results.loopSeconds > 0 ? results.publishes / results.loopSeconds : 0.0);
+	printf("%-24s %10.2f mean %10.2f p99 %10.2f max\n", "loop() us", loopMean, Percentile(results.loopUs, 99), *std::max_element(results.loopUs.begin(), results.loopUs.end()));
+
+	bool ok = true;
+	if (results.requestsSent == 0 || results.responsesOk != results.requestsSent)
+	{
+		std::cerr << "FAIL: " << results.requestsSent << " requests sent, " << results.responsesOk << " answered" << std::endl;
+		ok = false;
+	}
+	for (size_t i = 0; i < node.entityNames.size(); i++)
+	{
+		if (node.counter.perEntity[i] == publishedBefore[i])
+		{
+			std::cerr << "FAIL: '" << node.entityNames[i] << "' was never published" << std::endl;
+			ok = false;
+		}
+	}
+	if (host_esphome::get_warning_count() != warningsBefore || host_esphome::get_error_count() != errorsBefore)
+	{
+		std::cerr << "FAIL: logged " << (host_esphome::get_warning_count() - warningsBefore) << " warnings and " << (host_esphome::get_error_count() - errorsBefore) << " errors, run with --verbose to see them" << std::endl;
+		ok = false;
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,387 @@
+// Benchmark PACE BMS.cpp : cost per call of the protocol classes' request builders and response decoders, run over the known
+//     good example frames, and compared against a stored baseline so that optimizations and regressions show up
+//
+// time is machine dependent and only reported, allocations per call are not (for a given standard library) so
+//     --check-allocations fails the run if any of them went up, which is what ctest uses
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../../components/pace_bms/pace_bms_protocol_v25.h"
+#include "../../components/pace_bms/pace_bms_protocol_v20.h"
+
+// ============================================================================
+// every heap allocation in the process goes through here so that it can be counted
+static size_t allocationCount = 0;
+static size_t allocationBytes = 0;
+
+void* operator new(size_t size)
+{
+	allocationCount++;
+	allocationBytes += size;
+	void* p = malloc(size == 0 ? 1 : size);
+	if (p == nullptr)
+		throw std::bad_alloc();
+	return p;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+// ============================================================================
+// the decoders log through these, in ESPHome most of that is compiled out below the configured level, here it's just dropped
+void DropLog(std::string /*message*/) { }
+
+// ValidateResponseAndGetPayloadLength is protected
+class BenchmarkProtocolV25 : public PaceBmsProtocolV25
+{
+public:
+	BenchmarkProtocolV25() : PaceBmsProtocolV25(OPTIONAL_NS::nullopt, OPTIONAL_NS::nullopt, CID1_LithiumIron, &DropLog, &DropLog, &DropLog, &DropLog, &DropLog, &DropLog) { }
+	int16_t ValidateResponse(const uint8_t busId, const std::vector<uint8_t>& response) { return ValidateResponseAndGetPayloadLength(busId, response); }
+};
+
+static std::vector<uint8_t> Frame(const uint8_t* example)
+{
+	return std::vector<uint8_t>(example, example + strlen((const char*)example));
+}
+
+// ============================================================================
+struct BenchmarkResult
+{
+	std::string name;
+	bool ok;
+	size_t frameBytes;
+	double nsPerCall;
+	double allocationsPerCall;
+	double allocatedBytesPerCall;
+};
+
+static std::vector<BenchmarkResult> results;
+static double minTimeMs = 200;
+static std::string filter;
+
+template<typename F> void Benchmark(const std::string& name, size_t frameBytes, F call)
+{
+	if (!filter.empty() && name.find(filter) == std::string::npos)
+		return;
+
+	BenchmarkResult result;
+	result.name = name;
+	result.frameBytes = frameBytes;
+	// warm up, and make sure it's measuring the path that succeeds
+	result.ok = call();
+
+	// double the batch until it runs long enough to be worth timing
+	size_t iterations = 16;
+	double elapsedNs = 0;
+	size_t allocations = 0;
+	size_t allocatedBytes = 0;
+	while (true)
+	{
+		size_t startCount = allocationCount;
+		size_t startBytes = allocationBytes;
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < iterations; i++)
+			call();
+		auto end = std::chrono::steady_clock::now();
+		elapsedNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		allocations = allocationCount - startCount;
+		allocatedBytes = allocationBytes - startBytes;
+		if (elapsedNs >= minTimeMs * 1000000.0 || iterations >= ((size_t)1 << 30))
+			break;
+		iterations *= 2;
+	}
+
+	result.nsPerCall = elapsedNs / iterations;
+	result.allocationsPerCall = (double)allocations / iterations;
+	result.allocatedBytesPerCall = (double)allocatedBytes / iterations;
+	results.push_back(result);
+}
+
+// reads a configuration with the example response so that there's something valid to write back, then times both
+template<typename Config> void BenchmarkConfiguration(BenchmarkProtocolV25& protocol, const std::string& name, PaceBmsProtocolV25::ReadConfigurationType type, const uint8_t* readResponseExample, const uint8_t* writeResponseExample)
+{
+	std::vector<uint8_t> request;
+	std::vector<uint8_t> readResponse = Frame(readResponseExample);
+	std::vector<uint8_t> writeResponse = Frame(writeResponseExample);
+	Config config;
+	protocol.ProcessReadConfigurationResponse(0, readResponse, config);
+
+	Benchmark("v25.CreateReadConfigurationRequest." + name, 0, [&]() { return protocol.CreateReadConfigurationRequest(0, type, request); });
+	Benchmark("v25.ProcessReadConfigurationResponse." + name, readResponse.size(), [&]() { Config decoded; return protocol.ProcessReadConfigurationResponse(0, readResponse, decoded); });
+	Benchmark("v25.CreateWriteConfigurationRequest." + name, 0, [&]() { return protocol.CreateWriteConfigurationRequest(0, config, request); });
+	Benchmark("v25.ProcessWriteConfigurationResponse." + name, writeResponse.size(), [&]() { return protocol.ProcessWriteConfigurationResponse(0, writeResponse); });
+}
+
+#define BENCHMARK_CONFIGURATION(type) \
+	BenchmarkConfiguration<PaceBmsProtocolV25::type##Configuration>(protocol, #type, PaceBmsProtocolV25::RC_##type, \
+		PaceBmsProtocolV25::exampleRead##type##ConfigurationResponseV25, PaceBmsProtocolV25::exampleWrite##type##ConfigurationResponseV25)
+
+void BenchmarkV25()
+{
+	BenchmarkProtocolV25 protocol;
+	std::vector<uint8_t> request;
+
+	std::vector<uint8_t> analogResponse = Frame(PaceBmsProtocolV25::exampleReadAnalogInformationResponseV25);
+	std::vector<uint8_t> statusResponse = Frame(PaceBmsProtocolV25::exampleReadStatusInformationResponseV25);
+	std::vector<uint8_t> hardwareVersionResponse = Frame(PaceBmsProtocolV25::exampleReadHardwareVersionResponseV25);
+	std::vector<uint8_t> serialNumberResponse = Frame(PaceBmsProtocolV25::exampleReadSerialNumberResponseV25);
+	std::vector<uint8_t> switchResponse = Frame(PaceBmsProtocolV25::exampleWriteEnableBuzzerSwitchCommandResponseV25);
+	std::vector<uint8_t> mosfetResponse = Frame(PaceBmsProtocolV25::exampleWriteMosfetChargeCloseSwitchCommandResponseV25);
+	std::vector<uint8_t> shutdownResponse = Frame(PaceBmsProtocolV25::exampleWriteRebootCommandResponseV25);
+	std::vector<uint8_t> historyResponse = Frame(PaceBmsProtocolV25::exampleReadHistoryRecordResponseV25);
+	std::vector<uint8_t> readTimeResponse = Frame(PaceBmsProtocolV25::exampleReadSystemTimeResponseV25);
+	std::vector<uint8_t> writeTimeResponse = Frame(PaceBmsProtocolV25::exampleWriteSystemTimeResponseV25);
+	std::vector<uint8_t> readLimiterResponse = Frame(PaceBmsProtocolV25::exampleReadChargeCurrentLimiterStartCurrentResponseV25);
+	std::vector<uint8_t> writeLimiterResponse = Frame(PaceBmsProtocolV25::exampleWriteChargeCurrentLimiterStartCurrentResponseV25);
+	std::vector<uint8_t> remainingCapacityResponse = Frame(PaceBmsProtocolV25::exampleReadRemainingCapacityResponseV25);
+	std::vector<uint8_t> readProtocolsResponse = Frame(PaceBmsProtocolV25::exampleReadProtocolsResponseV25);
+	std::vector<uint8_t> writeProtocolsResponse = Frame(PaceBmsProtocolV25::exampleWriteProtocolsResponseV25);
+
+	Benchmark("v25.ValidateResponseAndGetPayloadLength", analogResponse.size(), [&]() { return protocol.ValidateResponse(1, analogResponse) > 0; });
+
+	Benchmark("v25.CreateReadAnalogInformationRequest", 0, [&]() { return protocol.CreateReadAnalogInformationRequest(1, request); });
+	Benchmark("v25.ProcessReadAnalogInformationResponse", analogResponse.size(), [&]() { PaceBmsProtocolV25::AnalogInformation decoded; return protocol.ProcessReadAnalogInformationResponse(1, analogResponse, decoded); });
+	Benchmark("v25.ProcessReadAnalogInformationResponse.AIF_None", analogResponse.size(), [&]() { PaceBmsProtocolV25::AnalogInformation decoded; return protocol.ProcessReadAnalogInformationResponse(1, analogResponse, decoded, PaceBmsProtocolBase::AIF_None); });
+	Benchmark("v25.CreateReadStatusInformationRequest", 0, [&]() { return protocol.CreateReadStatusInformationRequest(1, request); });
+	Benchmark("v25.ProcessReadStatusInformationResponse", statusResponse.size(), [&]() { PaceBmsProtocolV25::StatusInformation decoded; return protocol.ProcessReadStatusInformationResponse(1, statusResponse, decoded); });
+	Benchmark("v25.ProcessReadStatusInformationResponse.SIF_None", statusResponse.size(), [&]() { PaceBmsProtocolV25::StatusInformation decoded; return protocol.ProcessReadStatusInformationResponse(1, statusResponse, decoded, PaceBmsProtocolBase::SIF_None); });
+	Benchmark("v25.CreateReadHardwareVersionRequest", 0, [&]() { return protocol.CreateReadHardwareVersionRequest(1, request); });
+	Benchmark("v25.ProcessReadHardwareVersionResponse", hardwareVersionResponse.size(), [&]() { std::string decoded; return protocol.ProcessReadHardwareVersionResponse(1, hardwareVersionResponse, decoded); });
+	Benchmark("v25.CreateReadSerialNumberRequest", 0, [&]() { return protocol.CreateReadSerialNumberRequest(1, request); });
+	Benchmark("v25.ProcessReadSerialNumberResponse", serialNumberResponse.size(), [&]() { std::string decoded; return protocol.ProcessReadSerialNumberResponse(1, serialNumberResponse, decoded); });
+
+	Benchmark("v25.CreateWriteSwitchCommandRequest", 0, [&]() { return protocol.CreateWriteSwitchCommandRequest(0, PaceBmsProtocolV25::SC_EnableBuzzer, request); });
+	Benchmark("v25.ProcessWriteSwitchCommandResponse", switchResponse.size(), [&]() { return protocol.ProcessWriteSwitchCommandResponse(0, PaceBmsProtocolV25::SC_EnableBuzzer, switchResponse); });
+	Benchmark("v25.CreateWriteMosfetSwitchCommandRequest", 0, [&]() { return protocol.CreateWriteMosfetSwitchCommandRequest(0, PaceBmsProtocolV25::MT_Charge, PaceBmsProtocolV25::MS_Close, request); });
+	Benchmark("v25.ProcessWriteMosfetSwitchCommandResponse", mosfetResponse.size(), [&]() { return protocol.ProcessWriteMosfetSwitchCommandResponse(0, PaceBmsProtocolV25::MT_Charge, PaceBmsProtocolV25::MS_Close, mosfetResponse); });
+	Benchmark("v25.CreateWriteShutdownCommandRequest", 0, [&]() { return protocol.CreateWriteShutdownCommandRequest(0, request); });
+	Benchmark("v25.ProcessWriteShutdownCommandResponse", shutdownResponse.size(), [&]() { return protocol.ProcessWriteShutdownCommandResponse(0, shutdownResponse); });
+
+	Benchmark("v25.CreateReadHistoryRecordRequest", 0, [&]() { return protocol.CreateReadHistoryRecordRequest(0, 399, request); });
+	Benchmark("v25.ProcessReadHistoryRecordResponse", historyResponse.size(), [&]() { PaceBmsProtocolV25::HistoryRecord decoded; bool end; return protocol.ProcessReadHistoryRecordResponse(0, historyResponse, decoded, end); });
+
+	PaceBmsProtocolV25::DateTime dateTime;
+	protocol.ProcessReadSystemDateTimeResponse(0, readTimeResponse, dateTime);
+	Benchmark("v25.CreateReadSystemDateTimeRequest", 0, [&]() { return protocol.CreateReadSystemDateTimeRequest(0, request); });
+	Benchmark("v25.ProcessReadSystemDateTimeResponse", readTimeResponse.size(), [&]() { PaceBmsProtocolV25::DateTime decoded; return protocol.ProcessReadSystemDateTimeResponse(0, readTimeResponse, decoded); });
+	Benchmark("v25.CreateWriteSystemDateTimeRequest", 0, [&]() { return protocol.CreateWriteSystemDateTimeRequest(0, dateTime, request); });
+	Benchmark("v25.ProcessWriteSystemDateTimeResponse", writeTimeResponse.size(), [&]() { return protocol.ProcessWriteSystemDateTimeResponse(0, writeTimeResponse); });
+
+	BENCHMARK_CONFIGURATION(CellOverVoltage);
+	BENCHMARK_CONFIGURATION(PackOverVoltage);
+	BENCHMARK_CONFIGURATION(CellUnderVoltage);
+	BENCHMARK_CONFIGURATION(PackUnderVoltage);
+	BENCHMARK_CONFIGURATION(ChargeOverCurrent);
+	BenchmarkConfiguration<PaceBmsProtocolV25::DischargeOverCurrent1Configuration>(protocol, "DischargeOverCurrent1", PaceBmsProtocolV25::RC_DischargeOverCurrent1,
+		PaceBmsProtocolV25::exampleReadDishargeOverCurrent1ConfigurationResponseV25, PaceBmsProtocolV25::exampleWriteDishargeOverCurrent1ConfigurationResponseV25);
+	BenchmarkConfiguration<PaceBmsProtocolV25::DischargeOverCurrent2Configuration>(protocol, "DischargeOverCurrent2", PaceBmsProtocolV25::RC_DischargeOverCurrent2,
+		PaceBmsProtocolV25::exampleReadDishargeOverCurrent2ConfigurationResponseV25, PaceBmsProtocolV25::exampleWriteDishargeOverCurrent2ConfigurationResponseV25);
+	BENCHMARK_CONFIGURATION(ShortCircuitProtection);
+	BENCHMARK_CONFIGURATION(CellBalancing);
+	BENCHMARK_CONFIGURATION(Sleep);
+	BENCHMARK_CONFIGURATION(FullChargeLowCharge);
+	BENCHMARK_CONFIGURATION(ChargeAndDischargeOverTemperature);
+	BENCHMARK_CONFIGURATION(ChargeAndDischargeUnderTemperature);
+	BENCHMARK_CONFIGURATION(MosfetOverTemperature);
+	BENCHMARK_CONFIGURATION(EnvironmentOverUnderTemperature);
+
+	Benchmark("v25.CreateReadChargeCurrentLimiterStartCurrentRequest", 0, [&]() { return protocol.CreateReadChargeCurrentLimiterStartCurrentRequest(0, request); });
+	Benchmark("v25.ProcessReadChargeCurrentLimiterStartCurrentResponse", readLimiterResponse.size(), [&]() { uint8_t current; return protocol.ProcessReadChargeCurrentLimiterStartCurrentResponse(0, readLimiterResponse, current); });
+	Benchmark("v25.CreateWriteChargeCurrentLimiterStartCurrentRequest", 0, [&]() { return protocol.CreateWriteChargeCurrentLimiterStartCurrentRequest(0, 50, request); });
+	Benchmark("v25.ProcessWriteChargeCurrentLimiterStartCurrentResponse", writeLimiterResponse.size(), [&]() { return protocol.ProcessWriteChargeCurrentLimiterStartCurrentResponse(0, writeLimiterResponse); });
+	Benchmark("v25.CreateReadRemainingCapacityRequest", 0, [&]() { return protocol.CreateReadRemainingCapacityRequest(0, request); });
+	Benchmark("v25.ProcessReadRemainingCapacityResponse", remainingCapacityResponse.size(), [&]() { uint32_t remaining, actual, design; return protocol.ProcessReadRemainingCapacityResponse(0, remainingCapacityResponse, remaining, actual, design); });
+
+	PaceBmsProtocolV25::Protocols protocols;
+	protocol.ProcessReadProtocolsResponse(0, readProtocolsResponse, protocols);
+	Benchmark("v25.CreateReadProtocolsRequest", 0, [&]() { return protocol.CreateReadProtocolsRequest(0, request); });
+	Benchmark("v25.ProcessReadProtocolsResponse", readProtocolsResponse.size(), [&]() { PaceBmsProtocolV25::Protocols decoded; return protocol.ProcessReadProtocolsResponse(0, readProtocolsResponse, decoded); });
+	Benchmark("v25.CreateWriteProtocolsRequest", 0, [&]() { return protocol.CreateWriteProtocolsRequest(0, protocols, request); });
+	Benchmark("v25.ProcessWriteProtocolsResponse", writeProtocolsResponse.size(), [&]() { return protocol.ProcessWriteProtocolsResponse(0, writeProtocolsResponse); });
+}
+
+// the example frames were captured from one (EG4) BMS and every variant's decoder is run over them, a decoder that rejects
+//     one is still timed (and marked as failed) since rejecting a frame is part of the cost too
+void BenchmarkV20(const std::string& variant)
+{
+	PaceBmsProtocolV20 protocol(OPTIONAL_NS::optional<std::string>(variant), OPTIONAL_NS::nullopt, OPTIONAL_NS::optional<uint8_t>(0x4A), &DropLog, &DropLog, &DropLog, &DropLog, &DropLog, &DropLog);
+	std::vector<uint8_t> request;
+	std::string prefix = "v20." + variant + ".";
+
+	std::vector<uint8_t> analogResponse = Frame(PaceBmsProtocolV20::exampleReadAnalogInformationResponseV20);
+	std::vector<uint8_t> statusResponse = Frame(PaceBmsProtocolV20::exampleReadStatusInformationResponseV20);
+	std::vector<uint8_t> hardwareVersionResponse = Frame(PaceBmsProtocolV20::exampleReadHardwareVersionResponseV20);
+	std::vector<uint8_t> managementResponse = Frame(PaceBmsProtocolV20::exampleReadChargeDischargeManagementInformationResponseV20);
+	std::vector<uint8_t> readTimeResponse = Frame(PaceBmsProtocolV20::exampleReadSystemTimeResponseV20);
+	std::vector<uint8_t> writeTimeResponse = Frame(PaceBmsProtocolV20::exampleWriteSystemTimeResponseV20);
+
+	Benchmark(prefix + "CreateReadAnalogInformationRequest", 0, [&]() { return protocol.CreateReadAnalogInformationRequest(1, request); });
+	Benchmark(prefix + "ProcessReadAnalogInformationResponse", analogResponse.size(), [&]() { PaceBmsProtocolV20::AnalogInformation decoded; return protocol.ProcessReadAnalogInformationResponse(1, analogResponse, decoded); });
+	Benchmark(prefix + "CreateReadStatusInformationRequest", 0, [&]() { return protocol.CreateReadStatusInformationRequest(1, request); });
+	Benchmark(prefix + "ProcessReadStatusInformationResponse", statusResponse.size(), [&]() { PaceBmsProtocolV20::StatusInformation decoded; return protocol.ProcessReadStatusInformationResponse(1, statusResponse, decoded); });
+	Benchmark(prefix + "CreateReadHardwareVersionRequest", 0, [&]() { return protocol.CreateReadHardwareVersionRequest(1, request); });
+	Benchmark(prefix + "ProcessReadHardwareVersionResponse", hardwareVersionResponse.size(), [&]() { std::string decoded; return protocol.ProcessReadHardwareVersionResponse(1, hardwareVersionResponse, decoded); });
+	Benchmark(prefix + "CreateReadSerialNumberRequest", 0, [&]() { return protocol.CreateReadSerialNumberRequest(1, request); });
+	Benchmark(prefix + "CreateReadSystemDateTimeRequest", 0, [&]() { return protocol.CreateReadSystemDateTimeRequest(1, request); });
+	PaceBmsProtocolV20::DateTime dateTime;
+	protocol.ProcessReadSystemDateTimeResponse(1, readTimeResponse, dateTime);
+	Benchmark(prefix + "ProcessReadSystemDateTimeResponse", readTimeResponse.size(), [&]() { PaceBmsProtocolV20::DateTime decoded; return protocol.ProcessReadSystemDateTimeResponse(1, readTimeResponse, decoded); });
+	Benchmark(prefix + "CreateWriteSystemDateTimeRequest", 0, [&]() { return protocol.CreateWriteSystemDateTimeRequest(1, dateTime, request); });
+	Benchmark(prefix + "ProcessWriteSystemDateTimeResponse", writeTimeResponse.size(), [&]() { return protocol.ProcessWriteSystemDateTimeResponse(1, writeTimeResponse); });
+
+	if (variant == "PYLON")
+	{
+		// this example came from a different pack, reporting the standard lithium iron CID1
+		PaceBmsProtocolV20 pylon(OPTIONAL_NS::optional<std::string>(variant), OPTIONAL_NS::nullopt, OPTIONAL_NS::nullopt, &DropLog, &DropLog, &DropLog, &DropLog, &DropLog, &DropLog);
+		Benchmark(prefix + "CreateReadChargeDischargeManagementInformationRequest", 0, [&]() { return pylon.CreateReadChargeDischargeManagementInformationRequest(2, request); });
+		Benchmark(prefix + "ProcessReadChargeDischargeManagementInformationResponse", managementResponse.size(), [&]() { PaceBmsProtocolV20::ChargeDischargeManagementInformation decoded; return pylon.ProcessReadChargeDischargeManagementInformationResponse(2, managementResponse, decoded); });
+		Benchmark(prefix + "CreateReadSystemAnalogInformationRequest", 0, [&]() { return pylon.CreateReadSystemAnalogInformationRequest_PYLON(2, request); });
+		Benchmark(prefix + "CreateReadSystemStatusInformationRequest", 0, [&]() { return pylon.CreateReadSystemStatusInformationRequest_PYLON(2, request); });
+	}
+}
+
+// ============================================================================
+struct BaselineEntry
+{
+	double nsPerCall;
+	double allocationsPerCall;
+	int ok;
+};
+
+static std::map<std::string, BaselineEntry> ReadBaseline(const std::string& path)
+{
+	std::map<std::string, BaselineEntry> baseline;
+	std::ifstream file(path);
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (line.empty() || line[0] == '#')
+			continue;
+		std::istringstream fields(line);
+		std::string name;
+		BaselineEntry entry;
+		if (fields >> name >> entry.nsPerCall >> entry.allocationsPerCall >> entry.ok)
+			baseline[name] = entry;
+	}
+	return baseline;
+}
+
+static bool WriteBaseline(const std::string& path)
+{
+	std::ofstream file(path);
+	if (!file)
+		return false;
+	file << "# name ns_per_call allocations_per_call ok" << std::endl;
+	file << "# written by benchmark_pace_bms --write-baseline, ns_per_call is only meaningful relative to other runs on the same machine" << std::endl;
+	char line[256];
+	for (const BenchmarkResult& result : results)
+	{
+		snprintf(line, sizeof(line), "%s %.1f %.2f %d", result.name.c_str(), result.nsPerCall, result.allocationsPerCall, result.ok ? 1 : 0);
+		file << line << std::endl;
+	}
+	return true;
+}
+
+static void Usage()
+{
+	std::cerr <<
+		"usage: benchmark_pace_bms [options]\n"
+		"  --baseline PATH       baseline to compare against (default: the checked in baseline.txt)\n"
+		"  --write-baseline      replace the baseline with this run's results\n"
+		"  --check-allocations   exit 1 if any benchmark allocates more per call than the baseline, or fails where it didn't\n"
+		"  --min-time-ms N       time each benchmark for at least N milliseconds (default 200)\n"
+		"  --filter TEXT         only run benchmarks whose name contains TEXT\n";
+}
+
+int main(int argc, char* argv[])
+{
+#ifdef BENCHMARK_BASELINE
+	std::string baselinePath = BENCHMARK_BASELINE;
+#else
+	std::string baselinePath = "baseline.txt";
+#endif
+	bool writeBaseline = false;
+	bool checkAllocations = false;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--baseline" && hasValue)
+			baselinePath = argv[++i];
+		else if (arg == "--write-baseline")
+			writeBaseline = true;
+		else if (arg == "--check-allocations")
+			checkAllocations = true;
+		else if (arg == "--min-time-ms" && hasValue)
+			minTimeMs = atof(argv[++i]);
+		else if (arg == "--filter" && hasValue)
+			filter = argv[++i];
+		else
+		{
+			Usage();
+			return 2;
+		}
+	}
+
+	BenchmarkV25();
+	BenchmarkV20("PYLON");
+	BenchmarkV20("SEPLOS");
+	BenchmarkV20("EG4");
+
+	std::map<std::string, BaselineEntry> baseline = ReadBaseline(baselinePath);
+	bool regressed = false;
+	printf("%-72s %4s %10s %9s %8s %9s %10s %8s\n", "benchmark", "ok", "ns/call", "MB/s", "allocs", "bytes", "baseline", "delta");
+	for (const BenchmarkResult& result : results)
+	{
+		char throughput[16] = "-";
+		if (result.frameBytes != 0)
+			snprintf(throughput, sizeof(throughput), "%.1f", result.frameBytes * 1000.0 / result.nsPerCall);
+		printf("%-72s %4s %10.1f %9s %8.2f %9.1f", result.name.c_str(), result.ok ? "yes" : "NO", result.nsPerCall, throughput, result.allocationsPerCall, result.allocatedBytesPerCall);
+
+		auto found = baseline.find(result.name);
+		if (found == baseline.end())
+		{
+			printf(" %10s\n", "new");
+			continue;
+		}
+		printf(" %10.1f %+7.1f%%", found->second.nsPerCall, (result.nsPerCall - found->second.nsPerCall) * 100.0 / found->second.nsPerCall);
+		if (result.allocationsPerCall > found->second.allocationsPerCall + 0.005)
+		{
+			printf("  more allocations than baseline (%.2f)", found->second.allocationsPerCall);
+			regressed = true;
+		}
+		else if (result.allocationsPerCall < found->second.allocationsPerCall - 0.005)
+		{
+			printf("  fewer allocations than baseline (%.2f)", found->second.allocationsPerCall);
+		}
+		if (!result.ok && found->second.ok)
+		{
+			printf("  no longer accepts the example frame");
+			regressed = true;
+		}
+		printf("\n");
+	}
+
+	if (writeBaseline)
+	{
+		if (!WriteBaseline(baselinePath))
+		{
+			std::cerr << "Unable to write " << baselinePath << std::endl;
+			return 1;
+		}
+		std::cout << "wrote " << baselinePath << std::endl;
+	}
+
+	return checkAllocations && regressed ? 1 : 0;
+}
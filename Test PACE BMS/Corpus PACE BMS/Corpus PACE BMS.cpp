@@ -0,0 +1,836 @@
+// Corpus PACE BMS.cpp : every response frame in the checked in corpus (the frames directory next to this file) run through
+//     the reference decoders and compared against the decoded JSON checked in beside it, so that a change to a decoder
+//     (an optimized path, a new variant) can be shown to decode the whole corpus bit for bit the same as before
+//
+// layout:
+//     frames/<commandset>/<kind>/<name>.txt     the frame, as the hex ASCII that went over the wire (the leading ~ and the
+//                                               trailing \r are optional), lines starting with # are notes on where it
+//                                               came from: brand, model, firmware (the hardware version response), variant
+//     frames/<commandset>/<kind>/<name>.json    what each of the kind's decoders made of it (see: Kinds below), a v20 frame
+//                                               is decoded as every variant, a variant that rejects it is part of the
+//                                               expected result too
+// each frame is decoded at the bus id it says it's from (ADR) with the battery chemistry it says it has (CID1), so frames can
+//     come from any pack at any address
+//
+// the analog and status decoders can skip work for fields nobody asked for (AIF_* / SIF_*), each frame is also decoded with
+//     every field flag alone, with every field flag but one, and with none, and whatever those decodes did fill in has to
+//     match the full decode exactly
+//
+// adding frames:
+//     capture them (bus_capture: true, or a USB to RS485 adapter), anonymize the serial number response by overwriting the
+//     serial with a made up one of the same length and fixing up CHKSUM, drop each frame into the right <kind> directory
+//     with notes on the pack it came from, then: build/corpus_pace_bms --write-expected
+//     and check that the JSON it wrote is what the pack was actually showing at the time
+//
+//     build/corpus_pace_bms                      check every frame, prints PASS: or FAIL: for each
+//     build/corpus_pace_bms --benchmark          cost per call of each decoder over each frame
+//     build/corpus_pace_bms --write-expected     (re)write the JSON beside every frame from the current decoders
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../../components/pace_bms/pace_bms_protocol_v25.h"
+#include "../../components/pace_bms/pace_bms_protocol_v20.h"
+
+namespace fs = std::filesystem;
+
+// ============================================================================
+// the decoders log what they reject and why, --verbose shows it
+static bool verbose = false;
+void PrintLog(std::string message)
+{
+	if (verbose)
+		std::cerr << "    " << message << std::endl;
+}
+
+// the expected results are written one value per line so that a change to a decoder shows up as a readable diff
+class JsonWriter
+{
+public:
+	void BeginObject(const char* key = nullptr)
+	{
+		Key(key);
+		text += "{";
+		depth++;
+		first = true;
+	}
+	void EndObject()
+	{
+		depth--;
+		if (!first)
+			NewLine();
+		text += "}";
+		first = false;
+	}
+	void Value(const char* key, bool value) { Key(key); text += value ? "true" : "false"; }
+	void Value(const char* key, int64_t value) { Key(key); text += std::to_string(value); }
+	// 9 significant digits is enough for any float to read back as exactly the same float
+	void Value(const char* key, float value)
+	{
+		char buffer[32];
+		snprintf(buffer, sizeof(buffer), "%.9g", value);
+		Key(key);
+		text += buffer;
+	}
+	void Value(const char* key, const std::string& value)
+	{
+		Key(key);
+		text += "\"";
+		for (unsigned char c : value)
+		{
+			if (c == '"' || c == '\\')
+			{
+				text += '\\';
+				text += (char)c;
+			}
+			else if (c < 0x20 || c >= 0x7F)
+			{
+				char escaped[8];
+				snprintf(escaped, sizeof(escaped), "\\u%04X", c);
+				text += escaped;
+			}
+			else
+			{
+				text += (char)c;
+			}
+		}
+		text += "\"";
+	}
+	template<typename T> void Array(const char* key, const T* values, size_t count)
+	{
+		Key(key);
+		text += "[";
+		for (size_t i = 0; i < count; i++)
+		{
+			if (i != 0)
+				text += ", ";
+			text += std::to_string((int64_t)values[i]);
+		}
+		text += "]";
+	}
+
+	std::string text;
+
+private:
+	void NewLine()
+	{
+		text += "\n";
+		text.append(depth, '\t');
+	}
+	void Key(const char* key)
+	{
+		if (depth == 0)
+			return;
+		if (!first)
+			text += ",";
+		first = false;
+		NewLine();
+		text += "\"";
+		text += key;
+		text += "\": ";
+	}
+
+	int depth = 0;
+	bool first = true;
+};
+
+// ============================================================================
+// the protocol instances a frame is decoded with, configured from the frame itself
+struct Protocols
+{
+	Protocols(uint8_t chemistry) :
+		v25(OPTIONAL_NS::nullopt, OPTIONAL_NS::nullopt, OPTIONAL_NS::optional<uint8_t>(chemistry), &PrintLog, &PrintLog, &PrintLog, &PrintLog, &PrintLog, &PrintLog),
+		v20Pylon(OPTIONAL_NS::optional<std::string>("PYLON"), OPTIONAL_NS::nullopt, OPTIONAL_NS::optional<uint8_t>(chemistry), &PrintLog, &PrintLog, &PrintLog, &PrintLog, &PrintLog, &PrintLog),
+		v20Seplos(OPTIONAL_NS::optional<std::string>("SEPLOS"), OPTIONAL_NS::nullopt, OPTIONAL_NS::optional<uint8_t>(chemistry), &PrintLog, &PrintLog, &PrintLog, &PrintLog, &PrintLog, &PrintLog),
+		v20Eg4(OPTIONAL_NS::optional<std::string>("EG4"), OPTIONAL_NS::nullopt, OPTIONAL_NS::optional<uint8_t>(chemistry), &PrintLog, &PrintLog, &PrintLog, &PrintLog, &PrintLog, &PrintLog)
+	{ }
+
+	PaceBmsProtocolV25 v25;
+	PaceBmsProtocolV20 v20Pylon;
+	PaceBmsProtocolV20 v20Seplos;
+	PaceBmsProtocolV20 v20Eg4;
+};
+
+// decodes the frame with the given fields and, if json isn't null, writes out whatever writeFields cover
+typedef bool (*DecodeFunction)(Protocols& protocols, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t fields, uint32_t writeFields, JsonWriter* json);
+
+struct Decoder
+{
+	const char* name;
+	DecodeFunction decode;
+};
+
+struct Kind
+{
+	const char* commandset;
+	const char* name;
+	std::vector<Decoder> decoders;
+	// the flags the decoders take, empty if they don't take any
+	std::vector<uint32_t> fieldFlags;
+};
+
+static bool Has(uint32_t fields, uint32_t flag) { return (fields & flag) != 0; }
+
+// ============================================================================
+template<typename Analog> void WriteAnalog(JsonWriter& json, const Analog& analog, uint32_t fields)
+{
+	uint8_t cellCount = std::min(analog.cellCount, (uint8_t)PACE_BMS_MAX_CELL_COUNT);
+	uint8_t temperatureCount = std::min(analog.temperatureCount, (uint8_t)PACE_BMS_MAX_TEMP_COUNT);
+	json.Value("cellCount", (int64_t)analog.cellCount);
+	if (Has(fields, PaceBmsProtocolBase::AIF_CellVoltages))
+		json.Array("cellVoltagesMillivolts", analog.cellVoltagesMillivolts, cellCount);
+	json.Value("temperatureCount", (int64_t)analog.temperatureCount);
+	if (Has(fields, PaceBmsProtocolBase::AIF_Temperatures))
+		json.Array("temperaturesTenthsCelcius", analog.temperaturesTenthsCelcius, temperatureCount);
+	json.Value("currentMilliamps", (int64_t)analog.currentMilliamps);
+	json.Value("totalVoltageMillivolts", (int64_t)analog.totalVoltageMillivolts);
+	json.Value("remainingCapacityMilliampHours", (int64_t)analog.remainingCapacityMilliampHours);
+	json.Value("fullCapacityMilliampHours", (int64_t)analog.fullCapacityMilliampHours);
+	json.Value("cycleCount", (int64_t)analog.cycleCount);
+	json.Value("designCapacityMilliampHours", (int64_t)analog.designCapacityMilliampHours);
+	if (Has(fields, PaceBmsProtocolBase::AIF_StateOfCharge))
+		json.Value("SoC", analog.SoC);
+	if (Has(fields, PaceBmsProtocolBase::AIF_StateOfHealth))
+		json.Value("SoH", analog.SoH);
+	if (Has(fields, PaceBmsProtocolBase::AIF_Power))
+		json.Value("powerWatts", analog.powerWatts);
+	if (Has(fields, PaceBmsProtocolBase::AIF_CellMinMax))
+	{
+		json.Value("minCellVoltageMillivolts", (int64_t)analog.minCellVoltageMillivolts);
+		json.Value("maxCellVoltageMillivolts", (int64_t)analog.maxCellVoltageMillivolts);
+		json.Value("maxCellDifferentialMillivolts", (int64_t)analog.maxCellDifferentialMillivolts);
+	}
+	if (Has(fields, PaceBmsProtocolBase::AIF_CellAverage))
+		json.Value("avgCellVoltageMillivolts", (int64_t)analog.avgCellVoltageMillivolts);
+}
+
+template<typename Status> void WriteStatusCommon(JsonWriter& json, const Status& status, uint32_t /*fields*/)
+{
+	json.Array("warning_value_cell", status.warning_value_cell, PACE_BMS_MAX_CELL_COUNT);
+	json.Array("warning_value_temp", status.warning_value_temp, PACE_BMS_MAX_TEMP_COUNT);
+	json.Value("warning_value_charge_current", (int64_t)status.warning_value_charge_current);
+	json.Value("warning_value_total_voltage", (int64_t)status.warning_value_total_voltage);
+	json.Value("warning_value_discharge_current", (int64_t)status.warning_value_discharge_current);
+	json.Value("balancing_value", (int64_t)status.balancing_value);
+	json.Value("system_value", (int64_t)status.system_value);
+}
+
+template<typename Status> void WriteStatusText(JsonWriter& json, const Status& status, uint32_t fields)
+{
+	if (Has(fields, PaceBmsProtocolBase::SIF_WarningText))
+		json.Value("warningText", status.warningText);
+	if (Has(fields, PaceBmsProtocolBase::SIF_BalancingText))
+		json.Value("balancingText", status.balancingText);
+	if (Has(fields, PaceBmsProtocolBase::SIF_SystemText))
+		json.Value("systemText", status.systemText);
+	if (Has(fields, PaceBmsProtocolBase::SIF_ConfigurationText))
+		json.Value("configurationText", status.configurationText);
+	if (Has(fields, PaceBmsProtocolBase::SIF_ProtectionText))
+		json.Value("protectionText", status.protectionText);
+	if (Has(fields, PaceBmsProtocolBase::SIF_FaultText))
+		json.Value("faultText", status.faultText);
+}
+
+static void WriteDateTime(JsonWriter& json, const PaceBmsProtocolBase::DateTime& dateTime)
+{
+	json.Value("Year", (int64_t)dateTime.Year);
+	json.Value("Month", (int64_t)dateTime.Month);
+	json.Value("Day", (int64_t)dateTime.Day);
+	json.Value("Hour", (int64_t)dateTime.Hour);
+	json.Value("Minute", (int64_t)dateTime.Minute);
+	json.Value("Second", (int64_t)dateTime.Second);
+}
+
+// ============================================================================
+static bool DecodeV25Analog(Protocols& p, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t fields, uint32_t writeFields, JsonWriter* json)
+{
+	PaceBmsProtocolV25::AnalogInformation analog{ };
+	bool accepted = p.v25.ProcessReadAnalogInformationResponse(busId, frame, analog, fields);
+	if (accepted && json != nullptr)
+		WriteAnalog(*json, analog, writeFields);
+	return accepted;
+}
+
+static bool DecodeV25Status(Protocols& p, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t fields, uint32_t writeFields, JsonWriter* json)
+{
+	PaceBmsProtocolV25::StatusInformation status{ };
+	bool accepted = p.v25.ProcessReadStatusInformationResponse(busId, frame, status, fields);
+	if (accepted && json != nullptr)
+	{
+		WriteStatusCommon(*json, status, writeFields);
+		json->Value("warning_value1", (int64_t)status.warning_value1);
+		json->Value("warning_value2", (int64_t)status.warning_value2);
+		json->Value("configuration_value", (int64_t)status.configuration_value);
+		json->Value("protection_value1", (int64_t)status.protection_value1);
+		json->Value("protection_value2", (int64_t)status.protection_value2);
+		json->Value("fault_value", (int64_t)status.fault_value);
+		WriteStatusText(*json, status, writeFields);
+	}
+	return accepted;
+}
+
+static bool DecodeV25HardwareVersion(Protocols& p, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t /*fields*/, uint32_t /*writeFields*/, JsonWriter* json)
+{
+	std::string hardwareVersion;
+	bool accepted = p.v25.ProcessReadHardwareVersionResponse(busId, frame, hardwareVersion);
+	if (accepted && json != nullptr)
+		json->Value("hardwareVersion", hardwareVersion);
+	return accepted;
+}
+
+static bool DecodeV25SerialNumber(Protocols& p, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t /*fields*/, uint32_t /*writeFields*/, JsonWriter* json)
+{
+	std::string serialNumber;
+	bool accepted = p.v25.ProcessReadSerialNumberResponse(busId, frame, serialNumber);
+	if (accepted && json != nullptr)
+		json->Value("serialNumber", serialNumber);
+	return accepted;
+}
+
+static bool DecodeV25SystemDateTime(Protocols& p, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t /*fields*/, uint32_t /*writeFields*/, JsonWriter* json)
+{
+	PaceBmsProtocolV25::DateTime dateTime{ };
+	bool accepted = p.v25.ProcessReadSystemDateTimeResponse(busId, frame, dateTime);
+	if (accepted && json != nullptr)
+		WriteDateTime(*json, dateTime);
+	return accepted;
+}
+
+static bool DecodeV25HistoryRecord(Protocols& p, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t /*fields*/, uint32_t /*writeFields*/, JsonWriter* json)
+{
+	PaceBmsProtocolV25::HistoryRecord record{ };
+	bool endOfHistory = false;
+	bool accepted = p.v25.ProcessReadHistoryRecordResponse(busId, frame, record, endOfHistory);
+	if (accepted && json != nullptr)
+	{
+		json->Value("endOfHistory", endOfHistory);
+		if (!endOfHistory)
+		{
+			json->BeginObject("dateTime");
+			WriteDateTime(*json, record.dateTime);
+			json->EndObject();
+			json->Value("cellCount", (int64_t)record.cellCount);
+			json->Array("cellVoltagesMillivolts", record.cellVoltagesMillivolts, std::min(record.cellCount, (uint8_t)PACE_BMS_MAX_CELL_COUNT));
+			json->Value("temperatureCount", (int64_t)record.temperatureCount);
+			json->Array("temperaturesTenthsCelcius", record.temperaturesTenthsCelcius, std::min(record.temperatureCount, (uint8_t)PACE_BMS_MAX_TEMP_COUNT));
+			json->Value("currentMilliamps", (int64_t)record.currentMilliamps);
+			json->Value("totalVoltageMillivolts", (int64_t)record.totalVoltageMillivolts);
+			json->Value("remainingCapacityMilliampHours", (int64_t)record.remainingCapacityMilliampHours);
+			json->Value("fullCapacityMilliampHours", (int64_t)record.fullCapacityMilliampHours);
+			json->Value("minCellVoltageMillivolts", (int64_t)record.minCellVoltageMillivolts);
+			json->Value("maxCellVoltageMillivolts", (int64_t)record.maxCellVoltageMillivolts);
+			json->Array("statusBytes", record.statusBytes.data(), record.statusBytes.size());
+		}
+	}
+	return accepted;
+}
+
+static bool DecodeV25RemainingCapacity(Protocols& p, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t /*fields*/, uint32_t /*writeFields*/, JsonWriter* json)
+{
+	uint32_t remaining = 0, actual = 0, design = 0;
+	bool accepted = p.v25.ProcessReadRemainingCapacityResponse(busId, frame, remaining, actual, design);
+	if (accepted && json != nullptr)
+	{
+		json->Value("remainingCapacityMilliampHours", (int64_t)remaining);
+		json->Value("actualCapacityMilliampHours", (int64_t)actual);
+		json->Value("designCapacityMilliampHours", (int64_t)design);
+	}
+	return accepted;
+}
+
+// ============================================================================
+static bool DecodeV20Analog(PaceBmsProtocolV20& protocol, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t fields, uint32_t writeFields, JsonWriter* json)
+{
+	PaceBmsProtocolV20::AnalogInformation analog{ };
+	bool accepted = protocol.ProcessReadAnalogInformationResponse(busId, frame, analog, fields);
+	if (accepted && json != nullptr)
+		WriteAnalog(*json, analog, writeFields);
+	return accepted;
+}
+
+// each variant only fills in its own part of StatusInformation, so only that part is written out
+static bool DecodeV20Status(PaceBmsProtocolV20& protocol, const std::string& variant, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t fields, uint32_t writeFields, JsonWriter* json)
+{
+	PaceBmsProtocolV20::StatusInformation status{ };
+	bool accepted = protocol.ProcessReadStatusInformationResponse(busId, frame, status, fields);
+	if (!accepted || json == nullptr)
+		return accepted;
+
+	WriteStatusCommon(*json, status, writeFields);
+	if (variant == "PYLON")
+	{
+		json->Value("status1_value", (int64_t)status.status1_value);
+		json->Value("status2_value", (int64_t)status.status2_value);
+		json->Value("status3_value", (int64_t)status.status3_value);
+		json->Value("status4_value", (int64_t)status.status4_value);
+		json->Value("status5_value", (int64_t)status.status5_value);
+	}
+	else if (variant == "SEPLOS")
+	{
+		json->Value("warning1_value", (int64_t)status.warning1_value);
+		json->Value("warning2_value", (int64_t)status.warning2_value);
+		json->Value("warning3_value", (int64_t)status.warning3_value);
+		json->Value("warning4_value", (int64_t)status.warning4_value);
+		json->Value("warning5_value", (int64_t)status.warning5_value);
+		json->Value("warning6_value", (int64_t)status.warning6_value);
+		json->Value("power_value", (int64_t)status.power_value);
+		json->Value("disconnection_value", (int64_t)status.disconnection_value);
+		json->Value("warning7_value", (int64_t)status.warning7_value);
+		json->Value("warning8_value", (int64_t)status.warning8_value);
+	}
+	else if (variant == "EG4")
+	{
+		json->Value("balance_event_value", (int64_t)status.balance_event_value);
+		json->Value("voltage_event_value", (int64_t)status.voltage_event_value);
+		json->Value("temperature_event_value", (int64_t)status.temperature_event_value);
+		json->Value("current_event_value", (int64_t)status.current_event_value);
+		json->Value("remaining_capacity_value", (int64_t)status.remaining_capacity_value);
+		json->Value("fet_status_value", (int64_t)status.fet_status_value);
+	}
+	WriteStatusText(*json, status, writeFields);
+	return accepted;
+}
+
+static bool DecodeV20PylonAnalog(Protocols& p, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t fields, uint32_t writeFields, JsonWriter* json) { return DecodeV20Analog(p.v20Pylon, frame, busId, fields, writeFields, json); }
+static bool DecodeV20SeplosAnalog(Protocols& p, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t fields, uint32_t writeFields, JsonWriter* json) { return DecodeV20Analog(p.v20Seplos, frame, busId, fields, writeFields, json); }
+static bool DecodeV20Eg4Analog(Protocols& p, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t fields, uint32_t writeFields, JsonWriter* json) { return DecodeV20Analog(p.v20Eg4, frame, busId, fields, writeFields, json); }
+static bool DecodeV20PylonStatus(Protocols& p, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t fields, uint32_t writeFields, JsonWriter* json) { return DecodeV20Status(p.v20Pylon, "PYLON", frame, busId, fields, writeFields, json); }
+static bool DecodeV20SeplosStatus(Protocols& p, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t fields, uint32_t writeFields, JsonWriter* json) { return DecodeV20Status(p.v20Seplos, "SEPLOS", frame, busId, fields, writeFields, json); }
+static bool DecodeV20Eg4Status(Protocols& p, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t fields, uint32_t writeFields, JsonWriter* json) { return DecodeV20Status(p.v20Eg4, "EG4", frame, busId, fields, writeFields, json); }
+
+// the PYLON stack-wide responses, each pack written out the same as a single pack response
+static bool DecodeV20PylonSystemAnalog(Protocols& p, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t fields, uint32_t writeFields, JsonWriter* json)
+{
+	std::vector<PaceBmsProtocolV20::AnalogInformation> analog;
+	bool accepted = p.v20Pylon.ProcessReadSystemAnalogInformationResponse_PYLON(busId, frame, analog, fields);
+	if (accepted && json != nullptr)
+	{
+		json->Value("packCount", (int64_t)analog.size());
+		for (size_t i = 0; i < analog.size(); i++)
+		{
+			json->BeginObject(("pack" + std::to_string(i + 1)).c_str());
+			WriteAnalog(*json, analog[i], writeFields);
+			json->EndObject();
+		}
+	}
+	return accepted;
+}
+
+static bool DecodeV20PylonSystemStatus(Protocols& p, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t fields, uint32_t writeFields, JsonWriter* json)
+{
+	std::vector<PaceBmsProtocolV20::StatusInformation> status;
+	bool accepted = p.v20Pylon.ProcessReadSystemStatusInformationResponse_PYLON(busId, frame, status, fields);
+	if (accepted && json != nullptr)
+	{
+		json->Value("packCount", (int64_t)status.size());
+		for (size_t i = 0; i < status.size(); i++)
+		{
+			json->BeginObject(("pack" + std::to_string(i + 1)).c_str());
+			WriteStatusCommon(*json, status[i], writeFields);
+			json->Value("status1_value", (int64_t)status[i].status1_value);
+			json->Value("status2_value", (int64_t)status[i].status2_value);
+			json->Value("status3_value", (int64_t)status[i].status3_value);
+			json->Value("status4_value", (int64_t)status[i].status4_value);
+			json->Value("status5_value", (int64_t)status[i].status5_value);
+			WriteStatusText(*json, status[i], writeFields);
+			json->EndObject();
+		}
+	}
+	return accepted;
+}
+
+// the rest are the same whatever the variant
+static bool DecodeV20HardwareVersion(Protocols& p, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t /*fields*/, uint32_t /*writeFields*/, JsonWriter* json)
+{
+	std::string hardwareVersion;
+	bool accepted = p.v20Eg4.ProcessReadHardwareVersionResponse(busId, frame, hardwareVersion);
+	if (accepted && json != nullptr)
+		json->Value("hardwareVersion", hardwareVersion);
+	return accepted;
+}
+
+static bool DecodeV20SerialNumber(Protocols& p, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t /*fields*/, uint32_t /*writeFields*/, JsonWriter* json)
+{
+	std::string serialNumber;
+	bool accepted = p.v20Eg4.ProcessReadSerialNumberResponse(busId, frame, serialNumber);
+	if (accepted && json != nullptr)
+		json->Value("serialNumber", serialNumber);
+	return accepted;
+}
+
+static bool DecodeV20SystemDateTime(Protocols& p, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t /*fields*/, uint32_t /*writeFields*/, JsonWriter* json)
+{
+	PaceBmsProtocolV20::DateTime dateTime{ };
+	bool accepted = p.v20Eg4.ProcessReadSystemDateTimeResponse(busId, frame, dateTime);
+	if (accepted && json != nullptr)
+		WriteDateTime(*json, dateTime);
+	return accepted;
+}
+
+static bool DecodeV20ChargeDischargeManagement(Protocols& p, const std::vector<uint8_t>& frame, uint8_t busId, uint32_t /*fields*/, uint32_t /*writeFields*/, JsonWriter* json)
+{
+	PaceBmsProtocolV20::ChargeDischargeManagementInformation management{ };
+	bool accepted = p.v20Pylon.ProcessReadChargeDischargeManagementInformationResponse(busId, frame, management);
+	if (accepted && json != nullptr)
+	{
+		json->Value("chargeVoltageLimitMillivolts", (int64_t)management.chargeVoltageLimitMillivolts);
+		json->Value("dischargeVoltageLimitMillivolts", (int64_t)management.dischargeVoltageLimitMillivolts);
+		json->Value("chargeCurrentLimitMilliamps", (int64_t)management.chargeCurrentLimitMilliamps);
+		json->Value("dischargeCurrentLimitMilliamps", (int64_t)management.dischargeCurrentLimitMilliamps);
+		json->Value("status_value", (int64_t)management.status_value);
+		json->Value("chargeEnable", management.chargeEnable);
+		json->Value("dischargeEnable", management.dischargeEnable);
+		json->Value("chargeImmediately", management.chargeImmediately);
+		json->Value("fullChargeRequest", management.fullChargeRequest);
+	}
+	return accepted;
+}
+
+// ============================================================================
+static const std::vector<uint32_t> analogFlags = {
+	PaceBmsProtocolBase::AIF_CellVoltages, PaceBmsProtocolBase::AIF_Temperatures, PaceBmsProtocolBase::AIF_StateOfCharge, PaceBmsProtocolBase::AIF_StateOfHealth,
+	PaceBmsProtocolBase::AIF_Power, PaceBmsProtocolBase::AIF_CellMinMax, PaceBmsProtocolBase::AIF_CellAverage,
+};
+static const std::vector<uint32_t> statusFlags = {
+	PaceBmsProtocolBase::SIF_WarningText, PaceBmsProtocolBase::SIF_BalancingText, PaceBmsProtocolBase::SIF_SystemText,
+	PaceBmsProtocolBase::SIF_ConfigurationText, PaceBmsProtocolBase::SIF_ProtectionText, PaceBmsProtocolBase::SIF_FaultText,
+};
+
+static const std::vector<Kind>& Kinds()
+{
+	static const std::vector<Kind> kinds = {
+		{ "v25", "analog_information", { { "v25", &DecodeV25Analog } }, analogFlags },
+		{ "v25", "status_information", { { "v25", &DecodeV25Status } }, statusFlags },
+		{ "v25", "hardware_version", { { "v25", &DecodeV25HardwareVersion } }, { } },
+		{ "v25", "serial_number", { { "v25", &DecodeV25SerialNumber } }, { } },
+		{ "v25", "system_date_time", { { "v25", &DecodeV25SystemDateTime } }, { } },
+		{ "v25", "history_record", { { "v25", &DecodeV25HistoryRecord } }, { } },
+		{ "v25", "remaining_capacity", { { "v25", &DecodeV25RemainingCapacity } }, { } },
+		{ "v20", "analog_information", { { "PYLON", &DecodeV20PylonAnalog }, { "SEPLOS", &DecodeV20SeplosAnalog }, { "EG4", &DecodeV20Eg4Analog } }, analogFlags },
+		{ "v20", "status_information", { { "PYLON", &DecodeV20PylonStatus }, { "SEPLOS", &DecodeV20SeplosStatus }, { "EG4", &DecodeV20Eg4Status } }, statusFlags },
+		{ "v20", "hardware_version", { { "v20", &DecodeV20HardwareVersion } }, { } },
+		{ "v20", "serial_number", { { "v20", &DecodeV20SerialNumber } }, { } },
+		{ "v20", "system_date_time", { { "v20", &DecodeV20SystemDateTime } }, { } },
+		{ "v20", "charge_discharge_management", { { "v20", &DecodeV20ChargeDischargeManagement } }, { } },
+		{ "v20", "system_analog_information", { { "PYLON", &DecodeV20PylonSystemAnalog } }, analogFlags },
+		{ "v20", "system_status_information", { { "PYLON", &DecodeV20PylonSystemStatus } }, statusFlags },
+	};
+	return kinds;
+}
+
+// ============================================================================
+struct CorpusFrame
+{
+	const Kind* kind;
+	fs::path path;
+	std::string name;
+	std::vector<uint8_t> frame;
+	uint8_t busId;
+	uint8_t chemistry;
+};
+
+static int HexDigit(uint8_t c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	return -1;
+}
+
+// the first line that isn't a note, with ~ and \r put on it if they were left off
+static bool ReadFrame(const fs::path& path, std::vector<uint8_t>& frame)
+{
+	std::ifstream file(path);
+	std::string line;
+	while (std::getline(file, line))
+	{
+		while (!line.empty() && isspace((unsigned char)line.back()))
+			line.pop_back();
+		size_t start = line.find_first_not_of(" \t");
+		if (start == std::string::npos || line[start] == '#')
+			continue;
+		line = line.substr(start);
+		if (line[0] != '~')
+			line.insert(line.begin(), '~');
+		frame.assign(line.begin(), line.end());
+		frame.push_back('\r');
+		return true;
+	}
+	return false;
+}
+
+static bool LoadCorpus(const fs::path& root, std::vector<CorpusFrame>& corpus)
+{
+	bool ok = true;
+	for (const Kind& kind : Kinds())
+	{
+		fs::path directory = root / kind.commandset / kind.name;
+		if (!fs::is_directory(directory))
+			continue;
+		std::vector<fs::path> paths;
+		for (const fs::directory_entry& entry : fs::directory_iterator(directory))
+			if (entry.is_regular_file() && entry.path().extension() == ".txt")
+				paths.push_back(entry.path());
+		std::sort(paths.begin(), paths.end());
+
+		for (const fs::path& path : paths)
+		{
+			CorpusFrame corpusFrame;
+			corpusFrame.kind = &kind;
+			corpusFrame.path = path;
+			corpusFrame.name = std::string(kind.commandset) + "/" + kind.name + "/" + path.stem().string();
+			// ~ VER ADR CID1 ...
+			if (!ReadFrame(path, corpusFrame.frame) || corpusFrame.frame.size() < 18 ||
+				HexDigit(corpusFrame.frame[3]) < 0 || HexDigit(corpusFrame.frame[4]) < 0 || HexDigit(corpusFrame.frame[5]) < 0 || HexDigit(corpusFrame.frame[6]) < 0)
+			{
+				printf("FAIL: %s: not a frame\n", corpusFrame.name.c_str());
+				ok = false;
+				continue;
+			}
+			corpusFrame.busId = (uint8_t)(HexDigit(corpusFrame.frame[3]) << 4 | HexDigit(corpusFrame.frame[4]));
+			corpusFrame.chemistry = (uint8_t)(HexDigit(corpusFrame.frame[5]) << 4 | HexDigit(corpusFrame.frame[6]));
+			corpus.push_back(corpusFrame);
+		}
+	}
+	return ok;
+}
+
+// ============================================================================
+// decodes the frame with every one of the kind's decoders, each one's result written out with writeFields
+static std::string DecodeToJson(Protocols& protocols, const CorpusFrame& corpusFrame, uint32_t fields, uint32_t writeFields)
+{
+	JsonWriter json;
+	json.BeginObject();
+	for (const Decoder& decoder : corpusFrame.kind->decoders)
+	{
+		json.BeginObject(decoder.name);
+		bool accepted = decoder.decode(protocols, corpusFrame.frame, corpusFrame.busId, fields, writeFields, nullptr);
+		json.Value("accepted", accepted);
+		if (accepted)
+			decoder.decode(protocols, corpusFrame.frame, corpusFrame.busId, fields, writeFields, &json);
+		json.EndObject();
+	}
+	json.EndObject();
+	json.text += "\n";
+	return json.text;
+}
+
+static fs::path ExpectedPath(const CorpusFrame& corpusFrame)
+{
+	fs::path path = corpusFrame.path;
+	return path.replace_extension(".json");
+}
+
+static std::string ReadText(const fs::path& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	std::stringstream text;
+	text << file.rdbuf();
+	return text.str();
+}
+
+// the first line that differs, to show in a failure
+static std::string FirstDifference(const std::string& expected, const std::string& actual)
+{
+	std::istringstream expectedLines(expected);
+	std::istringstream actualLines(actual);
+	std::string expectedLine;
+	std::string actualLine;
+	for (int line = 1; ; line++)
+	{
+		bool moreExpected = (bool)std::getline(expectedLines, expectedLine);
+		bool moreActual = (bool)std::getline(actualLines, actualLine);
+		if (!moreExpected && !moreActual)
+			return "";
+		if (!moreExpected || !moreActual || expectedLine != actualLine)
+			return "line " + std::to_string(line) + ": expected " + (moreExpected ? expectedLine : "(end)") + ", decoded " + (moreActual ? actualLine : "(end)");
+	}
+}
+
+// decoding with only some fields has to fill those in exactly as the full decode does
+static std::string CheckFields(Protocols& protocols, const CorpusFrame& corpusFrame)
+{
+	std::vector<uint32_t> masks = { 0 };
+	for (uint32_t flag : corpusFrame.kind->fieldFlags)
+	{
+		masks.push_back(flag);
+		masks.push_back(0xFFFFFFFF & ~flag);
+	}
+	if (masks.size() == 1)
+		return "";
+
+	for (uint32_t mask : masks)
+	{
+		// the full decode, written out with only the masked fields, is what the masked decode should come to
+		std::string full = DecodeToJson(protocols, corpusFrame, 0xFFFFFFFF, mask);
+		std::string masked = DecodeToJson(protocols, corpusFrame, mask, mask);
+		std::string difference = FirstDifference(full, masked);
+		if (!difference.empty())
+		{
+			char description[64];
+			snprintf(description, sizeof(description), "decoded with fields 0x%08X, ", mask);
+			return description + difference;
+		}
+	}
+	return "";
+}
+
+static bool Check(const std::vector<CorpusFrame>& corpus)
+{
+	bool ok = true;
+	for (const CorpusFrame& corpusFrame : corpus)
+	{
+		Protocols protocols(corpusFrame.chemistry);
+		std::string actual = DecodeToJson(protocols, corpusFrame, 0xFFFFFFFF, 0xFFFFFFFF);
+		fs::path expectedPath = ExpectedPath(corpusFrame);
+		std::string failure;
+		if (!fs::exists(expectedPath))
+			failure = "no " + expectedPath.filename().string() + ", run with --write-expected";
+		else
+			failure = FirstDifference(ReadText(expectedPath), actual);
+		if (failure.empty())
+			failure = CheckFields(protocols, corpusFrame);
+
+		printf("%s: %s\n", failure.empty() ? "PASS" : "FAIL", corpusFrame.name.c_str());
+		if (!failure.empty())
+		{
+			printf("    %s\n", failure.c_str());
+			ok = false;
+		}
+	}
+	return ok;
+}
+
+static bool WriteExpected(const std::vector<CorpusFrame>& corpus)
+{
+	for (const CorpusFrame& corpusFrame : corpus)
+	{
+		Protocols protocols(corpusFrame.chemistry);
+		std::string json = DecodeToJson(protocols, corpusFrame, 0xFFFFFFFF, 0xFFFFFFFF);
+		fs::path expectedPath = ExpectedPath(corpusFrame);
+		bool changed = ReadText(expectedPath) != json;
+		if (changed)
+		{
+			std::ofstream file(expectedPath, std::ios::binary);
+			if (!(file << json))
+			{
+				std::cerr << "Unable to write " << expectedPath.string() << std::endl;
+				return false;
+			}
+		}
+		printf("%-8s %s\n", changed ? "wrote" : "same", expectedPath.string().c_str());
+	}
+	return true;
+}
+
+// ============================================================================
+// double the batch until it runs long enough to be worth timing, as benchmark_pace_bms does
+static double TimeDecoder(Protocols& protocols, const Decoder& decoder, const CorpusFrame& corpusFrame, double minTimeMs)
+{
+	size_t iterations = 16;
+	while (true)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < iterations; i++)
+			decoder.decode(protocols, corpusFrame.frame, corpusFrame.busId, 0xFFFFFFFF, 0xFFFFFFFF, nullptr);
+		double elapsedNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+		if (elapsedNs >= minTimeMs * 1000000.0 || iterations >= ((size_t)1 << 30))
+			return elapsedNs / iterations;
+		iterations *= 2;
+	}
+}
+
+static void Benchmark(const std::vector<CorpusFrame>& corpus, double minTimeMs)
+{
+	printf("%-64s %-8s %4s %10s %9s\n", "frame", "decoder", "ok", "ns/call", "MB/s");
+	double totalNs = 0;
+	size_t totalBytes = 0;
+	for (const CorpusFrame& corpusFrame : corpus)
+	{
+		Protocols protocols(corpusFrame.chemistry);
+		for (const Decoder& decoder : corpusFrame.kind->decoders)
+		{
+			bool accepted = decoder.decode(protocols, corpusFrame.frame, corpusFrame.busId, 0xFFFFFFFF, 0xFFFFFFFF, nullptr);
+			double ns = TimeDecoder(protocols, decoder, corpusFrame, minTimeMs);
+			printf("%-64s %-8s %4s %10.1f %9.1f\n", corpusFrame.name.c_str(), decoder.name, accepted ? "yes" : "no", ns, corpusFrame.frame.size() * 1000.0 / ns);
+			totalNs += ns;
+			totalBytes += corpusFrame.frame.size();
+		}
+	}
+	if (totalNs > 0)
+		printf("%-64s %-8s %4s %10.1f %9.1f\n", "all of the above, one call each", "", "", totalNs, totalBytes * 1000.0 / totalNs);
+}
+
+static void Usage()
+{
+	std::cerr <<
+		"usage: corpus_pace_bms [options]\n"
+		"  --corpus PATH         the frames directory (default: the checked in one)\n"
+		"  --write-expected      (re)write the expected JSON beside every frame from what the decoders make of it now\n"
+		"  --benchmark           time every decoder over every frame instead of checking them\n"
+		"  --min-time-ms N       with --benchmark, time each for at least N milliseconds (default 200)\n"
+		"  --filter TEXT         only frames whose name (commandset/kind/file) contains TEXT\n"
+		"  --verbose             show what the decoders log\n";
+}
+
+int main(int argc, char* argv[])
+{
+#ifdef CORPUS_DIRECTORY
+	std::string corpusPath = CORPUS_DIRECTORY;
+#else
+	std::string corpusPath = "frames";
+#endif
+	bool writeExpected = false;
+	bool benchmark = false;
+	double minTimeMs = 200;
+	std::string filter;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--corpus" && hasValue)
+			corpusPath = argv[++i];
+		else if (arg == "--write-expected")
+			writeExpected = true;
+		else if (arg == "--benchmark")
+			benchmark = true;
+		else if (arg == "--min-time-ms" && hasValue)
+			minTimeMs = atof(argv[++i]);
+		else if (arg == "--filter" && hasValue)
+			filter = argv[++i];
+		else if (arg == "--verbose")
+			verbose = true;
+		else
+		{
+			Usage();
+			return 2;
+		}
+	}
+
+	std::vector<CorpusFrame> corpus;
+	bool ok = LoadCorpus(corpusPath, corpus);
+	if (!filter.empty())
+		corpus.erase(std::remove_if(corpus.begin(), corpus.end(), [&filter](const CorpusFrame& f) { return f.name.find(filter) == std::string::npos; }), corpus.end());
+	if (corpus.empty())
+	{
+		printf("FAIL: no frames in %s\n", corpusPath.c_str());
+		return 1;
+	}
+
+	if (writeExpected)
+		ok &= WriteExpected(corpus);
+	else if (benchmark)
+		Benchmark(corpus, minTimeMs);
+	else
+		ok &= Check(corpus);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,765 @@
+// Fuzz PACE BMS.cpp : coverage guided fuzzing of every v20 / v25 response decoder and of the receive side frame assembler
+//
+// one entry point, LLVMFuzzerTestOneInput, shared by all of the ways this gets driven:
+//     clang with -fsanitize=fuzzer (cmake -DPACE_BMS_LIBFUZZER=ON) links libFuzzer's own main
+//     AFL runs the standalone build with the input file as the argument: afl-fuzz -i seeds -o findings -- fuzz_pace_bms @@
+//     the standalone build can also replay files (or directories of them) to reproduce a finding, and without any arguments
+//         runs the example frames through every target, followed by --iterations of a simple mutator, which is what ctest does
+//
+// input layout:
+//     byte 0    which target, modulo the number of targets (see Targets below)
+//     byte 1    bit 0 set: the rest is a whole frame, exactly as it came off the wire
+//               bit 0 clear: the rest is only the INFO field, it gets wrapped in a frame with the correct VER, ADR, CID1,
+//                   LENGTH and CHKSUM for the target so that mutations get past validation and into the decoder itself
+//     byte 2..  the frame or INFO
+//
+// the decoders are built with AddressSanitizer and UndefinedBehaviorSanitizer and anything they catch aborts, as does a frame
+//     length the assembler would get wrong or a system response with more packs than it has room for
+//     counts (cells, temperatures) are passed through as they came off the wire, everything using them clamps to MAX_CELL_COUNT /
+//     MAX_TEMP_COUNT, so a large one isn't a finding, reading or writing past the end of the array because of it is
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+#include "../../components/pace_bms/pace_bms_protocol_v25.h"
+#include "../../components/pace_bms/pace_bms_protocol_v20.h"
+#include "../../components/pace_bms/pace_bms_protocol_modbus.h"
+
+// ============================================================================
+// the decoders log a lot when handed garbage, none of it is interesting here
+void DropLog(std::string /*message*/) { }
+
+// set for the duration of each input so that a failure says which decoder it was in
+static const char* currentTarget = "";
+
+#define FUZZ_CHECK(condition) \
+	do { if (!(condition)) { fprintf(stderr, "FAIL: %s: %s:%d: %s\n", currentTarget, __FILE__, __LINE__, #condition); abort(); } } while (0)
+
+// the frame building helpers are protected
+class FuzzProtocolV25 : public PaceBmsProtocolV25
+{
+public:
+	FuzzProtocolV25() : PaceBmsProtocolV25(OPTIONAL_NS::nullopt, OPTIONAL_NS::nullopt, CID1_LithiumIron, &DropLog, &DropLog, &DropLog, &DropLog, &DropLog, &DropLog) { }
+	using PaceBmsProtocolBase::CreateChecksummedLength;
+	using PaceBmsProtocolBase::CalculateRequestOrResponseChecksum;
+};
+
+static PaceBmsProtocolV20* CreateV20(OPTIONAL_NS::optional<std::string> variant, uint8_t chemistry)
+{
+	return new PaceBmsProtocolV20(variant, OPTIONAL_NS::nullopt, OPTIONAL_NS::optional<uint8_t>(chemistry), &DropLog, &DropLog, &DropLog, &DropLog, &DropLog, &DropLog);
+}
+
+static const uint8_t HEX[] = "0123456789ABCDEF";
+
+static void AppendHexByte(std::vector<uint8_t>& frame, uint8_t value)
+{
+	frame.push_back(HEX[value >> 4]);
+	frame.push_back(HEX[value & 0x0F]);
+}
+
+static void AppendHexUShort(std::vector<uint8_t>& frame, uint16_t value)
+{
+	AppendHexByte(frame, (uint8_t)(value >> 8));
+	AppendHexByte(frame, (uint8_t)(value & 0xFF));
+}
+
+// ~ VER ADR CID1 RTN LENGTH INFO CHKSUM \r, with RTN 00 and everything else correct
+static std::vector<uint8_t> WrapInfo(uint8_t version, uint8_t busId, uint8_t cid1, const uint8_t* info, size_t infoLength)
+{
+	if (infoLength > 0x0FFF)
+		infoLength = 0x0FFF;
+	std::vector<uint8_t> frame;
+	frame.reserve(infoLength + 18);
+	frame.push_back('~');
+	AppendHexByte(frame, version);
+	AppendHexByte(frame, busId);
+	AppendHexByte(frame, cid1);
+	AppendHexByte(frame, 0x00);
+	AppendHexUShort(frame, FuzzProtocolV25::CreateChecksummedLength((uint16_t)infoLength));
+	frame.insert(frame.end(), info, info + infoLength);
+	// placeholder for CHKSUM, which skips itself when calculating
+	frame.insert(frame.end(), 4, '0');
+	frame.push_back('\r');
+	uint16_t checksum = FuzzProtocolV25::CalculateRequestOrResponseChecksum(frame);
+	for (int i = 0; i < 4; i++)
+		frame[frame.size() - 5 + i] = HEX[(checksum >> (12 - i * 4)) & 0x0F];
+	return frame;
+}
+
+// the INFO of a known good frame, to turn an example into a wrapped seed
+static std::vector<uint8_t> UnwrapInfo(const std::vector<uint8_t>& frame)
+{
+	if (frame.size() < 18)
+		return std::vector<uint8_t>();
+	return std::vector<uint8_t>(frame.begin() + 13, frame.end() - 5);
+}
+
+// raw frames answer for whichever ADR they say they're from, so that the examples (captured at a mix of addresses) validate
+static uint8_t FrameBusId(const std::vector<uint8_t>& frame)
+{
+	uint8_t busId = 0;
+	for (size_t i = 3; i < 5 && i < frame.size(); i++)
+	{
+		const uint8_t* digit = (const uint8_t*)strchr((const char*)HEX, frame[i]);
+		busId = (uint8_t)((busId << 4) | (digit != nullptr && *digit != 0 ? digit - HEX : 0));
+	}
+	return busId;
+}
+
+static std::vector<uint8_t> Frame(const uint8_t* example)
+{
+	return std::vector<uint8_t>(example, example + strlen((const char*)example));
+}
+
+// ============================================================================
+struct Target
+{
+	const char* name;
+	uint8_t version;
+	uint8_t cid1;
+	std::vector<const uint8_t*> examples;
+	// returns true if the decoder accepted the frame
+	bool (*decode)(const std::vector<uint8_t>& frame, uint8_t busId);
+};
+
+static FuzzProtocolV25* v25 = nullptr;
+static PaceBmsProtocolV20* v20Pylon = nullptr;
+static PaceBmsProtocolV20* v20Seplos = nullptr;
+static PaceBmsProtocolV20* v20Eg4 = nullptr;
+static PaceBmsProtocolV20* v20Management = nullptr;
+static PaceBmsProtocolV20* v20Stack = nullptr;
+
+static bool DecodeV25Analog(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	PaceBmsProtocolV25::AnalogInformation analog;
+	return v25->ProcessReadAnalogInformationResponse(busId, frame, analog);
+}
+
+static bool DecodeV25Status(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	PaceBmsProtocolV25::StatusInformation status;
+	return v25->ProcessReadStatusInformationResponse(busId, frame, status);
+}
+
+static bool DecodeV25HardwareVersion(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	std::string hardwareVersion;
+	return v25->ProcessReadHardwareVersionResponse(busId, frame, hardwareVersion);
+}
+
+static bool DecodeV25SerialNumber(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	std::string serialNumber;
+	return v25->ProcessReadSerialNumberResponse(busId, frame, serialNumber);
+}
+
+static bool DecodeV25SwitchCommand(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	static const PaceBmsProtocolV25::SwitchCommand commands[] = {
+		PaceBmsProtocolV25::SC_DisableBuzzer, PaceBmsProtocolV25::SC_EnableBuzzer,
+		PaceBmsProtocolV25::SC_DisableLedWarning, PaceBmsProtocolV25::SC_EnableLedWarning,
+		PaceBmsProtocolV25::SC_DisableChargeCurrentLimiter, PaceBmsProtocolV25::SC_EnableChargeCurrentLimiter,
+		PaceBmsProtocolV25::SC_SetChargeCurrentLimiterCurrentLimitHighGear, PaceBmsProtocolV25::SC_SetChargeCurrentLimiterCurrentLimitLowGear,
+	};
+	bool accepted = false;
+	for (PaceBmsProtocolV25::SwitchCommand command : commands)
+		accepted |= v25->ProcessWriteSwitchCommandResponse(busId, command, frame);
+	return accepted;
+}
+
+static bool DecodeV25MosfetSwitchCommand(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	bool accepted = false;
+	for (PaceBmsProtocolV25::MosfetType type : { PaceBmsProtocolV25::MT_Charge, PaceBmsProtocolV25::MT_Discharge })
+		for (PaceBmsProtocolV25::MosfetState state : { PaceBmsProtocolV25::MS_Open, PaceBmsProtocolV25::MS_Close })
+			accepted |= v25->ProcessWriteMosfetSwitchCommandResponse(busId, type, state, frame);
+	return accepted;
+}
+
+static bool DecodeV25Shutdown(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	return v25->ProcessWriteShutdownCommandResponse(busId, frame);
+}
+
+static bool DecodeV25HistoryRecord(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	PaceBmsProtocolV25::HistoryRecord record;
+	bool endOfHistory = false;
+	return v25->ProcessReadHistoryRecordResponse(busId, frame, record, endOfHistory);
+}
+
+static bool DecodeV25ReadSystemDateTime(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	PaceBmsProtocolV25::DateTime dateTime;
+	return v25->ProcessReadSystemDateTimeResponse(busId, frame, dateTime);
+}
+
+static bool DecodeV25WriteSystemDateTime(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	return v25->ProcessWriteSystemDateTimeResponse(busId, frame);
+}
+
+static bool DecodeV25WriteConfiguration(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	return v25->ProcessWriteConfigurationResponse(busId, frame);
+}
+
+template<typename Config> bool DecodeV25ReadConfiguration(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	Config config;
+	return v25->ProcessReadConfigurationResponse(busId, frame, config);
+}
+
+static bool DecodeV25ReadChargeCurrentLimiterStartCurrent(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	uint8_t current;
+	return v25->ProcessReadChargeCurrentLimiterStartCurrentResponse(busId, frame, current);
+}
+
+static bool DecodeV25WriteChargeCurrentLimiterStartCurrent(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	return v25->ProcessWriteChargeCurrentLimiterStartCurrentResponse(busId, frame);
+}
+
+static bool DecodeV25RemainingCapacity(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	uint32_t remaining, actual, design;
+	return v25->ProcessReadRemainingCapacityResponse(busId, frame, remaining, actual, design);
+}
+
+static bool DecodeV25ReadProtocols(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	PaceBmsProtocolV25::Protocols protocols;
+	return v25->ProcessReadProtocolsResponse(busId, frame, protocols);
+}
+
+static bool DecodeV25WriteProtocols(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	return v25->ProcessWriteProtocolsResponse(busId, frame);
+}
+
+static bool DecodeV20Analog(PaceBmsProtocolV20* protocol, const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	PaceBmsProtocolV20::AnalogInformation analog;
+	return protocol->ProcessReadAnalogInformationResponse(busId, frame, analog);
+}
+
+static bool DecodeV20Status(PaceBmsProtocolV20* protocol, const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	PaceBmsProtocolV20::StatusInformation status;
+	return protocol->ProcessReadStatusInformationResponse(busId, frame, status);
+}
+
+static bool DecodeV20PylonAnalog(const std::vector<uint8_t>& frame, uint8_t busId) { return DecodeV20Analog(v20Pylon, frame, busId); }
+static bool DecodeV20SeplosAnalog(const std::vector<uint8_t>& frame, uint8_t busId) { return DecodeV20Analog(v20Seplos, frame, busId); }
+static bool DecodeV20Eg4Analog(const std::vector<uint8_t>& frame, uint8_t busId) { return DecodeV20Analog(v20Eg4, frame, busId); }
+static bool DecodeV20PylonStatus(const std::vector<uint8_t>& frame, uint8_t busId) { return DecodeV20Status(v20Pylon, frame, busId); }
+static bool DecodeV20SeplosStatus(const std::vector<uint8_t>& frame, uint8_t busId) { return DecodeV20Status(v20Seplos, frame, busId); }
+static bool DecodeV20Eg4Status(const std::vector<uint8_t>& frame, uint8_t busId) { return DecodeV20Status(v20Eg4, frame, busId); }
+
+// with no variant configured both the analog and the status response try to pick one, and complain if they disagree
+//     a fresh instance each time so that an input always does the same thing
+static bool DecodeV20DetectVariant(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	PaceBmsProtocolV20* protocol = CreateV20(OPTIONAL_NS::nullopt, 0x4A);
+	bool accepted = DecodeV20Analog(protocol, frame, busId);
+	accepted |= DecodeV20Status(protocol, frame, busId);
+	delete protocol;
+	return accepted;
+}
+
+static bool DecodeV20SystemAnalog(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	std::vector<PaceBmsProtocolV20::AnalogInformation> packs;
+	if (!v20Stack->ProcessReadSystemAnalogInformationResponse_PYLON(busId, frame, packs))
+		return false;
+	FUZZ_CHECK(packs.size() <= PaceBmsProtocolV20::MAX_SYSTEM_PACK_COUNT_PYLON);
+	return true;
+}
+
+static bool DecodeV20SystemStatus(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	std::vector<PaceBmsProtocolV20::StatusInformation> packs;
+	if (!v20Stack->ProcessReadSystemStatusInformationResponse_PYLON(busId, frame, packs))
+		return false;
+	FUZZ_CHECK(packs.size() <= PaceBmsProtocolV20::MAX_SYSTEM_PACK_COUNT_PYLON);
+	return true;
+}
+
+static bool DecodeV20ChargeDischargeManagement(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	PaceBmsProtocolV20::ChargeDischargeManagementInformation management;
+	return v20Management->ProcessReadChargeDischargeManagementInformationResponse(busId, frame, management);
+}
+
+static bool DecodeV20HardwareVersion(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	std::string hardwareVersion;
+	return v20Eg4->ProcessReadHardwareVersionResponse(busId, frame, hardwareVersion);
+}
+
+static bool DecodeV20SerialNumber(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	std::string serialNumber;
+	return v20Eg4->ProcessReadSerialNumberResponse(busId, frame, serialNumber);
+}
+
+static bool DecodeV20Shutdown(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	return v20Eg4->ProcessWriteShutdownCommandResponse(busId, frame);
+}
+
+static bool DecodeV20ReadSystemDateTime(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	PaceBmsProtocolV20::DateTime dateTime;
+	return v20Eg4->ProcessReadSystemDateTimeResponse(busId, frame, dateTime);
+}
+
+static bool DecodeV20WriteSystemDateTime(const std::vector<uint8_t>& frame, uint8_t busId)
+{
+	return v20Eg4->ProcessWriteSystemDateTimeResponse(busId, frame);
+}
+
+// the receive loop in PaceBms::loop, byte by byte: GetResponseFrameLength is asked for the length until it knows, the frame
+//     ends at that length or at EOI, and whatever was collected goes to the decoders
+static bool AssembleFrames(const std::vector<uint8_t>& bytes, uint8_t /*busId*/)
+{
+	bool accepted = false;
+	std::vector<uint8_t> buffer;
+	uint16_t expectedLength = 0;
+	for (uint8_t byte : bytes)
+	{
+		if (buffer.empty() && byte != '~')
+			continue;
+		buffer.push_back(byte);
+		uint16_t received = (uint16_t)buffer.size();
+		if (expectedLength == 0)
+		{
+			expectedLength = PaceBmsProtocolBase::GetResponseFrameLength(buffer.data(), received);
+			FUZZ_CHECK(expectedLength == 0 || expectedLength >= received);
+			FUZZ_CHECK(expectedLength == 0 || expectedLength == received || (expectedLength >= 18 && expectedLength <= 13 + 0x0FFF + 5));
+			FUZZ_CHECK((expectedLength == 0) == (received < 13));
+		}
+		bool endOfFrame = (expectedLength != 0 && received >= expectedLength) || byte == '\r';
+		if (endOfFrame || received >= 13 + 0x0FFF + 5)
+		{
+			accepted |= DecodeV25Analog(buffer, FrameBusId(buffer));
+			accepted |= DecodeV20Eg4Analog(buffer, FrameBusId(buffer));
+			buffer.clear();
+			expectedLength = 0;
+		}
+	}
+	return accepted;
+}
+
+// the same for MODBUS, which has no start or end marker and is sized entirely from its header
+static bool AssembleModbusFrames(const std::vector<uint8_t>& bytes, uint8_t /*busId*/)
+{
+	std::vector<uint8_t> buffer;
+	uint16_t expectedLength = 0;
+	for (uint8_t byte : bytes)
+	{
+		buffer.push_back(byte);
+		uint16_t received = (uint16_t)buffer.size();
+		if (expectedLength == 0)
+		{
+			expectedLength = PaceBmsProtocolModbus::GetResponseFrameLength(buffer.data(), received);
+			FUZZ_CHECK(expectedLength == 0 || expectedLength >= received);
+			FUZZ_CHECK(expectedLength <= 5 + 255);
+		}
+		if (expectedLength != 0 && received >= expectedLength)
+		{
+			buffer.clear();
+			expectedLength = 0;
+		}
+	}
+	return true;
+}
+
+#define V25_CONFIGURATION(type) \
+	{ "v25.ProcessReadConfigurationResponse." #type, 0x25, PaceBmsProtocolV25::CID1_LithiumIron, \
+		{ PaceBmsProtocolV25::exampleRead##type##ConfigurationResponseV25 }, &DecodeV25ReadConfiguration<PaceBmsProtocolV25::type##Configuration> }
+
+static const std::vector<Target>& Targets()
+{
+	static const std::vector<Target> targets = {
+		{ "v25.ProcessReadAnalogInformationResponse", 0x25, PaceBmsProtocolV25::CID1_LithiumIron, { PaceBmsProtocolV25::exampleReadAnalogInformationResponseV25 }, &DecodeV25Analog },
+		{ "v25.ProcessReadStatusInformationResponse", 0x25, PaceBmsProtocolV25::CID1_LithiumIron, { PaceBmsProtocolV25::exampleReadStatusInformationResponseV25 }, &DecodeV25Status },
+		{ "v25.ProcessReadHardwareVersionResponse", 0x25, PaceBmsProtocolV25::CID1_LithiumIron, { PaceBmsProtocolV25::exampleReadHardwareVersionResponseV25 }, &DecodeV25HardwareVersion },
+		{ "v25.ProcessReadSerialNumberResponse", 0x25, PaceBmsProtocolV25::CID1_LithiumIron, { PaceBmsProtocolV25::exampleReadSerialNumberResponseV25 }, &DecodeV25SerialNumber },
+		{ "v25.ProcessWriteSwitchCommandResponse", 0x25, PaceBmsProtocolV25::CID1_LithiumIron, {
+			PaceBmsProtocolV25::exampleWriteDisableBuzzerSwitchCommandResponseV25, PaceBmsProtocolV25::exampleWriteEnableBuzzerSwitchCommandResponseV25,
+			PaceBmsProtocolV25::exampleWriteDisableLedWarningSwitchCommandResponseV25, PaceBmsProtocolV25::exampleWriteEnableLedWarningSwitchCommandResponseV25,
+			PaceBmsProtocolV25::exampleWriteDisableChargeCurrentLimiterSwitchCommandResponseV25, PaceBmsProtocolV25::exampleWriteEnableChargeCurrentLimiterSwitchCommandResponseV25,
+			PaceBmsProtocolV25::exampleWriteSetChargeCurrentLimiterCurrentLimitLowGearSwitchCommandResponseV25, PaceBmsProtocolV25::exampleWriteSetChargeCurrentLimiterCurrentLimitHighGearSwitchCommandResponseV25 },
+			&DecodeV25SwitchCommand },
+		{ "v25.ProcessWriteMosfetSwitchCommandResponse", 0x25, PaceBmsProtocolV25::CID1_LithiumIron, {
+			PaceBmsProtocolV25::exampleWriteMosfetChargeOpenSwitchCommandResponseV25, PaceBmsProtocolV25::exampleWriteMosfetChargeCloseSwitchCommandResponseV25,
+			PaceBmsProtocolV25::exampleWriteMosfetDischargeOpenSwitchCommandResponseV25, PaceBmsProtocolV25::exampleWriteMosfetDischargeCloseSwitchCommandResponseV25 },
+			&DecodeV25MosfetSwitchCommand },
+		{ "v25.ProcessWriteShutdownCommandResponse", 0x25, PaceBmsProtocolV25::CID1_LithiumIron, { PaceBmsProtocolV25::exampleWriteRebootCommandResponseV25 }, &DecodeV25Shutdown },
+		{ "v25.ProcessReadHistoryRecordResponse", 0x25, PaceBmsProtocolV25::CID1_LithiumIron, { PaceBmsProtocolV25::exampleReadHistoryRecordResponseV25, PaceBmsProtocolV25::exampleReadHistoryRecordEndResponseV25 }, &DecodeV25HistoryRecord },
+		{ "v25.ProcessReadSystemDateTimeResponse", 0x25, PaceBmsProtocolV25::CID1_LithiumIron, { PaceBmsProtocolV25::exampleReadSystemTimeResponseV25 }, &DecodeV25ReadSystemDateTime },
+		{ "v25.ProcessWriteSystemDateTimeResponse", 0x25, PaceBmsProtocolV25::CID1_LithiumIron, { PaceBmsProtocolV25::exampleWriteSystemTimeResponseV25 }, &DecodeV25WriteSystemDateTime },
+		{ "v25.ProcessWriteConfigurationResponse", 0x25, PaceBmsProtocolV25::CID1_LithiumIron, { PaceBmsProtocolV25::exampleWriteCellOverVoltageConfigurationResponseV25 }, &DecodeV25WriteConfiguration },
+		V25_CONFIGURATION(CellOverVoltage),
+		V25_CONFIGURATION(PackOverVoltage),
+		V25_CONFIGURATION(CellUnderVoltage),
+		V25_CONFIGURATION(PackUnderVoltage),
+		V25_CONFIGURATION(ChargeOverCurrent),
+		{ "v25.ProcessReadConfigurationResponse.DischargeOverCurrent1", 0x25, PaceBmsProtocolV25::CID1_LithiumIron,
+			{ PaceBmsProtocolV25::exampleReadDishargeOverCurrent1ConfigurationResponseV25 }, &DecodeV25ReadConfiguration<PaceBmsProtocolV25::DischargeOverCurrent1Configuration> },
+		{ "v25.ProcessReadConfigurationResponse.DischargeOverCurrent2", 0x25, PaceBmsProtocolV25::CID1_LithiumIron,
+			{ PaceBmsProtocolV25::exampleReadDishargeOverCurrent2ConfigurationResponseV25 }, &DecodeV25ReadConfiguration<PaceBmsProtocolV25::DischargeOverCurrent2Configuration> },
+		V25_CONFIGURATION(ShortCircuitProtection),
+		V25_CONFIGURATION(CellBalancing),
+		V25_CONFIGURATION(Sleep),
+		V25_CONFIGURATION(FullChargeLowCharge),
+		V25_CONFIGURATION(ChargeAndDischargeOverTemperature),
+		V25_CONFIGURATION(ChargeAndDischargeUnderTemperature),
+		V25_CONFIGURATION(MosfetOverTemperature),
+		V25_CONFIGURATION(EnvironmentOverUnderTemperature),
+		{ "v25.ProcessReadChargeCurrentLimiterStartCurrentResponse", 0x25, PaceBmsProtocolV25::CID1_LithiumIron, { PaceBmsProtocolV25::exampleReadChargeCurrentLimiterStartCurrentResponseV25 }, &DecodeV25ReadChargeCurrentLimiterStartCurrent },
+		{ "v25.ProcessWriteChargeCurrentLimiterStartCurrentResponse", 0x25, PaceBmsProtocolV25::CID1_LithiumIron, { PaceBmsProtocolV25::exampleWriteChargeCurrentLimiterStartCurrentResponseV25 }, &DecodeV25WriteChargeCurrentLimiterStartCurrent },
+		{ "v25.ProcessReadRemainingCapacityResponse", 0x25, PaceBmsProtocolV25::CID1_LithiumIron, { PaceBmsProtocolV25::exampleReadRemainingCapacityResponseV25 }, &DecodeV25RemainingCapacity },
+		{ "v25.ProcessReadProtocolsResponse", 0x25, PaceBmsProtocolV25::CID1_LithiumIron, { PaceBmsProtocolV25::exampleReadProtocolsResponseV25 }, &DecodeV25ReadProtocols },
+		{ "v25.ProcessWriteProtocolsResponse", 0x25, PaceBmsProtocolV25::CID1_LithiumIron, { PaceBmsProtocolV25::exampleWriteProtocolsResponseV25 }, &DecodeV25WriteProtocols },
+
+		{ "v20.PYLON.ProcessReadAnalogInformationResponse", 0x20, 0x4A, { PaceBmsProtocolV20::exampleReadAnalogInformationResponseV20 }, &DecodeV20PylonAnalog },
+		{ "v20.SEPLOS.ProcessReadAnalogInformationResponse", 0x20, 0x4A, { PaceBmsProtocolV20::exampleReadAnalogInformationResponseV20 }, &DecodeV20SeplosAnalog },
+		{ "v20.EG4.ProcessReadAnalogInformationResponse", 0x20, 0x4A, { PaceBmsProtocolV20::exampleReadAnalogInformationResponseV20 }, &DecodeV20Eg4Analog },
+		{ "v20.detect.ProcessReadAnalogInformationResponse", 0x20, 0x4A, { PaceBmsProtocolV20::exampleReadAnalogInformationResponseV20, PaceBmsProtocolV20::exampleReadStatusInformationResponseV20 }, &DecodeV20DetectVariant },
+		{ "v20.PYLON.ProcessReadStatusInformationResponse", 0x20, 0x4A, { PaceBmsProtocolV20::exampleReadStatusInformationResponseV20 }, &DecodeV20PylonStatus },
+		{ "v20.SEPLOS.ProcessReadStatusInformationResponse", 0x20, 0x4A, { PaceBmsProtocolV20::exampleReadStatusInformationResponseV20 }, &DecodeV20SeplosStatus },
+		{ "v20.EG4.ProcessReadStatusInformationResponse", 0x20, 0x4A, { PaceBmsProtocolV20::exampleReadStatusInformationResponseV20 }, &DecodeV20Eg4Status },
+		{ "v20.PYLON.ProcessReadSystemAnalogInformationResponse", 0x20, 0x46, { PaceBmsProtocolV20::exampleReadSystemAnalogInformationResponseV20_PYLON }, &DecodeV20SystemAnalog },
+		{ "v20.PYLON.ProcessReadSystemStatusInformationResponse", 0x20, 0x46, { PaceBmsProtocolV20::exampleReadSystemStatusInformationResponseV20_PYLON }, &DecodeV20SystemStatus },
+		{ "v20.PYLON.ProcessReadChargeDischargeManagementInformationResponse", 0x20, 0x46, { PaceBmsProtocolV20::exampleReadChargeDischargeManagementInformationResponseV20 }, &DecodeV20ChargeDischargeManagement },
+		{ "v20.ProcessReadHardwareVersionResponse", 0x20, 0x4A, { PaceBmsProtocolV20::exampleReadHardwareVersionResponseV20 }, &DecodeV20HardwareVersion },
+		{ "v20.ProcessReadSerialNumberResponse", 0x20, 0x4A, { PaceBmsProtocolV20::exampleReadSerialNumberResponseV20 }, &DecodeV20SerialNumber },
+		{ "v20.ProcessWriteShutdownCommandResponse", 0x20, 0x4A, { PaceBmsProtocolV20::exampleWriteRebootCommandResponseV20 }, &DecodeV20Shutdown },
+		{ "v20.ProcessReadSystemDateTimeResponse", 0x20, 0x4A, { PaceBmsProtocolV20::exampleReadSystemTimeResponseV20 }, &DecodeV20ReadSystemDateTime },
+		{ "v20.ProcessWriteSystemDateTimeResponse", 0x20, 0x4A, { PaceBmsProtocolV20::exampleWriteSystemTimeResponseV20 }, &DecodeV20WriteSystemDateTime },
+
+		// always handed the raw bytes, a run of frames back to back makes a good seed
+		{ "GetResponseFrameLength", 0x25, PaceBmsProtocolV25::CID1_LithiumIron,
+			{ PaceBmsProtocolV25::exampleReadAnalogInformationResponseV25, PaceBmsProtocolV20::exampleReadAnalogInformationResponseV20, PaceBmsProtocolV25::exampleReadHistoryRecordEndResponseV25 }, &AssembleFrames },
+		{ "PaceBmsProtocolModbus::GetResponseFrameLength", 0x25, PaceBmsProtocolV25::CID1_LithiumIron, { }, &AssembleModbusFrames },
+	};
+	return targets;
+}
+
+static bool IsAssembler(const Target& target)
+{
+	return target.decode == &AssembleFrames || target.decode == &AssembleModbusFrames;
+}
+
+static void Initialize()
+{
+	if (v25 != nullptr)
+		return;
+	v25 = new FuzzProtocolV25();
+	v20Pylon = CreateV20(std::string("PYLON"), 0x4A);
+	v20Seplos = CreateV20(std::string("SEPLOS"), 0x4A);
+	v20Eg4 = CreateV20(std::string("EG4"), 0x4A);
+	// the only capture of this came from a pack reporting the standard lithium iron CID1
+	v20Management = CreateV20(std::string("PYLON"), 0x46);
+	// and the stack wide examples are for a stack of packs that report it as well
+	v20Stack = CreateV20(std::string("PYLON"), 0x46);
+}
+
+// ============================================================================
+static std::vector<size_t> acceptedCounts;
+static std::vector<size_t> runCounts;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	Initialize();
+	if (size < 2)
+		return 0;
+
+	const std::vector<Target>& targets = Targets();
+	size_t index = data[0] % targets.size();
+	const Target& target = targets[index];
+	bool raw = (data[1] & 0x01) != 0 || IsAssembler(target);
+
+	std::vector<uint8_t> frame;
+	uint8_t busId;
+	if (raw)
+	{
+		frame.assign(data + 2, data + size);
+		busId = FrameBusId(frame);
+	}
+	else
+	{
+		busId = 1;
+		frame = WrapInfo(target.version, busId, target.cid1, data + 2, size - 2);
+	}
+
+	currentTarget = target.name;
+	bool accepted = target.decode(frame, busId);
+
+	if (runCounts.size() != targets.size())
+	{
+		runCounts.resize(targets.size());
+		acceptedCounts.resize(targets.size());
+	}
+	runCounts[index]++;
+	if (accepted)
+		acceptedCounts[index]++;
+	return 0;
+}
+
+// ============================================================================
+// everything from here down is the standalone driver, libFuzzer brings its own
+
+#ifndef PACE_BMS_LIBFUZZER
+
+// each example becomes two seeds, raw and wrapped (just its INFO), for each target it belongs to
+static std::vector<std::vector<uint8_t>> Seeds()
+{
+	std::vector<std::vector<uint8_t>> seeds;
+	const std::vector<Target>& targets = Targets();
+	for (size_t index = 0; index < targets.size(); index++)
+	{
+		const Target& target = targets[index];
+		if (IsAssembler(target))
+		{
+			std::vector<uint8_t> seed = { (uint8_t)index, 0x01 };
+			for (const uint8_t* example : target.examples)
+			{
+				std::vector<uint8_t> frame = Frame(example);
+				seed.insert(seed.end(), frame.begin(), frame.end());
+			}
+			if (target.decode == &AssembleModbusFrames)
+			{
+				// a read of two registers, an exception and a write acknowledgement
+				static const uint8_t modbus[] = { 0x01, 0x03, 0x04, 0x00, 0x10, 0x00, 0x20, 0xFA, 0x3C, 0x01, 0x83, 0x02, 0xC0, 0xF1, 0x01, 0x10, 0x00, 0x96, 0x00, 0x01, 0x20, 0x27 };
+				seed.insert(seed.end(), std::begin(modbus), std::end(modbus));
+			}
+			seeds.push_back(seed);
+			continue;
+		}
+		for (const uint8_t* example : target.examples)
+		{
+			std::vector<uint8_t> frame = Frame(example);
+			std::vector<uint8_t> seed = { (uint8_t)index, 0x01 };
+			seed.insert(seed.end(), frame.begin(), frame.end());
+			seeds.push_back(seed);
+
+			std::vector<uint8_t> info = UnwrapInfo(frame);
+			seed = { (uint8_t)index, 0x00 };
+			seed.insert(seed.end(), info.begin(), info.end());
+			seeds.push_back(seed);
+		}
+	}
+	return seeds;
+}
+
+static void Run(const std::vector<uint8_t>& input)
+{
+	LLVMFuzzerTestOneInput(input.data(), input.size());
+}
+
+// the usual byte level mutations, plus ones that keep hex digits hex so that wrapped INFO mostly stays decodable
+static std::vector<uint8_t> Mutate(const std::vector<std::vector<uint8_t>>& seeds, std::mt19937& random)
+{
+	std::vector<uint8_t> input = seeds[random() % seeds.size()];
+	int mutations = 1 + random() % 8;
+	for (int m = 0; m < mutations; m++)
+	{
+		size_t size = input.size();
+		size_t at = size > 2 ? 2 + random() % (size - 2) : 2;
+		switch (random() % 9)
+		{
+		case 0:
+			if (at < size)
+				input[at] ^= (uint8_t)(1 << (random() % 8));
+			break;
+		case 1:
+			if (at < size)
+				input[at] = (uint8_t)random();
+			break;
+		case 2:
+			if (at < size)
+				input[at] = HEX[random() % 16];
+			break;
+		case 3:
+			// small counts are where the interesting edges are
+			if (at + 1 < size)
+			{
+				uint8_t count = (uint8_t)(random() % 4 == 0 ? random() : random() % 40);
+				input[at] = HEX[count >> 4];
+				input[at + 1] = HEX[count & 0x0F];
+			}
+			break;
+		case 4:
+			if (at < size)
+				input.erase(input.begin() + at, input.begin() + std::min(size, at + 1 + random() % 16));
+			break;
+		case 5:
+			input.insert(input.begin() + std::min(at, size), 1 + random() % 16, HEX[random() % 16]);
+			break;
+		case 6:
+			if (at < size)
+				input.resize(at);
+			break;
+		case 7:
+		{
+			// splice in part of another seed
+			const std::vector<uint8_t>& other = seeds[random() % seeds.size()];
+			if (other.size() > 2)
+			{
+				size_t from = 2 + random() % (other.size() - 2);
+				size_t length = std::min(other.size() - from, (size_t)(1 + random() % 64));
+				input.insert(input.begin() + std::min(at, size), other.begin() + from, other.begin() + from + length);
+			}
+			break;
+		}
+		case 8:
+			// same INFO, different decoder, or the same bytes unwrapped
+			if (random() % 2 == 0)
+				input[0] = (uint8_t)random();
+			else
+				input[1] ^= 0x01;
+			break;
+		}
+	}
+	return input;
+}
+
+static bool ReadFile(const std::string& path, std::vector<uint8_t>& contents)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+	contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	return true;
+}
+
+static std::vector<std::string> ListInputs(const std::string& path)
+{
+	std::vector<std::string> paths;
+#ifndef _WIN32
+	struct stat info;
+	if (stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode))
+	{
+		DIR* dir = opendir(path.c_str());
+		if (dir != nullptr)
+		{
+			while (struct dirent* entry = readdir(dir))
+			{
+				if (entry->d_name[0] != '.')
+					paths.push_back(path + "/" + entry->d_name);
+			}
+			closedir(dir);
+		}
+		return paths;
+	}
+#endif
+	paths.push_back(path);
+	return paths;
+}
+
+static bool WriteSeeds(const std::string& directory)
+{
+	const std::vector<Target>& targets = Targets();
+	std::vector<std::vector<uint8_t>> seeds = Seeds();
+	for (size_t i = 0; i < seeds.size(); i++)
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "/seed-%03u-%02u-%s", (unsigned)i, (unsigned)seeds[i][0], seeds[i][1] & 0x01 ? "raw" : "info");
+		std::ofstream file(directory + name, std::ios::binary);
+		if (!file)
+		{
+			std::cerr << "Unable to write " << directory << name << std::endl;
+			return false;
+		}
+		file.write((const char*)seeds[i].data(), seeds[i].size());
+	}
+	std::cout << "wrote " << seeds.size() << " seeds for " << targets.size() << " targets to " << directory << std::endl;
+	return true;
+}
+
+static void Usage()
+{
+	std::cerr <<
+		"usage: fuzz_pace_bms [options] [file or directory ...]\n"
+		"  with files, runs each one once (to reproduce a finding, or under AFL: afl-fuzz -i seeds -o findings -- fuzz_pace_bms @@)\n"
+		"  without, runs the example frames through every target and then mutates them\n"
+		"  --iterations N        number of mutated inputs to run (default 100000)\n"
+		"  --seed N              seed for the mutator (default 1)\n"
+		"  --write-seeds DIR     write the seed corpus to DIR, for libFuzzer or AFL to start from\n";
+}
+
+int main(int argc, char* argv[])
+{
+	size_t iterations = 100000;
+	uint32_t seed = 1;
+	std::vector<std::string> inputs;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--iterations" && hasValue)
+			iterations = (size_t)strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--seed" && hasValue)
+			seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (arg == "--write-seeds" && hasValue)
+			return WriteSeeds(argv[++i]) ? 0 : 1;
+		else if (arg.size() > 1 && arg[0] == '-')
+		{
+			Usage();
+			return 2;
+		}
+		else
+			inputs.push_back(arg);
+	}
+
+	if (!inputs.empty())
+	{
+		for (const std::string& input : inputs)
+		{
+			for (const std::string& path : ListInputs(input))
+			{
+				std::vector<uint8_t> contents;
+				if (!ReadFile(path, contents))
+				{
+					std::cerr << "Unable to read " << path << std::endl;
+					return 1;
+				}
+				Run(contents);
+			}
+		}
+		return 0;
+	}
+
+	std::vector<std::vector<uint8_t>> seeds = Seeds();
+	for (const std::vector<uint8_t>& input : seeds)
+		Run(input);
+
+	std::mt19937 random(seed);
+	for (size_t i = 0; i < iterations; i++)
+		Run(Mutate(seeds, random));
+
+	// a target whose decoder never accepted anything was only ever exercising validation
+	const std::vector<Target>& targets = Targets();
+	printf("%-72s %10s %10s\n", "target", "inputs", "accepted");
+	for (size_t index = 0; index < targets.size(); index++)
+		printf("%-72s %10u %10u\n", targets[index].name, (unsigned)runCounts[index], (unsigned)acceptedCounts[index]);
+	printf("%u seeds, %u mutated inputs, seed %u\n", (unsigned)seeds.size(), (unsigned)iterations, (unsigned)seed);
+	return 0;
+}
+
+#endif
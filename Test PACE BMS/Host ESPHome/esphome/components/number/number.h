@@ -0,0 +1,102 @@
+#pragma once
+
+// host stand-in for ESPHome, see: host_esphome.h
+// the generated code sets min / max / step through traits, a harness does the same, and NumberCall is cut down to set_value
+
+#include <cmath>
+#include <functional>
+#include <string>
+
+#include "esphome/core/component.h"
+#include "esphome/core/entity_base.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#define LOG_NUMBER(prefix, type, obj) \
+	if ((obj) != nullptr) { \
+		ESP_LOGCONFIG(TAG, "%s%s '%s'", prefix, type, (obj)->get_name().c_str()); \
+	}
+
+namespace esphome {
+namespace number {
+
+class NumberTraits {
+public:
+	void set_min_value(float min_value) { this->min_value_ = min_value; }
+	float get_min_value() const { return this->min_value_; }
+	void set_max_value(float max_value) { this->max_value_ = max_value; }
+	float get_max_value() const { return this->max_value_; }
+	void set_step(float step) { this->step_ = step; }
+	float get_step() const { return this->step_; }
+
+protected:
+	float min_value_{ NAN };
+	float max_value_{ NAN };
+	float step_{ NAN };
+};
+
+class Number;
+
+class NumberCall {
+public:
+	explicit NumberCall(Number* parent) : parent_(parent) {}
+
+	NumberCall& set_value(float value) {
+		this->value_ = value;
+		return *this;
+	}
+	void perform();
+
+protected:
+	Number* parent_;
+	float value_{ NAN };
+};
+
+class Number : public EntityBase {
+public:
+	Number() = default;
+	explicit Number(const std::string& name) : EntityBase(name) {}
+
+	void publish_state(float state) {
+		this->state = state;
+		this->has_state_ = true;
+		this->state_callback_.call(state);
+	}
+	void add_on_state_callback(std::function<void(float)>&& callback) { this->state_callback_.add(std::move(callback)); }
+
+	NumberCall make_call() { return NumberCall(this); }
+
+	bool has_state() const { return this->has_state_; }
+
+	NumberTraits traits;
+	float state{ NAN };
+
+protected:
+	friend class NumberCall;
+
+	virtual void control(float value) = 0;
+
+	bool has_state_{ false };
+	CallbackManager<void(float)> state_callback_{};
+};
+
+// as in ESPHome, a value outside of min / max is logged and dropped
+inline void NumberCall::perform() {
+	static const char* const TAG = "number";
+	if (std::isnan(this->value_)) {
+		ESP_LOGW(TAG, "'%s' - No value set", this->parent_->get_name().c_str());
+		return;
+	}
+	if (!std::isnan(this->parent_->traits.get_min_value()) && this->value_ < this->parent_->traits.get_min_value()) {
+		ESP_LOGW(TAG, "'%s' - Value %f must not be less than minimum %f", this->parent_->get_name().c_str(), this->value_, this->parent_->traits.get_min_value());
+		return;
+	}
+	if (!std::isnan(this->parent_->traits.get_max_value()) && this->value_ > this->parent_->traits.get_max_value()) {
+		ESP_LOGW(TAG, "'%s' - Value %f must not be greater than maximum %f", this->parent_->get_name().c_str(), this->value_, this->parent_->traits.get_max_value());
+		return;
+	}
+	this->parent_->control(this->value_);
+}
+
+}  // namespace number
+}  // namespace esphome
@@ -0,0 +1,4 @@
+#pragma once
+
+// the platforms include the hub by its ESPHome path, on the host that's the component directory in this repo
+#include "../../../../../components/pace_bms/pace_bms_component.h"
@@ -0,0 +1,90 @@
+#pragma once
+
+// host stand-in for ESPHome, see: host_esphome.h
+// the generated code sets the options through traits, a harness does the same, and SelectCall is cut down to set_option
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "esphome/core/component.h"
+#include "esphome/core/entity_base.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#define LOG_SELECT(prefix, type, obj) \
+	if ((obj) != nullptr) { \
+		ESP_LOGCONFIG(TAG, "%s%s '%s'", prefix, type, (obj)->get_name().c_str()); \
+	}
+
+namespace esphome {
+namespace select {
+
+class SelectTraits {
+public:
+	void set_options(std::vector<std::string> options) { this->options_ = std::move(options); }
+	const std::vector<std::string>& get_options() const { return this->options_; }
+
+protected:
+	std::vector<std::string> options_;
+};
+
+class Select;
+
+class SelectCall {
+public:
+	explicit SelectCall(Select* parent) : parent_(parent) {}
+
+	SelectCall& set_option(const std::string& option) {
+		this->option_ = option;
+		return *this;
+	}
+	void perform();
+
+protected:
+	Select* parent_;
+	std::string option_;
+};
+
+class Select : public EntityBase {
+public:
+	Select() = default;
+	explicit Select(const std::string& name) : EntityBase(name) {}
+
+	void publish_state(const std::string& state) {
+		this->state = state;
+		this->has_state_ = true;
+		this->state_callback_.call(state);
+	}
+	void add_on_state_callback(std::function<void(const std::string&)>&& callback) { this->state_callback_.add(std::move(callback)); }
+
+	SelectCall make_call() { return SelectCall(this); }
+
+	bool has_state() const { return this->has_state_; }
+
+	SelectTraits traits;
+	std::string state;
+
+protected:
+	friend class SelectCall;
+
+	virtual void control(const std::string& value) = 0;
+
+	bool has_state_{ false };
+	CallbackManager<void(const std::string&)> state_callback_{};
+};
+
+// as in ESPHome, an option that isn't one of the options is logged and dropped
+inline void SelectCall::perform() {
+	static const char* const TAG = "select";
+	const std::vector<std::string>& options = this->parent_->traits.get_options();
+	if (std::find(options.cbegin(), options.cend(), this->option_) == options.cend()) {
+		ESP_LOGW(TAG, "'%s' - Option %s is not a valid option", this->parent_->get_name().c_str(), this->option_.c_str());
+		return;
+	}
+	this->parent_->control(this->option_);
+}
+
+}  // namespace select
+}  // namespace esphome
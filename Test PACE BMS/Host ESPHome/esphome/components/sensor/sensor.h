@@ -0,0 +1,49 @@
+#pragma once
+
+// host stand-in for ESPHome, see: host_esphome.h
+// no filters, publish_state goes straight to state and the state callbacks as it would without any configured
+
+#include <cmath>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "esphome/core/component.h"
+#include "esphome/core/entity_base.h"
+#include "esphome/core/log.h"
+
+#define LOG_SENSOR(prefix, type, obj) \
+	if ((obj) != nullptr) { \
+		ESP_LOGCONFIG(TAG, "%s%s '%s'", prefix, type, (obj)->get_name().c_str()); \
+	}
+
+namespace esphome {
+namespace sensor {
+
+class Sensor : public EntityBase {
+public:
+	Sensor() = default;
+	explicit Sensor(const std::string& name) : EntityBase(name) {}
+
+	void publish_state(float state) {
+		this->raw_state = state;
+		this->state = state;
+		this->has_state_ = true;
+		for (auto& callback : this->state_callbacks_)
+			callback(state);
+	}
+	void add_on_state_callback(std::function<void(float)>&& callback) { this->state_callbacks_.push_back(std::move(callback)); }
+
+	float get_state() const { return this->state; }
+	bool has_state() const { return this->has_state_; }
+
+	float state{ NAN };
+	float raw_state{ NAN };
+
+protected:
+	bool has_state_{ false };
+	std::vector<std::function<void(float)>> state_callbacks_;
+};
+
+}  // namespace sensor
+}  // namespace esphome
@@ -0,0 +1,46 @@
+#pragma once
+
+// host stand-in for ESPHome, see: host_esphome.h
+// no restore mode and no inverted, turn_on / turn_off go straight to write_state as a front end command would
+
+#include <functional>
+#include <string>
+
+#include "esphome/core/component.h"
+#include "esphome/core/entity_base.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#define LOG_SWITCH(prefix, type, obj) \
+	if ((obj) != nullptr) { \
+		ESP_LOGCONFIG(TAG, "%s%s '%s'", prefix, type, (obj)->get_name().c_str()); \
+	}
+
+namespace esphome {
+namespace switch_ {
+
+class Switch : public EntityBase {
+public:
+	Switch() = default;
+	explicit Switch(const std::string& name) : EntityBase(name) {}
+
+	void publish_state(bool state) {
+		this->state = state;
+		this->state_callback_.call(state);
+	}
+	void add_on_state_callback(std::function<void(bool)>&& callback) { this->state_callback_.add(std::move(callback)); }
+
+	void turn_on() { this->write_state(true); }
+	void turn_off() { this->write_state(false); }
+	void toggle() { this->write_state(!this->state); }
+
+	bool state{ false };
+
+protected:
+	virtual void write_state(bool state) = 0;
+
+	CallbackManager<void(bool)> state_callback_{};
+};
+
+}  // namespace switch_
+}  // namespace esphome
@@ -0,0 +1,49 @@
+#pragma once
+
+// host stand-in for ESPHome, see: host_esphome.h
+// no filters, publish_state keeps its own copies of the value the way the real one does, so that the cost of a state
+//     that grows shows up in a harness that counts allocations
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "esphome/core/component.h"
+#include "esphome/core/entity_base.h"
+#include "esphome/core/log.h"
+
+#define LOG_TEXT_SENSOR(prefix, type, obj) \
+	if ((obj) != nullptr) { \
+		ESP_LOGCONFIG(TAG, "%s%s '%s'", prefix, type, (obj)->get_name().c_str()); \
+	}
+
+namespace esphome {
+namespace text_sensor {
+
+class TextSensor : public EntityBase {
+public:
+	TextSensor() = default;
+	explicit TextSensor(const std::string& name) : EntityBase(name) {}
+
+	void publish_state(const std::string& state) {
+		this->raw_state = state;
+		this->state = state;
+		this->has_state_ = true;
+		for (auto& callback : this->state_callbacks_)
+			callback(this->state);
+	}
+	void add_on_state_callback(std::function<void(const std::string&)>&& callback) { this->state_callbacks_.push_back(std::move(callback)); }
+
+	const std::string& get_state() const { return this->state; }
+	bool has_state() const { return this->has_state_; }
+
+	std::string state;
+	std::string raw_state;
+
+protected:
+	bool has_state_{ false };
+	std::vector<std::function<void(const std::string&)>> state_callbacks_;
+};
+
+}  // namespace text_sensor
+}  // namespace esphome
@@ -0,0 +1,66 @@
+#pragma once
+
+// host stand-in for ESPHome, see: host_esphome.h
+// the bus itself is whatever UARTComponent the harness hands to set_uart_parent(), see: host_uart.h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "esphome/core/component.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace uart {
+
+enum UARTParityOptions {
+	UART_CONFIG_PARITY_NONE,
+	UART_CONFIG_PARITY_EVEN,
+	UART_CONFIG_PARITY_ODD,
+};
+
+class UARTComponent {
+public:
+	virtual ~UARTComponent() = default;
+
+	virtual void write_array(const uint8_t* data, size_t len) = 0;
+	virtual bool peek_byte(uint8_t* data) = 0;
+	virtual bool read_array(uint8_t* data, size_t len) = 0;
+	virtual int available() = 0;
+	virtual void flush() = 0;
+
+	void set_baud_rate(uint32_t baud_rate) { this->baud_rate_ = baud_rate; }
+	uint32_t get_baud_rate() const { return this->baud_rate_; }
+
+protected:
+	uint32_t baud_rate_{ 9600 };
+};
+
+class UARTDevice {
+public:
+	UARTDevice() = default;
+	UARTDevice(UARTComponent* parent) : parent_(parent) {}
+
+	void set_uart_parent(UARTComponent* parent) { this->parent_ = parent; }
+
+	void write_byte(uint8_t data) { this->parent_->write_array(&data, 1); }
+	void write_array(const uint8_t* data, size_t len) { this->parent_->write_array(data, len); }
+	void write_array(const std::vector<uint8_t>& data) { this->parent_->write_array(data.data(), data.size()); }
+
+	bool read_byte(uint8_t* data) { return this->parent_->read_array(data, 1); }
+	bool peek_byte(uint8_t* data) { return this->parent_->peek_byte(data); }
+	bool read_array(uint8_t* data, size_t len) { return this->parent_->read_array(data, len); }
+	int available() { return this->parent_->available(); }
+	void flush() { this->parent_->flush(); }
+
+	void check_uart_settings(uint32_t baud_rate, uint8_t stop_bits = 1, UARTParityOptions parity = UART_CONFIG_PARITY_NONE, uint8_t data_bits = 8) {
+		if (this->parent_->get_baud_rate() != baud_rate)
+			ESP_LOGE("uart", "  Invalid baud_rate: Integration requested baud_rate %u but you have %u!", (unsigned)baud_rate, (unsigned)this->parent_->get_baud_rate());
+	}
+
+protected:
+	UARTComponent* parent_{ nullptr };
+};
+
+}  // namespace uart
+}  // namespace esphome
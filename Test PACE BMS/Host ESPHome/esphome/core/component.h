@@ -0,0 +1,72 @@
+#pragma once
+
+// host stand-in for ESPHome, see: host_esphome.h
+// only the parts of the component API that the pace_bms component and its platforms use, intervals and timeouts run on the
+//     host scheduler (host_esphome::run_scheduler) against the host clock
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+
+namespace setup_priority {
+
+const float BUS = 1000.0f;
+const float IO = 900.0f;
+const float HARDWARE = 800.0f;
+const float DATA = 600.0f;
+const float PROCESSOR = 400.0f;
+const float AFTER_WIFI = 200.0f;
+const float AFTER_CONNECTION = 100.0f;
+const float LATE = -100.0f;
+
+}  // namespace setup_priority
+
+class Component {
+public:
+	virtual ~Component();
+
+	virtual void setup() {}
+	virtual void loop() {}
+	virtual void dump_config() {}
+	virtual float get_setup_priority() const { return setup_priority::DATA; }
+
+	void mark_failed() { this->failed_ = true; }
+	bool is_failed() const { return this->failed_; }
+	void status_set_error() { this->status_error_ = true; }
+	void status_clear_error() { this->status_error_ = false; }
+	bool status_has_error() const { return this->status_error_; }
+	void status_set_warning() { this->status_warning_ = true; }
+	void status_clear_warning() { this->status_warning_ = false; }
+	bool status_has_warning() const { return this->status_warning_; }
+
+protected:
+	void set_interval(const std::string& name, uint32_t interval, std::function<void()>&& f);
+	bool cancel_interval(const std::string& name);
+	void set_timeout(const std::string& name, uint32_t timeout, std::function<void()>&& f);
+	bool cancel_timeout(const std::string& name);
+
+	bool failed_{ false };
+	bool status_error_{ false };
+	bool status_warning_{ false };
+};
+
+// update() is not scheduled by itself, the harness calls it so that it controls when a cycle starts
+class PollingComponent : public Component {
+public:
+	PollingComponent() : PollingComponent(0) {}
+	explicit PollingComponent(uint32_t update_interval) : update_interval_(update_interval) {}
+
+	virtual void update() = 0;
+	virtual void set_update_interval(uint32_t update_interval) { this->update_interval_ = update_interval; }
+	virtual uint32_t get_update_interval() const { return this->update_interval_; }
+
+protected:
+	uint32_t update_interval_;
+};
+
+}  // namespace esphome
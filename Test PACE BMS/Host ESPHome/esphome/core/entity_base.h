@@ -0,0 +1,22 @@
+#pragma once
+
+// host stand-in for ESPHome, see: host_esphome.h
+// just the name, there's no object id, icon or entity category to go with it
+
+#include <string>
+
+namespace esphome {
+
+class EntityBase {
+public:
+	EntityBase() = default;
+	explicit EntityBase(const std::string& name) : name_(name) {}
+
+	void set_name(const std::string& name) { this->name_ = name; }
+	const std::string& get_name() const { return this->name_; }
+
+protected:
+	std::string name_;
+};
+
+}  // namespace esphome
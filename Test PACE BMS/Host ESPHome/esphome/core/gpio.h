@@ -0,0 +1,23 @@
+#pragma once
+
+// host stand-in for ESPHome, see: host_esphome.h
+
+#include <string>
+
+namespace esphome {
+
+class GPIOPin {
+public:
+	virtual ~GPIOPin() = default;
+	virtual void setup() = 0;
+	virtual bool digital_read() = 0;
+	virtual void digital_write(bool value) = 0;
+	virtual std::string dump_summary() const = 0;
+};
+
+}  // namespace esphome
+
+#define LOG_PIN(prefix, pin) \
+	if ((pin) != nullptr) { \
+		ESP_LOGCONFIG(TAG, prefix "%s", (pin)->dump_summary().c_str()); \
+	}
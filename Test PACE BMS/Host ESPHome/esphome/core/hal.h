@@ -0,0 +1,17 @@
+#pragma once
+
+// host stand-in for ESPHome, see: host_esphome.h
+// the clock only moves when the harness moves it, so that a run is repeatable and as fast as the host can go
+
+#include <cstdint>
+
+#include "esphome/core/gpio.h"
+
+namespace esphome {
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+}  // namespace esphome
@@ -0,0 +1,32 @@
+#pragma once
+
+// host stand-in for ESPHome, see: host_esphome.h
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace esphome {
+
+uint32_t fnv1_hash(const std::string& str);
+
+template<typename... X> class CallbackManager;
+
+// every callback added is called, in the order added, with the same arguments
+template<typename... Ts> class CallbackManager<void(Ts...)> {
+public:
+	void add(std::function<void(Ts...)>&& callback) { this->callbacks_.push_back(std::move(callback)); }
+	void call(Ts... args) {
+		for (auto& callback : this->callbacks_)
+			callback(args...);
+	}
+	size_t size() const { return this->callbacks_.size(); }
+	void operator()(Ts... args) { this->call(args...); }
+
+protected:
+	std::vector<std::function<void(Ts...)>> callbacks_;
+};
+
+}  // namespace esphome
@@ -0,0 +1,36 @@
+#pragma once
+
+// host stand-in for ESPHome, see: host_esphome.h
+// "flash" is a map in memory that lasts until host_esphome::clear_preferences, which is how a harness simulates a reboot
+//     that keeps (or loses) what was saved
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+
+class ESPPreferenceObject {
+public:
+	ESPPreferenceObject() = default;
+	ESPPreferenceObject(uint32_t type, size_t length) : type_(type), length_(length) {}
+
+	template<typename T> bool save(const T* src) { return this->save_(reinterpret_cast<const uint8_t*>(src), sizeof(T)); }
+	template<typename T> bool load(T* dest) { return this->load_(reinterpret_cast<uint8_t*>(dest), sizeof(T)); }
+
+protected:
+	bool save_(const uint8_t* data, size_t length);
+	bool load_(uint8_t* data, size_t length);
+
+	uint32_t type_{ 0 };
+	size_t length_{ 0 };
+};
+
+class ESPPreferences {
+public:
+	template<typename T> ESPPreferenceObject make_preference(uint32_t type, bool in_flash) { return ESPPreferenceObject(type, sizeof(T)); }
+	template<typename T> ESPPreferenceObject make_preference(uint32_t type) { return ESPPreferenceObject(type, sizeof(T)); }
+};
+
+extern ESPPreferences* global_preferences;
+
+}  // namespace esphome
@@ -0,0 +1,231 @@
+// host_esphome.cpp : see host_esphome.h
+
+#include <chrono>
+#include <cstdarg>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "host_esphome.h"
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
+
+// ============================================================================
+namespace host_esphome {
+
+static uint64_t clockUs = 0;
+static bool realTimeClock = false;
+static std::chrono::steady_clock::time_point realTimeStart;
+static int logLevel = ESPHOME_LOG_LEVEL_WARN;
+static uint32_t warningCount = 0;
+static uint32_t errorCount = 0;
+static int hostScopeDepth = 0;
+static std::function<void(int level, const char* tag, const char* message)> logHook;
+
+struct ScheduledItem
+{
+	esphome::Component* owner;
+	std::string name;
+	uint32_t intervalMs;
+	uint64_t dueUs;
+	bool repeat;
+	std::function<void()> callback;
+};
+static std::vector<ScheduledItem> scheduledItems;
+
+static std::map<uint32_t, std::vector<uint8_t>> preferences;
+
+uint64_t now_us()
+{
+	if (realTimeClock)
+		return clockUs + (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - realTimeStart).count();
+	return clockUs;
+}
+
+void advance_us(uint64_t us)
+{
+	if (realTimeClock)
+		std::this_thread::sleep_for(std::chrono::microseconds(us));
+	else
+		clockUs += us;
+}
+void advance_ms(uint32_t ms) { advance_us((uint64_t)ms * 1000); }
+
+void use_real_time_clock()
+{
+	if (realTimeClock)
+		return;
+	realTimeStart = std::chrono::steady_clock::now();
+	realTimeClock = true;
+}
+bool is_real_time_clock() { return realTimeClock; }
+
+void run_scheduler()
+{
+	// a callback may well schedule or cancel something itself, so find what's due first and then run it
+	std::vector<std::function<void()>> due;
+	{
+		HostScope scope;
+		uint64_t now = now_us();
+		for (size_t i = 0; i < scheduledItems.size(); )
+		{
+			ScheduledItem& item = scheduledItems[i];
+			if (item.dueUs > now)
+			{
+				i++;
+				continue;
+			}
+			due.push_back(item.callback);
+			if (item.repeat)
+			{
+				item.dueUs += (uint64_t)(item.intervalMs == 0 ? 1 : item.intervalMs) * 1000;
+				i++;
+			}
+			else
+			{
+				scheduledItems.erase(scheduledItems.begin() + i);
+			}
+		}
+	}
+	for (std::function<void()>& callback : due)
+		callback();
+}
+
+static void Schedule(esphome::Component* owner, const std::string& name, uint32_t ms, bool repeat, std::function<void()>&& callback)
+{
+	HostScope scope;
+	// as in ESPHome, scheduling under a name that's already in use replaces whatever was there
+	for (size_t i = 0; i < scheduledItems.size(); i++)
+	{
+		if (scheduledItems[i].owner == owner && scheduledItems[i].name == name && scheduledItems[i].repeat == repeat)
+		{
+			scheduledItems.erase(scheduledItems.begin() + i);
+			break;
+		}
+	}
+	scheduledItems.push_back(ScheduledItem{ owner, name, ms, now_us() + (uint64_t)ms * 1000, repeat, std::move(callback) });
+}
+
+static bool Cancel(esphome::Component* owner, const std::string& name, bool repeat)
+{
+	HostScope scope;
+	for (size_t i = 0; i < scheduledItems.size(); i++)
+	{
+		if (scheduledItems[i].owner == owner && scheduledItems[i].name == name && scheduledItems[i].repeat == repeat)
+		{
+			scheduledItems.erase(scheduledItems.begin() + i);
+			return true;
+		}
+	}
+	return false;
+}
+
+static void CancelAll(esphome::Component* owner)
+{
+	for (size_t i = 0; i < scheduledItems.size(); )
+	{
+		if (scheduledItems[i].owner == owner)
+			scheduledItems.erase(scheduledItems.begin() + i);
+		else
+			i++;
+	}
+}
+
+void set_log_level(int level) { logLevel = level; }
+uint32_t get_warning_count() { return warningCount; }
+uint32_t get_error_count() { return errorCount; }
+void set_log_hook(std::function<void(int level, const char* tag, const char* message)> hook) { logHook = std::move(hook); }
+
+void clear_preferences()
+{
+	HostScope scope;
+	preferences.clear();
+}
+
+HostScope::HostScope() { hostScopeDepth++; }
+HostScope::~HostScope() { hostScopeDepth--; }
+bool in_host_scope() { return hostScopeDepth != 0; }
+
+}  // namespace host_esphome
+
+// ============================================================================
+namespace esphome {
+
+uint32_t millis() { return (uint32_t)(host_esphome::now_us() / 1000); }
+uint32_t micros() { return (uint32_t)host_esphome::now_us(); }
+// nothing else is running, so waiting is just moving the clock on
+void delay(uint32_t ms) { host_esphome::advance_ms(ms); }
+void delayMicroseconds(uint32_t us) { host_esphome::advance_us(us); }
+
+void esp_log_printf_(int level, const char* tag, int line, const char* format, ...)
+{
+	host_esphome::HostScope scope;
+	if (level <= ESPHOME_LOG_LEVEL_ERROR)
+		host_esphome::errorCount++;
+	else if (level <= ESPHOME_LOG_LEVEL_WARN)
+		host_esphome::warningCount++;
+	if (level > host_esphome::logLevel && !host_esphome::logHook)
+		return;
+
+	// like the device, formatted into a fixed buffer and truncated if it doesn't fit
+	static const char letters[] = "?EWICDVV";
+	char message[512];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(message, sizeof(message), format, args);
+	va_end(args);
+	if (host_esphome::logHook)
+		host_esphome::logHook(level, tag, message);
+	if (level > host_esphome::logLevel)
+		return;
+	fprintf(stderr, "[%10.3f][%c][%s:%d]: %s\n", host_esphome::now_us() / 1000000.0, letters[level < 0 || level > 7 ? 0 : level], tag, line, message);
+}
+
+uint32_t fnv1_hash(const std::string& str)
+{
+	uint32_t hash = 2166136261UL;
+	for (char c : str)
+	{
+		hash *= 16777619UL;
+		hash ^= (uint8_t)c;
+	}
+	return hash;
+}
+
+static ESPPreferences hostPreferences;
+ESPPreferences* global_preferences = &hostPreferences;
+
+bool ESPPreferenceObject::save_(const uint8_t* data, size_t length)
+{
+	if (length != this->length_)
+		return false;
+	host_esphome::HostScope scope;
+	host_esphome::preferences[this->type_].assign(data, data + length);
+	return true;
+}
+
+bool ESPPreferenceObject::load_(uint8_t* data, size_t length)
+{
+	if (length != this->length_)
+		return false;
+	host_esphome::HostScope scope;
+	auto found = host_esphome::preferences.find(this->type_);
+	if (found == host_esphome::preferences.end() || found->second.size() != length)
+		return false;
+	memcpy(data, found->second.data(), length);
+	return true;
+}
+
+Component::~Component() { host_esphome::CancelAll(this); }
+
+void Component::set_interval(const std::string& name, uint32_t interval, std::function<void()>&& f) { host_esphome::Schedule(this, name, interval, true, std::move(f)); }
+bool Component::cancel_interval(const std::string& name) { return host_esphome::Cancel(this, name, true); }
+void Component::set_timeout(const std::string& name, uint32_t timeout, std::function<void()>&& f) { host_esphome::Schedule(this, name, timeout, false, std::move(f)); }
+bool Component::cancel_timeout(const std::string& name) { return host_esphome::Cancel(this, name, false); }
+
+}  // namespace esphome
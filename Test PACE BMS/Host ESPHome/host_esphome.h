@@ -0,0 +1,54 @@
+#pragma once
+
+// host_esphome.h : the controls for the host stand-in of ESPHome in this directory, which is just enough of the ESPHome API
+//     (component, hal, log, helpers, preferences, uart, sensor, text_sensor, switch, select, number) to build the real pace_bms hub and its
+//     platforms into a test program and drive them without a device, see: host_node.h, "Allocations PACE BMS.cpp"
+//     and "Benchmark Component PACE BMS.cpp"
+//
+// it is a test double and not a port of ESPHome: there's no Application, no API server and no filters, the harness
+//     constructs the components, wires them together the way the generated main.cpp would, calls setup(), then calls
+//     update() / loop() / run_scheduler() itself while moving the clock
+
+#include <cstdint>
+#include <functional>
+
+namespace host_esphome {
+
+// the clock, starts at zero and only moves when told to
+uint64_t now_us();
+void advance_us(uint64_t us);
+void advance_ms(uint32_t ms);
+
+// for talking to something outside the process (see: host_serial_uart.h) the clock can instead follow the steady clock,
+//     from wherever it has got to, in which case advancing it sleeps
+void use_real_time_clock();
+bool is_real_time_clock();
+
+// runs any set_interval / set_timeout callbacks that have come due
+void run_scheduler();
+
+// ESPHOME_LOG_LEVEL_* of the most verbose message written to stderr, ESPHOME_LOG_LEVEL_NONE to silence everything
+void set_log_level(int level);
+// how many messages at ESPHOME_LOG_LEVEL_WARN or worse have been logged, written out or not
+uint32_t get_warning_count();
+uint32_t get_error_count();
+// called with every message at any level, written out or not, for a harness that picks things out of the log (see:
+//     "Replay PACE BMS.cpp"), an empty function to stop
+void set_log_hook(std::function<void(int level, const char* tag, const char* message)> hook);
+
+// forget everything saved through global_preferences
+void clear_preferences();
+
+// marks work done by the stand-in itself (simulated packs, logging) rather than by the code under test, so that a harness
+//     counting allocations or time can leave it out
+class HostScope
+{
+public:
+	HostScope();
+	~HostScope();
+	HostScope(const HostScope&) = delete;
+	HostScope& operator=(const HostScope&) = delete;
+};
+bool in_host_scope();
+
+}  // namespace host_esphome
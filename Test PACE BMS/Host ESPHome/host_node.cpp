@@ -0,0 +1,270 @@
+// host_node.cpp : see host_node.h
+
+#include "host_node.h"
+#include "host_esphome.h"
+
+using namespace esphome;
+using namespace esphome::pace_bms;
+
+namespace host_esphome {
+
+// the select options in the same order as select/__init__.py gives them, which is what the values are matched up with
+static const HostNode::SelectOption chargeCurrentLimiterGearOptions[] = {
+	{ "Low Gear", 0x08 }, { "High Gear", 0x09 },
+};
+static const HostNode::SelectOption protocolCanOptions[] = {
+	{ "", 0xFF }, { "PACE", 0x00 }, { "Pylon / DeYe / CHNT Power / LiVolTek / Megarevo / SunSynk / SunGrow / Sol-Ark / SolarEdge", 0x01 },
+	{ "Growatt / Sacolar", 0x02 }, { "Victron", 0x03 }, { "Schneider / SE / SMA", 0x04 }, { "LuxPower", 0x05 }, { "SoroTec / SRD", 0x06 },
+	{ "SMA / Studer", 0x07 }, { "GoodWe", 0x08 }, { "Studer", 0x09 }, { "Sofar", 0x0A }, { "Must / PV", 0x0B }, { "Solis / Jinlang", 0x0C },
+	{ "DIDU", 0x0D }, { "Senergy", 0x0E }, { "TBB", 0x0F }, { "Pylon_V202", 0x10 }, { "Growatt_V109", 0x11 }, { "Must_V202", 0x12 },
+	{ "Afore", 0x13 }, { "INVT / YWT", 0x14 }, { "FUJI", 0x15 }, { "Sofar V21003", 0x16 },
+};
+static const HostNode::SelectOption protocolRs485Options[] = {
+	{ "", 0xFF }, { "Pace Modbus", 0x00 }, { "Pylon / DeYe / Bentterson", 0x01 }, { "Growatt", 0x02 }, { "Voltronic / EA Sun Power / MPP Solar", 0x03 },
+	{ "Schneider / SE", 0x04 }, { "PHOCOS", 0x05 }, { "LuxPower", 0x06 }, { "Solar", 0x07 }, { "Lithium", 0x08 }, { "EP", 0x09 }, { "RTU04", 0x0A },
+	{ "LuxPower_V01", 0x0B }, { "LuxPower_V03", 0x0C }, { "SRNE / WOW", 0x0D }, { "LEOCH", 0x0E }, { "Pylon_F", 0x0F }, { "Afore", 0x10 },
+	{ "UPS_AGXN", 0x11 }, { "Orex_Sunpolo", 0x12 }, { "XIONGTAO", 0x13 }, { "RONGKE", 0x14 }, { "XINRUI", 0x15 }, { "ELTEK", 0x16 },
+	{ "GT", 0x17 }, { "Leoch_V106", 0x18 },
+};
+static const HostNode::SelectOption protocolTypeOptions[] = {
+	{ "", 0xFF }, { "Auto", 0x00 }, { "Manual", 0x01 },
+};
+#define SELECT_OPTIONS(options) options, sizeof(options) / sizeof(options[0])
+
+std::function<void()> PublishCounter::Add()
+{
+	size_t index = this->perEntity.size();
+	this->perEntity.push_back(0);
+	return [this, index]() {
+		this->publishes++;
+		this->lastPublishUs = now_us();
+		this->perEntity[index]++;
+	};
+}
+
+sensor::Sensor* HostNode::NewSensor(const std::string& name)
+{
+	this->sensorObjects.emplace_back(new sensor::Sensor(name));
+	this->sensorObjects.back()->add_on_state_callback([publish = this->counter.Add()](float) { publish(); });
+	this->entityNames.push_back(name);
+	return this->sensorObjects.back().get();
+}
+
+text_sensor::TextSensor* HostNode::NewTextSensor(const std::string& name)
+{
+	this->textSensorObjects.emplace_back(new text_sensor::TextSensor(name));
+	this->textSensorObjects.back()->add_on_state_callback([publish = this->counter.Add()](const std::string&) { publish(); });
+	this->entityNames.push_back(name);
+	return this->textSensorObjects.back().get();
+}
+
+PaceBmsNumberImplementation* HostNode::NewNumber(const std::string& name)
+{
+	this->numberObjects.emplace_back(new PaceBmsNumberImplementation());
+	this->numberObjects.back()->set_name(name);
+	this->numberObjects.back()->add_on_state_callback([publish = this->counter.Add()](float) { publish(); });
+	this->entityNames.push_back(name);
+	return this->numberObjects.back().get();
+}
+
+PaceBmsSwitchImplementation* HostNode::NewSwitch(const std::string& name)
+{
+	this->switchObjects.emplace_back(new PaceBmsSwitchImplementation());
+	this->switchObjects.back()->set_name(name);
+	this->switchObjects.back()->add_on_state_callback([publish = this->counter.Add()](bool) { publish(); });
+	this->entityNames.push_back(name);
+	return this->switchObjects.back().get();
+}
+
+PaceBmsSelectImplementation* HostNode::NewSelect(const std::string& name, const SelectOption* options, size_t count)
+{
+	this->selectObjects.emplace_back(new PaceBmsSelectImplementation());
+	PaceBmsSelectImplementation* select = this->selectObjects.back().get();
+	select->set_name(name);
+	std::vector<std::string> texts;
+	std::vector<uint8_t> values;
+	for (size_t i = 0; i < count; i++)
+	{
+		texts.push_back(options[i].text);
+		values.push_back(options[i].value);
+	}
+	select->traits.set_options(texts);
+	select->set_values(values);
+	select->add_on_state_callback([publish = this->counter.Add()](const std::string&) { publish(); });
+	this->entityNames.push_back(name);
+	return select;
+}
+
+void HostNode::ConfigureSensors(int commandset)
+{
+	PaceBmsSensor& s = this->sensors;
+	s.set_parent(&this->hub);
+	s.set_cell_count_sensor(this->NewSensor("cell_count"));
+	for (int i = 0; i < PACE_BMS_MAX_CELL_COUNT; i++)
+		s.set_cell_voltage_sensor(i, this->NewSensor("cell_voltage_" + std::to_string(i + 1)));
+	s.set_temperature_count_sensor(this->NewSensor("temperature_count"));
+	for (int i = 0; i < PACE_BMS_MAX_TEMP_COUNT; i++)
+		s.set_temperature_sensor(i, this->NewSensor("temperature_" + std::to_string(i + 1)));
+	s.set_current_sensor(this->NewSensor("current"));
+	s.set_total_voltage_sensor(this->NewSensor("total_voltage"));
+	s.set_remaining_capacity_sensor(this->NewSensor("remaining_capacity"));
+	s.set_full_capacity_sensor(this->NewSensor("full_capacity"));
+	s.set_design_capacity_sensor(this->NewSensor("design_capacity"));
+	s.set_cycle_count_sensor(this->NewSensor("cycle_count"));
+	s.set_state_of_charge_sensor(this->NewSensor("state_of_charge"));
+	s.set_state_of_health_sensor(this->NewSensor("state_of_health"));
+	s.set_power_sensor(this->NewSensor("power"));
+	s.set_min_cell_voltage_sensor(this->NewSensor("min_cell_voltage"));
+	s.set_max_cell_voltage_sensor(this->NewSensor("max_cell_voltage"));
+	s.set_avg_cell_voltage_sensor(this->NewSensor("avg_cell_voltage"));
+	s.set_max_cell_differential_sensor(this->NewSensor("max_cell_differential"));
+	for (int i = 0; i < PACE_BMS_MAX_CELL_COUNT; i++)
+		s.set_warning_status_value_cells_sensor(i, this->NewSensor("warning_status_value_cell_" + std::to_string(i + 1)));
+	for (int i = 0; i < PACE_BMS_MAX_TEMP_COUNT; i++)
+		s.set_warning_status_value_temps_sensor(i, this->NewSensor("warning_status_value_temperature_" + std::to_string(i + 1)));
+	s.set_warning_status_value_charge_current_sensor(this->NewSensor("warning_status_value_charge_current"));
+	s.set_warning_status_value_total_voltage_sensor(this->NewSensor("warning_status_value_total_voltage"));
+	s.set_warning_status_value_discharge_current_sensor(this->NewSensor("warning_status_value_discharge_current"));
+	s.set_balancing_status_value_sensor(this->NewSensor("balancing_status_value"));
+	s.set_system_status_value_sensor(this->NewSensor("system_status_value"));
+	if (commandset == 0x25)
+	{
+		s.set_warning_status_value_1_sensor(this->NewSensor("warning_status_value_1"));
+		s.set_warning_status_value_2_sensor(this->NewSensor("warning_status_value_2"));
+		s.set_configuration_status_value_sensor(this->NewSensor("configuration_status_value"));
+		s.set_protection_status_value_1_sensor(this->NewSensor("protection_status_value_1"));
+		s.set_protection_status_value_2_sensor(this->NewSensor("protection_status_value_2"));
+		s.set_fault_status_value_sensor(this->NewSensor("fault_status_value"));
+	}
+	s.set_requests_sent_sensor(this->NewSensor("requests_sent"));
+	s.set_responses_ok_sensor(this->NewSensor("responses_ok"));
+	s.set_timeouts_sensor(this->NewSensor("timeouts"));
+	s.set_checksum_errors_sensor(this->NewSensor("checksum_errors"));
+	s.set_return_code_errors_sensor(this->NewSensor("return_code_errors"));
+	s.set_mean_latency_sensor(this->NewSensor("mean_latency"));
+	s.set_p95_latency_sensor(this->NewSensor("p95_latency"));
+	s.set_bus_utilization_sensor(this->NewSensor("bus_utilization"));
+
+	PaceBmsTextSensor& t = this->textSensors;
+	t.set_parent(&this->hub);
+	t.set_warning_status_sensor(this->NewTextSensor("warning_status"));
+	t.set_balancing_status_sensor(this->NewTextSensor("balancing_status"));
+	t.set_system_status_sensor(this->NewTextSensor("system_status"));
+	t.set_configuration_status_sensor(this->NewTextSensor("configuration_status"));
+	t.set_protection_status_sensor(this->NewTextSensor("protection_status"));
+	t.set_fault_status_sensor(this->NewTextSensor("fault_status"));
+	t.set_hardware_version_sensor(this->NewTextSensor("hardware_version"));
+	// the simulated pack has no v20 serial number example to answer with
+	if (commandset == 0x25)
+		t.set_serial_number_sensor(this->NewTextSensor("serial_number"));
+	t.set_cell_voltages_sensor(this->NewTextSensor("cell_voltages"));
+	t.set_cell_warning_values_sensor(this->NewTextSensor("cell_warning_values"));
+}
+
+void HostNode::ConfigureV25Settings()
+{
+	PaceBmsNumber& n = this->numbers;
+	n.set_parent(&this->hub);
+	n.set_cell_over_voltage_alarm_number(this->NewNumber("cell_over_voltage_alarm"));
+	n.set_cell_over_voltage_protection_number(this->NewNumber("cell_over_voltage_protection"));
+	n.set_cell_over_voltage_protection_release_number(this->NewNumber("cell_over_voltage_protection_release"));
+	n.set_cell_over_voltage_protection_delay_number(this->NewNumber("cell_over_voltage_protection_delay"));
+	n.set_pack_over_voltage_alarm_number(this->NewNumber("pack_over_voltage_alarm"));
+	n.set_pack_over_voltage_protection_number(this->NewNumber("pack_over_voltage_protection"));
+	n.set_pack_over_voltage_protection_release_number(this->NewNumber("pack_over_voltage_protection_release"));
+	n.set_pack_over_voltage_protection_delay_number(this->NewNumber("pack_over_voltage_protection_delay"));
+	n.set_cell_under_voltage_alarm_number(this->NewNumber("cell_under_voltage_alarm"));
+	n.set_cell_under_voltage_protection_number(this->NewNumber("cell_under_voltage_protection"));
+	n.set_cell_under_voltage_protection_release_number(this->NewNumber("cell_under_voltage_protection_release"));
+	n.set_cell_under_voltage_protection_delay_number(this->NewNumber("cell_under_voltage_protection_delay"));
+	n.set_pack_under_voltage_alarm_number(this->NewNumber("pack_under_voltage_alarm"));
+	n.set_pack_under_voltage_protection_number(this->NewNumber("pack_under_voltage_protection"));
+	n.set_pack_under_voltage_protection_release_number(this->NewNumber("pack_under_voltage_protection_release"));
+	n.set_pack_under_voltage_protection_delay_number(this->NewNumber("pack_under_voltage_protection_delay"));
+	n.set_charge_over_current_alarm_number(this->NewNumber("charge_over_current_alarm"));
+	n.set_charge_over_current_protection_number(this->NewNumber("charge_over_current_protection"));
+	n.set_charge_over_current_protection_delay_number(this->NewNumber("charge_over_current_protection_delay"));
+	n.set_discharge_over_current1_alarm_number(this->NewNumber("discharge_over_current1_alarm"));
+	n.set_discharge_over_current1_protection_number(this->NewNumber("discharge_over_current1_protection"));
+	n.set_discharge_over_current1_protection_delay_number(this->NewNumber("discharge_over_current1_protection_delay"));
+	n.set_discharge_over_current2_protection_number(this->NewNumber("discharge_over_current2_protection"));
+	n.set_discharge_over_current2_protection_delay_number(this->NewNumber("discharge_over_current2_protection_delay"));
+	n.set_short_circuit_protection_delay_number(this->NewNumber("short_circuit_protection_delay"));
+	n.set_cell_balancing_threshold_number(this->NewNumber("cell_balancing_threshold"));
+	n.set_cell_balancing_delta_number(this->NewNumber("cell_balancing_delta"));
+	n.set_sleep_cell_voltage_number(this->NewNumber("sleep_cell_voltage"));
+	n.set_sleep_delay_number(this->NewNumber("sleep_delay"));
+	n.set_full_charge_voltage_number(this->NewNumber("full_charge_voltage"));
+	n.set_full_charge_amps_number(this->NewNumber("full_charge_amps"));
+	n.set_low_charge_alarm_percent_number(this->NewNumber("low_charge_alarm_percent"));
+	n.set_charge_over_temperature_alarm_number(this->NewNumber("charge_over_temperature_alarm"));
+	n.set_charge_over_temperature_protection_number(this->NewNumber("charge_over_temperature_protection"));
+	n.set_charge_over_temperature_protection_release_number(this->NewNumber("charge_over_temperature_protection_release"));
+	n.set_discharge_over_temperature_alarm_number(this->NewNumber("discharge_over_temperature_alarm"));
+	n.set_discharge_over_temperature_protection_number(this->NewNumber("discharge_over_temperature_protection"));
+	n.set_discharge_over_temperature_protection_release_number(this->NewNumber("discharge_over_temperature_protection_release"));
+	n.set_charge_under_temperature_alarm_number(this->NewNumber("charge_under_temperature_alarm"));
+	n.set_charge_under_temperature_protection_number(this->NewNumber("charge_under_temperature_protection"));
+	n.set_charge_under_temperature_protection_release_number(this->NewNumber("charge_under_temperature_protection_release"));
+	n.set_discharge_under_temperature_alarm_number(this->NewNumber("discharge_under_temperature_alarm"));
+	n.set_discharge_under_temperature_protection_number(this->NewNumber("discharge_under_temperature_protection"));
+	n.set_discharge_under_temperature_protection_release_number(this->NewNumber("discharge_under_temperature_protection_release"));
+	n.set_mosfet_over_temperature_alarm_number(this->NewNumber("mosfet_over_temperature_alarm"));
+	n.set_mosfet_over_temperature_protection_number(this->NewNumber("mosfet_over_temperature_protection"));
+	n.set_mosfet_over_temperature_protection_release_number(this->NewNumber("mosfet_over_temperature_protection_release"));
+	n.set_environment_under_temperature_alarm_number(this->NewNumber("environment_under_temperature_alarm"));
+	n.set_environment_under_temperature_protection_number(this->NewNumber("environment_under_temperature_protection"));
+	n.set_environment_under_temperature_protection_release_number(this->NewNumber("environment_under_temperature_protection_release"));
+	n.set_environment_over_temperature_alarm_number(this->NewNumber("environment_over_temperature_alarm"));
+	n.set_environment_over_temperature_protection_number(this->NewNumber("environment_over_temperature_protection"));
+	n.set_environment_over_temperature_protection_release_number(this->NewNumber("environment_over_temperature_protection_release"));
+	n.set_charge_current_limiter_start_current_number(this->NewNumber("charge_current_limiter_start_current"));
+
+	PaceBmsSwitch& w = this->switches;
+	w.set_parent(&this->hub);
+	w.set_buzzer_alarm_switch(this->NewSwitch("buzzer_alarm"));
+	w.set_led_alarm_switch(this->NewSwitch("led_alarm"));
+	w.set_charge_current_limiter_switch(this->NewSwitch("charge_current_limiter"));
+	w.set_charge_mosfet_switch(this->NewSwitch("charge_mosfet"));
+	w.set_discharge_mosfet_switch(this->NewSwitch("discharge_mosfet"));
+
+	PaceBmsSelect& l = this->selects;
+	l.set_parent(&this->hub);
+	l.set_charge_current_limiter_gear_select(this->NewSelect("charge_current_limiter_gear", SELECT_OPTIONS(chargeCurrentLimiterGearOptions)));
+	l.set_protocol_can_select(this->NewSelect("protocol_can", SELECT_OPTIONS(protocolCanOptions)));
+	l.set_protocol_rs485_select(this->NewSelect("protocol_rs485", SELECT_OPTIONS(protocolRs485Options)));
+	l.set_protocol_type_select(this->NewSelect("protocol_type", SELECT_OPTIONS(protocolTypeOptions)));
+}
+
+void HostNode::Configure(uart::UARTComponent* uart, const HostNodeSettings& settings)
+{
+	this->uart.reset(uart);
+
+	this->hub.set_uart_parent(uart);
+	this->hub.set_address(settings.address);
+	this->hub.set_protocol_commandset(settings.commandset);
+	if (!settings.variant.empty())
+		this->hub.set_protocol_variant(settings.variant);
+	this->hub.set_request_throttle(settings.requestThrottleMs);
+	this->hub.set_response_timeout(settings.responseTimeoutMs);
+	this->hub.set_update_interval(settings.updateIntervalMs);
+	this->hub.set_bus_capture(settings.busCapture);
+	this->hub.register_bus_metrics_callback([this](PaceBms::bus_metrics& metrics) { this->metrics = metrics; });
+
+	this->ConfigureSensors(settings.commandset);
+	if (settings.commandset == 0x25)
+		this->ConfigureV25Settings();
+
+	// in setup priority order, as the generated main.cpp would
+	this->sensors.setup();
+	this->textSensors.setup();
+	if (settings.commandset == 0x25)
+	{
+		this->numbers.setup();
+		this->switches.setup();
+		this->selects.setup();
+	}
+	this->hub.setup();
+}
+
+}  // namespace host_esphome
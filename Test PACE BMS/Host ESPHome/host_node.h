@@ -0,0 +1,86 @@
+#pragma once
+
+// host_node.h : the generated main.cpp, more or less, for a YAML that asks for every entity the hub's platforms offer, on
+//     whatever UARTComponent the harness hands it (see: host_uart.h, host_serial_uart.h, host_replay_uart.h)
+//
+// v25 gets the sensor, text_sensor, number, switch and select platforms with everything in them, v20 only the sensor and
+//     text_sensor platforms (the others are v25 only) and less the entities that v20 has no answer for
+//     every entity's state callback is counted so that a harness can tell what was published and when
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "esphome/components/uart/uart.h"
+#include "../../components/pace_bms/pace_bms_component.h"
+#include "../../components/pace_bms/sensor/pace_bms_sensor.h"
+#include "../../components/pace_bms/text_sensor/pace_bms_text_sensor.h"
+#include "../../components/pace_bms/number/pace_bms_number.h"
+#include "../../components/pace_bms/switch/pace_bms_switch.h"
+#include "../../components/pace_bms/select/pace_bms_select.h"
+
+namespace host_esphome {
+
+struct HostNodeSettings
+{
+	int commandset = 0x25;
+	// empty for the commandset's default
+	std::string variant;
+	uint8_t address = 1;
+	uint32_t requestThrottleMs = 50;
+	uint32_t responseTimeoutMs = 200;
+	uint32_t updateIntervalMs = 10000;
+	bool busCapture = false;
+};
+
+// what the entities have published, counted from their state callbacks
+struct PublishCounter
+{
+	uint64_t publishes = 0;
+	uint64_t lastPublishUs = 0;
+	std::vector<uint32_t> perEntity;
+
+	std::function<void()> Add();
+};
+
+struct HostNode
+{
+	std::unique_ptr<esphome::uart::UARTComponent> uart;
+	esphome::pace_bms::PaceBms hub;
+	esphome::pace_bms::PaceBmsSensor sensors;
+	esphome::pace_bms::PaceBmsTextSensor textSensors;
+	esphome::pace_bms::PaceBmsNumber numbers;
+	esphome::pace_bms::PaceBmsSwitch switches;
+	esphome::pace_bms::PaceBmsSelect selects;
+	std::vector<std::unique_ptr<esphome::sensor::Sensor>> sensorObjects;
+	std::vector<std::unique_ptr<esphome::text_sensor::TextSensor>> textSensorObjects;
+	std::vector<std::unique_ptr<esphome::pace_bms::PaceBmsNumberImplementation>> numberObjects;
+	std::vector<std::unique_ptr<esphome::pace_bms::PaceBmsSwitchImplementation>> switchObjects;
+	std::vector<std::unique_ptr<esphome::pace_bms::PaceBmsSelectImplementation>> selectObjects;
+	std::vector<std::string> entityNames;
+	PublishCounter counter;
+	// as of the last update(), which is when the hub hands them out
+	esphome::pace_bms::PaceBms::bus_metrics metrics;
+
+	// takes ownership of the uart, wires everything up and calls setup() on it all
+	void Configure(esphome::uart::UARTComponent* uart, const HostNodeSettings& settings);
+
+	esphome::sensor::Sensor* NewSensor(const std::string& name);
+	esphome::text_sensor::TextSensor* NewTextSensor(const std::string& name);
+	esphome::pace_bms::PaceBmsNumberImplementation* NewNumber(const std::string& name);
+	esphome::pace_bms::PaceBmsSwitchImplementation* NewSwitch(const std::string& name);
+	struct SelectOption
+	{
+		const char* text;
+		uint8_t value;
+	};
+	esphome::pace_bms::PaceBmsSelectImplementation* NewSelect(const std::string& name, const SelectOption* options, size_t count);
+
+protected:
+	void ConfigureSensors(int commandset);
+	void ConfigureV25Settings();
+};
+
+}  // namespace host_esphome
@@ -0,0 +1,126 @@
+// host_replay_uart.cpp : see host_replay_uart.h
+
+#include <algorithm>
+
+#include "host_replay_uart.h"
+#include "host_esphome.h"
+
+namespace host_esphome {
+
+void ReplayUart::load(const std::vector<PaceBmsCaptureReader::Record>& records)
+{
+	HostScope scope;
+	this->requests_.clear();
+	this->leading_bytes_ = 0;
+	bool lastTransmitted = false;
+	for (const PaceBmsCaptureReader::Record& record : records)
+	{
+		if (record.transmitted)
+		{
+			// a request too long for one record carries on in the next
+			if (lastTransmitted)
+				this->requests_.back().data.insert(this->requests_.back().data.end(), record.data.begin(), record.data.end());
+			else
+				this->requests_.push_back(Request{ record.timestampUs, record.data, {} });
+		}
+		else if (this->requests_.empty())
+		{
+			this->leading_bytes_ += record.data.size();
+		}
+		else
+		{
+			this->requests_.back().received.push_back(Received{ record.timestampUs, record.data });
+		}
+		lastTransmitted = record.transmitted;
+	}
+
+	this->next_request_ = 0;
+	this->capture_us_ = records.empty() ? 0 : records.front().timestampUs;
+	this->playing_ = nullptr;
+	this->unread_bytes_ = this->leading_bytes_;
+}
+
+void ReplayUart::drop_unread_()
+{
+	if (this->playing_ == nullptr)
+		return;
+	for (size_t i = this->received_index_; i < this->playing_->received.size(); i++)
+		this->unread_bytes_ += this->playing_->received[i].data.size() - (i == this->received_index_ ? this->received_offset_ : 0);
+	this->playing_ = nullptr;
+}
+
+void ReplayUart::write_array(const uint8_t* data, size_t len)
+{
+	HostScope scope;
+	// the bus is half duplex, whatever was still on its way in is lost under the new request
+	this->drop_unread_();
+
+	size_t end = this->next_request_ + SEARCH_WINDOW;
+	if (end > this->requests_.size())
+		end = this->requests_.size();
+	for (size_t i = this->next_request_; i < end; i++)
+	{
+		const Request& request = this->requests_[i];
+		if (request.data.size() != len || !std::equal(request.data.begin(), request.data.end(), data))
+			continue;
+
+		for (size_t skipped = this->next_request_; skipped < i; skipped++)
+		{
+			for (const Received& received : this->requests_[skipped].received)
+				this->unread_bytes_ += received.data.size();
+			this->skipped_count_++;
+		}
+		this->playing_ = &request;
+		this->playing_start_us_ = now_us();
+		this->received_index_ = 0;
+		this->received_offset_ = 0;
+		this->next_request_ = i + 1;
+		this->capture_us_ = request.timestampUs;
+		this->matched_count_++;
+		return;
+	}
+	this->not_found_count_++;
+}
+
+int ReplayUart::available()
+{
+	if (this->playing_ == nullptr)
+		return 0;
+	uint64_t elapsed = now_us() - this->playing_start_us_;
+	size_t arrived = 0;
+	for (size_t i = this->received_index_; i < this->playing_->received.size(); i++)
+	{
+		const Received& received = this->playing_->received[i];
+		if (received.timestampUs - this->playing_->timestampUs > elapsed)
+			break;
+		arrived += received.data.size() - (i == this->received_index_ ? this->received_offset_ : 0);
+	}
+	return (int)arrived;
+}
+
+bool ReplayUart::peek_byte(uint8_t* data)
+{
+	if (this->available() == 0)
+		return false;
+	*data = this->playing_->received[this->received_index_].data[this->received_offset_];
+	return true;
+}
+
+bool ReplayUart::read_array(uint8_t* data, size_t len)
+{
+	if ((size_t)this->available() < len)
+		return false;
+	for (size_t i = 0; i < len; i++)
+	{
+		const Received& received = this->playing_->received[this->received_index_];
+		data[i] = received.data[this->received_offset_++];
+		if (this->received_offset_ >= received.data.size())
+		{
+			this->received_index_++;
+			this->received_offset_ = 0;
+		}
+	}
+	return true;
+}
+
+}  // namespace host_esphome
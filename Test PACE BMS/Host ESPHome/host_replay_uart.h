@@ -0,0 +1,85 @@
+#pragma once
+
+// host_replay_uart.h : a UARTComponent that answers from a bus capture (see: pace_bms_capture.h) instead of a pack, so
+//     that traffic recorded in the field can be put back through the component on the host clock
+//
+// the component won't ask for things in exactly the same order or at exactly the same moments as it did when the capture
+//     was made (a different build, a different configuration, a reboot part way through) so the capture isn't played out
+//     blindly:
+//     each request the component writes is looked for among the next few requests in the capture, if it's there then
+//         whatever was received after it in the capture (up to the next request) is played back relative to now, with
+//         the same spacing as it was captured with, and any captured requests that were stepped over are skipped
+//     a request that isn't in the capture gets no answer (the component will time out) and the capture stays where it is
+// so a capture made with the same configuration as the replay replays exactly, and one that doesn't replays as much of
+//     itself as can be matched up, the counters say how much that was
+
+#include <cstdint>
+#include <vector>
+
+#include "esphome/components/uart/uart.h"
+#include "../../components/pace_bms/pace_bms_capture.h"
+
+namespace host_esphome {
+
+class ReplayUart : public esphome::uart::UARTComponent
+{
+public:
+	// how many captured requests further on a request is looked for
+	static const size_t SEARCH_WINDOW = 64;
+
+	void load(const std::vector<PaceBmsCaptureReader::Record>& records);
+
+	// every captured request has been matched or stepped over, anything received after the last of them may still be
+	//     arriving
+	bool finished() const { return this->next_request_ >= this->requests_.size(); }
+	// the capture time the replay has got up to, of the last request matched
+	uint64_t get_capture_us() const { return this->capture_us_; }
+
+	uint32_t get_request_count() const { return (uint32_t)this->requests_.size(); }
+	uint32_t get_matched_count() const { return this->matched_count_; }
+	uint32_t get_not_found_count() const { return this->not_found_count_; }
+	uint32_t get_skipped_count() const { return this->skipped_count_; }
+	// received bytes that were never handed to the component, because they came before the first request that was matched
+	//     or the request they followed was skipped or a later request came before they were read
+	uint64_t get_unread_bytes() const { return this->unread_bytes_; }
+
+	void write_array(const uint8_t* data, size_t len) override;
+	bool peek_byte(uint8_t* data) override;
+	bool read_array(uint8_t* data, size_t len) override;
+	int available() override;
+	void flush() override { }
+
+protected:
+	struct Received
+	{
+		uint64_t timestampUs;
+		std::vector<uint8_t> data;
+	};
+	struct Request
+	{
+		uint64_t timestampUs;
+		std::vector<uint8_t> data;
+		// what was received after it, up to the next request
+		std::vector<Received> received;
+	};
+
+	void drop_unread_();
+
+	std::vector<Request> requests_;
+	uint64_t leading_bytes_{ 0 };
+	size_t next_request_{ 0 };
+	uint64_t capture_us_{ 0 };
+
+	// what's being played back, and from when on the host clock
+	const Request* playing_{ nullptr };
+	uint64_t playing_start_us_{ 0 };
+	size_t received_index_{ 0 };
+	size_t received_offset_{ 0 };
+
+	uint32_t matched_count_{ 0 };
+	uint32_t not_found_count_{ 0 };
+	uint32_t skipped_count_{ 0 };
+	uint64_t unread_bytes_{ 0 };
+};
+
+}  // namespace host_esphome
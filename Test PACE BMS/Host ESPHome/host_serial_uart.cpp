@@ -0,0 +1,150 @@
+// host_serial_uart.cpp : see host_serial_uart.h
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "host_serial_uart.h"
+#include "host_esphome.h"
+#include "esphome/core/log.h"
+
+namespace host_esphome {
+
+static const char* const TAG = "host.serial_uart";
+
+static speed_t BaudRateToSpeed(uint32_t baudRate)
+{
+	switch (baudRate)
+	{
+	case 1200: return B1200;
+	case 2400: return B2400;
+	case 4800: return B4800;
+	case 9600: return B9600;
+	case 19200: return B19200;
+	case 38400: return B38400;
+	case 57600: return B57600;
+	case 115200: return B115200;
+	default: return B0;
+	}
+}
+
+SerialPortUart::~SerialPortUart() { this->close(); }
+
+bool SerialPortUart::open(const std::string& path)
+{
+	HostScope scope;
+	this->close();
+
+	speed_t speed = BaudRateToSpeed(this->baud_rate_);
+	if (speed == B0)
+	{
+		ESP_LOGE(TAG, "Unsupported baud rate %u", (unsigned)this->baud_rate_);
+		return false;
+	}
+
+	int fd = ::open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (fd < 0)
+	{
+		ESP_LOGE(TAG, "Unable to open '%s': %s", path.c_str(), strerror(errno));
+		return false;
+	}
+
+	// 8N1, raw, reads return immediately with whatever has arrived
+	struct termios serialParams;
+	if (tcgetattr(fd, &serialParams) != 0)
+	{
+		ESP_LOGE(TAG, "'%s' is not a serial port: %s", path.c_str(), strerror(errno));
+		::close(fd);
+		return false;
+	}
+	cfmakeraw(&serialParams);
+	cfsetispeed(&serialParams, speed);
+	cfsetospeed(&serialParams, speed);
+	serialParams.c_cflag |= CLOCAL | CREAD;
+	serialParams.c_cflag &= ~(PARENB | CSTOPB | CSIZE);
+	serialParams.c_cflag |= CS8;
+	serialParams.c_cc[VMIN] = 0;
+	serialParams.c_cc[VTIME] = 0;
+	tcsetattr(fd, TCSANOW, &serialParams);
+	tcflush(fd, TCIOFLUSH);
+
+	this->fd_ = fd;
+	this->received_.clear();
+	this->received_read_ = 0;
+	return true;
+}
+
+void SerialPortUart::close()
+{
+	if (this->fd_ >= 0)
+		::close(this->fd_);
+	this->fd_ = -1;
+}
+
+void SerialPortUart::write_array(const uint8_t* data, size_t len)
+{
+	HostScope scope;
+	// a pty or an adapter takes a whole frame at once, but the port is non-blocking so keep at it until it's all gone
+	size_t written = 0;
+	while (this->fd_ >= 0 && written < len)
+	{
+		ssize_t result = ::write(this->fd_, data + written, len - written);
+		if (result > 0)
+			written += (size_t)result;
+		else if (result < 0 && errno != EAGAIN && errno != EINTR)
+		{
+			ESP_LOGE(TAG, "Write failed: %s", strerror(errno));
+			return;
+		}
+	}
+}
+
+void SerialPortUart::receive_()
+{
+	HostScope scope;
+	if (this->fd_ < 0)
+		return;
+	// everything before the read position has been handed out already
+	if (this->received_read_ != 0)
+	{
+		this->received_.erase(this->received_.begin(), this->received_.begin() + this->received_read_);
+		this->received_read_ = 0;
+	}
+	uint8_t buffer[256];
+	ssize_t result;
+	while ((result = ::read(this->fd_, buffer, sizeof(buffer))) > 0)
+		this->received_.insert(this->received_.end(), buffer, buffer + result);
+}
+
+int SerialPortUart::available()
+{
+	this->receive_();
+	return (int)(this->received_.size() - this->received_read_);
+}
+
+bool SerialPortUart::peek_byte(uint8_t* data)
+{
+	if (this->available() == 0)
+		return false;
+	*data = this->received_[this->received_read_];
+	return true;
+}
+
+bool SerialPortUart::read_array(uint8_t* data, size_t len)
+{
+	if (this->received_.size() - this->received_read_ < len && (size_t)this->available() < len)
+		return false;
+	memcpy(data, this->received_.data() + this->received_read_, len);
+	this->received_read_ += len;
+	return true;
+}
+
+void SerialPortUart::flush()
+{
+	if (this->fd_ >= 0)
+		tcdrain(this->fd_);
+}
+
+}  // namespace host_esphome
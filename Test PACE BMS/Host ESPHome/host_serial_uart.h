@@ -0,0 +1,40 @@
+#pragma once
+
+// host_serial_uart.h : a UARTComponent on a serial port, a USB to RS485 adapter with a real BMS on it or the pseudo-terminal
+//     that simulate_pace_bms prints the name of (a TCP to serial bridge can be put on a pty with socat), POSIX only
+//
+// nothing waits, available() picks up whatever the OS has received so far, so use it with the real time clock
+//     (host_esphome::use_real_time_clock) for the component's throttle and timeout to mean anything
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "esphome/components/uart/uart.h"
+
+namespace host_esphome {
+
+class SerialPortUart : public esphome::uart::UARTComponent
+{
+public:
+	~SerialPortUart() override;
+
+	// raw 8N1 at the baud rate set with set_baud_rate(), returns false (and logs why) if the port can't be opened
+	bool open(const std::string& path);
+	void close();
+
+	void write_array(const uint8_t* data, size_t len) override;
+	bool peek_byte(uint8_t* data) override;
+	bool read_array(uint8_t* data, size_t len) override;
+	int available() override;
+	void flush() override;
+
+protected:
+	void receive_();
+
+	int fd_{ -1 };
+	std::vector<uint8_t> received_;
+	size_t received_read_{ 0 };
+};
+
+}  // namespace host_esphome
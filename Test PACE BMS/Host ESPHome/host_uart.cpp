@@ -0,0 +1,136 @@
+// host_uart.cpp : see host_uart.h
+
+#include "host_uart.h"
+#include "host_esphome.h"
+
+namespace host_esphome {
+
+void SimulatedUart::add_pack(uint8_t address)
+{
+	HostScope scope;
+	SimulatedPack pack;
+	pack.address = address;
+	this->packs_.push_back(pack);
+}
+
+void SimulatedUart::write_array(const uint8_t* data, size_t len)
+{
+	HostScope scope;
+	for (size_t i = 0; i < len; i++)
+	{
+		// anything before an SOI is line noise
+		if (data[i] == '~')
+			this->request_.clear();
+		if (this->request_.empty() && data[i] != '~')
+			continue;
+		this->request_.push_back(data[i]);
+		if (data[i] == '\r')
+		{
+			this->request_complete_();
+			this->request_.clear();
+		}
+	}
+}
+
+void SimulatedUart::request_complete_()
+{
+	this->request_count_++;
+	if (this->on_request)
+		this->on_request(this->request_);
+
+	// a real BMS just ignores a frame it can't make sense of, or one for somebody else
+	if (!IsSimulatedRequestValid(this->request_))
+		return;
+	uint8_t address = GetSimulatedRequestAddress(this->request_);
+	for (SimulatedPack& pack : this->packs_)
+	{
+		if (pack.address != address)
+			continue;
+		// the bus is half duplex, whatever was still on its way in is lost under the new request
+		this->response_ = CreateSimulatedResponse(pack, this->request_, this->rng_);
+		this->apply_fault_(address);
+		if (this->rewrite_response)
+			this->rewrite_response(this->request_, this->response_);
+		this->response_read_ = 0;
+		this->request_us_ = now_us();
+		this->response_start_us_ = this->request_us_ + (uint64_t)this->latency_ms_ * 1000;
+		this->response_count_++;
+		if (this->on_response)
+			this->on_response(this->response_);
+		return;
+	}
+}
+
+void SimulatedUart::apply_fault_(uint8_t address)
+{
+	double total = this->faults_.noise + this->faults_.dropped_byte + this->faults_.wrong_address + this->faults_.return_code;
+	if (total <= 0)
+		return;
+	double chance = std::uniform_real_distribution<double>(0, 1)(this->rng_);
+	std::vector<uint8_t>& response = this->response_;
+	if ((chance -= this->faults_.noise) < 0)
+	{
+		// anywhere up to just ahead of the EOI
+		size_t at = std::uniform_int_distribution<size_t>(0, response.size() - 1)(this->rng_);
+		int count = std::uniform_int_distribution<int>(1, 4)(this->rng_);
+		for (int i = 0; i < count; i++)
+			response.insert(response.begin() + at, (uint8_t)std::uniform_int_distribution<int>(0, 255)(this->rng_));
+		this->fault_counts_.noise++;
+	}
+	else if ((chance -= this->faults_.dropped_byte) < 0)
+	{
+		response.erase(response.begin() + std::uniform_int_distribution<size_t>(0, response.size() - 1)(this->rng_));
+		this->fault_counts_.dropped_byte++;
+	}
+	else if ((chance -= this->faults_.wrong_address) < 0)
+	{
+		SetSimulatedResponseAddress(response, (uint8_t)(address + 1));
+		this->fault_counts_.wrong_address++;
+	}
+	else if ((chance -= this->faults_.return_code) < 0)
+	{
+		// anything but 0x00 (OK) and 0x04 (CID2 invalid), which a pack only sends for commands it doesn't have at all
+		static const uint8_t returnCodes[] = { 0x01, 0x02, 0x03, 0x05, 0x06, 0x90 };
+		response = CreateSimulatedErrorResponse(this->request_, address, returnCodes[std::uniform_int_distribution<size_t>(0, sizeof(returnCodes) - 1)(this->rng_)]);
+		this->fault_counts_.return_code++;
+	}
+}
+
+int SimulatedUart::available()
+{
+	if (this->response_read_ >= this->response_.size() || now_us() < this->response_start_us_)
+		return 0;
+	size_t arrived = this->response_.size();
+	if (this->baud_rate_ != 0)
+	{
+		// the first byte has arrived once it has been fully clocked in
+		uint64_t bytes = (now_us() - this->response_start_us_) * this->baud_rate_ / 10000000;
+		if (bytes < arrived)
+			arrived = (size_t)bytes;
+	}
+	return arrived > this->response_read_ ? (int)(arrived - this->response_read_) : 0;
+}
+
+bool SimulatedUart::peek_byte(uint8_t* data)
+{
+	if (this->available() == 0)
+		return false;
+	*data = this->response_[this->response_read_];
+	return true;
+}
+
+bool SimulatedUart::read_array(uint8_t* data, size_t len)
+{
+	if ((size_t)this->available() < len)
+		return false;
+	for (size_t i = 0; i < len; i++)
+		data[i] = this->response_[this->response_read_++];
+	if (len != 0 && this->response_read_ == this->response_.size() && this->on_response_read)
+	{
+		HostScope scope;
+		this->on_response_read(now_us() - this->request_us_);
+	}
+	return true;
+}
+
+}  // namespace host_esphome
@@ -0,0 +1,90 @@
+#pragma once
+
+// host_uart.h : a UARTComponent with pretend battery packs on the other end, answering from the example frames the way
+//     the pseudo-terminal simulator does (see: "Simulate PACE BMS/simulated_pack.h") but on the host clock, so that a
+//     harness can run the component through as many cycles as it likes in no time at all
+//
+// a response starts arriving latency_ms after the request's EOI has been written and then trickles in at the baud rate
+//     (10 bits per byte), only what has "arrived" by now_us() is available()
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "esphome/components/uart/uart.h"
+#include "../Simulate PACE BMS/simulated_pack.h"
+
+namespace host_esphome {
+
+class SimulatedUart : public esphome::uart::UARTComponent
+{
+public:
+	void add_pack(uint8_t address);
+	void set_latency_ms(uint32_t latency_ms) { this->latency_ms_ = latency_ms; }
+	void set_seed(unsigned int seed) { this->rng_.seed(seed); }
+
+	// per response chances (0..1) of the things that go wrong on a real bus, at most one of them per response, drawn from
+	//     the same rng that set_seed() seeds
+	struct Faults
+	{
+		// one to four random bytes land somewhere in the response, or just ahead of it
+		double noise{ 0 };
+		// one byte of the response is lost
+		double dropped_byte{ 0 };
+		// the response comes back from a different address than the one asked
+		double wrong_address{ 0 };
+		// the pack answers with an error return code instead
+		double return_code{ 0 };
+	};
+	struct FaultCounts
+	{
+		uint32_t noise{ 0 };
+		uint32_t dropped_byte{ 0 };
+		uint32_t wrong_address{ 0 };
+		uint32_t return_code{ 0 };
+		uint32_t total() const { return this->noise + this->dropped_byte + this->wrong_address + this->return_code; }
+	};
+	void set_faults(const Faults& faults) { this->faults_ = faults; }
+	const FaultCounts& get_fault_counts() const { return this->fault_counts_; }
+
+	// called with every complete request (SOI through EOI) as it's written, and every response as it's queued
+	std::function<void(const std::vector<uint8_t>&)> on_request;
+	std::function<void(const std::vector<uint8_t>&)> on_response;
+	// called with every request that a pack answers and the answer it's about to send (faults included), for a harness that
+	//     wants the pack to say something else, see: UpdateSimulatedResponseChecksum
+	std::function<void(const std::vector<uint8_t>& request, std::vector<uint8_t>& response)> rewrite_response;
+	// called as the last byte of a response is read, with how long after its request was written that was
+	std::function<void(uint64_t latency_us)> on_response_read;
+
+	uint32_t get_request_count() const { return this->request_count_; }
+	uint32_t get_response_count() const { return this->response_count_; }
+
+	void write_array(const uint8_t* data, size_t len) override;
+	bool peek_byte(uint8_t* data) override;
+	bool read_array(uint8_t* data, size_t len) override;
+	int available() override;
+	void flush() override { }
+
+protected:
+	void request_complete_();
+	void apply_fault_(uint8_t address);
+
+	std::vector<SimulatedPack> packs_;
+	std::mt19937 rng_;
+	uint32_t latency_ms_{ 0 };
+
+	std::vector<uint8_t> request_;
+	std::vector<uint8_t> response_;
+	size_t response_read_{ 0 };
+	uint64_t response_start_us_{ 0 };
+	uint64_t request_us_{ 0 };
+
+	Faults faults_;
+	FaultCounts fault_counts_;
+
+	uint32_t request_count_{ 0 };
+	uint32_t response_count_{ 0 };
+};
+
+}  // namespace host_esphome
@@ -0,0 +1,372 @@
+// Replay PACE BMS.cpp : puts a bus capture (see: pace_bms_capture.h) back through the ESPHome component on the host, with
+//     every entity configured (see: host_node.h), so that a problem seen in the field can be reproduced, stepped through
+//     in a debugger or profiled, a day of traffic in a minute or so
+//
+// getting a capture:
+//     bus_capture: true on the pace_bms hub with the logger at INFO or more verbose, then save the log for as long as it
+//         takes, e.g. esphome logs node.yaml > capture.txt, the "Bus capture N: ..." lines are picked out of whatever else
+//         is in there (timestamps, colours, other components)
+//     or --record, which makes one against the simulated pack (see: host_uart.h)
+//
+// the replay runs on the host clock as fast as it can, with --speed N it is held back to N times the speed the capture was
+//     made at on the wall clock, which makes no difference to the component since its throttle and timeout decisions
+//     are always made on the host clock
+//     the component is configured from the command line and not from the capture, so give it the same commandset,
+//     variant, address and update interval as the node the capture came from, see host_replay_uart.h for what happens
+//     to whatever doesn't match up
+//
+//     build/replay_pace_bms capture.txt --commandset 0x25
+//     build/replay_pace_bms capture.txt --commandset 0x20 --variant EG4 --write-binary capture.pbmscap
+//     build/replay_pace_bms --record simulated.txt --cycles 20
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "host_esphome.h"
+#include "host_node.h"
+#include "host_replay_uart.h"
+#include "host_uart.h"
+
+using namespace esphome;
+using namespace esphome::pace_bms;
+using host_esphome::HostNode;
+
+// ============================================================================
+struct Options
+{
+	std::string capturePath;
+	host_esphome::HostNodeSettings settings;
+	uint32_t loopIntervalMs = 16;
+	double speed = 0;
+	std::string writeBinaryPath;
+	std::string recordPath;
+	int cycles = 5;
+	uint32_t latencyMs = 20;
+	bool check = false;
+};
+
+// ============================================================================
+// the blocks the component logged, wherever they are in each line, put back together in order
+static bool ReadCaptureLog(const std::string& text, std::vector<PaceBmsCaptureReader::Record>& records)
+{
+	static const char marker[] = "Bus capture ";
+	std::istringstream lines(text);
+	std::string line;
+	int lineNumber = 0;
+	uint32_t expected = 0;
+	uint32_t blocks = 0;
+	uint64_t lastTimestampUs = 0;
+	while (std::getline(lines, line))
+	{
+		lineNumber++;
+		size_t found = line.find(marker);
+		if (found == std::string::npos)
+			continue;
+		const char* p = line.c_str() + found + strlen(marker);
+		// "Bus capture started" and anything else that isn't a block
+		if (*p < '0' || *p > '9')
+			continue;
+		char* end;
+		uint32_t sequence = (uint32_t)strtoul(p, &end, 10);
+		if (end[0] != ':' || end[1] != ' ')
+			continue;
+		std::string encoded;
+		for (p = end + 2; isalnum((unsigned char)*p) || *p == '+' || *p == '/' || *p == '='; p++)
+			encoded.push_back(*p);
+
+		std::vector<uint8_t> block;
+		if (!PaceBmsCaptureReader::DecodeBase64(encoded, block))
+		{
+			std::cerr << "line " << lineNumber << ": block " << sequence << " isn't valid base64, skipped" << std::endl;
+			continue;
+		}
+		if (sequence == 0 && blocks != 0)
+			std::cerr << "line " << lineNumber << ": the capture starts over (the device restarted?), carrying straight on" << std::endl;
+		else if (sequence != expected)
+			std::cerr << "line " << lineNumber << ": blocks " << expected << " to " << (sequence - 1) << " are missing, the timing around them will be off" << std::endl;
+		expected = sequence + 1;
+		blocks++;
+
+		if (!PaceBmsCaptureReader::ReadRecords(block.data(), block.size(), records, lastTimestampUs))
+			std::cerr << "line " << lineNumber << ": block " << sequence << " is cut short, kept what there was of it" << std::endl;
+	}
+	if (blocks == 0)
+	{
+		std::cerr << "no \"" << marker << "N: ...\" lines found, was the log level INFO or more verbose?" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+static bool LoadCapture(const std::string& path, std::vector<PaceBmsCaptureReader::Record>& records)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		std::cerr << "unable to open " << path << std::endl;
+		return false;
+	}
+	std::vector<uint8_t> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	if (contents.size() >= sizeof(PaceBmsCaptureReader::FILE_MAGIC) && memcmp(contents.data(), PaceBmsCaptureReader::FILE_MAGIC, sizeof(PaceBmsCaptureReader::FILE_MAGIC)) == 0)
+	{
+		uint64_t lastTimestampUs = 0;
+		if (!PaceBmsCaptureReader::ReadRecords(contents.data(), contents.size(), records, lastTimestampUs))
+			std::cerr << path << " is cut short, kept what there was of it" << std::endl;
+		return true;
+	}
+	return ReadCaptureLog(std::string(contents.begin(), contents.end()), records);
+}
+
+static bool WriteBinary(const std::string& path, const std::vector<PaceBmsCaptureReader::Record>& records)
+{
+	std::vector<uint8_t> contents = PaceBmsCaptureReader::WriteFile(records);
+	std::ofstream file(path, std::ios::binary);
+	file.write((const char*)contents.data(), contents.size());
+	if (!file)
+	{
+		std::cerr << "unable to write " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// ============================================================================
+// a capture of the simulated pack, written out the way it would come out of `esphome logs`
+static int Record(const Options& options)
+{
+	std::vector<std::string> lines;
+	host_esphome::set_log_hook([&lines](int level, const char* tag, const char* message) {
+		static const char letters[] = "?EWICDVV";
+		if (level > ESPHOME_LOG_LEVEL_INFO)
+			return;
+		char line[600];
+		snprintf(line, sizeof(line), "[%c][%s]: %s", letters[level < 0 || level > 7 ? 0 : level], tag, message);
+		lines.push_back(line);
+	});
+
+	host_esphome::SimulatedUart* uart = new host_esphome::SimulatedUart();
+	uart->add_pack(options.settings.address);
+	uart->set_latency_ms(options.latencyMs);
+	HostNode node;
+	host_esphome::HostNodeSettings settings = options.settings;
+	settings.busCapture = true;
+	node.Configure(uart, settings);
+
+	for (int cycle = 0; cycle < options.cycles; cycle++)
+	{
+		node.hub.update();
+		for (uint32_t elapsed = 0; elapsed < settings.updateIntervalMs; elapsed += options.loopIntervalMs)
+		{
+			host_esphome::advance_ms(options.loopIntervalMs);
+			host_esphome::run_scheduler();
+			node.hub.loop();
+		}
+	}
+	// which flushes the last of it out
+	node.hub.update();
+	host_esphome::set_log_hook(nullptr);
+
+	std::ofstream file(options.recordPath);
+	for (const std::string& line : lines)
+		file << line << "\n";
+	if (!file)
+	{
+		std::cerr << "unable to write " << options.recordPath << std::endl;
+		return 1;
+	}
+	printf("recorded %d cycles, %u requests, to %s\n", options.cycles, (unsigned)uart->get_request_count(), options.recordPath.c_str());
+	return 0;
+}
+
+// ============================================================================
+static int Replay(const Options& options)
+{
+	std::vector<PaceBmsCaptureReader::Record> records;
+	if (!LoadCapture(options.capturePath, records))
+		return 1;
+	if (!options.writeBinaryPath.empty() && !WriteBinary(options.writeBinaryPath, records))
+		return 1;
+	if (records.empty())
+	{
+		std::cerr << "the capture is empty" << std::endl;
+		return 1;
+	}
+	uint64_t captureUs = records.back().timestampUs - records.front().timestampUs;
+
+	host_esphome::ReplayUart* uart = new host_esphome::ReplayUart();
+	uart->load(records);
+	HostNode node;
+	node.Configure(uart, options.settings);
+
+	uint32_t warningsBefore = host_esphome::get_warning_count();
+	uint32_t errorsBefore = host_esphome::get_error_count();
+	uint64_t startUs = host_esphome::now_us();
+	auto wallStart = std::chrono::steady_clock::now();
+	double loopSeconds = 0;
+	double loopMaxUs = 0;
+	uint64_t loops = 0;
+
+	// on to the end of the update interval that the last request was matched in so its answer can come in, and give up if
+	//     the capture stops matching what the component asks for altogether
+	const uint64_t intervalUs = (uint64_t)options.settings.updateIntervalMs * 1000;
+	uint64_t nextUpdateUs = startUs;
+	uint64_t lastMatchUs = startUs;
+	uint32_t lastMatched = 0;
+	bool gaveUp = false;
+	while (true)
+	{
+		uint64_t now = host_esphome::now_us();
+		if (uart->get_matched_count() != lastMatched)
+		{
+			lastMatched = uart->get_matched_count();
+			lastMatchUs = now;
+		}
+		if (uart->finished() && now >= nextUpdateUs)
+			break;
+		if (now - lastMatchUs >= 10 * intervalUs)
+		{
+			gaveUp = true;
+			break;
+		}
+
+		if (now >= nextUpdateUs)
+		{
+			node.hub.update();
+			nextUpdateUs += intervalUs;
+		}
+		host_esphome::advance_ms(options.loopIntervalMs);
+		host_esphome::run_scheduler();
+
+		auto start = std::chrono::steady_clock::now();
+		node.hub.loop();
+		double us = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0;
+		loopSeconds += us / 1000000.0;
+		loopMaxUs = std::max(loopMaxUs, us);
+		loops++;
+
+		if (options.speed > 0)
+			std::this_thread::sleep_until(wallStart + std::chrono::microseconds((uint64_t)((host_esphome::now_us() - startUs) / options.speed)));
+	}
+	// the bus metrics are handed out at the top of each update()
+	node.hub.update();
+	double wallSeconds = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - wallStart).count() / 1000000.0;
+	double hostSeconds = (host_esphome::now_us() - startUs) / 1000000.0;
+	const PaceBms::bus_metrics& m = node.metrics;
+	uint32_t warnings = host_esphome::get_warning_count() - warningsBefore;
+	uint32_t errors = host_esphome::get_error_count() - errorsBefore;
+
+	printf("%-12s %zu records, %u requests, %.1f s, %s\n", "capture", records.size(), (unsigned)uart->get_request_count(), captureUs / 1000000.0, options.capturePath.c_str());
+	printf("%-12s %u requests answered from the capture, %u not in it, %u skipped over, %llu received bytes unread\n", "replay", (unsigned)uart->get_matched_count(), (unsigned)uart->get_not_found_count(), (unsigned)uart->get_skipped_count(), (unsigned long long)uart->get_unread_bytes());
+	printf("%-12s %u sent, %u ok, %u timeouts, %u checksum errors, %u return code errors, %u other errors, %llu publishes, %u warnings, %u errors logged\n", "component", (unsigned)m.requests_sent_, (unsigned)m.responses_ok_, (unsigned)m.timeouts_, (unsigned)m.checksum_errors_, (unsigned)m.return_code_errors_, (unsigned)m.other_errors_, (unsigned long long)node.counter.publishes, (unsigned)warnings, (unsigned)errors);
+	printf("%-12s %.1f s of host clock in %.3f s of wall clock (%.0fx), loop() %.2f us mean %.2f us max\n", "time", hostSeconds, wallSeconds, wallSeconds > 0 ? hostSeconds / wallSeconds : 0.0, loops != 0 ? loopSeconds * 1000000.0 / loops : 0.0, loopMaxUs);
+	if (gaveUp)
+		std::cerr << "gave up at " << uart->get_capture_us() / 1000000.0 << " s into the capture, nothing the component asked for in the last 10 update intervals was in it, is the configuration the same?" << std::endl;
+
+	if (!options.check)
+		return 0;
+	bool ok = true;
+	if (gaveUp || uart->get_matched_count() != uart->get_request_count() || uart->get_not_found_count() != 0 || uart->get_unread_bytes() != 0)
+	{
+		std::cerr << "FAIL: the capture didn't replay exactly" << std::endl;
+		ok = false;
+	}
+	if (m.requests_sent_ == 0 || m.responses_ok_ != m.requests_sent_ - uart->get_not_found_count())
+	{
+		std::cerr << "FAIL: " << m.requests_sent_ << " requests sent, " << m.responses_ok_ << " answered" << std::endl;
+		ok = false;
+	}
+	if (warnings != 0 || errors != 0)
+	{
+		std::cerr << "FAIL: logged " << warnings << " warnings and " << errors << " errors, run with --verbose to see them" << std::endl;
+		ok = false;
+	}
+	return ok ? 0 : 1;
+}
+
+// ============================================================================
+static void Usage()
+{
+	std::cerr <<
+		"usage: replay_pace_bms CAPTURE [options]       replay a saved log with \"Bus capture\" lines in it, or a binary capture\n"
+		"       replay_pace_bms --record PATH [options] make a capture of the simulated pack, as a log\n"
+		"  --commandset N            0x25 (default) or 0x20, as the node the capture came from\n"
+		"  --variant NAME            the protocol_variant, for v20\n"
+		"  --address N               the pack's address (default 1)\n"
+		"  --update-interval-ms N    the hub's update_interval (default 10000)\n"
+		"  --request-throttle-ms N   the hub's request_throttle (default 50)\n"
+		"  --response-timeout-ms N   the hub's response_timeout (default 200)\n"
+		"  --loop-interval-ms N      time between loop() calls, ESPHome's default is 16\n"
+		"  --speed N                 hold the replay back to N times the capture's speed, rather than as fast as possible\n"
+		"  --write-binary PATH       also save the capture in the binary format\n"
+		"  --cycles N                update cycles to --record (default 5)\n"
+		"  --latency-ms N            the simulated pack waits N milliseconds before answering, for --record (default 20)\n"
+		"  --check                   fail unless the capture replayed exactly and cleanly, for a capture of the same configuration\n"
+		"  --verbose                 show the component's log (at DEBUG) on stderr\n";
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--commandset" && hasValue)
+			options.settings.commandset = (int)strtol(argv[++i], nullptr, 16);
+		else if (arg == "--variant" && hasValue)
+			options.settings.variant = argv[++i];
+		else if (arg == "--address" && hasValue)
+			options.settings.address = (uint8_t)atoi(argv[++i]);
+		else if (arg == "--update-interval-ms" && hasValue)
+			options.settings.updateIntervalMs = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--request-throttle-ms" && hasValue)
+			options.settings.requestThrottleMs = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--response-timeout-ms" && hasValue)
+			options.settings.responseTimeoutMs = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--loop-interval-ms" && hasValue)
+			options.loopIntervalMs = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--speed" && hasValue)
+			options.speed = atof(argv[++i]);
+		else if (arg == "--write-binary" && hasValue)
+			options.writeBinaryPath = argv[++i];
+		else if (arg == "--record" && hasValue)
+			options.recordPath = argv[++i];
+		else if (arg == "--cycles" && hasValue)
+			options.cycles = atoi(argv[++i]);
+		else if (arg == "--latency-ms" && hasValue)
+			options.latencyMs = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--check")
+			options.check = true;
+		else if (arg == "--verbose")
+			host_esphome::set_log_level(ESPHOME_LOG_LEVEL_DEBUG);
+		else if (arg[0] != '-' && options.capturePath.empty())
+			options.capturePath = arg;
+		else
+		{
+			Usage();
+			return 2;
+		}
+	}
+	if (options.capturePath.empty() == options.recordPath.empty() || (options.settings.commandset != 0x25 && options.settings.commandset != 0x20))
+	{
+		Usage();
+		return 2;
+	}
+	if (options.loopIntervalMs < 1)
+		options.loopIntervalMs = 1;
+	if (options.settings.updateIntervalMs < options.loopIntervalMs)
+		options.settings.updateIntervalMs = options.loopIntervalMs;
+
+	return options.recordPath.empty() ? Replay(options) : Record(options);
+}
@@ -0,0 +1,537 @@
+// Scheduler PACE BMS.cpp : the hub's request scheduling (request_throttle, response_timeout, the bus metrics that come out
+//     of them) checked exactly, over thousands of update intervals of a simulated pack on the host clock, with the hub's
+//     own clock injected through PaceBms::set_clock so that it can also be started just short of the 32 bit millis()
+//     wrap without waiting 49 days for it, along with the history download that fills the idle time between updates,
+//     the fast poll tier, the flight recorder's freeze, which answers may grow the receive buffer and how a response
+//     that can't be decoded is counted
+//
+// the hub is configured with bare callbacks rather than entities so that there are no publishes for it to work through
+//     between requests, which leaves every request's timing down to the throttle, the timeout and the pack alone
+//
+// each scenario prints PASS: or FAIL:, along with what it measured
+//     build/scheduler_pace_bms --intervals 100000     a longer run than ctest does
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "host_esphome.h"
+#include "host_uart.h"
+#include "../../components/pace_bms/pace_bms_component.h"
+
+using namespace esphome;
+using namespace esphome::pace_bms;
+
+// ============================================================================
+struct Scenario
+{
+	const char* name;
+	uint8_t packAddress = 1;
+	uint32_t latencyMs = 0;
+	uint32_t throttleMs = 250;
+	uint32_t timeoutMs = 200;
+	// what the hub's clock reads at the first update(), zero to just follow the host clock
+	uint32_t clockStartMs = 0;
+};
+
+struct Measured
+{
+	// the hub's clock at each request, and which update interval it was sent in
+	std::vector<uint32_t> requestMs;
+	std::vector<int> requestInterval;
+	std::vector<uint32_t> updateMs;
+	PaceBms::bus_metrics metrics;
+	double hostSeconds = 0;
+};
+
+static const uint32_t loopIntervalMs = 1;
+static const uint32_t updateIntervalMs = 2000;
+static int intervals = 2000;
+
+static Measured Run(const Scenario& scenario)
+{
+	Measured measured;
+	host_esphome::SimulatedUart uart;
+	uart.add_pack(scenario.packAddress);
+	uart.set_latency_ms(scenario.latencyMs);
+
+	PaceBms hub;
+	uint32_t offsetMs = scenario.clockStartMs == 0 ? 0 : scenario.clockStartMs - (uint32_t)(host_esphome::now_us() / 1000);
+	auto hubMillis = [offsetMs]() { return (uint32_t)(host_esphome::now_us() / 1000) + offsetMs; };
+	hub.set_clock(hubMillis, [offsetMs]() { return (uint32_t)host_esphome::now_us() + offsetMs * 1000; });
+
+	int interval = -1;
+	uart.on_request = [&measured, &interval, hubMillis](const std::vector<uint8_t>&) {
+		measured.requestMs.push_back(hubMillis());
+		measured.requestInterval.push_back(interval);
+	};
+
+	hub.set_uart_parent(&uart);
+	hub.set_address(1);
+	hub.set_protocol_commandset(0x25);
+	hub.set_request_throttle(scenario.throttleMs);
+	hub.set_response_timeout(scenario.timeoutMs);
+	hub.set_update_interval(updateIntervalMs);
+	hub.register_analog_information_callback_v25([](PaceBmsProtocolV25::AnalogInformation&) {}, PaceBmsProtocolBase::AIF_None);
+	hub.register_status_information_callback_v25([](PaceBmsProtocolV25::StatusInformation&) {}, PaceBmsProtocolBase::SIF_None);
+	hub.register_hardware_version_callback_v25([](std::string&) {});
+	hub.register_serial_number_callback_v25([](std::string&) {});
+	hub.register_bus_metrics_callback([&measured](PaceBms::bus_metrics& metrics) { measured.metrics = metrics; });
+	hub.setup();
+
+	uint64_t startUs = host_esphome::now_us();
+	for (interval = 0; interval < intervals; interval++)
+	{
+		measured.updateMs.push_back(hubMillis());
+		hub.update();
+		for (uint32_t elapsed = 0; elapsed < updateIntervalMs; elapsed += loopIntervalMs)
+		{
+			host_esphome::advance_ms(loopIntervalMs);
+			host_esphome::run_scheduler();
+			hub.loop();
+		}
+	}
+	// the bus metrics are handed out at the top of each update()
+	interval = intervals;
+	hub.update();
+	measured.hostSeconds = (host_esphome::now_us() - startUs) / 1000000.0;
+	return measured;
+}
+
+// every interval should have sent the same requests, the first of them one loop() after update() and then each one
+//     spacingMs after the one before, returns a description of the first that wasn't
+static std::string CheckSpacing(const Measured& measured, uint32_t spacingMs)
+{
+	size_t perInterval = 0;
+	while (perInterval < measured.requestInterval.size() && measured.requestInterval[perInterval] == 0)
+		perInterval++;
+	if (perInterval == 0)
+		return "no requests were sent";
+	if (measured.requestMs.size() != perInterval * intervals)
+		return std::to_string(measured.requestMs.size()) + " requests sent, expected " + std::to_string(perInterval * intervals);
+
+	for (size_t i = 0; i < measured.requestMs.size(); i++)
+	{
+		int interval = measured.requestInterval[i];
+		if (interval != (int)(i / perInterval))
+			return "request " + std::to_string(i) + " was sent in interval " + std::to_string(interval);
+		// unsigned differences, so that a 32 bit wrap makes no difference
+		uint32_t gap = i % perInterval == 0 ? measured.requestMs[i] - measured.updateMs[interval] : measured.requestMs[i] - measured.requestMs[i - 1];
+		uint32_t expected = i % perInterval == 0 ? loopIntervalMs : spacingMs;
+		if (gap != expected)
+			return "request " + std::to_string(i) + " was " + std::to_string(gap) + " ms after the " + (i % perInterval == 0 ? "update()" : "request before") + ", expected " + std::to_string(expected);
+	}
+	return "";
+}
+
+static bool Report(const Scenario& scenario, const Measured& measured, const std::string& failure)
+{
+	const PaceBms::bus_metrics& m = measured.metrics;
+	printf("%s: %s, %u requests, %u ok, %u timeouts, %.1f requests per host s, %.1f ms mean latency\n", failure.empty() ? "PASS" : "FAIL", scenario.name,
+		(unsigned)m.requests_sent_, (unsigned)m.responses_ok_, (unsigned)m.timeouts_, m.requests_sent_ / measured.hostSeconds, m.mean_latency_ms_);
+	if (!failure.empty())
+		printf("    %s\n", failure.c_str());
+	return failure.empty();
+}
+
+// ============================================================================
+// answered well within the throttle, so requests go out exactly request_throttle apart
+static bool TestThrottleSpacing(uint32_t latencyMs, uint32_t clockStartMs, const char* name)
+{
+	Scenario scenario;
+	scenario.name = name;
+	scenario.latencyMs = latencyMs;
+	scenario.clockStartMs = clockStartMs;
+	Measured measured = Run(scenario);
+
+	std::string failure = CheckSpacing(measured, scenario.throttleMs);
+	if (failure.empty() && (measured.metrics.responses_ok_ != measured.metrics.requests_sent_ || measured.metrics.requests_sent_ != measured.requestMs.size()))
+		failure = "not every request was answered";
+	if (failure.empty() && clockStartMs != 0 && measured.updateMs.back() > clockStartMs)
+		failure = "the hub's clock never wrapped";
+	return Report(scenario, measured, failure);
+}
+
+// nobody at the hub's address, so every request times out response_timeout after it was sent and the next goes out on
+//     the loop() after that
+static bool TestTimeoutSpacing()
+{
+	Scenario scenario;
+	scenario.name = "every request timing out";
+	scenario.packAddress = 2;
+	scenario.throttleMs = 50;
+	Measured measured = Run(scenario);
+
+	std::string failure = CheckSpacing(measured, scenario.timeoutMs + loopIntervalMs);
+	if (failure.empty() && (measured.metrics.timeouts_ != measured.metrics.requests_sent_ || measured.metrics.responses_ok_ != 0))
+		failure = "not every request timed out";
+	return Report(scenario, measured, failure);
+}
+
+// the pack answering later than response_timeout, the answers arrive when nothing is waiting for them any more and have to
+//     be thrown away rather than being taken for the answer to the next request
+static bool TestLateAnswers()
+{
+	Scenario scenario;
+	scenario.name = "pack answering after the timeout";
+	scenario.latencyMs = 230;
+	// long enough for each answer to be over and done with before the next request, which the simulated pack would
+	//     otherwise drop it for
+	scenario.throttleMs = 500;
+	Measured measured = Run(scenario);
+
+	std::string failure;
+	if (measured.metrics.timeouts_ != measured.metrics.requests_sent_ || measured.metrics.responses_ok_ != 0 || measured.metrics.requests_sent_ == 0)
+		failure = "a late answer was taken for the answer to a later request";
+	return Report(scenario, measured, failure);
+}
+
+// the history download runs in the idle time between updates and only finishes a pass on an end of the log it can trust,
+//     an RTN 0x07 "No Data (historical record)" answer with a bad checksum part way through has to leave the cursor where
+//     it was, so that the next update() carries on from there rather than the older records never being handed out
+static bool TestCorruptEndOfHistory()
+{
+	host_esphome::clear_preferences();
+	host_esphome::SimulatedUart uart;
+	uart.add_pack(1);
+
+	// three records a second apart, newest first, and the first time record 1 is asked for it's a corrupt end of the log
+	static const int recordCount = 3;
+	bool corrupted = false;
+	uart.rewrite_response = [&corrupted](const std::vector<uint8_t>& request, std::vector<uint8_t>& response) {
+		if (std::stoi(std::string(request.begin() + 7, request.begin() + 9), nullptr, 16) != 0xA1)
+			return;
+		int index = std::stoi(std::string(request.begin() + 13, request.begin() + 17), nullptr, 16);
+		if (index == 1 && !corrupted)
+		{
+			corrupted = true;
+			response = CreateSimulatedErrorResponse(request, 1, 0x07);
+			response[response.size() - 2] = response[response.size() - 2] == '0' ? '1' : '0';
+			return;
+		}
+		if (index >= recordCount)
+		{
+			response = CreateSimulatedErrorResponse(request, 1, 0x07);
+			return;
+		}
+		// the seconds of the record's timestamp
+		static const char hex[] = "0123456789ABCDEF";
+		int second = 30 - index;
+		response[23] = hex[second >> 4];
+		response[24] = hex[second & 0x0F];
+		UpdateSimulatedResponseChecksum(response);
+	};
+
+	PaceBms hub;
+	hub.set_uart_parent(&uart);
+	hub.set_address(1);
+	hub.set_protocol_commandset(0x25);
+	hub.set_request_throttle(50);
+	hub.set_response_timeout(200);
+	hub.set_update_interval(updateIntervalMs);
+	std::vector<int> seconds;
+	hub.register_history_record_callback_v25([&seconds](PaceBmsProtocolV25::HistoryRecord& record) { seconds.push_back(record.dateTime.Second); });
+	hub.setup();
+
+	for (int interval = 0; interval < 3; interval++)
+	{
+		hub.update();
+		for (uint32_t elapsed = 0; elapsed < updateIntervalMs; elapsed += loopIntervalMs)
+		{
+			host_esphome::advance_ms(loopIntervalMs);
+			host_esphome::run_scheduler();
+			hub.loop();
+		}
+	}
+
+	std::string handedOut;
+	for (int second : seconds)
+		handedOut += (handedOut.empty() ? "" : ", ") + std::to_string(second);
+	bool pass = corrupted && seconds == std::vector<int>{ 30, 29, 28 };
+	printf("%s: corrupt end of history part way through a download, records handed out (by second) %s\n", pass ? "PASS" : "FAIL", handedOut.c_str());
+	if (!pass)
+		printf("    expected 30, 29, 28\n");
+	return pass;
+}
+
+// on v25 the capacity values are fast polled with their own small request, a pack that rejects it has to be given up on and
+//     the capacity taken from the analog information instead, rather than the capacity sensors never updating
+static bool TestRemainingCapacityRejected()
+{
+	host_esphome::SimulatedUart uart;
+	uart.add_pack(1);
+	int capacityRequests = 0;
+	uart.rewrite_response = [&capacityRequests](const std::vector<uint8_t>& request, std::vector<uint8_t>& response) {
+		if (std::stoi(std::string(request.begin() + 7, request.begin() + 9), nullptr, 16) != 0xA6)
+			return;
+		capacityRequests++;
+		response = CreateSimulatedErrorResponse(request, 1, 0x04);
+	};
+
+	PaceBms hub;
+	hub.set_uart_parent(&uart);
+	hub.set_address(1);
+	hub.set_protocol_commandset(0x25);
+	hub.set_request_throttle(50);
+	hub.set_response_timeout(200);
+	hub.set_update_interval(updateIntervalMs);
+	hub.set_fast_poll_interval(updateIntervalMs / 4);
+	int capacityUpdates = 0;
+	hub.register_remaining_capacity_callback_v25([&capacityUpdates](uint32_t&, uint32_t& actual_capacity, uint32_t&) {
+		if (actual_capacity != 0)
+			capacityUpdates++;
+	});
+	hub.setup();
+
+	static const int updates = 3;
+	for (int interval = 0; interval < updates; interval++)
+	{
+		hub.update();
+		for (uint32_t elapsed = 0; elapsed < updateIntervalMs; elapsed += loopIntervalMs)
+		{
+			host_esphome::advance_ms(loopIntervalMs);
+			host_esphome::run_scheduler();
+			hub.loop();
+		}
+	}
+
+	bool pass = capacityRequests == 1 && capacityUpdates == updates - 1;
+	printf("%s: remaining capacity request rejected by the pack, asked %i times, capacity then read %i times from the analog information\n", pass ? "PASS" : "FAIL", capacityRequests, capacityUpdates);
+	if (!pass)
+		printf("    expected 1 and %i\n", updates - 1);
+	return pass;
+}
+
+// with 0x20 the recorder can only see a protection or fault condition in the decoder's text, it has to freeze on one even
+//     when nothing that reads the status information asked for the text
+static bool TestV20FlightRecorderFreeze()
+{
+	host_esphome::SimulatedUart uart;
+	uart.add_pack(1);
+	// the example status answer (from an EG4 pack, CID1 0x4A, decoded as PYLON), with a protection bit (status1) set from the
+	//     second update on
+	int statusRequests = 0;
+	uart.rewrite_response = [&statusRequests](const std::vector<uint8_t>& request, std::vector<uint8_t>& response) {
+		if (std::stoi(std::string(request.begin() + 7, request.begin() + 9), nullptr, 16) != 0x44)
+			return;
+		const char* example = (const char*)PaceBmsProtocolV20::exampleReadStatusInformationResponseV20;
+		response.assign(example, example + strlen(example));
+		if (++statusRequests > 1)
+		{
+			response[67] = '0';
+			response[68] = '1';
+			UpdateSimulatedResponseChecksum(response);
+		}
+	};
+
+	PaceBms hub;
+	hub.set_uart_parent(&uart);
+	hub.set_address(1);
+	hub.set_protocol_commandset(0x20);
+	hub.set_protocol_variant("PYLON");
+	hub.set_chemistry(0x4A);
+	hub.set_request_throttle(50);
+	hub.set_response_timeout(200);
+	hub.set_update_interval(updateIntervalMs);
+	hub.set_flight_recorder_size(8);
+	hub.register_status_information_callback_v20([](PaceBmsProtocolV20::StatusInformation&) {}, PaceBmsProtocolBase::SIF_None);
+	hub.setup();
+
+	bool frozen = false;
+	host_esphome::set_log_hook([&frozen](int, const char*, const char* message) {
+		if (strstr(message, "Flight recorder dump (frozen)") != nullptr)
+			frozen = true;
+	});
+	for (int interval = 0; interval < 2; interval++)
+	{
+		hub.update();
+		for (uint32_t elapsed = 0; elapsed < updateIntervalMs; elapsed += loopIntervalMs)
+		{
+			host_esphome::advance_ms(loopIntervalMs);
+			host_esphome::run_scheduler();
+			hub.loop();
+		}
+	}
+	hub.dump_flight_recorder();
+	host_esphome::set_log_hook(nullptr);
+
+	bool pass = statusRequests == 2 && frozen;
+	printf("%s: 0x20 protection condition with no status text asked for, status read %i times, recorder %s\n", pass ? "PASS" : "FAIL", statusRequests, frozen ? "frozen" : "not frozen");
+	if (!pass)
+		printf("    expected 2 reads and a frozen recorder\n");
+	return pass;
+}
+
+// pads a response's payload with zero bytes, keeping its length and checksums right
+static void PadResponse(std::vector<uint8_t>& response, int extraBytes)
+{
+	static const char hex[] = "0123456789ABCDEF";
+	response.insert(response.end() - 5, extraBytes * 2, '0');
+	int lenid = (int)response.size() - 18;
+	int lchksum = (~((lenid & 0x0F) + ((lenid >> 4) & 0x0F) + ((lenid >> 8) & 0x0F)) + 1) & 0x0F;
+	response[9] = hex[lchksum];
+	response[10] = hex[(lenid >> 8) & 0x0F];
+	response[11] = hex[(lenid >> 4) & 0x0F];
+	response[12] = hex[lenid & 0x0F];
+	UpdateSimulatedResponseChecksum(response);
+}
+
+// only a request expected to have a long answer (here a history record) may grow the receive buffer past 256 bytes, and it
+//     goes back to 256 afterwards, so an analog information answer that runs long is dropped both before and after one
+static bool TestReceiveBufferGrowth()
+{
+	host_esphome::clear_preferences();
+	host_esphome::SimulatedUart uart;
+	uart.add_pack(1);
+	int recordReads = 0;
+	uart.rewrite_response = [&recordReads](const std::vector<uint8_t>& request, std::vector<uint8_t>& response) {
+		int cid2 = std::stoi(std::string(request.begin() + 7, request.begin() + 9), nullptr, 16);
+		if (cid2 == 0x42)
+			PadResponse(response, 100);
+		else if (cid2 == 0xA1 && std::stoi(std::string(request.begin() + 13, request.begin() + 17), nullptr, 16) == 0)
+		{
+			recordReads++;
+			PadResponse(response, 150);
+		}
+		else if (cid2 == 0xA1)
+			response = CreateSimulatedErrorResponse(request, 1, 0x07);
+	};
+
+	PaceBms hub;
+	hub.set_uart_parent(&uart);
+	hub.set_address(1);
+	hub.set_protocol_commandset(0x25);
+	hub.set_request_throttle(50);
+	hub.set_response_timeout(200);
+	hub.set_update_interval(updateIntervalMs);
+	int analogUpdates = 0;
+	int historyRecords = 0;
+	hub.register_analog_information_callback_v25([&analogUpdates](PaceBmsProtocolV25::AnalogInformation&) { analogUpdates++; }, PaceBmsProtocolBase::AIF_None);
+	hub.register_history_record_callback_v25([&historyRecords](PaceBmsProtocolV25::HistoryRecord&) { historyRecords++; });
+	hub.setup();
+
+	int grown = 0;
+	host_esphome::set_log_hook([&grown](int, const char*, const char* message) {
+		if (strstr(message, "Growing receive buffer") != nullptr)
+			grown++;
+	});
+	for (int interval = 0; interval < 2; interval++)
+	{
+		hub.update();
+		for (uint32_t elapsed = 0; elapsed < updateIntervalMs; elapsed += loopIntervalMs)
+		{
+			host_esphome::advance_ms(loopIntervalMs);
+			host_esphome::run_scheduler();
+			hub.loop();
+		}
+	}
+	host_esphome::set_log_hook(nullptr);
+
+	// each pass of the history download reads the newest record again to see if there's anything new
+	bool pass = historyRecords == 1 && recordReads > 0 && grown == recordReads && analogUpdates == 0;
+	printf("%s: long answers, history record read %i times with the buffer grown %i times, long analog information handed out %i times\n", pass ? "PASS" : "FAIL", recordReads, grown, analogUpdates);
+	if (!pass)
+		printf("    expected the buffer grown for every history record read and no analog information, %i records handed out\n", historyRecords);
+	return pass;
+}
+
+// a response that validates but can't be decoded (here a hardware version one byte too long) is an error for the bus
+//     metrics, not an ok, while the analog information read alongside it still counts as ok
+static bool TestUndecodableResponse()
+{
+	host_esphome::SimulatedUart uart;
+	uart.add_pack(1);
+	uart.rewrite_response = [](const std::vector<uint8_t>& request, std::vector<uint8_t>& response) {
+		if (std::stoi(std::string(request.begin() + 7, request.begin() + 9), nullptr, 16) == 0xC1)
+			PadResponse(response, 1);
+	};
+
+	PaceBms hub;
+	hub.set_uart_parent(&uart);
+	hub.set_address(1);
+	hub.set_protocol_commandset(0x25);
+	hub.set_request_throttle(50);
+	hub.set_response_timeout(200);
+	hub.set_update_interval(updateIntervalMs);
+	int versions = 0;
+	hub.register_analog_information_callback_v25([](PaceBmsProtocolV25::AnalogInformation&) {}, PaceBmsProtocolBase::AIF_None);
+	hub.register_hardware_version_callback_v25([&versions](std::string&) { versions++; });
+	std::map<std::string, PaceBms::bus_metrics> commands;
+	hub.register_command_metrics_callback([&commands](const std::map<std::string, PaceBms::bus_metrics>& metrics) { commands = metrics; });
+	hub.setup();
+
+	static const int updates = 3;
+	for (int interval = 0; interval < updates; interval++)
+	{
+		hub.update();
+		for (uint32_t elapsed = 0; elapsed < updateIntervalMs; elapsed += loopIntervalMs)
+		{
+			host_esphome::advance_ms(loopIntervalMs);
+			host_esphome::run_scheduler();
+			hub.loop();
+		}
+	}
+	// the metrics are handed out at the top of each update()
+	hub.update();
+
+	const PaceBms::bus_metrics& version = commands["read hardware version"];
+	const PaceBms::bus_metrics& analog = commands["read analog information"];
+	bool pass = versions == 0 && version.requests_sent_ == updates && version.responses_ok_ == 0 && version.other_errors_ == updates &&
+		analog.requests_sent_ == updates && analog.responses_ok_ == updates;
+	printf("%s: undecodable hardware version, %u sent, %u ok, %u other errors, analog information %u sent, %u ok\n", pass ? "PASS" : "FAIL",
+		(unsigned)version.requests_sent_, (unsigned)version.responses_ok_, (unsigned)version.other_errors_, (unsigned)analog.requests_sent_, (unsigned)analog.responses_ok_);
+	if (!pass)
+		printf("    expected %i sent and %i other errors for the hardware version, %i sent and ok for the analog information\n", updates, updates, updates);
+	return pass;
+}
+
+static void Usage()
+{
+	std::cerr <<
+		"usage: scheduler_pace_bms [options]\n"
+		"  --intervals N    update intervals to run each scenario for (default 2000)\n"
+		"  --verbose        show the component's log (at DEBUG) on stderr\n";
+}
+
+int main(int argc, char* argv[])
+{
+	bool verbose = false;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--intervals" && i + 1 < argc)
+			intervals = atoi(argv[++i]);
+		else if (arg == "--verbose")
+			verbose = true;
+		else
+		{
+			Usage();
+			return 2;
+		}
+	}
+	if (intervals < 1)
+		intervals = 1;
+	// timeouts are warnings, so they would be written out by default
+	host_esphome::set_log_level(verbose ? ESPHOME_LOG_LEVEL_DEBUG : ESPHOME_LOG_LEVEL_NONE);
+
+	// on a device the first update() comes well after boot, and so well clear of the throttle since the last request, which
+	//     as far as the hub knows was sent at zero
+	host_esphome::advance_ms(updateIntervalMs);
+
+	bool ok = true;
+	ok &= TestThrottleSpacing(0, 0, "answered at once");
+	ok &= TestThrottleSpacing(40, 0, "answered after 40 ms");
+	// the wrap is a few seconds in
+	ok &= TestThrottleSpacing(40, 0xFFFFFFFFu - 5000, "answered after 40 ms across the millis() wrap");
+	ok &= TestTimeoutSpacing();
+	ok &= TestLateAnswers();
+	ok &= TestCorruptEndOfHistory();
+	ok &= TestRemainingCapacityRejected();
+	ok &= TestV20FlightRecorderFreeze();
+	ok &= TestReceiveBufferGrowth();
+	ok &= TestUndecodableResponse();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,263 @@
+// Simulate PACE BMS.cpp : one or more pretend battery packs sharing a virtual RS485 bus on a pseudo-terminal, for exercising the
+//     protocol classes and the ESPHome component without a rack of real batteries attached
+//
+// how each pack answers is in simulated_pack.cpp
+//
+// POSIX only, see CMakeLists.txt
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "simulated_pack.h"
+
+struct SimulatorOptions
+{
+	std::vector<uint8_t> addresses;
+	int latencyMs = 0;
+	int baudRate = 0;          // 0 = as fast as the pseudo-terminal will take it
+	double dropChance = 0;     // 0..1, per response
+	double corruptChance = 0;  // 0..1, per response
+	unsigned int seed = 0;
+	std::string link;
+	bool verbose = false;
+};
+
+static SimulatorOptions options;
+static std::vector<SimulatedPack> packs;
+static std::mt19937 rng;
+
+static void WritePaced(int fd, const std::vector<uint8_t>& frame)
+{
+	if (options.baudRate <= 0)
+	{
+		if (write(fd, frame.data(), frame.size()) != (ssize_t)frame.size())
+			std::cerr << "short write" << std::endl;
+		return;
+	}
+
+	// 10 bits per byte at 8N1
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < frame.size(); i++)
+	{
+		std::this_thread::sleep_until(start + std::chrono::microseconds((uint64_t)i * 10000000 / options.baudRate));
+		if (write(fd, &frame[i], 1) != 1)
+			std::cerr << "short write" << std::endl;
+	}
+}
+
+// reads one frame from SOI through EOI, anything before an SOI is line noise and is discarded
+static bool ReadFrame(int fd, std::vector<uint8_t>& frame)
+{
+	frame.clear();
+	uint8_t c;
+	while (true)
+	{
+		ssize_t read_result = read(fd, &c, 1);
+		if (read_result < 0)
+			return false;
+		if (read_result == 0)
+			continue;
+		if (c == '~')
+			frame.clear();
+		if (frame.empty() && c != '~')
+			continue;
+		frame.push_back(c);
+		if (c == '\r')
+			return true;
+		if (frame.size() > 4096)
+			frame.clear();
+	}
+}
+
+static void RunBus(int master)
+{
+	std::uniform_real_distribution<double> chance(0.0, 1.0);
+	std::vector<uint8_t> request;
+	while (ReadFrame(master, request))
+	{
+		std::string requestText(request.begin(), request.end() - 1);
+		if (!IsSimulatedRequestValid(request))
+		{
+			// a real BMS just ignores a frame it can't make sense of
+			if (options.verbose)
+				std::cerr << "ignored: " << requestText << std::endl;
+			continue;
+		}
+
+		uint8_t address = GetSimulatedRequestAddress(request);
+		SimulatedPack* pack = nullptr;
+		for (SimulatedPack& candidate : packs)
+		{
+			if (candidate.address == address)
+				pack = &candidate;
+		}
+		if (pack == nullptr)
+		{
+			if (options.verbose)
+				std::cerr << "no pack at address " << (int)address << ": " << requestText << std::endl;
+			continue;
+		}
+
+		std::vector<uint8_t> response = CreateSimulatedResponse(*pack, request, rng);
+
+		if (options.dropChance > 0 && chance(rng) < options.dropChance)
+		{
+			if (options.verbose)
+				std::cerr << "request: " << requestText << std::endl << "dropped" << std::endl;
+			continue;
+		}
+		if (options.corruptChance > 0 && chance(rng) < options.corruptChance)
+		{
+			// flip a bit in one of the hex characters between SOI and EOI so that the checksum no longer matches
+			size_t at = std::uniform_int_distribution<size_t>(1, response.size() - 2)(rng);
+			response[at] ^= 0x01;
+		}
+
+		if (options.verbose)
+			std::cerr << "request: " << requestText << std::endl << "response: " << std::string(response.begin(), response.end() - 1) << std::endl;
+
+		if (options.latencyMs > 0)
+			std::this_thread::sleep_for(std::chrono::milliseconds(options.latencyMs));
+		WritePaced(master, response);
+	}
+}
+
+static void Usage()
+{
+	std::cerr <<
+		"usage: simulate_pace_bms [options] [-- command {} args...]\n"
+		"  --address N        answer as a pack at bus address N, repeat for several packs on the same bus (default 1)\n"
+		"  --latency-ms N     wait N milliseconds before answering\n"
+		"  --baud N           pace the response bytes as if sent at N baud (default: no pacing)\n"
+		"  --drop P           don't answer, with probability P (0..1)\n"
+		"  --corrupt P        corrupt the answer, with probability P (0..1)\n"
+		"  --seed N           random seed, for repeatable runs\n"
+		"  --link PATH        also make the pseudo-terminal available as PATH (a symlink)\n"
+		"  --verbose          log every request and response to stderr\n"
+		"the pseudo-terminal's name is printed on stdout, it stays up until killed unless a command is given, in which \n"
+		"    case {} in the command is replaced with the name, and the exit code is the command's\n";
+}
+
+int main(int argc, char* argv[])
+{
+	int commandStart = -1;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--address" && hasValue)
+			options.addresses.push_back((uint8_t)atoi(argv[++i]));
+		else if (arg == "--latency-ms" && hasValue)
+			options.latencyMs = atoi(argv[++i]);
+		else if (arg == "--baud" && hasValue)
+			options.baudRate = atoi(argv[++i]);
+		else if (arg == "--drop" && hasValue)
+			options.dropChance = atof(argv[++i]);
+		else if (arg == "--corrupt" && hasValue)
+			options.corruptChance = atof(argv[++i]);
+		else if (arg == "--seed" && hasValue)
+			options.seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+		else if (arg == "--link" && hasValue)
+			options.link = argv[++i];
+		else if (arg == "--verbose")
+			options.verbose = true;
+		else if (arg == "--" && i + 1 < argc)
+		{
+			commandStart = i + 1;
+			break;
+		}
+		else
+		{
+			Usage();
+			return 2;
+		}
+	}
+	if (options.addresses.empty())
+		options.addresses.push_back(1);
+	for (uint8_t address : options.addresses)
+	{
+		SimulatedPack pack;
+		pack.address = address;
+		packs.push_back(pack);
+	}
+	rng.seed(options.seed);
+
+	int master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+	{
+		std::cerr << "Unable to open a pseudo-terminal" << std::endl;
+		return 1;
+	}
+	std::string slaveName = ptsname(master);
+
+	// holding the slave side open ourselves means the master side doesn't see a hangup every time a client disconnects,
+	//     and lets us put it in raw mode up front so that nothing gets echoed or translated before the client gets to it
+	int slave = open(slaveName.c_str(), O_RDWR | O_NOCTTY);
+	struct termios params;
+	if (slave < 0 || tcgetattr(slave, &params) != 0)
+	{
+		std::cerr << "Unable to open " << slaveName << std::endl;
+		return 1;
+	}
+	cfmakeraw(&params);
+	tcsetattr(slave, TCSANOW, &params);
+
+	if (!options.link.empty())
+	{
+		unlink(options.link.c_str());
+		if (symlink(slaveName.c_str(), options.link.c_str()) != 0)
+		{
+			std::cerr << "Unable to create " << options.link << std::endl;
+			return 1;
+		}
+	}
+
+	std::cout << slaveName << std::endl;
+
+	if (commandStart < 0)
+	{
+		RunBus(master);
+		return 0;
+	}
+
+	std::thread bus(RunBus, master);
+	bus.detach();
+
+	std::vector<std::string> command;
+	for (int i = commandStart; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		size_t at = arg.find("{}");
+		if (at != std::string::npos)
+			arg.replace(at, 2, slaveName);
+		command.push_back(arg);
+	}
+	std::vector<char*> commandArgv;
+	for (std::string& arg : command)
+		commandArgv.push_back(&arg[0]);
+	commandArgv.push_back(nullptr);
+
+	pid_t child = fork();
+	if (child == 0)
+	{
+		close(master);
+		close(slave);
+		execvp(commandArgv[0], commandArgv.data());
+		std::cerr << "Unable to run " << command[0] << std::endl;
+		_exit(127);
+	}
+	int status = 0;
+	waitpid(child, &status, 0);
+	if (!options.link.empty())
+		unlink(options.link.c_str());
+	return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
@@ -0,0 +1,255 @@
+// simulated_pack.cpp : see simulated_pack.h
+
+#include <cstring>
+#include "simulated_pack.h"
+#include "../../components/pace_bms/pace_bms_protocol_v25.h"
+#include "../../components/pace_bms/pace_bms_protocol_v20.h"
+
+struct ExampleExchange
+{
+	const uint8_t* request;
+	const uint8_t* response;
+};
+
+#define EXAMPLE_V25(name) { PaceBmsProtocolV25::example##name##RequestV25, PaceBmsProtocolV25::example##name##ResponseV25 }
+#define EXAMPLE_V20(name) { PaceBmsProtocolV20::example##name##RequestV20, PaceBmsProtocolV20::example##name##ResponseV20 }
+
+static const ExampleExchange exampleExchanges[] = {
+	EXAMPLE_V25(ReadAnalogInformation),
+	EXAMPLE_V25(ReadStatusInformation),
+	EXAMPLE_V25(ReadHardwareVersion),
+	EXAMPLE_V25(ReadSerialNumber),
+	EXAMPLE_V25(WriteDisableBuzzerSwitchCommand),
+	EXAMPLE_V25(WriteEnableBuzzerSwitchCommand),
+	EXAMPLE_V25(WriteDisableLedWarningSwitchCommand),
+	EXAMPLE_V25(WriteEnableLedWarningSwitchCommand),
+	EXAMPLE_V25(WriteDisableChargeCurrentLimiterSwitchCommand),
+	EXAMPLE_V25(WriteEnableChargeCurrentLimiterSwitchCommand),
+	EXAMPLE_V25(WriteSetChargeCurrentLimiterCurrentLimitLowGearSwitchCommand),
+	EXAMPLE_V25(WriteSetChargeCurrentLimiterCurrentLimitHighGearSwitchCommand),
+	EXAMPLE_V25(WriteMosfetChargeOpenSwitchCommand),
+	EXAMPLE_V25(WriteMosfetChargeCloseSwitchCommand),
+	// the discharge "open" example is the BMS refusing the command, leave that one for the harness
+	EXAMPLE_V25(WriteMosfetDischargeCloseSwitchCommand),
+	EXAMPLE_V25(WriteRebootCommand),
+	EXAMPLE_V25(ReadHistoryRecord),
+	EXAMPLE_V25(ReadSystemTime),
+	EXAMPLE_V25(WriteSystemTime),
+	EXAMPLE_V25(ReadCellOverVoltageConfiguration),
+	EXAMPLE_V25(WriteCellOverVoltageConfiguration),
+	EXAMPLE_V25(ReadPackOverVoltageConfiguration),
+	EXAMPLE_V25(WritePackOverVoltageConfiguration),
+	EXAMPLE_V25(ReadCellUnderVoltageConfiguration),
+	EXAMPLE_V25(WriteCellUnderVoltageConfiguration),
+	EXAMPLE_V25(ReadPackUnderVoltageConfiguration),
+	EXAMPLE_V25(WritePackUnderVoltageConfiguration),
+	EXAMPLE_V25(ReadChargeOverCurrentConfiguration),
+	EXAMPLE_V25(WriteChargeOverCurrentConfiguration),
+	EXAMPLE_V25(ReadDishargeOverCurrent1Configuration),
+	EXAMPLE_V25(WriteDishargeOverCurrent1Configuration),
+	EXAMPLE_V25(ReadDishargeOverCurrent2Configuration),
+	EXAMPLE_V25(WriteDishargeOverCurrent2Configuration),
+	EXAMPLE_V25(ReadShortCircuitProtectionConfiguration),
+	EXAMPLE_V25(WriteShortCircuitProtectionConfiguration),
+	EXAMPLE_V25(ReadCellBalancingConfiguration),
+	EXAMPLE_V25(WriteCellBalancingConfiguration),
+	EXAMPLE_V25(ReadSleepConfiguration),
+	EXAMPLE_V25(WriteSleepConfiguration),
+	EXAMPLE_V25(ReadFullChargeLowChargeConfiguration),
+	EXAMPLE_V25(WriteFullChargeLowChargeConfiguration),
+	EXAMPLE_V25(ReadChargeAndDischargeOverTemperatureConfiguration),
+	EXAMPLE_V25(WriteChargeAndDischargeOverTemperatureConfiguration),
+	EXAMPLE_V25(ReadChargeAndDischargeUnderTemperatureConfiguration),
+	EXAMPLE_V25(WriteChargeAndDischargeUnderTemperatureConfiguration),
+	EXAMPLE_V25(ReadMosfetOverTemperatureConfiguration),
+	EXAMPLE_V25(WriteMosfetOverTemperatureConfiguration),
+	EXAMPLE_V25(ReadEnvironmentOverUnderTemperatureConfiguration),
+	EXAMPLE_V25(WriteEnvironmentOverUnderTemperatureConfiguration),
+	EXAMPLE_V25(ReadChargeCurrentLimiterStartCurrent),
+	EXAMPLE_V25(WriteChargeCurrentLimiterStartCurrent),
+	EXAMPLE_V25(ReadRemainingCapacity),
+	EXAMPLE_V25(ReadProtocols),
+	EXAMPLE_V25(WriteProtocols),
+
+	EXAMPLE_V20(ReadAnalogInformation),
+	EXAMPLE_V20(ReadStatusInformation),
+	EXAMPLE_V20(ReadChargeDischargeManagementInformation),
+	EXAMPLE_V20(ReadHardwareVersion),
+	EXAMPLE_V20(ReadSystemTime),
+	EXAMPLE_V20(WriteSystemTime),
+};
+
+// offsets into a frame, see the "General format of requests/responses" in pace_bms_protocol_base.h
+static const int OFFSET_VER = 1;
+static const int OFFSET_ADR = 3;
+static const int OFFSET_CID1 = 5;
+static const int OFFSET_CID2 = 7;
+static const int OFFSET_INFO = 13;
+static const int FRAME_OVERHEAD = 18;
+
+static uint16_t ReadHex(const std::vector<uint8_t>& frame, int offset, int digits)
+{
+	uint16_t value = 0;
+	for (int i = 0; i < digits; i++)
+	{
+		uint8_t c = frame[offset + i];
+		value = (uint16_t)((value << 4) | (c >= 'A' ? c - 'A' + 10 : c - '0'));
+	}
+	return value;
+}
+
+static void WriteHex(std::vector<uint8_t>& frame, int offset, int digits, uint16_t value)
+{
+	static const char hex[] = "0123456789ABCDEF";
+	for (int i = digits - 1; i >= 0; i--)
+	{
+		frame[offset + i] = hex[value & 0x0F];
+		value >>= 4;
+	}
+}
+
+// the same as PaceBmsProtocolBase::CalculateRequestOrResponseChecksum, which isn't public
+static uint16_t CalculateChecksum(const std::vector<uint8_t>& frame)
+{
+	uint32_t cksum = 0;
+	for (int i = 1; i < (int)frame.size() - 5; i++)
+		cksum += frame[i];
+	return (uint16_t)((~cksum + 1) & 0xFFFF);
+}
+
+static void UpdateChecksum(std::vector<uint8_t>& frame)
+{
+	WriteHex(frame, (int)frame.size() - 5, 4, CalculateChecksum(frame));
+}
+
+// everything from VER through INFO matches, ignoring the address
+static bool RequestMatches(const std::vector<uint8_t>& request, const uint8_t* example, bool commandOnly)
+{
+	size_t exampleLen = strlen((const char*)example);
+	if (exampleLen < FRAME_OVERHEAD)
+		return false;
+	if (request[OFFSET_VER] != example[OFFSET_VER] || request[OFFSET_VER + 1] != example[OFFSET_VER + 1])
+		return false;
+	if (request[OFFSET_CID2] != example[OFFSET_CID2] || request[OFFSET_CID2 + 1] != example[OFFSET_CID2 + 1])
+		return false;
+	if (commandOnly)
+		return true;
+	return exampleLen == request.size() && 0 == memcmp(request.data() + OFFSET_CID1, example + OFFSET_CID1, exampleLen - 5 - OFFSET_CID1);
+}
+
+static int Wander(int value, int step, int limit, std::mt19937& rng)
+{
+	value += std::uniform_int_distribution<int>(-step, step)(rng);
+	return value < -limit ? -limit : value > limit ? limit : value;
+}
+
+// both the version 25 and the (PACE style) version 20 analog information responses start with a flag byte, the bus id,
+//     the cell count, the cell voltages, the temperature count, the temperatures, and then the current
+static void WanderAnalogInformation(SimulatedPack& pack, std::vector<uint8_t>& response, std::mt19937& rng)
+{
+	int offset = OFFSET_INFO + 4;
+	int cellCount = ReadHex(response, offset, 2);
+	offset += 2;
+	for (int i = 0; i < cellCount && i < 32; i++, offset += 4)
+	{
+		pack.cellOffsetsMillivolts[i] = (int16_t)Wander(pack.cellOffsetsMillivolts[i], 2, 20, rng);
+		WriteHex(response, offset, 4, (uint16_t)(ReadHex(response, offset, 4) + pack.cellOffsetsMillivolts[i]));
+	}
+	int temperatureCount = ReadHex(response, offset, 2);
+	offset += 2;
+	for (int i = 0; i < temperatureCount && i < 16; i++, offset += 4)
+	{
+		pack.temperatureOffsetsTenths[i] = (int16_t)Wander(pack.temperatureOffsetsTenths[i], 2, 30, rng);
+		WriteHex(response, offset, 4, (uint16_t)(ReadHex(response, offset, 4) + pack.temperatureOffsetsTenths[i]));
+	}
+	pack.currentOffsetCentiamps = (int16_t)Wander(pack.currentOffsetCentiamps, 20, 200, rng);
+	WriteHex(response, offset, 4, (uint16_t)((int16_t)ReadHex(response, offset, 4) + pack.currentOffsetCentiamps));
+}
+
+std::vector<uint8_t> CreateSimulatedResponse(SimulatedPack& pack, const std::vector<uint8_t>& request, std::mt19937& rng)
+{
+	const uint8_t* example = nullptr;
+	for (const ExampleExchange& exchange : exampleExchanges)
+	{
+		if (RequestMatches(request, exchange.request, false))
+		{
+			example = exchange.response;
+			break;
+		}
+	}
+	// a write with different values than the example, or a read of a different history record, gets the same answer
+	if (example == nullptr)
+	{
+		for (const ExampleExchange& exchange : exampleExchanges)
+		{
+			if (RequestMatches(request, exchange.request, true))
+			{
+				example = exchange.response;
+				break;
+			}
+		}
+	}
+
+	std::vector<uint8_t> response;
+	if (example != nullptr && strlen((const char*)example) >= FRAME_OVERHEAD)
+	{
+		response.assign(example, example + strlen((const char*)example));
+		if (ReadHex(request, OFFSET_CID2, 2) == 0x42)
+			WanderAnalogInformation(pack, response, rng);
+	}
+	else
+	{
+		// RTN 04: CID2 invalid
+		response = CreateSimulatedErrorResponse(request, pack.address, 0x04);
+	}
+
+	// answer as whoever was asked, which a few v25 responses also repeat in their payload
+	WriteHex(response, OFFSET_ADR, 2, pack.address);
+	if (response[OFFSET_VER] == '2' && response[OFFSET_VER + 1] == '5' && ReadHex(response, OFFSET_CID2, 2) == 0x00)
+	{
+		uint16_t cid2 = ReadHex(request, OFFSET_CID2, 2);
+		if ((cid2 == 0x42 || cid2 == 0x44) && response.size() >= FRAME_OVERHEAD + 4)
+			WriteHex(response, OFFSET_INFO + 2, 2, pack.address);
+		else if (cid2 == 0xED && response.size() >= FRAME_OVERHEAD + 2)
+			WriteHex(response, OFFSET_INFO, 2, pack.address);
+	}
+	response[OFFSET_CID1] = request[OFFSET_CID1];
+	response[OFFSET_CID1 + 1] = request[OFFSET_CID1 + 1];
+	UpdateChecksum(response);
+
+	return response;
+}
+
+std::vector<uint8_t> CreateSimulatedErrorResponse(const std::vector<uint8_t>& request, uint8_t address, uint8_t returnCode)
+{
+	std::vector<uint8_t> response((const uint8_t*)"~250046040000FDAB\r", (const uint8_t*)"~250046040000FDAB\r" + 18);
+	response[OFFSET_VER] = request[OFFSET_VER];
+	response[OFFSET_VER + 1] = request[OFFSET_VER + 1];
+	WriteHex(response, OFFSET_ADR, 2, address);
+	response[OFFSET_CID1] = request[OFFSET_CID1];
+	response[OFFSET_CID1 + 1] = request[OFFSET_CID1 + 1];
+	WriteHex(response, OFFSET_CID2, 2, returnCode);
+	UpdateChecksum(response);
+	return response;
+}
+
+void SetSimulatedResponseAddress(std::vector<uint8_t>& response, uint8_t address)
+{
+	WriteHex(response, OFFSET_ADR, 2, address);
+	UpdateChecksum(response);
+}
+
+void UpdateSimulatedResponseChecksum(std::vector<uint8_t>& response)
+{
+	UpdateChecksum(response);
+}
+
+bool IsSimulatedRequestValid(const std::vector<uint8_t>& request)
+{
+	return request.size() >= FRAME_OVERHEAD && ReadHex(request, (int)request.size() - 5, 4) == CalculateChecksum(request);
+}
+
+uint8_t GetSimulatedRequestAddress(const std::vector<uint8_t>& request)
+{
+	return (uint8_t)ReadHex(request, OFFSET_ADR, 2);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+// a pretend battery pack, shared by the pseudo-terminal simulator and anything else that needs a BMS on the other end of a
+//     bus without one being there (see: "Host ESPHome/host_uart.h")
+//
+// every command that has a known good example request / response in the protocol classes is answered using that example
+//     response as a template, the analog information response has its cell voltages, temperatures and current wandered
+//     around a bit on every poll so that the values aren't static, anything else gets the "CID2 invalid" error response
+//     a real BMS would send
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+struct SimulatedPack
+{
+	uint8_t address;
+	// how far each reading has wandered from the example response
+	int16_t cellOffsetsMillivolts[32]{ };
+	int16_t temperatureOffsetsTenths[16]{ };
+	int16_t currentOffsetCentiamps{ 0 };
+};
+
+// long enough to be a frame, and the checksum matches, a real BMS just ignores anything else
+bool IsSimulatedRequestValid(const std::vector<uint8_t>& request);
+
+// the bus address a (valid) request is for
+uint8_t GetSimulatedRequestAddress(const std::vector<uint8_t>& request);
+
+// the response pack would send to request, rng drives the wandering of the analog values
+std::vector<uint8_t> CreateSimulatedResponse(SimulatedPack& pack, const std::vector<uint8_t>& request, std::mt19937& rng);
+
+// what a pack at address sends back when it rejects request, with a non-zero RTN such as 0x04 (CID2 invalid)
+std::vector<uint8_t> CreateSimulatedErrorResponse(const std::vector<uint8_t>& request, uint8_t address, uint8_t returnCode);
+
+// the same response as though a different pack had sent it, only the header's address is changed
+void SetSimulatedResponseAddress(std::vector<uint8_t>& response, uint8_t address);
+
+// recalculates the frame checksum of a response that has been edited by hand
+void UpdateSimulatedResponseChecksum(std::vector<uint8_t>& response);
@@ -0,0 +1,325 @@
+// Soak PACE BMS.cpp : the whole ESPHome component with every entity configured (see: host_node.h) polling a simulated pack
+//     for hours of host clock, with the faults a real bus has injected into the pack's answers (see: SimulatedUart::Faults),
+//     so that scheduler and codec changes can be judged on how they hold up over a long run rather than a single cycle
+//
+// reported, for each simulated hour and for the whole run:
+//     frames/s        requests sent, and answered ok, per host clock second
+//     outcomes        the share of requests answered ok, timed out, or failed on checksum, return code, or anything else
+//     latency ms      from a request being written to the last byte of its answer being read, p50 / p99 / max
+//     heap bytes      live heap allocated by the component (not the host stand-in or the simulated pack), its high water
+//                     mark, and where it was at the end of the first hour and at the end, to show anything creeping up
+//     loop() us       wall clock time of each loop() call, mean and max
+//
+// every fault is injected into a different answer and should cost the hub exactly that one request, so a run fails if the
+//     hub lost any request that wasn't hit by a fault (or took a faulty answer for a good one), or if anything was logged
+//     at error other than the faulty answers that couldn't be decoded
+//     build/soak_pace_bms --hours 24 --noise 0.02 --seed 7
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include "host_esphome.h"
+#include "host_node.h"
+#include "host_uart.h"
+
+using namespace esphome;
+using namespace esphome::pace_bms;
+using host_esphome::HostNode;
+
+// ============================================================================
+// live heap of everything outside host_esphome::HostScope, each block carries its size (and whether it was counted) in a
+//     header so that it can be taken off again when it's freed
+static size_t liveBytes = 0;
+static size_t highWaterBytes = 0;
+static const size_t HEADER_SIZE = alignof(std::max_align_t) > 2 * sizeof(size_t) ? alignof(std::max_align_t) : 2 * sizeof(size_t);
+
+void* operator new(size_t size)
+{
+	uint8_t* block = (uint8_t*)malloc(HEADER_SIZE + size);
+	if (block == nullptr)
+		throw std::bad_alloc();
+	bool counted = !host_esphome::in_host_scope();
+	((size_t*)block)[0] = size;
+	((size_t*)block)[1] = counted ? 1 : 0;
+	if (counted)
+	{
+		liveBytes += size;
+		if (liveBytes > highWaterBytes)
+			highWaterBytes = liveBytes;
+	}
+	return block + HEADER_SIZE;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept
+{
+	if (p == nullptr)
+		return;
+	uint8_t* block = (uint8_t*)p - HEADER_SIZE;
+	if (((size_t*)block)[1] != 0)
+		liveBytes -= ((size_t*)block)[0];
+	free(block);
+}
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+// ============================================================================
+struct Options
+{
+	double hours = 1;
+	host_esphome::HostNodeSettings settings;
+	host_esphome::SimulatedUart::Faults faults;
+	uint32_t latencyMs = 20;
+	uint32_t loopIntervalMs = 16;
+	unsigned int seed = 1;
+};
+
+// what the hub did over some stretch of the run, from the difference between two sets of bus metrics
+struct Totals
+{
+	double hostSeconds = 0;
+	uint32_t requests = 0;
+	uint32_t ok = 0;
+	uint32_t timeouts = 0;
+	uint32_t checksumErrors = 0;
+	uint32_t returnCodeErrors = 0;
+	uint32_t otherErrors = 0;
+	std::vector<uint32_t> latencyUs;
+};
+
+static Totals Difference(const PaceBms::bus_metrics& before, const PaceBms::bus_metrics& after, double hostSeconds, std::vector<uint32_t>& latencyUs)
+{
+	Totals totals;
+	totals.hostSeconds = hostSeconds;
+	totals.requests = after.requests_sent_ - before.requests_sent_;
+	totals.ok = after.responses_ok_ - before.responses_ok_;
+	totals.timeouts = after.timeouts_ - before.timeouts_;
+	totals.checksumErrors = after.checksum_errors_ - before.checksum_errors_;
+	totals.returnCodeErrors = after.return_code_errors_ - before.return_code_errors_;
+	totals.otherErrors = after.other_errors_ - before.other_errors_;
+	totals.latencyUs.swap(latencyUs);
+	return totals;
+}
+
+static double Percent(uint32_t part, uint32_t whole) { return whole == 0 ? 0 : part * 100.0 / whole; }
+
+static double PercentileMs(std::vector<uint32_t>& values, double percent)
+{
+	if (values.empty())
+		return 0;
+	size_t index = (size_t)(values.size() * percent / 100.0);
+	if (index >= values.size())
+		index = values.size() - 1;
+	std::nth_element(values.begin(), values.begin() + index, values.end());
+	return values[index] / 1000.0;
+}
+
+static void PrintTotals(const char* label, Totals& t)
+{
+	uint32_t maxUs = t.latencyUs.empty() ? 0 : *std::max_element(t.latencyUs.begin(), t.latencyUs.end());
+	double p50 = PercentileMs(t.latencyUs, 50);
+	double p99 = PercentileMs(t.latencyUs, 99);
+	printf("%-10s %7.2f frames/s %7.2f ok/s   %6.2f%% ok %6.2f%% timeout %6.2f%% checksum %6.2f%% return code %6.2f%% other   latency ms %7.1f p50 %7.1f p99 %7.1f max   heap %7zu live %7zu high water\n",
+		label, t.requests / t.hostSeconds, t.ok / t.hostSeconds,
+		Percent(t.ok, t.requests), Percent(t.timeouts, t.requests), Percent(t.checksumErrors, t.requests), Percent(t.returnCodeErrors, t.requests), Percent(t.otherErrors, t.requests),
+		p50, p99, maxUs / 1000.0, liveBytes, highWaterBytes);
+}
+
+static void Usage()
+{
+	std::cerr <<
+		"usage: soak_pace_bms [options]\n"
+		"  --hours N                 simulated hours to run for (default 1)\n"
+		"  --noise N                 chance (0..1) of random bytes landing in an answer (default 0.01)\n"
+		"  --dropped-byte N          chance of a byte of an answer being lost (default 0.01)\n"
+		"  --wrong-address N         chance of an answer coming back from the wrong address (default 0.005)\n"
+		"  --return-code N           chance of the pack answering with an error return code (default 0.005)\n"
+		"  --latency-ms N            the simulated pack waits N milliseconds before answering (default 20)\n"
+		"  --commandset N            0x25 (default) or 0x20\n"
+		"  --variant NAME            the protocol_variant, for v20\n"
+		"  --update-interval-ms N    the hub's update_interval (default 10000)\n"
+		"  --request-throttle-ms N   the hub's request_throttle (default 50)\n"
+		"  --response-timeout-ms N   the hub's response_timeout (default 200)\n"
+		"  --loop-interval-ms N      time between loop() calls, ESPHome's default is 16\n"
+		"  --seed N                  for the faults and the pack's wandering values (default 1)\n"
+		"  --verbose                 show the component's log (at DEBUG) on stderr\n";
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	options.faults.noise = 0.01;
+	options.faults.dropped_byte = 0.01;
+	options.faults.wrong_address = 0.005;
+	options.faults.return_code = 0.005;
+	bool verbose = false;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--hours" && hasValue)
+			options.hours = atof(argv[++i]);
+		else if (arg == "--noise" && hasValue)
+			options.faults.noise = atof(argv[++i]);
+		else if (arg == "--dropped-byte" && hasValue)
+			options.faults.dropped_byte = atof(argv[++i]);
+		else if (arg == "--wrong-address" && hasValue)
+			options.faults.wrong_address = atof(argv[++i]);
+		else if (arg == "--return-code" && hasValue)
+			options.faults.return_code = atof(argv[++i]);
+		else if (arg == "--latency-ms" && hasValue)
+			options.latencyMs = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--commandset" && hasValue)
+			options.settings.commandset = (int)strtol(argv[++i], nullptr, 16);
+		else if (arg == "--variant" && hasValue)
+			options.settings.variant = argv[++i];
+		else if (arg == "--update-interval-ms" && hasValue)
+			options.settings.updateIntervalMs = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--request-throttle-ms" && hasValue)
+			options.settings.requestThrottleMs = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--response-timeout-ms" && hasValue)
+			options.settings.responseTimeoutMs = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--loop-interval-ms" && hasValue)
+			options.loopIntervalMs = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--seed" && hasValue)
+			options.seed = (unsigned int)atoi(argv[++i]);
+		else if (arg == "--verbose")
+			verbose = true;
+		else
+		{
+			Usage();
+			return 2;
+		}
+	}
+	if (options.settings.commandset != 0x25 && options.settings.commandset != 0x20)
+	{
+		Usage();
+		return 2;
+	}
+	if (options.loopIntervalMs < 1)
+		options.loopIntervalMs = 1;
+	if (options.settings.updateIntervalMs < options.loopIntervalMs)
+		options.settings.updateIntervalMs = options.loopIntervalMs;
+	// timeouts and the like are warnings and there will be plenty of them
+	host_esphome::set_log_level(verbose ? ESPHOME_LOG_LEVEL_DEBUG : ESPHOME_LOG_LEVEL_NONE);
+
+	std::vector<uint32_t> latencyUs;
+	std::vector<uint32_t> hourLatencyUs;
+	host_esphome::SimulatedUart* uart = new host_esphome::SimulatedUart();
+	uart->add_pack(options.settings.address);
+	uart->set_latency_ms(options.latencyMs);
+	uart->set_seed(options.seed);
+	uart->set_faults(options.faults);
+	uart->on_response_read = [&latencyUs, &hourLatencyUs](uint64_t us) {
+		latencyUs.push_back((uint32_t)us);
+		hourLatencyUs.push_back((uint32_t)us);
+	};
+	HostNode node;
+	node.Configure(uart, options.settings);
+
+	const uint64_t hourUs = 3600ull * 1000000;
+	const uint64_t intervalUs = (uint64_t)options.settings.updateIntervalMs * 1000;
+	const uint64_t startUs = host_esphome::now_us();
+	const uint64_t endUs = startUs + (uint64_t)(options.hours * hourUs);
+	// a faulty answer that gets as far as being decoded is logged at error, by the protocol and again by the hub, anything
+	//     else logged at error is something going wrong that the faults don't account for
+	uint32_t decodeErrors = 0;
+	uint32_t otherErrors = 0;
+	host_esphome::set_log_hook([&decodeErrors, &otherErrors](int level, const char* tag, const char* message) {
+		if (level != ESPHOME_LOG_LEVEL_ERROR)
+			return;
+		if (strcmp(tag, "pace_bms") == 0 && strncmp(message, "Unable to decode", 16) == 0)
+			decodeErrors++;
+		else if (strcmp(tag, "pace_bms_protocol") != 0)
+			otherErrors++;
+	});
+	auto wallStart = std::chrono::steady_clock::now();
+
+	// the bus metrics are only handed out at the top of each update(), so hours are counted in whole update intervals
+	uint64_t nextUpdateUs = startUs;
+	uint64_t hourStartUs = startUs;
+	int hour = 0;
+	PaceBms::bus_metrics start;
+	PaceBms::bus_metrics hourStart;
+	size_t firstHourLiveBytes = 0;
+	double loopSeconds = 0;
+	double loopMaxUs = 0;
+	uint64_t loops = 0;
+	while (true)
+	{
+		uint64_t now = host_esphome::now_us();
+		if (now >= nextUpdateUs)
+		{
+			node.hub.update();
+			nextUpdateUs += intervalUs;
+			if (now == startUs)
+			{
+				start = node.metrics;
+				hourStart = node.metrics;
+			}
+			else if (now - hourStartUs >= hourUs || now >= endUs)
+			{
+				host_esphome::HostScope scope;
+				hour++;
+				Totals totals = Difference(hourStart, node.metrics, (now - hourStartUs) / 1000000.0, hourLatencyUs);
+				PrintTotals(("hour " + std::to_string(hour)).c_str(), totals);
+				if (hour == 1)
+					firstHourLiveBytes = liveBytes;
+				hourStart = node.metrics;
+				hourStartUs = now;
+			}
+			if (now >= endUs)
+				break;
+		}
+
+		host_esphome::advance_ms(options.loopIntervalMs);
+		host_esphome::run_scheduler();
+		auto loopStart = std::chrono::steady_clock::now();
+		node.hub.loop();
+		double us = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - loopStart).count() / 1000.0;
+		loopSeconds += us / 1000000.0;
+		loopMaxUs = std::max(loopMaxUs, us);
+		loops++;
+	}
+	double wallSeconds = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - wallStart).count() / 1000000.0;
+	double hostSeconds = (host_esphome::now_us() - startUs) / 1000000.0;
+
+	host_esphome::HostScope scope;
+	Totals totals = Difference(start, node.metrics, hostSeconds, latencyUs);
+	const host_esphome::SimulatedUart::FaultCounts& faults = uart->get_fault_counts();
+	PrintTotals("total", totals);
+	printf("%-10s %.1f h of host clock in %.2f s of wall clock (%.0fx), loop() %.2f us mean %.2f us max\n", "time", hostSeconds / 3600, wallSeconds, wallSeconds > 0 ? hostSeconds / wallSeconds : 0.0, loops != 0 ? loopSeconds * 1000000.0 / loops : 0.0, loopMaxUs);
+	printf("%-10s %u noise, %u dropped byte, %u wrong address, %u return code, in %u answers\n", "faults", (unsigned)faults.noise, (unsigned)faults.dropped_byte, (unsigned)faults.wrong_address, (unsigned)faults.return_code, (unsigned)uart->get_response_count());
+	printf("%-10s %zu high water, %zu after the first hour, %zu at the end\n", "heap bytes", highWaterBytes, firstHourLiveBytes, liveBytes);
+
+	bool ok = true;
+	if (totals.requests == 0)
+	{
+		std::cerr << "FAIL: no requests were sent" << std::endl;
+		ok = false;
+	}
+	// the counts are over whole update intervals and so are the faults, near enough, the last interval's answers are all
+	//     in by the time of the final update()
+	if (totals.ok + faults.total() != totals.requests)
+	{
+		std::cerr << "FAIL: " << totals.requests << " requests, " << totals.ok << " ok and " << faults.total() << " faults injected, every request should have been one or the other" << std::endl;
+		ok = false;
+	}
+	if (decodeErrors > faults.total())
+	{
+		std::cerr << "FAIL: " << decodeErrors << " answers couldn't be decoded but only " << faults.total() << " faults were injected" << std::endl;
+		ok = false;
+	}
+	if (otherErrors != 0)
+	{
+		std::cerr << "FAIL: logged " << otherErrors << " errors other than answers that couldn't be decoded, run with --verbose to see them" << std::endl;
+		ok = false;
+	}
+	return ok ? 0 : 1;
+}
@@ -1,10 +1,20 @@
 // Test PACE BMS.cpp : This file contains the 'main' function. Program execution begins and ends there.
 //
 
+#ifdef _WIN32
 #include <windows.h>
+#else
+// POSIX build, see CMakeLists.txt
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <thread>
+#endif
+#include <cstring>
 #include <iostream>
 #include <sstream>
-#include "..\..\components\pace_bms\pace_bms_protocol_v25.h"
+#include "../../components/pace_bms/pace_bms_protocol_v25.h"
+#include "../../components/pace_bms/pace_bms_protocol_modbus.h"
 
 
 std::ostringstream error;
@@ -52,7 +62,7 @@ void VeryVerboseLogFunc(std::string message)
 
 void BasicTests()
 {
-	PaceBmsProtocolV25* paceBms = new PaceBmsProtocolV25(PaceBmsProtocolV25::CID1_LithiumIron, &ErrorLogFunc, &WarningLogFunc, &InfoLogFunc, &DebugLogFunc, &VerboseLogFunc, &VeryVerboseLogFunc);
+	PaceBmsProtocolV25* paceBms = new PaceBmsProtocolV25(OPTIONAL_NS::nullopt, OPTIONAL_NS::nullopt, PaceBmsProtocolV25::CID1_LithiumIron, &ErrorLogFunc, &WarningLogFunc, &InfoLogFunc, &DebugLogFunc, &VerboseLogFunc, &VeryVerboseLogFunc);
 	std::vector<uint8_t> buffer;
 	bool res;
 
@@ -976,7 +986,7 @@ void BasicTests()
 	veryVerbose.str("");
 
 	type = PaceBmsProtocolV25::MT_Discharge;
-	typeAsText = "MT_Charge";
+	typeAsText = "MT_Discharge";
 	state = PaceBmsProtocolV25::MS_Open;
 	stateAsText = "MS_Open";
 
@@ -1010,13 +1020,14 @@ void BasicTests()
 		std::vector<uint8_t>(
 			PaceBmsProtocolV25::exampleWriteMosfetDischargeOpenSwitchCommandResponseV25,
 			PaceBmsProtocolV25::exampleWriteMosfetDischargeOpenSwitchCommandResponseV25 + exlen));
-	if (error.str().length() != 0 || warning.str().length() != 0 || info.str().length() != 0)
+	// this capture is the BMS refusing the command (RTN 09), so it should be reported as an error and rejected
+	if (error.str().length() == 0 || warning.str().length() != 0 || info.str().length() != 0)
 	{
-		std::cout << "FAIL: ProcessWriteMosfetSwitchCommandResponse (" + typeAsText + "/" + stateAsText + ") logged something above verbose" << std::endl;
+		std::cout << "FAIL: ProcessWriteMosfetSwitchCommandResponse (" + typeAsText + "/" + stateAsText + ") did not log the error code returned by the device" << std::endl;
 	}
-	else if (res != true)
+	else if (res != false)
 	{
-		std::cout << "FAIL: ProcessWriteMosfetSwitchCommandResponse (" + typeAsText + "/" + stateAsText + ") returned false" << std::endl;
+		std::cout << "FAIL: ProcessWriteMosfetSwitchCommandResponse (" + typeAsText + "/" + stateAsText + ") returned true" << std::endl;
 	}
 	else
 	{
@@ -1031,7 +1042,7 @@ void BasicTests()
 	veryVerbose.str("");
 
 	type = PaceBmsProtocolV25::MT_Discharge;
-	typeAsText = "MT_Charge";
+	typeAsText = "MT_Discharge";
 	state = PaceBmsProtocolV25::MS_Close;
 	stateAsText = "MS_Close";
 
@@ -1169,6 +1180,65 @@ void BasicTests()
 	//                20.2	20.3	20.5	20.4	19.9	20.7
 	// resp:  ~250046000000FDAF.
 	//            this means "no more records available"
+	// resp:  ~250046070000FDA8.
+	//            some firmwares return RTN 0x07 "No Data (historical record)" instead, which is only to be believed from a frame 
+	//            that is otherwise valid
+
+	{
+		const char* endResponses[] = { "~250046000000FDAF\r", "~250046070000FDA8\r" };
+		for (const char* endResponse : endResponses)
+		{
+			error.str("");
+			warning.str("");
+			info.str("");
+			debug.str("");
+			verbose.str("");
+			veryVerbose.str("");
+
+			PaceBmsProtocolV25::HistoryRecord record;
+			bool endOfHistory = false;
+			res = paceBms->ProcessReadHistoryRecordResponse(0, std::vector<uint8_t>(endResponse, endResponse + strlen(endResponse)), record, endOfHistory);
+			std::string rtn = std::string(endResponse + 7, 2);
+			if (error.str().length() != 0 || warning.str().length() != 0 || info.str().length() != 0)
+			{
+				std::cout << "FAIL: ProcessReadHistoryRecordResponse (end of history, RTN " + rtn + ") logged something above verbose" << std::endl;
+			}
+			else if (res != true || endOfHistory != true)
+			{
+				std::cout << "FAIL: ProcessReadHistoryRecordResponse (end of history, RTN " + rtn + ") was not taken as the end of the history" << std::endl;
+			}
+			else
+			{
+				std::cout << "PASS: ProcessReadHistoryRecordResponse (end of history, RTN " + rtn + ")" << std::endl;
+			}
+		}
+
+		// RTN 0x07 with a bad frame checksum, or from a different bus id, must not be taken as the end of the history
+		const char* badEndResponses[] = { "~250046070000FDA9\r", "~250246070000FDA6\r" };
+		const PaceBmsProtocolBase::ResponseValidationResult badEndResults[] = { PaceBmsProtocolBase::RVR_ChecksumError, PaceBmsProtocolBase::RVR_WrongDevice };
+		const char* badEndNames[] = { "bad checksum", "wrong bus id" };
+		for (int i = 0; i < 2; i++)
+		{
+			error.str("");
+
+			PaceBmsProtocolV25::HistoryRecord record;
+			record.cellCount = 0xAA;
+			bool endOfHistory = false;
+			res = paceBms->ProcessReadHistoryRecordResponse(0, std::vector<uint8_t>(badEndResponses[i], badEndResponses[i] + strlen(badEndResponses[i])), record, endOfHistory);
+			if (res != false || endOfHistory != false || record.cellCount != 0xAA)
+			{
+				std::cout << "FAIL: ProcessReadHistoryRecordResponse (RTN 07 with " + std::string(badEndNames[i]) + ") was accepted" << std::endl;
+			}
+			else if (paceBms->GetLastResponseValidationResult() != badEndResults[i] || error.str().length() == 0)
+			{
+				std::cout << "FAIL: ProcessReadHistoryRecordResponse (RTN 07 with " + std::string(badEndNames[i]) + ") was not rejected for the right reason" << std::endl;
+			}
+			else
+			{
+				std::cout << "PASS: ProcessReadHistoryRecordResponse (RTN 07 with " + std::string(badEndNames[i]) + ")" << std::endl;
+			}
+		}
+	}
 
 
 	// -------- NOT IMPLEMENTED --------
@@ -3169,43 +3239,543 @@ void BasicTests()
 	// none of which I am exposing because it would be a Very Bad Idea to mess with them
 }
 
-bool WriteSerial(HANDLE hComPort, unsigned char* buffer, int bufferLen)
+// MODBUS frames are binary so the examples can't be measured with strlen, responses carry their own length and a read
+//     request is always 8 bytes
+std::vector<uint8_t> ModbusResponse(const uint8_t* frame)
 {
-	DWORD dwBytesWritten;
-	bool success = WriteFile(hComPort, buffer, bufferLen, &dwBytesWritten, NULL);
+	return std::vector<uint8_t>(frame, frame + PaceBmsProtocolModbus::GetResponseFrameLength(frame, 3));
+}
 
-	if (dwBytesWritten != bufferLen)
-		return false;
+// the standard MODBUS CRC16, for building block responses out of the examples
+uint16_t ModbusCrc(const std::vector<uint8_t>& frame)
+{
+	uint16_t crc = 0xFFFF;
+	for (uint8_t b : frame)
+	{
+		crc ^= b;
+		for (int bit = 0; bit < 8; bit++)
+			crc = (crc & 1) != 0 ? (crc >> 1) ^ 0xA001 : crc >> 1;
+	}
+	return crc;
+}
 
-	return true;
+bool ModbusRequestMatches(const std::vector<uint8_t>& request, const uint8_t* example)
+{
+	// write multiple registers: ADR, 0x10, START, COUNT, BYTECOUNT, DATA..., CRC
+	size_t exlen = example[1] == 0x10 ? 9 + example[6] : 8;
+	return request.size() == exlen && 0 == memcmp(request.data(), example, exlen);
 }
 
-int ReadSerialUntilTerminator(HANDLE hComPort, unsigned char* buffer, int bufferLen, char terminator)
+void ModbusTests()
 {
-	int offset = 0;
-	while (buffer[offset - 1] != terminator && bufferLen - offset > 0)
+	PaceBmsProtocolModbus* paceBms = new PaceBmsProtocolModbus(OPTIONAL_NS::nullopt, OPTIONAL_NS::nullopt, OPTIONAL_NS::nullopt, &ErrorLogFunc, &WarningLogFunc, &InfoLogFunc, &DebugLogFunc, &VerboseLogFunc, &VeryVerboseLogFunc);
+	std::vector<uint8_t> buffer;
+	bool res;
+
+	// ==== Read Analog Information (MODBUS)
+	// req:   01 03 0000 0025 8411
+	// resp:  01 03 4A FF1F 1473 003F 0064 183C 286A 2710 008C 0000 0001 0000 0E00 0000 0000 0000 0CC7 0CC8 0CC7 0CC7 0CC7 0CC5 0CC6 0CC7 0CC7 0CC6 0CC7 0CC6 0CC6 0CC7 0CC6 0CC7 00FB 00F9 00F9 00F9 0113 011C 15A4
+
+	error.str("");
+	warning.str("");
+	info.str("");
+	debug.str("");
+	verbose.str("");
+	veryVerbose.str("");
+
+	paceBms->CreateReadAnalogInformationRequest(1, buffer);
+	if (error.str().length() != 0 || warning.str().length() != 0 || info.str().length() != 0)
 	{
-		DWORD dwBytesRead;
-		bool success = ReadFile(hComPort, buffer + offset, 1, &dwBytesRead, NULL);
-		if (!success)
-			return -1;
-		if (dwBytesRead == 0)
-			return -1;
+		std::cout << "FAIL: CreateReadAnalogInformationRequest (MODBUS) logged something above verbose" << std::endl;
+	}
+	else if (!ModbusRequestMatches(buffer, PaceBmsProtocolModbus::exampleReadAnalogInformationRequestModbus))
+	{
+		std::cout << "FAIL: CreateReadAnalogInformationRequest (MODBUS) created a different request than the known good example" << std::endl;
+	}
+	else
+	{
+		std::cout << "PASS: CreateReadAnalogInformationRequest (MODBUS)" << std::endl;
+	}
 
-		offset += dwBytesRead;
+	error.str("");
+	warning.str("");
+	info.str("");
+	debug.str("");
+	verbose.str("");
+	veryVerbose.str("");
+
+	PaceBmsProtocolModbus::AnalogInformation analogInfo;
+	res = paceBms->ProcessReadAnalogInformationResponse(1, ModbusResponse(PaceBmsProtocolModbus::exampleReadAnalogInformationResponseModbus), analogInfo);
+	if (error.str().length() != 0 || warning.str().length() != 0 || info.str().length() != 0)
+	{
+		std::cout << "FAIL: ProcessReadAnalogInformationResponse (MODBUS) logged something above verbose" << std::endl;
+	}
+	else if (res != true)
+	{
+		std::cout << "FAIL: ProcessReadAnalogInformationResponse (MODBUS) returned false" << std::endl;
+	}
+	else if (
+		analogInfo.cellCount != 16 ||
+		analogInfo.cellVoltagesMillivolts[0] != 3271 ||
+		analogInfo.cellVoltagesMillivolts[1] != 3272 ||
+		analogInfo.cellVoltagesMillivolts[5] != 3269 ||
+		analogInfo.cellVoltagesMillivolts[15] != 3271 ||
+		analogInfo.temperatureCount != 6 ||
+		analogInfo.temperaturesTenthsCelcius[0] != 251 ||
+		analogInfo.temperaturesTenthsCelcius[1] != 249 ||
+		analogInfo.temperaturesTenthsCelcius[4] != 275 ||
+		analogInfo.temperaturesTenthsCelcius[5] != 284 ||
+		analogInfo.currentMilliamps != -2250 ||
+		analogInfo.totalVoltageMillivolts != 52350 ||
+		analogInfo.remainingCapacityMilliampHours != 62040 ||
+		analogInfo.fullCapacityMilliampHours != 103460 ||
+		analogInfo.cycleCount != 140 ||
+		analogInfo.designCapacityMilliampHours != 100000 ||
+		analogInfo.SoC != 63.0f ||
+		analogInfo.SoH != 100.0f ||
+		analogInfo.powerWatts != -117.787506f ||
+		analogInfo.minCellVoltageMillivolts != 3269 ||
+		analogInfo.maxCellVoltageMillivolts != 3272 ||
+		analogInfo.avgCellVoltageMillivolts != 3270 ||
+		analogInfo.maxCellDifferentialMillivolts != 3
+		)
+	{
+		std::cout << "FAIL: ProcessReadAnalogInformationResponse (MODBUS) did not accurately decode the known good example" << std::endl;
+	}
+	else
+	{
+		std::cout << "PASS: ProcessReadAnalogInformationResponse (MODBUS)" << std::endl;
 	}
 
-	return offset;
+	// ==== Read Status Information (MODBUS)
+	// req:   01 03 0009 0004 940B
+	// resp:  01 03 08 0001 0000 0E00 0000 87FF
+
+	error.str("");
+	warning.str("");
+	info.str("");
+	debug.str("");
+	verbose.str("");
+	veryVerbose.str("");
+
+	paceBms->CreateReadStatusInformationRequest(1, buffer);
+	if (error.str().length() != 0 || warning.str().length() != 0 || info.str().length() != 0)
+	{
+		std::cout << "FAIL: CreateReadStatusInformationRequest (MODBUS) logged something above verbose" << std::endl;
+	}
+	else if (!ModbusRequestMatches(buffer, PaceBmsProtocolModbus::exampleReadStatusInformationRequestModbus))
+	{
+		std::cout << "FAIL: CreateReadStatusInformationRequest (MODBUS) created a different request than the known good example" << std::endl;
+	}
+	else
+	{
+		std::cout << "PASS: CreateReadStatusInformationRequest (MODBUS)" << std::endl;
+	}
+
+	error.str("");
+	warning.str("");
+	info.str("");
+	debug.str("");
+	verbose.str("");
+	veryVerbose.str("");
+
+	PaceBmsProtocolModbus::StatusInformation statusInformation;
+	res = paceBms->ProcessReadStatusInformationResponse(1, ModbusResponse(PaceBmsProtocolModbus::exampleReadStatusInformationResponseModbus), statusInformation);
+	if (error.str().length() != 0 || warning.str().length() != 0 || info.str().length() != 0)
+	{
+		std::cout << "FAIL: ProcessReadStatusInformationResponse (MODBUS) logged something above verbose" << std::endl;
+	}
+	else if (res != true)
+	{
+		std::cout << "FAIL: ProcessReadStatusInformationResponse (MODBUS) returned false" << std::endl;
+	}
+	else if (statusInformation.warning_value1 != 0x01 || statusInformation.warning_value2 != 0 ||
+		statusInformation.protection_value1 != 0 || statusInformation.protection_value2 != 0 || statusInformation.fault_value != 0 ||
+		statusInformation.balancing_value != 0 || statusInformation.warningText.compare("High Cell Voltage Warning") != 0 || statusInformation.balancingText.length() != 0 ||
+		statusInformation.systemText.compare("Discharging; Discharge MOSFET On; Charge MOSFET On; Charge Current Limiter Disabled") != 0 ||
+		statusInformation.configurationText.length() != 0 || statusInformation.protectionText.length() != 0 || statusInformation.faultText.length() != 0)
+	{
+		std::cout << "FAIL: ProcessReadStatusInformationResponse (MODBUS) did not accurately decode the known good example" << std::endl;
+	}
+	else
+	{
+		std::cout << "PASS: ProcessReadStatusInformationResponse (MODBUS)" << std::endl;
+	}
+
+	// ==== Read Hardware Version (MODBUS)
+	// req:   01 03 0096 000A 25E1
+	// resp:  01 03 14 5031 3653 3130 3041 2D31 3831 322D 312E 3030 2000 DD76
+
+	error.str("");
+	warning.str("");
+	info.str("");
+	debug.str("");
+	verbose.str("");
+	veryVerbose.str("");
+
+	paceBms->CreateReadHardwareVersionRequest(1, buffer);
+	if (error.str().length() != 0 || warning.str().length() != 0 || info.str().length() != 0)
+	{
+		std::cout << "FAIL: CreateReadHardwareVersionRequest (MODBUS) logged something above verbose" << std::endl;
+	}
+	else if (!ModbusRequestMatches(buffer, PaceBmsProtocolModbus::exampleReadHardwareVersionRequestModbus))
+	{
+		std::cout << "FAIL: CreateReadHardwareVersionRequest (MODBUS) created a different request than the known good example" << std::endl;
+	}
+	else
+	{
+		std::cout << "PASS: CreateReadHardwareVersionRequest (MODBUS)" << std::endl;
+	}
+
+	error.str("");
+	warning.str("");
+	info.str("");
+	debug.str("");
+	verbose.str("");
+	veryVerbose.str("");
+
+	std::string hardwareVersion;
+	res = paceBms->ProcessReadHardwareVersionResponse(1, ModbusResponse(PaceBmsProtocolModbus::exampleReadHardwareVersionResponseModbus), hardwareVersion);
+	if (error.str().length() != 0 || warning.str().length() != 0 || info.str().length() != 0)
+	{
+		std::cout << "FAIL: ProcessReadHardwareVersionResponse (MODBUS) logged something above verbose" << std::endl;
+	}
+	else if (res != true)
+	{
+		std::cout << "FAIL: ProcessReadHardwareVersionResponse (MODBUS) returned false" << std::endl;
+	}
+	else if (hardwareVersion.compare("P16S100A-1812-1.00") != 0)
+	{
+		std::cout << "FAIL: ProcessReadHardwareVersionResponse (MODBUS) did not accurately decode the known good example" << std::endl;
+	}
+	else
+	{
+		std::cout << "PASS: ProcessReadHardwareVersionResponse (MODBUS)" << std::endl;
+	}
+
+	// ==== Read Serial Number (MODBUS)
+	// req:   01 03 00A0 000A C5EF
+	// resp:  01 03 14 3138 3132 3130 3133 3830 3330 3944 2020 2020 2020 A548
+
+	error.str("");
+	warning.str("");
+	info.str("");
+	debug.str("");
+	verbose.str("");
+	veryVerbose.str("");
+
+	paceBms->CreateReadSerialNumberRequest(1, buffer);
+	if (error.str().length() != 0 || warning.str().length() != 0 || info.str().length() != 0)
+	{
+		std::cout << "FAIL: CreateReadSerialNumberRequest (MODBUS) logged something above verbose" << std::endl;
+	}
+	else if (!ModbusRequestMatches(buffer, PaceBmsProtocolModbus::exampleReadSerialNumberRequestModbus))
+	{
+		std::cout << "FAIL: CreateReadSerialNumberRequest (MODBUS) created a different request than the known good example" << std::endl;
+	}
+	else
+	{
+		std::cout << "PASS: CreateReadSerialNumberRequest (MODBUS)" << std::endl;
+	}
+
+	error.str("");
+	warning.str("");
+	info.str("");
+	debug.str("");
+	verbose.str("");
+	veryVerbose.str("");
+
+	std::string serialNumber;
+	res = paceBms->ProcessReadSerialNumberResponse(1, ModbusResponse(PaceBmsProtocolModbus::exampleReadSerialNumberResponseModbus), serialNumber);
+	if (error.str().length() != 0 || warning.str().length() != 0 || info.str().length() != 0)
+	{
+		std::cout << "FAIL: ProcessReadSerialNumberResponse (MODBUS) logged something above verbose" << std::endl;
+	}
+	else if (res != true)
+	{
+		std::cout << "FAIL: ProcessReadSerialNumberResponse (MODBUS) returned false" << std::endl;
+	}
+	else if (serialNumber.compare("1812101380309D") != 0)
+	{
+		std::cout << "FAIL: ProcessReadSerialNumberResponse (MODBUS) did not accurately decode the known good example" << std::endl;
+	}
+	else
+	{
+		std::cout << "PASS: ProcessReadSerialNumberResponse (MODBUS)" << std::endl;
+	}
+
+	// ==== Cell Over Voltage Configuration (MODBUS)
+	// read:  01 03 0040 0004 45DD
+	// resp:  01 03 08 0E10 0E74 0D34 000A 77DA
+	// write: 01 10 0040 0004 08 0E10 0E74 0D34 000A 5548
+	// resp:  01 10 0040 0004 C01E
+
+	error.str("");
+	warning.str("");
+	info.str("");
+	debug.str("");
+	verbose.str("");
+	veryVerbose.str("");
+
+	std::string configTypeString = "RC_CellOverVoltage";
+
+	paceBms->CreateReadConfigurationRequest(1, PaceBmsProtocolModbus::RC_CellOverVoltage, buffer);
+	if (error.str().length() != 0 || warning.str().length() != 0 || info.str().length() != 0)
+	{
+		std::cout << "FAIL: CreateReadConfigurationRequest (MODBUS " + configTypeString + ") logged something above verbose" << std::endl;
+	}
+	else if (!ModbusRequestMatches(buffer, PaceBmsProtocolModbus::exampleReadCellOverVoltageConfigurationRequestModbus))
+	{
+		std::cout << "FAIL: CreateReadConfigurationRequest (MODBUS " + configTypeString + ") created a different request than the known good example" << std::endl;
+	}
+	else
+	{
+		std::cout << "PASS: CreateReadConfigurationRequest (MODBUS " + configTypeString + ")" << std::endl;
+	}
+
+	error.str("");
+	warning.str("");
+	info.str("");
+	debug.str("");
+	verbose.str("");
+	veryVerbose.str("");
+
+	PaceBmsProtocolModbus::CellOverVoltageConfiguration cellOverVoltageConfig;
+	res = paceBms->ProcessReadConfigurationResponse(1, ModbusResponse(PaceBmsProtocolModbus::exampleReadCellOverVoltageConfigurationResponseModbus), cellOverVoltageConfig);
+	if (error.str().length() != 0 || warning.str().length() != 0 || info.str().length() != 0)
+	{
+		std::cout << "FAIL: ProcessReadConfigurationResponse (MODBUS " + configTypeString + ") logged something above verbose" << std::endl;
+	}
+	else if (res != true)
+	{
+		std::cout << "FAIL: ProcessReadConfigurationResponse (MODBUS " + configTypeString + ") returned false" << std::endl;
+	}
+	else if (cellOverVoltageConfig.AlarmMillivolts != 3600 ||
+		cellOverVoltageConfig.ProtectionMillivolts != 3700 ||
+		cellOverVoltageConfig.ProtectionReleaseMillivolts != 3380 ||
+		cellOverVoltageConfig.ProtectionDelayMilliseconds != 1000)
+	{
+		std::cout << "FAIL: ProcessReadConfigurationResponse (MODBUS " + configTypeString + ") did not accurately decode the known good example" << std::endl;
+	}
+	else
+	{
+		std::cout << "PASS: ProcessReadConfigurationResponse (MODBUS " + configTypeString + ")" << std::endl;
+	}
+
+	error.str("");
+	warning.str("");
+	info.str("");
+	debug.str("");
+	verbose.str("");
+	veryVerbose.str("");
+
+	// writing back what was just read has to produce the same registers
+	paceBms->CreateWriteConfigurationRequest(1, cellOverVoltageConfig, buffer);
+	if (error.str().length() != 0 || warning.str().length() != 0 || info.str().length() != 0)
+	{
+		std::cout << "FAIL: CreateWriteConfigurationRequest (MODBUS " + configTypeString + ") logged something above verbose" << std::endl;
+	}
+	else if (!ModbusRequestMatches(buffer, PaceBmsProtocolModbus::exampleWriteCellOverVoltageConfigurationRequestModbus))
+	{
+		std::cout << "FAIL: CreateWriteConfigurationRequest (MODBUS " + configTypeString + ") created a different request than the known good example" << std::endl;
+	}
+	else
+	{
+		std::cout << "PASS: CreateWriteConfigurationRequest (MODBUS " + configTypeString + ")" << std::endl;
+	}
+
+	error.str("");
+	warning.str("");
+	info.str("");
+	debug.str("");
+	verbose.str("");
+	veryVerbose.str("");
+
+	res = paceBms->ProcessWriteConfigurationResponse(1, ModbusResponse(PaceBmsProtocolModbus::exampleWriteCellOverVoltageConfigurationResponseModbus));
+	if (error.str().length() != 0 || warning.str().length() != 0 || info.str().length() != 0)
+	{
+		std::cout << "FAIL: ProcessWriteConfigurationResponse (MODBUS " + configTypeString + ") logged something above verbose" << std::endl;
+	}
+	else if (res != true)
+	{
+		std::cout << "FAIL: ProcessWriteConfigurationResponse (MODBUS " + configTypeString + ") returned false" << std::endl;
+	}
+	else
+	{
+		std::cout << "PASS: ProcessWriteConfigurationResponse (MODBUS " + configTypeString + ")" << std::endl;
+	}
+
+	// ==== Read planning (MODBUS)
+	// ranges are merged in register order, through gaps of up to maxGap registers, into blocks of at most maxRegisters
+
+	typedef PaceBmsProtocolModbus::RegisterRange RegisterRange;
+	typedef PaceBmsProtocolModbus::ReadBlock ReadBlock;
+	std::vector<ReadBlock> blocks;
+
+	// the analog block (0-36) and the pack over voltage configuration (60-63) are 23 registers apart
+	blocks = PaceBmsProtocolModbus::PlanReadBlocks({ { 60, 4 }, { 0, 37 } }, 125, 23);
+	if (blocks.size() != 1 || blocks[0].range.firstRegister != 0 || blocks[0].range.registerCount != 64 ||
+		blocks[0].members.size() != 2 || blocks[0].members[0] != 1 || blocks[0].members[1] != 0)
+	{
+		std::cout << "FAIL: PlanReadBlocks (MODBUS) did not read through a gap of maxGap registers" << std::endl;
+	}
+	else if (PaceBmsProtocolModbus::PlanReadBlocks({ { 60, 4 }, { 0, 37 } }, 125, 22).size() != 2)
+	{
+		std::cout << "FAIL: PlanReadBlocks (MODBUS) read through a gap of more than maxGap registers" << std::endl;
+	}
+	else
+	{
+		std::cout << "PASS: PlanReadBlocks (MODBUS gap)" << std::endl;
+	}
+
+	// pack over voltage (60-63) and cell over voltage (64-67) fill 8 registers, pack under voltage (68-71) would go past it
+	blocks = PaceBmsProtocolModbus::PlanReadBlocks({ { 60, 4 }, { 64, 4 }, { 68, 4 } }, 8, 10);
+	if (blocks.size() != 2 || blocks[0].range.firstRegister != 60 || blocks[0].range.registerCount != 8 || blocks[0].members.size() != 2 ||
+		blocks[1].range.firstRegister != 68 || blocks[1].range.registerCount != 4 || blocks[1].members.size() != 1 || blocks[1].members[0] != 2)
+	{
+		std::cout << "FAIL: PlanReadBlocks (MODBUS) did not keep blocks to maxRegisters" << std::endl;
+	}
+	else
+	{
+		std::cout << "PASS: PlanReadBlocks (MODBUS maxRegisters)" << std::endl;
+	}
+
+	// the status registers (9-12) sit inside the analog block, reading both costs nothing extra
+	blocks = PaceBmsProtocolModbus::PlanReadBlocks({ { 9, 4 }, { 0, 37 } }, 125, 0);
+	if (blocks.size() != 1 || blocks[0].range.firstRegister != 0 || blocks[0].range.registerCount != 37 ||
+		blocks[0].members.size() != 2 || blocks[0].members[0] != 1 || blocks[0].members[1] != 0)
+	{
+		std::cout << "FAIL: PlanReadBlocks (MODBUS) did not fold an overlapping range into the block around it" << std::endl;
+	}
+	else
+	{
+		std::cout << "PASS: PlanReadBlocks (MODBUS overlap)" << std::endl;
+	}
+
+	// a range larger than maxRegisters is still read, on its own, and nothing is added to it
+	blocks = PaceBmsProtocolModbus::PlanReadBlocks({ { 0, 37 }, { 40, 4 } }, 16, 10);
+	if (blocks.size() != 2 || blocks[0].range.firstRegister != 0 || blocks[0].range.registerCount != 37 || blocks[0].members.size() != 1 ||
+		blocks[1].range.firstRegister != 40 || blocks[1].range.registerCount != 4)
+	{
+		std::cout << "FAIL: PlanReadBlocks (MODBUS) did not give a range larger than maxRegisters a block of its own" << std::endl;
+	}
+	else
+	{
+		std::cout << "PASS: PlanReadBlocks (MODBUS range larger than maxRegisters)" << std::endl;
+	}
+
+	error.str("");
+	warning.str("");
+	info.str("");
+	debug.str("");
+	verbose.str("");
+	veryVerbose.str("");
+
+	// the analog example is a block response for analog and status at once, each slice has to be the response the
+	//     member would have got on its own, down to the CRC, and decode the same
+	RegisterRange realtimeBlock = { 0, 37 };
+	std::vector<uint8_t> blockResponse = ModbusResponse(PaceBmsProtocolModbus::exampleReadAnalogInformationResponseModbus);
+	std::vector<uint8_t> analogSlice;
+	std::vector<uint8_t> statusSlice;
+	PaceBmsProtocolModbus::AnalogInformation slicedAnalogInfo;
+	PaceBmsProtocolModbus::StatusInformation slicedStatusInformation;
+	res = paceBms->ValidateReadBlockResponse(1, blockResponse, realtimeBlock);
+	paceBms->ExtractReadBlockResponse(1, blockResponse, realtimeBlock, { 0, 37 }, analogSlice);
+	paceBms->ExtractReadBlockResponse(1, blockResponse, realtimeBlock, { 9, 4 }, statusSlice);
+	if (error.str().length() != 0 || warning.str().length() != 0 || info.str().length() != 0)
+	{
+		std::cout << "FAIL: ExtractReadBlockResponse (MODBUS realtime) logged something above verbose" << std::endl;
+	}
+	else if (res != true)
+	{
+		std::cout << "FAIL: ExtractReadBlockResponse (MODBUS realtime) the block response did not validate" << std::endl;
+	}
+	else if (analogSlice != blockResponse || statusSlice != ModbusResponse(PaceBmsProtocolModbus::exampleReadStatusInformationResponseModbus))
+	{
+		std::cout << "FAIL: ExtractReadBlockResponse (MODBUS realtime) sliced out a different response than the known good examples" << std::endl;
+	}
+	else if (!paceBms->ProcessReadAnalogInformationResponse(1, analogSlice, slicedAnalogInfo) ||
+		!paceBms->ProcessReadStatusInformationResponse(1, statusSlice, slicedStatusInformation) ||
+		slicedAnalogInfo.totalVoltageMillivolts != analogInfo.totalVoltageMillivolts ||
+		slicedAnalogInfo.minCellVoltageMillivolts != analogInfo.minCellVoltageMillivolts ||
+		slicedStatusInformation.systemText != statusInformation.systemText ||
+		slicedStatusInformation.warningText != statusInformation.warningText)
+	{
+		std::cout << "FAIL: ExtractReadBlockResponse (MODBUS realtime) slices did not decode the same as reading them on their own" << std::endl;
+	}
+	else
+	{
+		std::cout << "PASS: ExtractReadBlockResponse (MODBUS realtime)" << std::endl;
+	}
+
+	error.str("");
+	warning.str("");
+	info.str("");
+	debug.str("");
+	verbose.str("");
+	veryVerbose.str("");
+
+	// the hardware version (150-159) and serial number (160-169) read as one block, the serial number slice starts part way in
+	RegisterRange stringBlock = { 150, 20 };
+	const uint8_t* versionResponse = PaceBmsProtocolModbus::exampleReadHardwareVersionResponseModbus;
+	const uint8_t* serialResponse = PaceBmsProtocolModbus::exampleReadSerialNumberResponseModbus;
+	blockResponse = { 0x01, 0x03, 40 };
+	blockResponse.insert(blockResponse.end(), versionResponse + 3, versionResponse + 3 + versionResponse[2]);
+	blockResponse.insert(blockResponse.end(), serialResponse + 3, serialResponse + 3 + serialResponse[2]);
+	uint16_t crc = ModbusCrc(blockResponse);
+	blockResponse.push_back(crc & 0xFF);
+	blockResponse.push_back(crc >> 8);
+	std::vector<uint8_t> versionSlice;
+	std::vector<uint8_t> serialSlice;
+	std::string slicedHardwareVersion;
+	std::string slicedSerialNumber;
+	res = paceBms->ValidateReadBlockResponse(1, blockResponse, stringBlock);
+	paceBms->ExtractReadBlockResponse(1, blockResponse, stringBlock, { 150, 10 }, versionSlice);
+	paceBms->ExtractReadBlockResponse(1, blockResponse, stringBlock, { 160, 10 }, serialSlice);
+	if (error.str().length() != 0 || warning.str().length() != 0 || info.str().length() != 0)
+	{
+		std::cout << "FAIL: ExtractReadBlockResponse (MODBUS strings) logged something above verbose" << std::endl;
+	}
+	else if (res != true)
+	{
+		std::cout << "FAIL: ExtractReadBlockResponse (MODBUS strings) the block response did not validate" << std::endl;
+	}
+	else if (versionSlice != ModbusResponse(versionResponse) || serialSlice != ModbusResponse(serialResponse))
+	{
+		std::cout << "FAIL: ExtractReadBlockResponse (MODBUS strings) sliced out a different response than the known good examples" << std::endl;
+	}
+	else if (!paceBms->ProcessReadHardwareVersionResponse(1, versionSlice, slicedHardwareVersion) ||
+		!paceBms->ProcessReadSerialNumberResponse(1, serialSlice, slicedSerialNumber) ||
+		slicedHardwareVersion != hardwareVersion || slicedSerialNumber != serialNumber)
+	{
+		std::cout << "FAIL: ExtractReadBlockResponse (MODBUS strings) slices did not decode the same as reading them on their own" << std::endl;
+	}
+	else
+	{
+		std::cout << "PASS: ExtractReadBlockResponse (MODBUS strings)" << std::endl;
+	}
+
+	delete paceBms;
 }
 
-// use with a USB to RS485 adapter
-// quick and dirty, no error checks because it's throwaway
-void ComPortTests(int portNum, int rs485_address)
+#ifdef _WIN32
+typedef HANDLE SerialHandle;
+#define INVALID_SERIAL_HANDLE INVALID_HANDLE_VALUE
+#else
+typedef int SerialHandle;
+#define INVALID_SERIAL_HANDLE -1
+#endif
+
+// portName is "8" for COM8 on windows, or a device such as /dev/ttyUSB0 or a pseudo-terminal such as /dev/pts/3 everywhere else
+SerialHandle OpenSerial(std::string portName)
 {
+#ifdef _WIN32
 	HANDLE serialHandle;
-	std::string comName = std::string("\\\\.\\COM") + std::to_string(portNum);
+	std::string comName = std::string("\\\\.\\COM") + portName;
 	std::wstring comNameW = std::wstring(comName.begin(), comName.end());
 	serialHandle = CreateFile(comNameW.c_str(), GENERIC_READ | GENERIC_WRITE, 0, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+	if (serialHandle == INVALID_HANDLE_VALUE)
+		return INVALID_SERIAL_HANDLE;
 
 	DCB serialParams = { 0 };
 	serialParams.DCBlength = sizeof(serialParams);
@@ -3228,183 +3798,224 @@ void ComPortTests(int portNum, int rs485_address)
 
 	SetCommMask(serialHandle, EV_RXCHAR);
 
+	return serialHandle;
+#else
+	int serialHandle = open(portName.c_str(), O_RDWR | O_NOCTTY);
+	if (serialHandle < 0)
+		return INVALID_SERIAL_HANDLE;
+
+	// 9600 8N1, raw, a read returns after whatever has arrived or after 1 second of silence
+	struct termios serialParams;
+	if (tcgetattr(serialHandle, &serialParams) != 0)
+	{
+		close(serialHandle);
+		return INVALID_SERIAL_HANDLE;
+	}
+	cfmakeraw(&serialParams);
+	cfsetispeed(&serialParams, B9600);
+	cfsetospeed(&serialParams, B9600);
+	serialParams.c_cflag |= CLOCAL | CREAD;
+	serialParams.c_cflag &= ~(PARENB | CSTOPB | CSIZE);
+	serialParams.c_cflag |= CS8;
+	serialParams.c_cc[VMIN] = 0;
+	serialParams.c_cc[VTIME] = 10;
+	tcsetattr(serialHandle, TCSANOW, &serialParams);
+	tcflush(serialHandle, TCIOFLUSH);
+
+	return serialHandle;
+#endif
+}
+
+void CloseSerial(SerialHandle serialHandle)
+{
+#ifdef _WIN32
+	CloseHandle(serialHandle);
+#else
+	close(serialHandle);
+#endif
+}
 
-	PaceBmsProtocolV25* paceBms = new PaceBmsProtocolV25(PaceBmsProtocolV25::CID1_LithiumIron, &ErrorLogFunc, &WarningLogFunc, &InfoLogFunc, &DebugLogFunc, &VerboseLogFunc, &VeryVerboseLogFunc);
+bool WriteSerial(SerialHandle hComPort, const unsigned char* buffer, int bufferLen)
+{
+#ifdef _WIN32
+	DWORD dwBytesWritten;
+	bool success = WriteFile(hComPort, buffer, bufferLen, &dwBytesWritten, NULL);
 
-	/*
-	ZeroMemory(buffer, bufferLen);
-	signed short srv = paceBms->CreateAnalogInformationRequest(rs485_address, buffer, bufferLen);
-	buffer[srv] = 0;
-	if (!WriteSerial(serialHandle, buffer, (int)strlen((char*)buffer)))
-	{
-		std::cout << "Unable to write to serial" << std::endl;
-		return;
-	}
+	if (dwBytesWritten != bufferLen)
+		return false;
 
-	ZeroMemory(buffer, bufferLen);
-	int bytesRead = 0;
-	bytesRead = ReadSerialUntilTerminator(serialHandle, buffer, bufferLen, '\r');
-	if(bytesRead <= 0)
+	return true;
+#else
+	int offset = 0;
+	while (offset < bufferLen)
 	{
-		std::cout << "Unable to read from serial" << std::endl;
-		return;
+		ssize_t written = write(hComPort, buffer + offset, bufferLen - offset);
+		if (written <= 0)
+			return false;
+		offset += (int)written;
 	}
 
-	buffer[bytesRead] = 0;
-	PaceBms::TheAnalogInformation analogInfo;
-	bool brv = paceBms->ProcessAnalogInformationResponse(rs485_address, buffer, bytesRead, &analogInfo);
-	if (brv == false)
+	return true;
+#endif
+}
+
+int ReadSerialUntilTerminator(SerialHandle hComPort, unsigned char* buffer, int bufferLen, char terminator)
+{
+	int offset = 0;
+	while ((offset == 0 || buffer[offset - 1] != terminator) && bufferLen - offset > 0)
 	{
-		std::cout << "ProcessAnalogInformationResponse returned false" << std::endl;
-	}
+#ifdef _WIN32
+		DWORD dwBytesRead;
+		bool success = ReadFile(hComPort, buffer + offset, 1, &dwBytesRead, NULL);
+		if (!success)
+			return -1;
+#else
+		ssize_t dwBytesRead = read(hComPort, buffer + offset, 1);
+		if (dwBytesRead < 0)
+			return -1;
+#endif
+		if (dwBytesRead == 0)
+			return -1;
 
-	std::cout << "Create/ProcessAnalogInformation over COM port OK" << std::endl;
+		offset += (int)dwBytesRead;
+	}
 
+	return offset;
+}
 
-	ZeroMemory(buffer, bufferLen);
-	srv = paceBms->CreateStatusInformationRequest(rs485_address, buffer, bufferLen);
-	buffer[srv] = 0;
-	if (!WriteSerial(serialHandle, buffer, (int)strlen((char*)buffer)))
+// sends a request and hands back everything up to and including the end of the response frame
+bool ExchangeSerial(SerialHandle serialHandle, const std::vector<uint8_t>& request, std::vector<uint8_t>& response)
+{
+	if (!WriteSerial(serialHandle, request.data(), (int)request.size()))
 	{
 		std::cout << "Unable to write to serial" << std::endl;
-		return;
+		return false;
 	}
 
-	ZeroMemory(buffer, bufferLen);
-	bytesRead = 0;
-	bytesRead = ReadSerialUntilTerminator(serialHandle, buffer, bufferLen, '\r');
+	unsigned char buffer[512];
+	int bytesRead = ReadSerialUntilTerminator(serialHandle, buffer, sizeof(buffer), '\r');
 	if (bytesRead <= 0)
 	{
 		std::cout << "Unable to read from serial" << std::endl;
-		return;
+		return false;
 	}
 
-	std::string warningText;
-	std::string balancingText;
-	std::string systemText;
-	std::string configurationText;
-	std::string protectionText;
-	std::string faultText;
-	brv = paceBms->ProcessStatusInformationResponse(rs485_address, buffer, bytesRead, warningText, balancingText, systemText, configurationText, protectionText, faultText);
-	if (brv == false)
+	response.assign(buffer, buffer + bytesRead);
+	return true;
+}
+
+// use with a USB to RS485 adapter, or a pseudo-terminal with something pretending to be a BMS on the other end (see EmulatePaceBmsOnPty)
+void ComPortTests(std::string portName, int rs485_address)
+{
+	SerialHandle serialHandle = OpenSerial(portName);
+	if (serialHandle == INVALID_SERIAL_HANDLE)
 	{
-		std::cout << "ProcessWarningInformationResponse returned false" << std::endl;
+		std::cout << "FAIL: Unable to open serial port " << portName << std::endl;
+		return;
 	}
 
-	std::cout << "live warning status text: " << warningText << std::endl;
-	std::cout << "live balancing status text: " << balancingText << std::endl;
-	std::cout << "live system status text: " << systemText << std::endl;
-	std::cout << "live configuration status text: " << configurationText << std::endl;
-	std::cout << "live protection status text: " << protectionText << std::endl;
-	std::cout << "live fault status text: " << faultText << std::endl;
-	std::cout << "Create/ProcessWarningInformation over COM port OK" << std::endl;
-
+	PaceBmsProtocolV25* paceBms = new PaceBmsProtocolV25(OPTIONAL_NS::nullopt, OPTIONAL_NS::nullopt, PaceBmsProtocolV25::CID1_LithiumIron, &ErrorLogFunc, &WarningLogFunc, &InfoLogFunc, &DebugLogFunc, &VerboseLogFunc, &VeryVerboseLogFunc);
+	std::vector<uint8_t> request;
+	std::vector<uint8_t> response;
 
-	ZeroMemory(buffer, bufferLen);
-	srv = paceBms->CreateHardwareVersionRequest(rs485_address, buffer, bufferLen);
-	buffer[srv] = 0;
-	if (!WriteSerial(serialHandle, buffer, (int)strlen((char*)buffer)))
+	PaceBmsProtocolV25::AnalogInformation analogInfo;
+	paceBms->CreateReadAnalogInformationRequest(rs485_address, request);
+	if (!ExchangeSerial(serialHandle, request, response) || !paceBms->ProcessReadAnalogInformationResponse(rs485_address, response, analogInfo))
 	{
-		std::cout << "Unable to write to serial" << std::endl;
-		return;
+		std::cout << "FAIL: Create/ProcessReadAnalogInformation over serial" << std::endl;
+	}
+	else
+	{
+		std::cout << "live cell count: " << (int)analogInfo.cellCount << ", total voltage: " << analogInfo.totalVoltageMillivolts << " mV, SoC: " << analogInfo.SoC << " %" << std::endl;
+		std::cout << "PASS: Create/ProcessReadAnalogInformation over serial" << std::endl;
 	}
 
-	ZeroMemory(buffer, bufferLen);
-	bytesRead = 0;
-	bytesRead = ReadSerialUntilTerminator(serialHandle, buffer, bufferLen, '\r');
-	if (bytesRead <= 0)
+	PaceBmsProtocolV25::StatusInformation statusInfo;
+	paceBms->CreateReadStatusInformationRequest(rs485_address, request);
+	if (!ExchangeSerial(serialHandle, request, response) || !paceBms->ProcessReadStatusInformationResponse(rs485_address, response, statusInfo))
 	{
-		std::cout << "Unable to read from serial" << std::endl;
-		return;
+		std::cout << "FAIL: Create/ProcessReadStatusInformation over serial" << std::endl;
+	}
+	else
+	{
+		std::cout << "live warning status text: " << statusInfo.warningText << std::endl;
+		std::cout << "live balancing status text: " << statusInfo.balancingText << std::endl;
+		std::cout << "live system status text: " << statusInfo.systemText << std::endl;
+		std::cout << "live configuration status text: " << statusInfo.configurationText << std::endl;
+		std::cout << "live protection status text: " << statusInfo.protectionText << std::endl;
+		std::cout << "live fault status text: " << statusInfo.faultText << std::endl;
+		std::cout << "PASS: Create/ProcessReadStatusInformation over serial" << std::endl;
 	}
 
 	std::string hardwareVersion;
-	brv = paceBms->ProcessHardwareVersionResponse(rs485_address, buffer, bytesRead, hardwareVersion);
-	if (brv == false)
+	paceBms->CreateReadHardwareVersionRequest(rs485_address, request);
+	if (!ExchangeSerial(serialHandle, request, response) || !paceBms->ProcessReadHardwareVersionResponse(rs485_address, response, hardwareVersion))
 	{
-		std::cout << "ProcessHardwareVersionResponse returned false" << std::endl;
+		std::cout << "FAIL: Create/ProcessReadHardwareVersion over serial" << std::endl;
 	}
-
-	std::cout << "live hardware version: " << hardwareVersion << std::endl;
-	std::cout << "Create/ProcessHardwareVersion over COM port OK" << std::endl;
-
-
-	ZeroMemory(buffer, bufferLen);
-	srv = paceBms->CreateSerialNumberRequest(rs485_address, buffer, bufferLen);
-	buffer[srv] = 0;
-	if (!WriteSerial(serialHandle, buffer, (int)strlen((char*)buffer)))
+	else
 	{
-		std::cout << "Unable to write to serial" << std::endl;
-		return;
+		std::cout << "live hardware version: " << hardwareVersion << std::endl;
+		std::cout << "PASS: Create/ProcessReadHardwareVersion over serial" << std::endl;
 	}
 
-	ZeroMemory(buffer, bufferLen);
-	bytesRead = 0;
-	bytesRead = ReadSerialUntilTerminator(serialHandle, buffer, bufferLen, '\r');
-	if (bytesRead <= 0)
+	std::string serialNumber;
+	paceBms->CreateReadSerialNumberRequest(rs485_address, request);
+	if (!ExchangeSerial(serialHandle, request, response) || !paceBms->ProcessReadSerialNumberResponse(rs485_address, response, serialNumber))
 	{
-		std::cout << "Unable to read from serial" << std::endl;
-		return;
+		std::cout << "FAIL: Create/ProcessReadSerialNumber over serial" << std::endl;
 	}
-
-	std::string productInformation;
-	brv = paceBms->ProcessSerialNumberResponse(rs485_address, buffer, bytesRead, productInformation);
-	if (brv == false)
+	else
 	{
-		std::cout << "ProcessSerialNumberResponse returned false" << std::endl;
+		std::cout << "live serial number: " << serialNumber << std::endl;
+		std::cout << "PASS: Create/ProcessReadSerialNumber over serial" << std::endl;
 	}
 
-	std::cout << "live serial number: " << productInformation << std::endl;
-	std::cout << "Create/ProcessSerialNumber over COM port OK" << std::endl;
-	*/
-
-
-
-
-
-	//ZeroMemory(buffer, bufferLen);
-	//srv = paceBms->Create_unknown1_Request(rs485_address, buffer, bufferLen);
-	//buffer[srv] = 0;
-	//if (!WriteSerial(serialHandle, buffer, (int)strlen((char*)buffer)))
-	//{
-	//    std::cout << "Unable to write to serial" << std::endl;
-	//    return;
-	//}
-
-	//ZeroMemory(buffer, bufferLen);
-	//bytesRead = 0;
-	//bytesRead = ReadSerialUntilTerminator(serialHandle, buffer, bufferLen, '\r');
-	//if (bytesRead <= 0)
-	//{
-	//    std::cout << "Unable to read from serial" << std::endl;
-	//    return;
-	//}
-
-
-	//ZeroMemory(buffer, bufferLen);
-	//srv = paceBms->Create_unknown2_Request(rs485_address, buffer, bufferLen);
-	//buffer[srv] = 0;
-	//if (!WriteSerial(serialHandle, buffer, (int)strlen((char*)buffer)))
-	//{
-	//    std::cout << "Unable to write to serial" << std::endl;
-	//    return;
-	//}
-
-	//ZeroMemory(buffer, bufferLen);
-	//bytesRead = 0;
-	//bytesRead = ReadSerialUntilTerminator(serialHandle, buffer, bufferLen, '\r');
-	//if (bytesRead <= 0)
-	//{
-	//    std::cout << "Unable to read from serial" << std::endl;
-	//    return;
-	//}
-
-
+	delete paceBms;
+	CloseSerial(serialHandle);
+}
 
+#ifndef _WIN32
+// answers the requests that ComPortTests sends with the known good example responses, from the master side of a pseudo-terminal, 
+//     so that the serial code path can be exercised without a BMS attached - returns the name of the slave side to hand to ComPortTests
+std::string EmulatePaceBmsOnPty(std::thread& emulator)
+{
+	int master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+		return "";
+	std::string slaveName = ptsname(master);
+
+	emulator = std::thread([master]() {
+		static const unsigned char* const exchanges[][2] = {
+			{ PaceBmsProtocolV25::exampleReadAnalogInformationRequestV25, PaceBmsProtocolV25::exampleReadAnalogInformationResponseV25 },
+			{ PaceBmsProtocolV25::exampleReadStatusInformationRequestV25, PaceBmsProtocolV25::exampleReadStatusInformationResponseV25 },
+			{ PaceBmsProtocolV25::exampleReadHardwareVersionRequestV25, PaceBmsProtocolV25::exampleReadHardwareVersionResponseV25 },
+			{ PaceBmsProtocolV25::exampleReadSerialNumberRequestV25, PaceBmsProtocolV25::exampleReadSerialNumberResponseV25 },
+		};
+
+		// the master side has no line discipline of its own, so this just reads whatever the slave side writes
+		unsigned char buffer[512];
+		while (true)
+		{
+			int read = ReadSerialUntilTerminator(master, buffer, sizeof(buffer), '\r');
+			if (read <= 0)
+				break;
 
+			// generic command error
+			const unsigned char* response = (const unsigned char*)"~250046040000FDAB\r";
+			for (auto& exchange : exchanges)
+			{
+				if (strlen((const char*)exchange[0]) == (size_t)read && 0 == memcmp(exchange[0], buffer, read))
+					response = exchange[1];
+			}
+			WriteSerial(master, response, (int)strlen((const char*)response));
+		}
+		close(master);
+	});
 
-	CloseHandle(serialHandle);
+	return slaveName;
 }
+#endif
 
 // temp code for forcing PBmsTools to give up it's secrets, used with a software NULL serial port loopback emulator, but I guess you could use a physical loopback too
 /*void EmulatePaceBms(int portNum, int rs485_address)
@@ -3471,11 +4082,35 @@ void ComPortTests(int portNum, int rs485_address)
 	CloseHandle(serialHandle);
 }*/
 
-int main()
+// no arguments:    BasicTests against the known good examples
+// <port> [address]: ComPortTests against a real BMS, port is "8" for COM8 on windows or a device such as /dev/ttyUSB0 elsewhere
+// --pty:            ComPortTests against the known good examples served from a pseudo-terminal (not on windows)
+int main(int argc, char* argv[])
 {
-	BasicTests();
-
-	//ComPortTests(8, 1);
+	if (argc < 2)
+	{
+		BasicTests();
+		ModbusTests();
+	}
+#ifndef _WIN32
+	else if (std::string(argv[1]) == "--pty")
+	{
+		std::thread emulator;
+		std::string portName = EmulatePaceBmsOnPty(emulator);
+		if (portName.empty())
+		{
+			std::cout << "FAIL: Unable to open a pseudo-terminal" << std::endl;
+			return 1;
+		}
+		ComPortTests(portName, 1);
+		// closing the slave side makes the emulator's read fail, which ends it
+		emulator.join();
+	}
+#endif
+	else
+	{
+		ComPortTests(argv[1], argc > 2 ? atoi(argv[2]) : 1);
+	}
 
 	//EmulatePaceBms(31, 1);
 }
@@ -8,6 +8,7 @@ from esphome.const import (
     CONF_ADDRESS,
 )
 from esphome import pins
+from esphome.core import CORE
 
 CODEOWNERS = ["@nkinnan"]
 
@@ -27,21 +28,50 @@ CONF_CHEMISTRY                   = "battery_chemistry"
 
 CONF_REQUEST_THROTTLE            = "request_throttle"
 CONF_RESPONSE_TIMEOUT            = "response_timeout"
+CONF_FLIGHT_RECORDER_SIZE        = "flight_recorder_size"
+CONF_BUS_CAPTURE                 = "bus_capture"
+CONF_FAST_POLL_INTERVAL          = "fast_poll_interval"
+CONF_TRANSPORT                   = "transport"
+CONF_MODBUS_MAX_REGISTERS        = "modbus_max_registers_per_request"
+CONF_MODBUS_GAP_TOLERANCE        = "modbus_register_gap_tolerance"
+CONF_MAX_CELL_COUNT              = "max_cell_count"
+CONF_MAX_TEMPERATURE_COUNT       = "max_temperature_count"
 
 
 #DEFAULT_FLOW_CONTROL_PIN = 
 DEFAULT_ADDRESS = 1
 
 DEFAULT_PROTOCOL_COMMANDSET = 0x25
+KNOWN_PROTOCOL_VARIANTS_V20 = ["PYLON", "SEPLOS", "EG4"]
 #DEFAULT_PROTOCOL_VARIANT = 
 #DEFAULT_PROTOCOL_VERSION = 
 #DEFAULT_CHEMISTRY = 
 
 DEFAULT_REQUEST_THROTTLE = "50ms"
 DEFAULT_RESPONSE_TIMEOUT = "200ms"
-
-
-CONFIG_SCHEMA = (
+DEFAULT_FLIGHT_RECORDER_SIZE = 0
+DEFAULT_BUS_CAPTURE = False
+DEFAULT_TRANSPORT = "paceic"
+DEFAULT_MODBUS_MAX_REGISTERS = 125
+DEFAULT_MODBUS_GAP_TOLERANCE = 8
+DEFAULT_MAX_CELL_COUNT = 16
+DEFAULT_MAX_TEMPERATURE_COUNT = 6
+# the sensor platform only declares this many cell_voltage_XX / temperature_XX entries
+LIMIT_MAX_CELL_COUNT = 32
+LIMIT_MAX_TEMPERATURE_COUNT = 16
+
+
+def validate_transport(config):
+    # MODBUS carries the same data as the version 25 commandset, just encoded differently
+    if config[CONF_TRANSPORT] == "modbus":
+        if config[CONF_PROTOCOL_COMMANDSET] != 0x25:
+            raise cv.Invalid(f"{CONF_TRANSPORT}: modbus requires {CONF_PROTOCOL_COMMANDSET}: 0x25")
+        if config[CONF_ADDRESS] == 0:
+            raise cv.Invalid(f"{CONF_TRANSPORT}: modbus requires an {CONF_ADDRESS} of at least 1, 0 is the MODBUS broadcast address")
+    return config
+
+
+CONFIG_SCHEMA = cv.All(
     cv.Schema(
         {
             cv.GenerateID(): cv.declare_id(PaceBms),
@@ -56,10 +86,19 @@ CONFIG_SCHEMA = (
 
             cv.Optional(CONF_REQUEST_THROTTLE, default=DEFAULT_REQUEST_THROTTLE): cv.positive_time_period_milliseconds,
             cv.Optional(CONF_RESPONSE_TIMEOUT, default=DEFAULT_RESPONSE_TIMEOUT): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_FLIGHT_RECORDER_SIZE, default=DEFAULT_FLIGHT_RECORDER_SIZE): cv.int_range(min=0, max=64),
+            cv.Optional(CONF_BUS_CAPTURE, default=DEFAULT_BUS_CAPTURE): cv.boolean,
+            cv.Optional(CONF_FAST_POLL_INTERVAL): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_TRANSPORT, default=DEFAULT_TRANSPORT): cv.one_of("paceic", "modbus", lower=True),
+            cv.Optional(CONF_MODBUS_MAX_REGISTERS, default=DEFAULT_MODBUS_MAX_REGISTERS): cv.int_range(min=1, max=125),
+            cv.Optional(CONF_MODBUS_GAP_TOLERANCE, default=DEFAULT_MODBUS_GAP_TOLERANCE): cv.int_range(min=0, max=124),
+            cv.Optional(CONF_MAX_CELL_COUNT, default=DEFAULT_MAX_CELL_COUNT): cv.int_range(min=1, max=LIMIT_MAX_CELL_COUNT),
+            cv.Optional(CONF_MAX_TEMPERATURE_COUNT, default=DEFAULT_MAX_TEMPERATURE_COUNT): cv.int_range(min=1, max=LIMIT_MAX_TEMPERATURE_COUNT),
         }
     )
     .extend(cv.polling_component_schema("60s"))
-    .extend(uart.UART_DEVICE_SCHEMA)
+    .extend(uart.UART_DEVICE_SCHEMA),
+    validate_transport,
 )
 
 FINAL_VALIDATE_SCHEMA = uart.final_validate_device_schema(
@@ -70,6 +109,27 @@ async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
 
+    # only build the protocol commandset and variant(s) actually in use, if the variant is left to auto-detection all of them are needed
+    #     these are global, so with multiple pace_bms instances the result is the union of what each one needs
+    if config[CONF_PROTOCOL_COMMANDSET] == 0x25:
+        cg.add_build_flag("-DPACE_BMS_COMMANDSET_V25")
+        if config[CONF_TRANSPORT] == "modbus":
+            cg.add_build_flag("-DPACE_BMS_TRANSPORT_MODBUS")
+    elif config[CONF_PROTOCOL_COMMANDSET] == 0x20:
+        cg.add_build_flag("-DPACE_BMS_COMMANDSET_V20")
+        if config.get(CONF_PROTOCOL_VARIANT) in KNOWN_PROTOCOL_VARIANTS_V20:
+            cg.add_build_flag(f"-DPACE_BMS_V20_VARIANT_{config[CONF_PROTOCOL_VARIANT]}")
+        else:
+            for variant in KNOWN_PROTOCOL_VARIANTS_V20:
+                cg.add_build_flag(f"-DPACE_BMS_V20_VARIANT_{variant}")
+
+    # the cell and temperature array sizes are global as well, so they're sized for the largest of any instance
+    instances = CORE.config.get("pace_bms", [])
+    if not isinstance(instances, list):
+        instances = [instances]
+    cg.add_build_flag(f"-DPACE_BMS_MAX_CELL_COUNT={max(conf[CONF_MAX_CELL_COUNT] for conf in instances)}")
+    cg.add_build_flag(f"-DPACE_BMS_MAX_TEMP_COUNT={max(conf[CONF_MAX_TEMPERATURE_COUNT] for conf in instances)}")
+
     await uart.register_uart_device(var, config)
 
     if CONF_FLOW_CONTROL_PIN in config:
@@ -89,4 +149,14 @@ async def to_code(config):
         cg.add(var.set_request_throttle(config[CONF_REQUEST_THROTTLE]))
     if CONF_RESPONSE_TIMEOUT in config:
         cg.add(var.set_response_timeout(config[CONF_RESPONSE_TIMEOUT]))
+    if CONF_FLIGHT_RECORDER_SIZE in config:
+        cg.add(var.set_flight_recorder_size(config[CONF_FLIGHT_RECORDER_SIZE]))
+    if config[CONF_BUS_CAPTURE]:
+        cg.add(var.set_bus_capture(True))
+    if CONF_FAST_POLL_INTERVAL in config:
+        cg.add(var.set_fast_poll_interval(config[CONF_FAST_POLL_INTERVAL]))
+    if config[CONF_TRANSPORT] == "modbus":
+        cg.add(var.set_transport_modbus(True))
+        cg.add(var.set_modbus_max_registers_per_request(config[CONF_MODBUS_MAX_REGISTERS]))
+        cg.add(var.set_modbus_register_gap_tolerance(config[CONF_MODBUS_GAP_TOLERANCE]))
 
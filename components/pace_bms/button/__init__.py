@@ -3,6 +3,7 @@ import esphome.config_validation as cv
 from esphome.components import button
 from esphome.const import (
     CONF_ID,
+    ENTITY_CATEGORY_DIAGNOSTIC,
 )
 from .. import pace_bms_ns, CONF_PACE_BMS_ID, PaceBms
 
@@ -14,6 +15,7 @@ PaceBmsButton = pace_bms_ns.class_("PaceBmsButton", cg.Component)
 PaceBmsButtonImplementation = pace_bms_ns.class_("PaceBmsButtonImplementation", cg.Component, button.Button)
 
 CONF_SHUTDOWN = "shutdown"
+CONF_DUMP_FLIGHT_RECORDER = "dump_flight_recorder"
 
 CONFIG_SCHEMA = cv.Schema(
     {
@@ -21,6 +23,7 @@ CONFIG_SCHEMA = cv.Schema(
         cv.GenerateID(CONF_PACE_BMS_ID): cv.use_id(PaceBms),
 
         cv.Optional(CONF_SHUTDOWN): button.button_schema(PaceBmsButtonImplementation),
+        cv.Optional(CONF_DUMP_FLIGHT_RECORDER): button.button_schema(PaceBmsButtonImplementation, entity_category=ENTITY_CATEGORY_DIAGNOSTIC),
     }
 )
 
@@ -34,3 +37,6 @@ async def to_code(config):
     if shutdown_config := config.get(CONF_SHUTDOWN):
         btn = await button.new_button(shutdown_config)
         cg.add(var.set_shutdown_button(btn))
+    if dump_flight_recorder_config := config.get(CONF_DUMP_FLIGHT_RECORDER):
+        btn = await button.new_button(dump_flight_recorder_config)
+        cg.add(var.set_dump_flight_recorder_button(btn))
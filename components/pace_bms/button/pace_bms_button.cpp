@@ -8,29 +8,41 @@ static const char* const TAG = "pace_bms.button";
 
 void PaceBmsButton::setup() {
 	if (this->parent_->get_protocol_commandset() == 0x25) {
+#ifdef PACE_BMS_COMMANDSET_V25
 		if (this->shutdown_button_ != nullptr) {
 			this->shutdown_button_->add_on_press_callback([this]() {
 				ESP_LOGD(TAG, "Sending shutdown");
 				this->parent_->write_shutdown_v25();
 			});
 		}
+#endif
 	}
 	else if (this->parent_->get_protocol_commandset() == 0x20) {
+#ifdef PACE_BMS_COMMANDSET_V20
 		if (this->shutdown_button_ != nullptr) {
 			this->shutdown_button_->add_on_press_callback([this]() {
 				ESP_LOGD(TAG, "Sending shutdown");
 				this->parent_->write_shutdown_v20();
 			});
 		}
+#endif
 	}
 	else {
 		ESP_LOGE(TAG, "Protocol version not supported: 0x%02X", this->parent_->get_protocol_commandset());
 	}
+
+	// not protocol specific
+	if (this->dump_flight_recorder_button_ != nullptr) {
+		this->dump_flight_recorder_button_->add_on_press_callback([this]() {
+			this->parent_->dump_flight_recorder();
+		});
+	}
 }
 
 void PaceBmsButton::dump_config() {
 	ESP_LOGCONFIG(TAG, "pace_bms_button:");
 	LOG_BUTTON("  ", "Shutdown", this->shutdown_button_);
+	LOG_BUTTON("  ", "Dump Flight Recorder", this->dump_flight_recorder_button_);
 }
 
 }  // namespace pace_bms
@@ -13,6 +13,7 @@ public:
 	void set_parent(PaceBms* parent) { parent_ = parent; }
 
 	void set_shutdown_button(button::Button* button) { this->shutdown_button_ = button; }
+	void set_dump_flight_recorder_button(button::Button* button) { this->dump_flight_recorder_button_ = button; }
 
 	void setup() override;
 	float get_setup_priority() const { return setup_priority::DATA; }
@@ -23,6 +24,9 @@ protected:
 
 	// analog info
 	button::Button* shutdown_button_{ nullptr };
+
+	// diagnostics
+	button::Button* dump_flight_recorder_button_{ nullptr };
 };
 
 }  // namespace pace_bms
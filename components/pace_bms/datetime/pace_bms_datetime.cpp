@@ -14,6 +14,7 @@ static const char* const TAG = "pace_bms.datetime";
 */
 void PaceBmsDatetime::setup() {
 	if (this->parent_->get_protocol_commandset() == 0x25) {
+#ifdef PACE_BMS_COMMANDSET_V25
 		if (this->system_date_and_time_datetime_ != nullptr) {
 			this->parent_->register_system_datetime_callback_v25([this](PaceBmsProtocolV25::DateTime& dt) {
 				this->system_date_and_time_ = dt;
@@ -39,8 +40,10 @@ void PaceBmsDatetime::setup() {
 				this->parent_->write_system_datetime_v25(this->system_date_and_time_);
 			});
 		}
+#endif
 	}
 	else if (this->parent_->get_protocol_commandset() == 0x20) {
+#ifdef PACE_BMS_COMMANDSET_V20
 		if (this->system_date_and_time_datetime_ != nullptr) {
 			this->parent_->register_system_datetime_callback_v20([this](PaceBmsProtocolV20::DateTime& dt) {
 				this->system_date_and_time_ = dt;
@@ -66,6 +69,7 @@ void PaceBmsDatetime::setup() {
 				this->parent_->write_system_datetime_v20(this->system_date_and_time_);
 				});
 		}
+#endif
 	}
 	else {
 		ESP_LOGE(TAG, "Protocol version not supported: 0x%02X", this->parent_->get_protocol_commandset());
@@ -100,6 +100,8 @@ CONF_ENVIRONMENT_OVER_TEMPERATURE_ALARM               = "environment_over_temper
 CONF_ENVIRONMENT_OVER_TEMPERATURE_PROTECTION          = "environment_over_temperature_protection"
 CONF_ENVIRONMENT_OVER_TEMPERATURE_PROTECTION_RELEASE  = "environment_over_temperature_protection_release"
 
+CONF_CHARGE_CURRENT_LIMITER_START_CURRENT             = "charge_current_limiter_start_current"
+
 
 CONFIG_SCHEMA = cv.Schema(
     {
@@ -440,6 +442,13 @@ CONFIG_SCHEMA = cv.Schema(
             unit_of_measurement=UNIT_CELSIUS,
             entity_category=ENTITY_CATEGORY_CONFIG,
         ).extend({ cv.Optional(CONF_MODE, default=NUMBER_MODE_BOX): cv.enum(NUMBER_MODES, upper=True), }),        
+
+        cv.Optional(CONF_CHARGE_CURRENT_LIMITER_START_CURRENT): number.number_schema(
+            PaceBmsNumberImplementation,
+            device_class=DEVICE_CLASS_CURRENT,
+            unit_of_measurement=UNIT_AMPERE,
+            entity_category=ENTITY_CATEGORY_CONFIG,
+        ).extend({ cv.Optional(CONF_MODE, default=NUMBER_MODE_BOX): cv.enum(NUMBER_MODES, upper=True), }),
         
    }
 )
@@ -838,3 +847,10 @@ async def to_code(config):
             max_value=100, 
             step=1)
         cg.add(var.set_environment_over_temperature_protection_release_number(num))
+    if charge_current_limiter_start_current_config := config.get(CONF_CHARGE_CURRENT_LIMITER_START_CURRENT):
+        num = await number.new_number(
+            charge_current_limiter_start_current_config, 
+            min_value=5, 
+            max_value=150, 
+            step=1)
+        cg.add(var.set_charge_current_limiter_start_current_number(num))
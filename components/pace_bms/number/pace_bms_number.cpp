@@ -14,6 +14,7 @@ static const char* const TAG = "pace_bms.number";
 */
 void PaceBmsNumber::setup() {
 	if (this->parent_->get_protocol_commandset() == 0x25) {
+#ifdef PACE_BMS_COMMANDSET_V25
 		if (this->cell_over_voltage_alarm_number_ != nullptr ||
 			this->cell_over_voltage_protection_number_ != nullptr ||
 			this->cell_over_voltage_protection_release_number_ != nullptr ||
@@ -1006,6 +1007,19 @@ void PaceBmsNumber::setup() {
 				this->parent_->write_environment_over_under_temperature_configuration_v25(this->environment_over_under_temperature_configuration_);
 			});
 		}
+
+		if (this->charge_current_limiter_start_current_number_ != nullptr) {
+			this->parent_->register_charge_current_limiter_start_current_callback_v25([this](uint8_t& current) {
+				float state = current;
+				ESP_LOGV(TAG, "'charge_current_limiter_start_current': Publishing state due to update from the hardware: %f", state);
+				this->parent_->queue_sensor_update([this, value = state]() { this->charge_current_limiter_start_current_number_->publish_state(value); });
+			});
+			this->charge_current_limiter_start_current_number_->add_on_control_callback([this](float value) {
+				ESP_LOGD(TAG, "Setting charge_current_limiter_start_current user selected value %f", value);
+				this->parent_->write_charge_current_limiter_start_current_v25(std::lround(value));
+			});
+		}
+#endif
 	}
 	else {
 		ESP_LOGE(TAG, "Protocol version not supported: 0x%02X", this->parent_->get_protocol_commandset());
@@ -1067,6 +1081,7 @@ void PaceBmsNumber::dump_config() {
 	LOG_NUMBER("  ", "Environment Over Temperature Alarm", this->environment_over_temperature_alarm_number_);
 	LOG_NUMBER("  ", "Environment Over Temperature Protection", this->environment_over_temperature_protection_number_);
 	LOG_NUMBER("  ", "Environment Over Temperature Protection Release", this->environment_over_temperature_protection_release_number_);
+	LOG_NUMBER("  ", "Charge Current Limiter Start Current", this->charge_current_limiter_start_current_number_);
 }
 
 }  // namespace pace_bms
@@ -0,0 +1,179 @@
+
+#include <cstring>
+
+#include "pace_bms_capture.h"
+
+const uint8_t PaceBmsCaptureReader::FILE_MAGIC[8] = { 'P', 'B', 'M', 'S', 'C', 'A', 'P', '1' };
+
+static const char base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+PaceBmsCaptureWriter::PaceBmsCaptureWriter(BlockFunction blockFunction) : block_function(blockFunction)
+{
+}
+
+void PaceBmsCaptureWriter::Record(bool transmitted, uint32_t timestampUs, const uint8_t* data, size_t length)
+{
+	while (length > 0)
+	{
+		// carry on with the open record if it's going the same way, isn't full, and was started only just now
+		if (!this->record_open ||
+			this->record_transmitted != transmitted ||
+			(this->block[this->record_header_offset] & 0x7F) + 1 >= MAX_RECORD_BYTES ||
+			timestampUs - this->record_start_us >= COALESCE_US ||
+			this->block_length >= BLOCK_SIZE)
+		{
+			// a header, up to 5 bytes of delta, and at least one byte of data
+			if (this->block_length + 1 + 5 + 1 > BLOCK_SIZE)
+				this->Flush();
+
+			uint32_t delta = this->any_record ? timestampUs - this->record_start_us : 0;
+			this->record_header_offset = this->block_length;
+			// the count is filled in as bytes are added, starting from "one byte" which is the first one below
+			this->block[this->block_length++] = transmitted ? 0x80 : 0x00;
+			do
+			{
+				uint8_t b = delta & 0x7F;
+				delta >>= 7;
+				this->block[this->block_length++] = b | (delta != 0 ? 0x80 : 0x00);
+			} while (delta != 0);
+			this->block[this->block_length++] = *data++;
+			length--;
+
+			this->record_open = true;
+			this->record_transmitted = transmitted;
+			this->record_start_us = timestampUs;
+			this->any_record = true;
+			continue;
+		}
+
+		this->block[this->block_length++] = *data++;
+		length--;
+		this->block[this->record_header_offset]++;
+	}
+}
+
+void PaceBmsCaptureWriter::Flush()
+{
+	// the next record starts a new block, so close the open one even if nothing else is going to be added to it
+	this->record_open = false;
+	if (this->block_length == 0)
+		return;
+	if (this->block_function)
+		this->block_function(this->block, this->block_length, this->sequence);
+	this->sequence++;
+	this->block_length = 0;
+}
+
+void PaceBmsCaptureWriter::EncodeBase64(const uint8_t* data, size_t length, char* text)
+{
+	size_t i = 0;
+	for (; i + 2 < length; i += 3)
+	{
+		uint32_t triple = ((uint32_t)data[i] << 16) | ((uint32_t)data[i + 1] << 8) | data[i + 2];
+		*text++ = base64Alphabet[(triple >> 18) & 0x3F];
+		*text++ = base64Alphabet[(triple >> 12) & 0x3F];
+		*text++ = base64Alphabet[(triple >> 6) & 0x3F];
+		*text++ = base64Alphabet[triple & 0x3F];
+	}
+	if (i < length)
+	{
+		uint32_t triple = (uint32_t)data[i] << 16;
+		if (i + 1 < length)
+			triple |= (uint32_t)data[i + 1] << 8;
+		*text++ = base64Alphabet[(triple >> 18) & 0x3F];
+		*text++ = base64Alphabet[(triple >> 12) & 0x3F];
+		*text++ = i + 1 < length ? base64Alphabet[(triple >> 6) & 0x3F] : '=';
+		*text++ = '=';
+	}
+	*text = '\0';
+}
+
+bool PaceBmsCaptureReader::DecodeBase64(const std::string& text, std::vector<uint8_t>& data)
+{
+	data.clear();
+	uint32_t bits = 0;
+	int bitCount = 0;
+	size_t padding = 0;
+	for (char c : text)
+	{
+		if (c == '=')
+		{
+			padding++;
+			continue;
+		}
+		const char* found = strchr(base64Alphabet, c);
+		if (c == '\0' || found == nullptr || padding != 0)
+			return false;
+		bits = (bits << 6) | (uint32_t)(found - base64Alphabet);
+		bitCount += 6;
+		if (bitCount >= 8)
+		{
+			bitCount -= 8;
+			data.push_back((uint8_t)(bits >> bitCount));
+		}
+	}
+	return padding <= 2 && (text.size() % 4) == 0;
+}
+
+bool PaceBmsCaptureReader::ReadRecords(const uint8_t* data, size_t length, std::vector<Record>& records, uint64_t& lastTimestampUs)
+{
+	size_t offset = 0;
+	if (length >= sizeof(FILE_MAGIC) && memcmp(data, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0)
+		offset = sizeof(FILE_MAGIC);
+
+	while (offset < length)
+	{
+		uint8_t header = data[offset++];
+		uint64_t delta = 0;
+		int shift = 0;
+		while (true)
+		{
+			if (offset >= length || shift > 63)
+				return false;
+			uint8_t b = data[offset++];
+			delta |= (uint64_t)(b & 0x7F) << shift;
+			shift += 7;
+			if ((b & 0x80) == 0)
+				break;
+		}
+		size_t count = (size_t)(header & 0x7F) + 1;
+		if (offset + count > length)
+			return false;
+
+		Record record;
+		record.transmitted = (header & 0x80) != 0;
+		record.timestampUs = lastTimestampUs + delta;
+		record.data.assign(data + offset, data + offset + count);
+		offset += count;
+		lastTimestampUs = record.timestampUs;
+		records.push_back(std::move(record));
+	}
+	return true;
+}
+
+std::vector<uint8_t> PaceBmsCaptureReader::WriteFile(const std::vector<Record>& records)
+{
+	std::vector<uint8_t> file(FILE_MAGIC, FILE_MAGIC + sizeof(FILE_MAGIC));
+	uint64_t lastTimestampUs = records.empty() ? 0 : records.front().timestampUs;
+	for (const Record& record : records)
+	{
+		// longer records than fit in a header are split, the rest following on immediately
+		for (size_t start = 0; start < record.data.size(); start += PaceBmsCaptureWriter::MAX_RECORD_BYTES)
+		{
+			size_t count = record.data.size() - start;
+			if (count > PaceBmsCaptureWriter::MAX_RECORD_BYTES)
+				count = PaceBmsCaptureWriter::MAX_RECORD_BYTES;
+			uint64_t delta = start == 0 ? record.timestampUs - lastTimestampUs : 0;
+			file.push_back((uint8_t)((record.transmitted ? 0x80 : 0x00) | (count - 1)));
+			do
+			{
+				uint8_t b = delta & 0x7F;
+				delta >>= 7;
+				file.push_back(b | (delta != 0 ? 0x80 : 0x00));
+			} while (delta != 0);
+			file.insert(file.end(), record.data.begin() + start, record.data.begin() + start + count);
+		}
+		lastTimestampUs = record.timestampUs;
+	}
+	return file;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// a compact binary record of everything that went over the bus, for replaying field problems on a host (see: "Test PACE
+//     BMS/Replay PACE BMS"), with no dependencies so that the component and the host tools share it
+//
+// the format is little more than the bytes themselves:
+//     a capture file starts with the 8 byte magic "PBMSCAP1" and is then records back to back
+//     a record is a header byte (bit 7 set for bytes the component transmitted, clear for bytes it received, bits 0..6 the
+//         byte count less one), the microseconds since the start of the previous record as an unsigned LEB128 varint, and
+//         then the bytes themselves
+// bytes going the same way within a couple of milliseconds of a record's start are added to that record, so a request is
+//     normally one record and a response one or a few, depending on how it was read
+//
+// the device has nowhere to keep a file, so the writer hands out blocks of whole records instead, numbered from zero, which
+//     the component writes to the log base64 encoded (and so over the API as well), the host tools pick those lines back
+//     out of a saved log and put them back together into a capture file
+
+class PaceBmsCaptureWriter
+{
+public:
+	static const uint16_t BLOCK_SIZE = 192;
+	static const uint8_t MAX_RECORD_BYTES = 128;
+	static const uint32_t COALESCE_US = 2000;
+
+	// called with each block as it fills up or is flushed, the block is only valid for the duration of the call
+	typedef std::function<void(const uint8_t* block, uint16_t length, uint32_t sequence)> BlockFunction;
+
+	explicit PaceBmsCaptureWriter(BlockFunction blockFunction);
+
+	// timestamps are micros(), wrapping is fine as only the difference from one record to the next is kept
+	void Record(bool transmitted, uint32_t timestampUs, const uint8_t* data, size_t length);
+	// hands out whatever is in the current block, if anything
+	void Flush();
+
+	// the base64 encoding of a block is never longer than this, not counting a terminating null
+	static const uint16_t MAX_ENCODED_BLOCK_LENGTH = ((BLOCK_SIZE + 2) / 3) * 4;
+	// writes a null terminated base64 encoding of data into text, which must have room for ((length + 2) / 3) * 4 + 1 chars
+	static void EncodeBase64(const uint8_t* data, size_t length, char* text);
+
+protected:
+	BlockFunction block_function;
+
+	uint8_t block[BLOCK_SIZE];
+	uint16_t block_length{ 0 };
+	uint32_t sequence{ 0 };
+
+	// the record still being added to, if any
+	bool record_open{ false };
+	bool record_transmitted{ false };
+	uint16_t record_header_offset{ 0 };
+	uint32_t record_start_us{ 0 };
+	bool any_record{ false };
+};
+
+class PaceBmsCaptureReader
+{
+public:
+	static const uint8_t FILE_MAGIC[8];
+
+	struct Record
+	{
+		bool transmitted;
+		// since the start of the capture
+		uint64_t timestampUs;
+		std::vector<uint8_t> data;
+	};
+
+	// the records in a block, or in a whole capture file if it starts with FILE_MAGIC, timestamps carry on from lastTimestampUs
+	//     so that the blocks of a capture can be read one after the other, returns false if it doesn't parse
+	static bool ReadRecords(const uint8_t* data, size_t length, std::vector<Record>& records, uint64_t& lastTimestampUs);
+
+	// returns false if text isn't valid base64
+	static bool DecodeBase64(const std::string& text, std::vector<uint8_t>& data);
+	// the bytes of a capture file for a list of records, the inverse of ReadRecords
+	static std::vector<uint8_t> WriteFile(const std::vector<Record>& records);
+};
@@ -2,8 +2,10 @@
 #include <iomanip>
 #include <sstream>
 #include <functional>
+#include <algorithm>
 
 #include "esphome/core/log.h"
+#include "esphome/core/helpers.h"
 #include "pace_bms_component.h"
 
 namespace esphome {
@@ -48,8 +50,27 @@ void PaceBms::dump_config() {
 	LOG_PIN("  Flow Control Pin: ", this->flow_control_pin_);
 	ESP_LOGCONFIG(TAG, "  Address: %i", this->address_);
 	ESP_LOGCONFIG(TAG, "  Protocol Version: 0x%02X", this->protocol_commandset_);
+	ESP_LOGCONFIG(TAG, "  Transport: %s", this->transport_modbus_ ? "MODBUS" : "paceic");
+	if (this->transport_modbus_) {
+		ESP_LOGCONFIG(TAG, "  MODBUS Max Registers Per Request: %i", this->modbus_max_registers_per_request_);
+		ESP_LOGCONFIG(TAG, "  MODBUS Register Gap Tolerance: %i", this->modbus_register_gap_tolerance_);
+	}
 	ESP_LOGCONFIG(TAG, "  Request Throttle (ms): %i", this->request_throttle_);
 	ESP_LOGCONFIG(TAG, "  Response Timeout (ms): %i", this->response_timeout_);
+	ESP_LOGCONFIG(TAG, "  Flight Recorder Size: %i", this->flight_recorder_size_);
+	if (this->flight_recorder_size_ > 0) {
+		bool freezes = false;
+#ifdef PACE_BMS_COMMANDSET_V25
+		freezes |= this->protocol_commandset_ == 0x25 && this->status_information_callbacks_v25_.size() > 0;
+#endif
+#ifdef PACE_BMS_COMMANDSET_V20
+		freezes |= this->protocol_commandset_ == 0x20 && this->status_information_callbacks_v20_.size() > 0;
+#endif
+		if (!freezes)
+			ESP_LOGCONFIG(TAG, "    Protection/fault status is not being read, the flight recorder will not freeze on its own");
+	}
+	ESP_LOGCONFIG(TAG, "  Bus Capture: %s", YESNO(this->bus_capture_enabled_));
+	ESP_LOGCONFIG(TAG, "  Fast Poll Interval (ms): %" PRIu32, this->fast_poll_interval_);
 	this->check_uart_settings(9600);
 }
 
@@ -59,16 +80,75 @@ void PaceBms::dump_config() {
 
 void PaceBms::setup() {
 	if (this->protocol_commandset_ == 0x25) {
-		// the protocol en/decoder PaceBmsProtocolV25 is meant to be standalone with no dependencies, so inject esphome logging function wrappers on construction
-		this->pace_bms_v25_ = new PaceBmsProtocolV25(
-			protocol_variant_, protocol_version_, chemistry_,
-			error_log_func, warning_log_func, info_log_func, debug_log_func, verbose_log_func, very_verbose_log_func);
+#ifdef PACE_BMS_COMMANDSET_V25
+		if (this->transport_modbus_) {
+#ifdef PACE_BMS_TRANSPORT_MODBUS
+			// same data, same structs, different wire format
+			this->pace_bms_modbus_ = new PaceBmsProtocolModbus(
+				protocol_variant_, protocol_version_, chemistry_,
+				error_log_func, warning_log_func, info_log_func, debug_log_func, verbose_log_func, very_verbose_log_func);
+			this->pace_bms_v25_ = this->pace_bms_modbus_;
+
+			// these have no MODBUS registers, so don't bother sending requests that can never succeed
+			if (this->protocols_callbacks_v25_.size() > 0) {
+				ESP_LOGW(TAG, "Protocols are not available over MODBUS, ignoring");
+				this->protocols_callbacks_v25_.clear();
+			}
+			if (this->system_datetime_callbacks_v25_.size() > 0) {
+				ESP_LOGW(TAG, "System date and time are not available over MODBUS, ignoring");
+				this->system_datetime_callbacks_v25_.clear();
+			}
+			if (this->history_record_callbacks_v25_.size() > 0) {
+				ESP_LOGW(TAG, "History records are not available over MODBUS, ignoring");
+				this->history_record_callbacks_v25_.clear();
+			}
+			if (this->charge_current_limiter_start_current_callbacks_v25_.size() > 0) {
+				ESP_LOGW(TAG, "Charge current limiter start current is not available over MODBUS, ignoring");
+				this->charge_current_limiter_start_current_callbacks_v25_.clear();
+			}
+#else
+			this->status_set_error();
+			ESP_LOGE(TAG, "Support for the MODBUS transport was not compiled in");
+			return;
+#endif
+		}
+		else {
+			// the protocol en/decoder PaceBmsProtocolV25 is meant to be standalone with no dependencies, so inject esphome logging function wrappers on construction
+			this->pace_bms_v25_ = new PaceBmsProtocolV25(
+				protocol_variant_, protocol_version_, chemistry_,
+				error_log_func, warning_log_func, info_log_func, debug_log_func, verbose_log_func, very_verbose_log_func);
+		}
+
+		// one cursor per pack, so that several pace_bms instances on the same node don't trample each other
+		if (this->history_record_callbacks_v25_.size() > 0) {
+			this->history_preference_ = global_preferences->make_preference<history_cursor>(fnv1_hash(std::string("pace_bms_history_") + std::to_string(this->address_)), true);
+			if (!this->history_preference_.load(&this->history_cursor_))
+				this->history_cursor_ = history_cursor();
+			else if (this->history_cursor_.next_index_ != 0)
+				ESP_LOGI(TAG, "Resuming history download at record %i", this->history_cursor_.next_index_);
+		}
+#else
+		this->status_set_error();
+		ESP_LOGE(TAG, "Support for protocol version 0x25 was not compiled in");
+		return;
+#endif
 	}
 	else if (this->protocol_commandset_ == 0x20) {
+#ifdef PACE_BMS_COMMANDSET_V20
 		// the protocol en/decoder PaceBmsProtocolV25 is meant to be standalone with no dependencies, so inject esphome logging function wrappers on construction
 		this->pace_bms_v20_ = new PaceBmsProtocolV20(
 			protocol_variant_, protocol_version_, chemistry_,
 			error_log_func, warning_log_func, info_log_func, debug_log_func, verbose_log_func, very_verbose_log_func);
+#ifdef PACE_BMS_V20_VARIANT_PYLON
+		if ((this->system_analog_information_callbacks_v20_.size() > 0 || this->system_status_information_callbacks_v20_.size() > 0) &&
+			(!this->protocol_variant_.has_value() || this->protocol_variant_.value() != "PYLON"))
+			ESP_LOGW(TAG, "Stack-wide requests are only supported by protocol_variant PYLON, they will likely fail");
+#endif
+#else
+		this->status_set_error();
+		ESP_LOGE(TAG, "Support for protocol version 0x20 was not compiled in");
+		return;
+#endif
 	}
 	else {
 		this->status_set_error();
@@ -76,6 +156,34 @@ void PaceBms::setup() {
 		return;
 	}
 
+	if (this->flight_recorder_size_ > 0) {
+		// allocate everything up front, recording a frame is then just a copy
+		this->flight_recorder_.resize(this->flight_recorder_size_);
+		for (flight_recorder_entry& entry : this->flight_recorder_) {
+			entry.frame_.reserve(max_data_len_);
+		}
+#ifdef PACE_BMS_COMMANDSET_V20
+		// 0x20 status information only carries protection/fault as decoded text, have it decoded even if no child asked for it
+		if (this->protocol_commandset_ == 0x20)
+			this->status_information_fields_ |= PaceBmsProtocolBase::SIF_ProtectionText | PaceBmsProtocolBase::SIF_FaultText;
+#endif
+	}
+
+	if (this->bus_capture_enabled_) {
+		// at INFO so that it gets through the default log level, each line is a numbered block so the host tools can tell
+		//     if any went missing
+		this->bus_capture_ = new PaceBmsCaptureWriter([](const uint8_t* block, uint16_t length, uint32_t sequence) {
+			char text[PaceBmsCaptureWriter::MAX_ENCODED_BLOCK_LENGTH + 1];
+			PaceBmsCaptureWriter::EncodeBase64(block, length, text);
+			ESP_LOGI(TAG, "Bus capture %" PRIu32 ": %s", sequence, text);
+		});
+		ESP_LOGI(TAG, "Bus capture started");
+	}
+
+	if (this->fast_poll_interval_ > 0) {
+		this->set_interval("fast_poll", this->fast_poll_interval_, [this]() { this->queue_fast_poll_commands_(this->fast_queue_); });
+	}
+
 	if (this->flow_control_pin_ != nullptr)
 		this->flow_control_pin_->setup();
 
@@ -96,17 +204,26 @@ void PaceBms::update() {
 		this->pace_bms_v20_ == nullptr)
 		return;
 
+	this->publish_bus_metrics_(this->now_ms_());
+	this->publish_profiler_stats_();
+	// so that a quiet bus doesn't leave the last few frames sitting in the capture block
+	if (this->bus_capture_ != nullptr)
+		this->bus_capture_->Flush();
+
 	// writes are always processed first so no need to check that as well
 	if (!read_queue_.empty()) {
 		ESP_LOGW(TAG, "Commands still in queue on update(), skipping this refresh cycle: Could not speak with the BMS fast enough: increase update_interval or reduce request_throttle.");
 	}
 	else {
 		if (this->pace_bms_v25_ != nullptr) {
+#ifdef PACE_BMS_COMMANDSET_V25
 			ESP_LOGV(TAG, "Queueing v25 refresh commands");
 
-			if (this->analog_information_callbacks_v25_.size() > 0) {
+			if (this->analog_information_callbacks_v25_.size() > 0 || this->capacity_from_analog_information_v25_()) {
 				command_item* item = new command_item;
 				item->description_ = std::string("read analog information");
+				// only a build configured for more than 16 cells can expect more than max_data_len_ back
+				item->large_response_ = PaceBmsProtocolV25::MAX_CELL_COUNT > 16;
 				item->create_request_frame_ = [this](std::vector<uint8_t>& request) -> bool { return this->pace_bms_v25_->CreateReadAnalogInformationRequest(this->address_, request); };
 				item->process_response_frame_ = [this](std::vector<uint8_t>& response) -> void { this->handle_read_analog_information_response_v25(response); };
 				read_queue_.push(item);
@@ -114,6 +231,7 @@ void PaceBms::update() {
 			if (this->status_information_callbacks_v25_.size() > 0) {
 				command_item* item = new command_item;
 				item->description_ = std::string("read status information");
+				item->large_response_ = PaceBmsProtocolV25::MAX_CELL_COUNT > 16;
 				item->create_request_frame_ = [this](std::vector<uint8_t>& request) -> bool { return this->pace_bms_v25_->CreateReadStatusInformationRequest(this->address_, request); };
 				item->process_response_frame_ = [this](std::vector<uint8_t>& response) -> void { this->handle_read_status_information_response_v25(response); };
 				read_queue_.push(item);
@@ -237,6 +355,13 @@ void PaceBms::update() {
 				item->process_response_frame_ = [this](std::vector<uint8_t>& response) -> void { this->handle_read_system_datetime_response_v25(response); };
 				read_queue_.push(item);
 			}
+			if (this->charge_current_limiter_start_current_callbacks_v25_.size() > 0) {
+				command_item* item = new command_item;
+				item->description_ = std::string("read charge current limiter start current");
+				item->create_request_frame_ = [this](std::vector<uint8_t>& request) -> bool { return this->pace_bms_v25_->CreateReadChargeCurrentLimiterStartCurrentRequest(this->address_, request); };
+				item->process_response_frame_ = [this](std::vector<uint8_t>& response) -> void { this->handle_read_charge_current_limiter_start_current_response_v25(response); };
+				read_queue_.push(item);
+			}
 			if (this->mosfet_over_temperature_configuration_callbacks_v25_.size() > 0) {
 				command_item* item = new command_item;
 				item->description_ = std::string("read mosfet over temperature configuration");
@@ -251,13 +376,31 @@ void PaceBms::update() {
 				item->process_response_frame_ = [this](std::vector<uint8_t>& response) -> void { this->handle_read_environment_over_under_temperature_configuration_response_v25(response); };
 				read_queue_.push(item);
 			}
+			// without a fast_poll_interval these are read along with everything else
+			if (this->fast_poll_interval_ == 0)
+				this->queue_fast_poll_commands_(this->read_queue_);
+			// runs in the gaps between everything else until it catches up, see: send_next_request_frame_
+			if (this->history_record_callbacks_v25_.size() > 0 && !this->history_pass_active_) {
+				this->history_pass_active_ = true;
+				this->history_request_sent_ = false;
+				this->history_records_this_pass_ = 0;
+			}
+#ifdef PACE_BMS_TRANSPORT_MODBUS
+			// over MODBUS most of the above are neighbouring register ranges, fold them into as few requests as possible
+			if (this->pace_bms_modbus_ != nullptr)
+				this->plan_modbus_reads_(this->read_queue_);
+#endif
+#endif
 		}
 		else if (this->pace_bms_v20_ != nullptr) {
+#ifdef PACE_BMS_COMMANDSET_V20
 			ESP_LOGV(TAG, "Queueing v20 refresh commands");
 
 			if (this->analog_information_callbacks_v20_.size() > 0) {
 				command_item* item = new command_item;
 				item->description_ = std::string("read analog information");
+				// only a build configured for more than 16 cells can expect more than max_data_len_ back
+				item->large_response_ = PaceBmsProtocolV20::MAX_CELL_COUNT > 16;
 				item->create_request_frame_ = [this](std::vector<uint8_t>& request) -> bool { return this->pace_bms_v20_->CreateReadAnalogInformationRequest(this->address_, request); };
 				item->process_response_frame_ = [this](std::vector<uint8_t>& response) -> void { this->handle_read_analog_information_response_v20(response); };
 				read_queue_.push(item);
@@ -265,10 +408,32 @@ void PaceBms::update() {
 			if (this->status_information_callbacks_v20_.size() > 0) {
 				command_item* item = new command_item;
 				item->description_ = std::string("read status information");
+				item->large_response_ = PaceBmsProtocolV20::MAX_CELL_COUNT > 16;
 				item->create_request_frame_ = [this](std::vector<uint8_t>& request) -> bool { return this->pace_bms_v20_->CreateReadStatusInformationRequest(this->address_, request); };
 				item->process_response_frame_ = [this](std::vector<uint8_t>& response) -> void { this->handle_read_status_information_response_v20(response); };
 				read_queue_.push(item);
 			}
+#ifdef PACE_BMS_V20_VARIANT_PYLON
+			if (this->system_analog_information_callbacks_v20_.size() > 0) {
+				command_item* item = new command_item;
+				item->description_ = std::string("read system analog information");
+				item->large_response_ = true;
+				item->create_request_frame_ = [this](std::vector<uint8_t>& request) -> bool { return this->pace_bms_v20_->CreateReadSystemAnalogInformationRequest_PYLON(this->address_, request); };
+				item->process_response_frame_ = [this](std::vector<uint8_t>& response) -> void { this->handle_read_system_analog_information_response_v20(response); };
+				read_queue_.push(item);
+			}
+			if (this->system_status_information_callbacks_v20_.size() > 0) {
+				command_item* item = new command_item;
+				item->description_ = std::string("read system status information");
+				item->large_response_ = true;
+				item->create_request_frame_ = [this](std::vector<uint8_t>& request) -> bool { return this->pace_bms_v20_->CreateReadSystemStatusInformationRequest_PYLON(this->address_, request); };
+				item->process_response_frame_ = [this](std::vector<uint8_t>& response) -> void { this->handle_read_system_status_information_response_v20(response); };
+				read_queue_.push(item);
+			}
+#endif
+			// without a fast_poll_interval these are read along with everything else
+			if (this->fast_poll_interval_ == 0)
+				this->queue_fast_poll_commands_(this->read_queue_);
 			if (this->hardware_version_callbacks_v20_.size() > 0) {
 				command_item* item = new command_item;
 				item->description_ = std::string("read hardware version");
@@ -290,18 +455,130 @@ void PaceBms::update() {
 				item->process_response_frame_ = [this](std::vector<uint8_t>& response) -> void { this->handle_read_system_datetime_response_v20(response); };
 				read_queue_.push(item);
 			}
+#endif
 		}
 
 		ESP_LOGV(TAG, "Read commands queued: %i", read_queue_.size());
 	}
 }
 
+void PaceBms::queue_fast_poll_commands_(std::queue<command_item*>& queue) {
+	// if the previous round is still waiting its turn there's no point in piling up more behind it
+	if (!queue.empty() && &queue == &this->fast_queue_) {
+		ESP_LOGV(TAG, "Fast poll commands still in queue, skipping this fast poll cycle");
+		return;
+	}
+
+#ifdef PACE_BMS_COMMANDSET_V25
+	if (this->pace_bms_v25_ != nullptr && this->remaining_capacity_callbacks_v25_.size() > 0 && !this->capacity_from_analog_information_v25_()) {
+		command_item* item = new command_item;
+		item->description_ = std::string("read remaining capacity");
+		item->create_request_frame_ = [this](std::vector<uint8_t>& request) -> bool { return this->pace_bms_v25_->CreateReadRemainingCapacityRequest(this->address_, request); };
+		item->process_response_frame_ = [this](std::vector<uint8_t>& response) -> void { this->handle_read_remaining_capacity_response_v25(response); };
+		queue.push(item);
+	}
+#endif
+#if defined(PACE_BMS_COMMANDSET_V20) && defined(PACE_BMS_V20_VARIANT_PYLON)
+	if (this->pace_bms_v20_ != nullptr && this->charge_discharge_management_information_callbacks_v20_.size() > 0) {
+		command_item* item = new command_item;
+		item->description_ = std::string("read charge/discharge management information");
+		item->create_request_frame_ = [this](std::vector<uint8_t>& request) -> bool { return this->pace_bms_v20_->CreateReadChargeDischargeManagementInformationRequest(this->address_, request); };
+		item->process_response_frame_ = [this](std::vector<uint8_t>& response) -> void { this->handle_read_charge_discharge_management_information_response_v20(response); };
+		queue.push(item);
+	}
+#endif
+}
+
+#ifdef PACE_BMS_TRANSPORT_MODBUS
+/*
+* rebuild queue so that register reads which sit close together on the BMS are fetched by a single MODBUS request
+*     what gets merged follows directly from which child entities registered for callbacks, nothing here needs to know
+*     about individual structs, only the register range each queued read asks for
+*/
+
+void PaceBms::plan_modbus_reads_(std::queue<command_item*>& queue) {
+	std::vector<command_item*> reads;
+	std::vector<PaceBmsProtocolModbus::RegisterRange> ranges;
+	std::queue<command_item*> others;
+
+	// pull out everything that's a plain register read, anything else keeps its place in line after the block reads
+	while (!queue.empty()) {
+		command_item* item = queue.front();
+		queue.pop();
+
+		auto it = this->modbus_read_ranges_.find(item->description_);
+		if (it == this->modbus_read_ranges_.end()) {
+			std::vector<uint8_t> request;
+			PaceBmsProtocolModbus::RegisterRange range{ 0, 0 };
+			if (!item->create_request_frame_(request) || !PaceBmsProtocolModbus::GetReadRequestRange(request, range))
+				range.registerCount = 0;
+			it = this->modbus_read_ranges_.emplace(item->description_, range).first;
+		}
+
+		const PaceBmsProtocolModbus::RegisterRange& range = it->second;
+		if (range.registerCount != 0) {
+			reads.push_back(item);
+			ranges.push_back(range);
+		}
+		else {
+			others.push(item);
+		}
+	}
+
+	std::vector<PaceBmsProtocolModbus::ReadBlock> blocks = PaceBmsProtocolModbus::PlanReadBlocks(ranges, this->modbus_max_registers_per_request_, this->modbus_register_gap_tolerance_);
+	for (int b = 0; b < blocks.size(); b++) {
+		PaceBmsProtocolModbus::ReadBlock& block = blocks[b];
+
+		// nothing to merge it with, send it as it was
+		if (block.members.size() == 1) {
+			queue.push(reads[block.members[0]]);
+			continue;
+		}
+
+		command_item* item = new command_item;
+		std::vector<modbus_block_member> members;
+		for (int m = 0; m < block.members.size(); m++) {
+			command_item* read = reads[block.members[m]];
+			if (m != 0)
+				item->description_ += " + ";
+			item->description_ += read->description_;
+			members.push_back(modbus_block_member{ ranges[block.members[m]], read->process_response_frame_ });
+			delete read;
+		}
+
+		PaceBmsProtocolModbus::RegisterRange range = block.range;
+		item->large_response_ = true;
+		item->create_request_frame_ = [this, range](std::vector<uint8_t>& request) -> bool { return this->pace_bms_modbus_->CreateReadBlockRequest(this->address_, range, request); };
+		item->process_response_frame_ = [this, range, members](std::vector<uint8_t>& response) -> void { this->handle_read_register_block_response_modbus(range, members, response); };
+		queue.push(item);
+	}
+
+	while (!others.empty()) {
+		queue.push(others.front());
+		others.pop();
+	}
+
+	ESP_LOGV(TAG, "MODBUS reads planned into %i requests", blocks.size());
+}
+#endif
+
 /*
 * incrementally process incoming bytes off the bus, eventually dispatching a full response to process_response_frame_
 * once request_throttle has been satisfied and no request is outstanding, call send_next_request_frame to continue popping the read/write queues
 */
 
 void PaceBms::loop() {
+	if (this->profiler_enabled_ == false) {
+		this->loop_internal_();
+		return;
+	}
+
+	uint32_t start_us = this->now_us_();
+	this->loop_internal_();
+	this->profiler_record_(PROFILER_STAGE_LOOP, this->now_us_() - start_us);
+}
+
+void PaceBms::loop_internal_() {
 	if (this->pace_bms_v25_ == nullptr &&
 		this->pace_bms_v20_ == nullptr)
 		return;
@@ -311,7 +588,10 @@ void PaceBms::loop() {
 	{
 		std::function<void()> sensor_update_method = this->sensor_update_queue_.front();
 		this->sensor_update_queue_.pop();
+		uint32_t start_us = this->profiler_enabled_ ? this->now_us_() : 0;
 		sensor_update_method();
+		if (this->profiler_enabled_)
+			this->profiler_record_(PROFILER_STAGE_PUBLISH, this->now_us_() - start_us);
 	}
 	// don't continue while sensor publishes are pending
 	if (this->sensor_update_queue_.size() != 0)
@@ -324,21 +604,21 @@ void PaceBms::loop() {
 		uint8_t byte;
 		while (this->available() != 0) {
 			this->read_byte(&byte);
+			this->bus_capture_record_(false, &byte, 1);
 		}
 	}
 
-	const uint32_t now = millis();
+	const uint32_t now = this->now_ms_();
 
 	// if no request is active, we are not throttled, and there are pending requests to send, do so
 	if (this->request_outstanding_ == false &&
 		now - this->last_transmit_ >= this->request_throttle_ &&
-		(this->read_queue_.size() > 0 || this->write_queue_.size() > 0)) {
+		(this->read_queue_.size() > 0 || this->fast_queue_.size() > 0 || this->write_queue_.size() > 0 || this->history_pending_())) {
 		// this will do any desired logging
-		this->send_next_request_frame_();
-		this->request_outstanding_ = true;
+		this->request_outstanding_ = this->send_next_request_frame_();
 		this->last_transmit_ = now;
 		this->last_receive_ = now;
-		this->raw_data_index_ = 0;
+		this->reset_receive_buffer_();
 		return;
 	}
 
@@ -347,14 +627,16 @@ void PaceBms::loop() {
 		now - this->last_receive_ >= this->response_timeout_ &&
 		this->available() == 0) {
 		if (this->raw_data_index_ > 0) {
-			std::string str(this->raw_data_, this->raw_data_ + this->raw_data_index_ + 1);
+			std::string str = this->format_frame_(this->raw_data_.data(), this->raw_data_index_ + 1);
 			ESP_LOGW(TAG, "Response frame timeout for request %s after %i ms, partial frame: %s", this->last_request_description.c_str(), now - this->last_receive_, str.c_str());
 		}
 		else {
 			ESP_LOGW(TAG, "Response frame timeout for request %s after %i ms, no valid data received", this->last_request_description.c_str(), now - this->last_receive_);
 		}
+		this->flight_recorder_record_(false, this->raw_data_.data(), this->raw_data_index_, OUTCOME_TIMEOUT, now);
+		this->record_request_outcome_(OUTCOME_TIMEOUT, now);
 		request_outstanding_ = false;
-		this->raw_data_index_ = 0;
+		this->reset_receive_buffer_();
 		return;
 	}
 
@@ -369,30 +651,65 @@ void PaceBms::loop() {
 
 	while (this->available() != 0) {
 		this->read_byte(&this->raw_data_[this->raw_data_index_]);
+		this->bus_capture_record_(false, &this->raw_data_[this->raw_data_index_], 1);
 
-		// is the SOI marker present at byte 0?
-		if (this->raw_data_index_ == 0 && this->raw_data_[this->raw_data_index_] != '~') {
-			ESP_LOGV(TAG, "Response frame does not begin with '~', actual: 0x%02X = '%c'", this->raw_data_[this->raw_data_index_], this->raw_data_[this->raw_data_index_]);
+		// is the SOI marker (or for MODBUS, our address) present at byte 0?
+		if (this->raw_data_index_ == 0 && this->raw_data_[this->raw_data_index_] != (this->transport_modbus_ ? this->address_ : '~')) {
+			ESP_LOGV(TAG, "Response frame does not begin with '~' or the MODBUS address, actual: 0x%02X = '%c'", this->raw_data_[this->raw_data_index_], this->raw_data_[this->raw_data_index_]);
+			this->flight_recorder_record_(false, this->raw_data_.data(), 1, OUTCOME_OTHER_ERROR, now);
+			this->record_request_outcome_(OUTCOME_OTHER_ERROR, now);
 			request_outstanding_ = false;
-			this->raw_data_index_ = 0;
+			this->reset_receive_buffer_();
 			return;
 		}
+		if (this->raw_data_index_ == 0 && this->profiler_enabled_) {
+			this->profiler_first_byte_us_ = this->now_us_();
+			this->profiler_record_(PROFILER_STAGE_WAIT_FIRST_BYTE, this->profiler_first_byte_us_ - this->profiler_transmit_end_us_);
+		}
+
+		// once enough of the header is in to know how long this frame is going to be, make sure it will fit
+		if (this->raw_data_expected_length_ == 0) {
+			if (this->transport_modbus_) {
+#ifdef PACE_BMS_TRANSPORT_MODBUS
+				this->raw_data_expected_length_ = PaceBmsProtocolModbus::GetResponseFrameLength(this->raw_data_.data(), this->raw_data_index_ + 1);
+#endif
+			}
+			else {
+				this->raw_data_expected_length_ = PaceBmsProtocolBase::GetResponseFrameLength(this->raw_data_.data(), this->raw_data_index_ + 1);
+			}
+			// anything not expected to be large runs into the end of the buffer below and is dropped
+			if (this->raw_data_expected_length_ > this->raw_data_.size() && this->large_response_expected_) {
+				ESP_LOGD(TAG, "Growing receive buffer from %u to %u bytes for response to '%s'", (unsigned)this->raw_data_.size(), (unsigned)this->raw_data_expected_length_, this->last_request_description.c_str());
+				this->grow_receive_buffer_(this->raw_data_expected_length_);
+			}
+		}
 
 		// is this the end of a frame? process it
-		if (this->raw_data_[this->raw_data_index_] == '\r') {
+		//     MODBUS has no EOI, the header says how long the frame is going to be instead
+		bool end_of_frame = this->raw_data_expected_length_ != 0 && this->raw_data_index_ + 1 >= this->raw_data_expected_length_;
+		if (!this->transport_modbus_ && this->raw_data_[this->raw_data_index_] == '\r')
+			end_of_frame = true;
+		if (end_of_frame) {
+			if (this->profiler_enabled_)
+				this->profiler_record_(PROFILER_STAGE_RECEIVE, this->now_us_() - this->profiler_first_byte_us_);
 			// this will do any desired logging
-			this->process_response_frame_(this->raw_data_, this->raw_data_index_ + 1);
+			this->process_response_frame_(this->raw_data_.data(), this->raw_data_index_ + 1);
+			request_outcome outcome = this->response_outcome_;
+			this->flight_recorder_record_(false, this->raw_data_.data(), this->raw_data_index_ + 1, outcome, now);
+			this->record_request_outcome_(outcome, now);
 			request_outstanding_ = false;
-			this->raw_data_index_ = 0;
+			this->reset_receive_buffer_();
 			return;
 		}
 
 		// did we run out of buffer before EOI?
-		if (this->raw_data_index_ + 1 >= this->max_data_len_) {
-			std::string str(this->raw_data_, this->raw_data_ + this->raw_data_index_ + 1);
+		if (this->raw_data_index_ + 1 >= this->raw_data_.size()) {
+			std::string str = this->format_frame_(this->raw_data_.data(), this->raw_data_index_ + 1);
 			ESP_LOGV(TAG, "Response frame exceeds maximum supported length, last request was '%s', incomplete response frame: %s", this->last_request_description.c_str(), str.c_str());
+			this->flight_recorder_record_(false, this->raw_data_.data(), this->raw_data_index_ + 1, OUTCOME_OTHER_ERROR, now);
+			this->record_request_outcome_(OUTCOME_OTHER_ERROR, now);
 			request_outstanding_ = false;
-			this->raw_data_index_ = 0;
+			this->reset_receive_buffer_();
 			return;
 		}
 
@@ -401,19 +718,33 @@ void PaceBms::loop() {
 }
 
 // pops the next item off of this->command_queue_, generates and dispatches a request frame, and sets up this->next_response_handler_
-void PaceBms::send_next_request_frame_() {
+bool PaceBms::send_next_request_frame_() {
 
-	if (read_queue_.empty() && write_queue_.empty()) {
+	if (read_queue_.empty() && fast_queue_.empty() && write_queue_.empty() && !this->history_pending_()) {
 		ESP_LOGE(TAG, "command queue empty on send_next_request_frame");
-		return;
+		return false;
 	}
 
 	// always process writes first
 	PaceBms::command_item* command;
-	if (!write_queue_.empty()) {
+	if (read_queue_.empty() && fast_queue_.empty() && write_queue_.empty()) {
+		// only the history download is left, it's generated here rather than queued so that it never gets in anybody's way
+#ifdef PACE_BMS_COMMANDSET_V25
+		command = this->create_history_command_item_();
+#else
+		command = nullptr;
+#endif
+		if (command == nullptr)
+			return false;
+	}
+	else if (!write_queue_.empty()) {
 		command = write_queue_.front();
 		write_queue_.pop_front();
 	}
+	else if (!fast_queue_.empty()) {
+		command = fast_queue_.front();
+		fast_queue_.pop();
+	}
 	else {
 		command = read_queue_.front();
 		read_queue_.pop();
@@ -423,64 +754,363 @@ void PaceBms::send_next_request_frame_() {
 	this->next_response_handler_ = command->process_response_frame_;
 	// saved for logging
 	this->last_request_description = command->description_;
+	this->large_response_expected_ = command->large_response_;
 
 	std::vector<uint8_t> request;
+	uint32_t start_us = this->profiler_enabled_ ? this->now_us_() : 0;
 	if (false == command->create_request_frame_(request)) {
 		ESP_LOGE(TAG, "Error creating '%s' request frame", command->description_.c_str());
-		return;
+		this->next_response_handler_ = nullptr;
+		delete(command);
+		return false;
 	}
+	if (this->profiler_enabled_)
+		this->profiler_record_(PROFILER_STAGE_ENCODE, this->now_us_() - start_us);
+	// only count requests that actually make it onto the bus
+	this->record_request_sent_();
 
 	ESP_LOGD(TAG, "Sending '%s' request", command->description_.c_str());
+	this->flight_recorder_record_(true, request.data(), request.size(), OUTCOME_OK, this->now_ms_());
 #if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_VERY_VERBOSE
 	{
-		std::string str(request.data(), request.data() + request.size());
+		std::string str = this->format_frame_(request.data(), request.size());
 		ESP_LOGVV(TAG, "Request frame: %s", str.c_str());
 	}
 #endif
 
+	start_us = this->profiler_enabled_ ? this->now_us_() : 0;
 	if (this->flow_control_pin_ != nullptr)
 		this->flow_control_pin_->digital_write(true);
 	this->write_array(request.data(), request.size());
+	this->bus_capture_record_(true, request.data(), request.size());
 	// if flow control is required (rs485 does read+write on the same differential pair) then I don't see any other option than to block on flush()
 	// if using rs232, a flow control pin should not be assigned in yaml in order to avoid this block
 	if (this->flow_control_pin_ != nullptr) {
 		this->flush();
 		this->flow_control_pin_->digital_write(false);
 	}
+	if (this->profiler_enabled_) {
+		this->profiler_transmit_end_us_ = this->now_us_();
+		this->profiler_record_(PROFILER_STAGE_TRANSMIT, this->profiler_transmit_end_us_ - start_us);
+	}
 
 	delete(command);
+	return true;
 }
 
 // calls this->next_response_handler_ (set up from the previously dispatched command_queue_ item)
-void PaceBms::process_response_frame_(uint8_t* frame_bytes, uint8_t frame_length) {
+void PaceBms::process_response_frame_(uint8_t* frame_bytes, uint16_t frame_length) {
 	ESP_LOGV(TAG, "Processing response frame for '%s' request", this->last_request_description.c_str());
 #if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_VERY_VERBOSE
 	{
-		std::string str(frame_bytes, frame_bytes + frame_length);
+		std::string str = this->format_frame_(frame_bytes, frame_length);
 		ESP_LOGVV(TAG, "Response frame: %s", str.c_str());
 	}
 #endif
 
+	uint32_t start_us = this->profiler_enabled_ ? this->now_us_() : 0;
+	this->profiler_decoded_us_ = 0;
+
 	std::vector<uint8_t> response(frame_bytes, frame_bytes + frame_length);
 
+	// the handler reports how the decode went, a frame that no handler looked at isn't counted as ok
+	this->response_outcome_ = OUTCOME_OTHER_ERROR;
 	if (next_response_handler_ != nullptr)
 		next_response_handler_(response);
 	else
 		ESP_LOGE(TAG, "Response frame received but no response handler set");
 
+	// the handler marks the point where decoding finished and dispatch to child callbacks began, unless decoding failed
+	if (this->profiler_enabled_) {
+		uint32_t end_us = this->now_us_();
+		if (this->profiler_decoded_us_ != 0) {
+			this->profiler_record_(PROFILER_STAGE_DECODE, this->profiler_decoded_us_ - start_us);
+			this->profiler_record_(PROFILER_STAGE_DISPATCH, end_us - this->profiler_decoded_us_);
+		}
+		else {
+			this->profiler_record_(PROFILER_STAGE_DECODE, end_us - start_us);
+		}
+	}
+
 	// this request/response pair is complete, any additional frames received will not be expected and should not be processed until the next command queue pop / send
 	next_response_handler_ = nullptr;
 }
 
+std::string PaceBms::format_frame_(const uint8_t* frame_bytes, uint16_t frame_length) {
+	if (this->transport_modbus_) {
+		static const char* const hex = "0123456789ABCDEF";
+		std::string str;
+		str.reserve(frame_length * 3);
+		for (uint16_t i = 0; i < frame_length; i++) {
+			if (i != 0)
+				str.push_back(' ');
+			str.push_back(hex[frame_bytes[i] >> 4]);
+			str.push_back(hex[frame_bytes[i] & 0x0F]);
+		}
+		return str;
+	}
+
+	// a garbled or partial frame could contain anything
+	std::string str(frame_bytes, frame_bytes + frame_length);
+	for (char& c : str) {
+		if (c < 0x20 || c > 0x7E)
+			c = '.';
+	}
+	return str;
+}
+
+/*
+* bus metrics bookkeeping
+*/
+
+// called by every response handler straight after its Process call, a response only counts as ok if it decoded, one that
+//     validated but couldn't be decoded is an "other" error
+void PaceBms::mark_response_decoded_(bool decoded) {
+	this->profiler_mark_decoded_();
+	this->response_outcome_ = decoded ? OUTCOME_OK : this->get_decode_failure_outcome_();
+}
+
+// maps the protocol implementation's opinion of the response it just failed to decode onto a request outcome
+PaceBms::request_outcome PaceBms::get_decode_failure_outcome_() {
+	PaceBmsProtocolBase::ResponseValidationResult result = PaceBmsProtocolBase::RVR_Ok;
+	if (this->pace_bms_v25_ != nullptr)
+		result = this->pace_bms_v25_->GetLastResponseValidationResult();
+	else if (this->pace_bms_v20_ != nullptr)
+		result = this->pace_bms_v20_->GetLastResponseValidationResult();
+
+	switch (result) {
+		case PaceBmsProtocolBase::RVR_ChecksumError:
+			return OUTCOME_CHECKSUM_ERROR;
+		case PaceBmsProtocolBase::RVR_ReturnCodeError:
+			return OUTCOME_RETURN_CODE_ERROR;
+		default:
+			return OUTCOME_OTHER_ERROR;
+	}
+}
+
+void PaceBms::record_request_sent_() {
+	// std::map node addresses are stable so it's safe to hang on to this until the request completes
+	this->current_command_metrics_ = &this->command_metrics_[this->last_request_description];
+	this->current_command_metrics_->requests_sent_++;
+	this->bus_metrics_.requests_sent_++;
+}
+
+void PaceBms::record_request_outcome_(request_outcome outcome, uint32_t now) {
+	uint32_t elapsed = now - this->last_transmit_;
+	this->bus_busy_ms_ += elapsed;
+
+	// count against both the bus as a whole and the specific command, if we know what it was
+	bus_metrics* metrics[2] = { &this->bus_metrics_, this->current_command_metrics_ };
+	for (bus_metrics* m : metrics) {
+		if (m == nullptr)
+			continue;
+		switch (outcome) {
+			case OUTCOME_OK:
+				m->responses_ok_++;
+				m->latency_sum_ms_ += elapsed;
+				if (elapsed > m->latency_max_ms_)
+					m->latency_max_ms_ = elapsed;
+				break;
+			case OUTCOME_TIMEOUT:
+				m->timeouts_++;
+				break;
+			case OUTCOME_CHECKSUM_ERROR:
+				m->checksum_errors_++;
+				break;
+			case OUTCOME_RETURN_CODE_ERROR:
+				m->return_code_errors_++;
+				break;
+			default:
+				m->other_errors_++;
+				break;
+		}
+	}
+	this->current_command_metrics_ = nullptr;
+
+	if (outcome == OUTCOME_OK) {
+		this->latency_samples_[this->latency_sample_index_] = (uint16_t)std::min(elapsed, (uint32_t)UINT16_MAX);
+		this->latency_sample_index_ = (this->latency_sample_index_ + 1) % this->latency_sample_count_;
+		if (this->latency_sample_fill_ < this->latency_sample_count_)
+			this->latency_sample_fill_++;
+	}
+}
+
+// fills in the windowed values and hands the bus-wide and per-command metrics to any registered callbacks
+void PaceBms::publish_bus_metrics_(uint32_t now) {
+	uint32_t window = now - this->last_bus_metrics_publish_;
+	if (this->last_bus_metrics_publish_ != 0 && window > 0)
+		this->bus_metrics_.utilization_percent_ = std::min(100.0f, (this->bus_busy_ms_ * 100.0f) / window);
+	this->last_bus_metrics_publish_ = now;
+	this->bus_busy_ms_ = 0;
+
+	if (this->latency_sample_fill_ > 0) {
+		uint16_t sorted[latency_sample_count_];
+		uint32_t sum = 0;
+		for (int i = 0; i < this->latency_sample_fill_; i++) {
+			sorted[i] = this->latency_samples_[i];
+			sum += sorted[i];
+		}
+		uint8_t p95_index = (this->latency_sample_fill_ * 95) / 100;
+		if (p95_index >= this->latency_sample_fill_)
+			p95_index = this->latency_sample_fill_ - 1;
+		std::nth_element(sorted, sorted + p95_index, sorted + this->latency_sample_fill_);
+		this->bus_metrics_.mean_latency_ms_ = (float)sum / this->latency_sample_fill_;
+		this->bus_metrics_.p95_latency_ms_ = sorted[p95_index];
+	}
+
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_VERBOSE
+	for (auto& it : this->command_metrics_) {
+		const bus_metrics& m = it.second;
+		ESP_LOGV(TAG, "Bus metrics for '%s': sent %" PRIu32 ", ok %" PRIu32 ", timeouts %" PRIu32 ", checksum errors %" PRIu32 ", return code errors %" PRIu32 ", other errors %" PRIu32 ", mean latency %" PRIu32 " ms, max latency %" PRIu32 " ms",
+			it.first.c_str(), m.requests_sent_, m.responses_ok_, m.timeouts_, m.checksum_errors_, m.return_code_errors_, m.other_errors_,
+			m.responses_ok_ == 0 ? (uint32_t)0 : m.latency_sum_ms_ / m.responses_ok_, m.latency_max_ms_);
+	}
+#endif
+
+	for (int i = 0; i < this->bus_metrics_callbacks_.size(); i++) {
+		bus_metrics_callbacks_[i](this->bus_metrics_);
+	}
+	for (int i = 0; i < this->command_metrics_callbacks_.size(); i++) {
+		command_metrics_callbacks_[i](this->command_metrics_);
+	}
+}
+
+/*
+* profiler
+*/
+
+const char* PaceBms::profiler_stage_to_string(profiler_stage stage) {
+	switch (stage) {
+		case PROFILER_STAGE_ENCODE:
+			return "encode";
+		case PROFILER_STAGE_TRANSMIT:
+			return "transmit";
+		case PROFILER_STAGE_WAIT_FIRST_BYTE:
+			return "wait";
+		case PROFILER_STAGE_RECEIVE:
+			return "receive";
+		case PROFILER_STAGE_DECODE:
+			return "decode";
+		case PROFILER_STAGE_DISPATCH:
+			return "dispatch";
+		case PROFILER_STAGE_PUBLISH:
+			return "publish";
+		case PROFILER_STAGE_LOOP:
+			return "loop";
+		default:
+			return "unknown";
+	}
+}
+
+void PaceBms::profiler_record_(profiler_stage stage, uint32_t elapsed_us) {
+	profiler_stage_stats& stats = this->profiler_stats_.stages_[stage];
+	if (stats.count_ == 0 || elapsed_us < stats.min_us_)
+		stats.min_us_ = elapsed_us;
+	if (elapsed_us > stats.max_us_)
+		stats.max_us_ = elapsed_us;
+	stats.total_us_ += elapsed_us;
+	stats.count_++;
+}
+
+// hands the timings gathered since the last update() to any registered callbacks and starts a new window
+void PaceBms::publish_profiler_stats_() {
+	if (this->profiler_enabled_ == false)
+		return;
+
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_VERBOSE
+	for (int i = 0; i < PROFILER_STAGE_COUNT; i++) {
+		const profiler_stage_stats& stats = this->profiler_stats_.stages_[i];
+		ESP_LOGV(TAG, "Profiler stage '%s': count %" PRIu32 ", min %" PRIu32 " us, avg %" PRIu32 " us, max %" PRIu32 " us",
+			profiler_stage_to_string((profiler_stage)i), stats.count_, stats.min_us_, stats.count_ == 0 ? (uint32_t)0 : stats.total_us_ / stats.count_, stats.max_us_);
+	}
+#endif
+
+	for (int i = 0; i < this->profiler_callbacks_.size(); i++) {
+		profiler_callbacks_[i](this->profiler_stats_);
+	}
+
+	this->profiler_stats_ = profiler_stats();
+}
+
+/*
+* flight recorder
+*/
+
+void PaceBms::flight_recorder_record_(bool is_request, const uint8_t* frame_bytes, uint16_t frame_length, request_outcome outcome, uint32_t now) {
+	if (this->flight_recorder_.empty() || this->flight_recorder_frozen_)
+		return;
+
+	flight_recorder_entry& entry = this->flight_recorder_[this->flight_recorder_index_];
+	entry.timestamp_ = now;
+	entry.is_request_ = is_request;
+	entry.outcome_ = outcome;
+	entry.frame_.assign(frame_bytes, frame_bytes + (frame_length < max_data_len_ ? frame_length : max_data_len_));
+	this->flight_recorder_index_ = (this->flight_recorder_index_ + 1) % this->flight_recorder_.size();
+
+	if (this->flight_recorder_freeze_pending_) {
+		this->flight_recorder_freeze_pending_ = false;
+		this->flight_recorder_frozen_ = true;
+		ESP_LOGW(TAG, "Protection or fault condition detected, flight recorder frozen until dumped");
+	}
+}
+
+// only the transition into a protection/fault state freezes the recorder, otherwise a long-lived fault would re-freeze it immediately after every dump
+void PaceBms::flight_recorder_check_for_event_(bool event_active) {
+	if (event_active && !this->flight_recorder_event_active_ && !this->flight_recorder_frozen_)
+		this->flight_recorder_freeze_pending_ = true;
+	this->flight_recorder_event_active_ = event_active;
+}
+
+const char* PaceBms::request_outcome_to_string_(request_outcome outcome) {
+	switch (outcome) {
+		case OUTCOME_OK:
+			return "ok";
+		case OUTCOME_TIMEOUT:
+			return "timeout";
+		case OUTCOME_CHECKSUM_ERROR:
+			return "checksum error";
+		case OUTCOME_RETURN_CODE_ERROR:
+			return "return code error";
+		default:
+			return "error";
+	}
+}
+
+void PaceBms::dump_flight_recorder() {
+	if (this->flight_recorder_.empty()) {
+		ESP_LOGW(TAG, "Flight recorder is not enabled, set flight_recorder_size in the pace_bms config");
+		return;
+	}
+
+	ESP_LOGI(TAG, "Flight recorder dump%s, now = %" PRIu32 " ms:", this->flight_recorder_frozen_ ? " (frozen)" : "", this->now_ms_());
+	for (uint8_t i = 0; i < this->flight_recorder_.size(); i++) {
+		// start from the oldest entry, which is the one that will be overwritten next
+		const flight_recorder_entry& entry = this->flight_recorder_[(this->flight_recorder_index_ + i) % this->flight_recorder_.size()];
+		if (entry.timestamp_ == 0 && entry.frame_.empty())
+			continue;
+
+		std::string str = this->format_frame_(entry.frame_.data(), entry.frame_.size());
+		if (entry.is_request_)
+			ESP_LOGI(TAG, "  %10" PRIu32 " TX: %s", entry.timestamp_, str.c_str());
+		else
+			ESP_LOGI(TAG, "  %10" PRIu32 " RX (%s): %s", entry.timestamp_, request_outcome_to_string_(entry.outcome_), str.c_str());
+	}
+
+	this->flight_recorder_frozen_ = false;
+	this->flight_recorder_freeze_pending_ = false;
+}
+
 /*
 * read/write response frame received handlers, called via next_response_handler_ from process_response_frame
 */
 
+#ifdef PACE_BMS_COMMANDSET_V25
 void PaceBms::handle_read_analog_information_response_v25(std::vector<uint8_t>& response) {
 	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
 
 	PaceBmsProtocolV25::AnalogInformation analog_information;
-	bool result = this->pace_bms_v25_->ProcessReadAnalogInformationResponse(this->address_, response, analog_information);
+	bool result = this->pace_bms_v25_->ProcessReadAnalogInformationResponse(this->address_, response, analog_information, this->analog_information_fields_);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -490,29 +1120,68 @@ void PaceBms::handle_read_analog_information_response_v25(std::vector<uint8_t>&
 	for (int i = 0; i < this->analog_information_callbacks_v25_.size(); i++) {
 		analog_information_callbacks_v25_[i](analog_information);
 	}
+	if (this->capacity_from_analog_information_v25_()) {
+		uint32_t remaining_capacity = analog_information.remainingCapacityMilliampHours;
+		uint32_t actual_capacity = analog_information.fullCapacityMilliampHours;
+		uint32_t design_capacity = analog_information.designCapacityMilliampHours;
+		for (int i = 0; i < this->remaining_capacity_callbacks_v25_.size(); i++) {
+			remaining_capacity_callbacks_v25_[i](remaining_capacity, actual_capacity, design_capacity);
+		}
+	}
 }
 
 void PaceBms::handle_read_status_information_response_v25(std::vector<uint8_t>& response) {
 	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
 
 	PaceBmsProtocolV25::StatusInformation status_information;
-	bool result = this->pace_bms_v25_->ProcessReadStatusInformationResponse(this->address_, response, status_information);
+	bool result = this->pace_bms_v25_->ProcessReadStatusInformationResponse(this->address_, response, status_information, this->status_information_fields_);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
 	}
 
+	// freeze the flight recorder if a protection or fault condition has just appeared
+	if (!this->flight_recorder_.empty())
+		this->flight_recorder_check_for_event_(status_information.protection_value1 != 0 || status_information.protection_value2 != 0 || status_information.fault_value != 0);
+
 	// dispatch to any child components that registered for a callback with us
 	for (int i = 0; i < this->status_information_callbacks_v25_.size(); i++) {
 		status_information_callbacks_v25_[i](status_information);
 	}
 }
 
+#ifdef PACE_BMS_TRANSPORT_MODBUS
+void PaceBms::handle_read_register_block_response_modbus(PaceBmsProtocolModbus::RegisterRange block, const std::vector<modbus_block_member>& members, std::vector<uint8_t>& response) {
+	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
+
+	bool result = this->pace_bms_modbus_->ValidateReadBlockResponse(this->address_, response, block);
+	if (result == false) {
+		this->mark_response_decoded_(result);
+		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
+		return;
+	}
+
+	// hand each member the slice of the block it asked for, exactly as if it had been read on its own
+	//     the block only counts as ok if every member decoded
+	std::vector<uint8_t> member_response;
+	request_outcome outcome = OUTCOME_OK;
+	for (int i = 0; i < members.size(); i++) {
+		this->pace_bms_modbus_->ExtractReadBlockResponse(this->address_, response, block, members[i].range_, member_response);
+		members[i].process_response_frame_(member_response);
+		if (this->response_outcome_ != OUTCOME_OK)
+			outcome = this->response_outcome_;
+	}
+	this->response_outcome_ = outcome;
+}
+#endif
+
 void PaceBms::handle_read_hardware_version_response_v25(std::vector<uint8_t>& response) {
 	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
 
 	std::string hardware_version;
 	bool result = this->pace_bms_v25_->ProcessReadHardwareVersionResponse(this->address_, response, hardware_version);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -529,6 +1198,7 @@ void PaceBms::handle_read_serial_number_response_v25(std::vector<uint8_t>& respo
 
 	std::string serial_number;
 	bool result = this->pace_bms_v25_->ProcessReadSerialNumberResponse(this->address_, response, serial_number);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -544,6 +1214,7 @@ void PaceBms::handle_write_switch_command_response_v25(PaceBmsProtocolV25::Switc
 	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
 
 	bool result = this->pace_bms_v25_->ProcessWriteSwitchCommandResponse(this->address_, switch_command, response);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -554,6 +1225,7 @@ void PaceBms::handle_write_mosfet_switch_command_response_v25(PaceBmsProtocolV25
 	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
 
 	bool result = this->pace_bms_v25_->ProcessWriteMosfetSwitchCommandResponse(this->address_, type, state, response);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -564,6 +1236,7 @@ void PaceBms::handle_write_shutdown_command_response_v25(std::vector<uint8_t>& r
 	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
 
 	bool result = this->pace_bms_v25_->ProcessWriteShutdownCommandResponse(this->address_, response);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -575,16 +1248,22 @@ void PaceBms::handle_read_protocols_response_v25(std::vector<uint8_t>& response)
 
 	PaceBmsProtocolV25::Protocols protocols;
 	bool result = this->pace_bms_v25_->ProcessReadProtocolsResponse(this->address_, response, protocols);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
 	}
+	// dispatch to any child components that registered for a callback with us
+	for (int i = 0; i < this->protocols_callbacks_v25_.size(); i++) {
+		protocols_callbacks_v25_[i](protocols);
+	}
 }
 
 void PaceBms::handle_write_protocols_response_v25(PaceBmsProtocolV25::Protocols protocols, std::vector<uint8_t>& response) {
 	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
 
 	bool result = this->pace_bms_v25_->ProcessWriteProtocolsResponse(this->address_, response);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -596,6 +1275,7 @@ void PaceBms::handle_read_cell_over_voltage_configuration_response_v25(std::vect
 
 	PaceBmsProtocolV25::CellOverVoltageConfiguration config;
 	bool result = this->pace_bms_v25_->ProcessReadConfigurationResponse(this->address_, response, config);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -611,6 +1291,7 @@ void PaceBms::handle_read_pack_over_voltage_configuration_response_v25(std::vect
 
 	PaceBmsProtocolV25::PackOverVoltageConfiguration config;
 	bool result = this->pace_bms_v25_->ProcessReadConfigurationResponse(this->address_, response, config);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -626,6 +1307,7 @@ void PaceBms::handle_read_cell_under_voltage_configuration_response_v25(std::vec
 
 	PaceBmsProtocolV25::CellUnderVoltageConfiguration config;
 	bool result = this->pace_bms_v25_->ProcessReadConfigurationResponse(this->address_, response, config);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -641,6 +1323,7 @@ void PaceBms::handle_read_pack_under_voltage_configuration_response_v25(std::vec
 
 	PaceBmsProtocolV25::PackUnderVoltageConfiguration config;
 	bool result = this->pace_bms_v25_->ProcessReadConfigurationResponse(this->address_, response, config);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -656,6 +1339,7 @@ void PaceBms::handle_read_charge_over_current_configuration_response_v25(std::ve
 
 	PaceBmsProtocolV25::ChargeOverCurrentConfiguration config;
 	bool result = this->pace_bms_v25_->ProcessReadConfigurationResponse(this->address_, response, config);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -672,6 +1356,7 @@ void PaceBms::handle_read_discharge_over_current1_configuration_response_v25(std
 
 	PaceBmsProtocolV25::DischargeOverCurrent1Configuration config;
 	bool result = this->pace_bms_v25_->ProcessReadConfigurationResponse(this->address_, response, config);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -687,6 +1372,7 @@ void PaceBms::handle_read_discharge_over_current2_configuration_response_v25(std
 
 	PaceBmsProtocolV25::DischargeOverCurrent2Configuration config;
 	bool result = this->pace_bms_v25_->ProcessReadConfigurationResponse(this->address_, response, config);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -702,6 +1388,7 @@ void PaceBms::handle_read_short_circuit_protection_configuration_response_v25(st
 
 	PaceBmsProtocolV25::ShortCircuitProtectionConfiguration config;
 	bool result = this->pace_bms_v25_->ProcessReadConfigurationResponse(this->address_, response, config);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -717,6 +1404,7 @@ void PaceBms::handle_read_cell_balancing_configuration_response_v25(std::vector<
 
 	PaceBmsProtocolV25::CellBalancingConfiguration config;
 	bool result = this->pace_bms_v25_->ProcessReadConfigurationResponse(this->address_, response, config);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -732,6 +1420,7 @@ void PaceBms::handle_read_sleep_configuration_response_v25(std::vector<uint8_t>&
 
 	PaceBmsProtocolV25::SleepConfiguration config;
 	bool result = this->pace_bms_v25_->ProcessReadConfigurationResponse(this->address_, response, config);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -747,6 +1436,7 @@ void PaceBms::handle_read_full_charge_low_charge_configuration_response_v25(std:
 
 	PaceBmsProtocolV25::FullChargeLowChargeConfiguration config;
 	bool result = this->pace_bms_v25_->ProcessReadConfigurationResponse(this->address_, response, config);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -762,6 +1452,7 @@ void PaceBms::handle_read_charge_and_discharge_over_temperature_configuration_re
 
 	PaceBmsProtocolV25::ChargeAndDischargeOverTemperatureConfiguration config;
 	bool result = this->pace_bms_v25_->ProcessReadConfigurationResponse(this->address_, response, config);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -777,6 +1468,7 @@ void PaceBms::handle_read_charge_and_discharge_under_temperature_configuration_r
 
 	PaceBmsProtocolV25::ChargeAndDischargeUnderTemperatureConfiguration config;
 	bool result = this->pace_bms_v25_->ProcessReadConfigurationResponse(this->address_, response, config);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -791,10 +1483,151 @@ void PaceBms::handle_write_configuration_response_v25(std::vector<uint8_t>& resp
 	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
 
 	bool result = this->pace_bms_v25_->ProcessWriteConfigurationResponse(this->address_, response);
+	this->mark_response_decoded_(result);
+	if (result == false) {
+		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
+		return;
+	}
+}
+
+void PaceBms::handle_read_remaining_capacity_response_v25(std::vector<uint8_t>& response) {
+	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
+
+	uint32_t remaining_capacity;
+	uint32_t actual_capacity;
+	uint32_t design_capacity;
+	bool result = this->pace_bms_v25_->ProcessReadRemainingCapacityResponse(this->address_, response, remaining_capacity, actual_capacity, design_capacity);
+	this->mark_response_decoded_(result);
+	if (result == false) {
+		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
+		if (this->pace_bms_v25_->GetLastResponseValidationResult() == PaceBmsProtocolBase::RVR_ReturnCodeError) {
+			ESP_LOGW(TAG, "BMS does not support '%s', capacity will be read from the analog information every update_interval instead", this->last_request_description.c_str());
+			this->remaining_capacity_supported_v25_ = false;
+		}
+		return;
+	}
+	// dispatch to any child components that registered for a callback with us
+	for (int i = 0; i < this->remaining_capacity_callbacks_v25_.size(); i++) {
+		remaining_capacity_callbacks_v25_[i](remaining_capacity, actual_capacity, design_capacity);
+	}
+}
+
+void PaceBms::handle_read_charge_current_limiter_start_current_response_v25(std::vector<uint8_t>& response) {
+	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
+
+	uint8_t current;
+	bool result = this->pace_bms_v25_->ProcessReadChargeCurrentLimiterStartCurrentResponse(this->address_, response, current);
+	this->mark_response_decoded_(result);
+	if (result == false) {
+		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
+		return;
+	}
+	// dispatch to any child components that registered for a callback with us
+	for (int i = 0; i < this->charge_current_limiter_start_current_callbacks_v25_.size(); i++) {
+		charge_current_limiter_start_current_callbacks_v25_[i](current);
+	}
+}
+
+void PaceBms::handle_write_charge_current_limiter_start_current_response_v25(std::vector<uint8_t>& response) {
+	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
+
+	bool result = this->pace_bms_v25_->ProcessWriteChargeCurrentLimiterStartCurrentResponse(this->address_, response);
+	this->mark_response_decoded_(result);
+	if (result == false) {
+		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
+		return;
+	}
+}
+
+/*
+* history record download, see: history_cursor
+*/
+
+uint32_t PaceBms::history_key_(const PaceBmsProtocolV25::DateTime& date_time) {
+	return ((uint32_t)(date_time.Year - 2000) << 26) | ((uint32_t)date_time.Month << 22) | ((uint32_t)date_time.Day << 17) |
+		((uint32_t)date_time.Hour << 12) | ((uint32_t)date_time.Minute << 6) | (uint32_t)date_time.Second;
+}
+
+PaceBms::command_item* PaceBms::create_history_command_item_() {
+	// the previous request never made it back to its handler (timeout or garbage on the bus), rather than retrying 
+	//     forever in the idle time leave it until the next update() and resume from the same spot then
+	if (this->history_request_sent_) {
+		ESP_LOGW(TAG, "History download interrupted at record %i, will retry next update", this->history_cursor_.next_index_);
+		this->finish_history_pass_(false);
+		return nullptr;
+	}
+
+	uint16_t record_index = this->history_cursor_.next_index_;
+	command_item* item = new command_item;
+	item->description_ = std::string("read history record");
+	item->large_response_ = true;
+	item->create_request_frame_ = [this, record_index](std::vector<uint8_t>& request) -> bool { return this->pace_bms_v25_->CreateReadHistoryRecordRequest(this->address_, record_index, request); };
+	item->process_response_frame_ = [this, record_index](std::vector<uint8_t>& response) -> void { this->handle_read_history_record_response_v25(record_index, response); };
+	this->history_request_sent_ = true;
+	return item;
+}
+
+void PaceBms::finish_history_pass_(bool completed) {
+	this->history_pass_active_ = false;
+	this->history_request_sent_ = false;
+	if (!completed)
+		return;
+
+	if (this->history_cursor_.pass_newest_ > this->history_cursor_.synced_newest_)
+		this->history_cursor_.synced_newest_ = this->history_cursor_.pass_newest_;
+	this->history_cursor_.pass_newest_ = 0;
+	this->history_cursor_.pass_oldest_ = UINT32_MAX;
+	this->history_cursor_.next_index_ = 0;
+	this->history_preference_.save(&this->history_cursor_);
+
+	if (this->history_records_this_pass_ > 0)
+		ESP_LOGI(TAG, "History download complete, %i new records", this->history_records_this_pass_);
+}
+
+void PaceBms::handle_read_history_record_response_v25(uint16_t record_index, std::vector<uint8_t>& response) {
+	ESP_LOGD(TAG, "Processing '%s' response for record %i", this->last_request_description.c_str(), record_index);
+	this->history_request_sent_ = false;
+
+	PaceBmsProtocolV25::HistoryRecord record;
+	bool end_of_history;
+	bool result = this->pace_bms_v25_->ProcessReadHistoryRecordResponse(this->address_, response, record, end_of_history);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
+		this->finish_history_pass_(false);
+		return;
+	}
+
+	// caught up, either with the end of the log or with what we've already handed out
+	//     records are only identified by their timestamp, so a record sharing the same second as the newest one already 
+	//     handed out is treated as already seen
+	uint32_t key = end_of_history ? 0 : history_key_(record.dateTime);
+	if (end_of_history || key <= this->history_cursor_.synced_newest_) {
+		this->finish_history_pass_(true);
 		return;
 	}
+
+	this->history_cursor_.next_index_ = record_index + 1;
+
+	// anything at or above pass_oldest_ was already handed out by this pass, the log grew at the front since the pass started 
+	//     (or was resumed) and shifted the indexes, so just step past it
+	if (key < this->history_cursor_.pass_oldest_) {
+		if (key > this->history_cursor_.pass_newest_)
+			this->history_cursor_.pass_newest_ = key;
+		this->history_cursor_.pass_oldest_ = key;
+		this->history_records_this_pass_++;
+
+		// dispatch to any child components that registered for a callback with us
+		for (int i = 0; i < this->history_record_callbacks_v25_.size(); i++) {
+			history_record_callbacks_v25_[i](record);
+		}
+	}
+
+	if (this->history_cursor_.next_index_ >= PaceBmsProtocolV25::MAX_HISTORY_RECORD_COUNT) {
+		this->finish_history_pass_(true);
+		return;
+	}
+	this->history_preference_.save(&this->history_cursor_);
 }
 
 void PaceBms::handle_read_system_datetime_response_v25(std::vector<uint8_t>& response) {
@@ -802,6 +1635,7 @@ void PaceBms::handle_read_system_datetime_response_v25(std::vector<uint8_t>& res
 
 	PaceBmsProtocolV25::DateTime dt;
 	bool result = this->pace_bms_v25_->ProcessReadSystemDateTimeResponse(this->address_, response, dt);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -817,6 +1651,7 @@ void PaceBms::handle_read_mosfet_over_temperature_configuration_response_v25(std
 
 	PaceBmsProtocolV25::MosfetOverTemperatureConfiguration config;
 	bool result = this->pace_bms_v25_->ProcessReadConfigurationResponse(this->address_, response, config);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -832,6 +1667,7 @@ void PaceBms::handle_read_environment_over_under_temperature_configuration_respo
 
 	PaceBmsProtocolV25::EnvironmentOverUnderTemperatureConfiguration config;
 	bool result = this->pace_bms_v25_->ProcessReadConfigurationResponse(this->address_, response, config);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -846,6 +1682,7 @@ void PaceBms::handle_write_system_datetime_response_v25(std::vector<uint8_t>& re
 	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
 
 	bool result = this->pace_bms_v25_->ProcessWriteSystemDateTimeResponse(this->address_, response);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -853,11 +1690,15 @@ void PaceBms::handle_write_system_datetime_response_v25(std::vector<uint8_t>& re
 }
 
 
+#endif
+
+#ifdef PACE_BMS_COMMANDSET_V20
 void PaceBms::handle_read_analog_information_response_v20(std::vector<uint8_t>& response) {
 	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
 
 	PaceBmsProtocolV20::AnalogInformation analog_information;
-	bool result = this->pace_bms_v20_->ProcessReadAnalogInformationResponse(this->address_, response, analog_information);
+	bool result = this->pace_bms_v20_->ProcessReadAnalogInformationResponse(this->address_, response, analog_information, this->analog_information_fields_);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -873,23 +1714,81 @@ void PaceBms::handle_read_status_information_response_v20(std::vector<uint8_t>&
 	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
 
 	PaceBmsProtocolV20::StatusInformation status_information;
-	bool result = this->pace_bms_v20_->ProcessReadStatusInformationResponse(this->address_, response, status_information);
+	bool result = this->pace_bms_v20_->ProcessReadStatusInformationResponse(this->address_, response, status_information, this->status_information_fields_);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
 	}
 
+	// freeze the flight recorder if a protection or fault condition has just appeared, v20 variants scatter protection and fault 
+	//     flags across different status bytes so this relies on the decoder's text, setup() asks for it when the recorder is enabled
+	if (!this->flight_recorder_.empty())
+		this->flight_recorder_check_for_event_(!status_information.protectionText.empty() || !status_information.faultText.empty());
+
 	// dispatch to any child components that registered for a callback with us
 	for (int i = 0; i < this->status_information_callbacks_v20_.size(); i++) {
 		status_information_callbacks_v20_[i](status_information);
 	}
 }
+#ifdef PACE_BMS_V20_VARIANT_PYLON
+void PaceBms::handle_read_system_analog_information_response_v20(std::vector<uint8_t>& response) {
+	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
+
+	std::vector<PaceBmsProtocolV20::AnalogInformation> analog_information;
+	bool result = this->pace_bms_v20_->ProcessReadSystemAnalogInformationResponse_PYLON(this->address_, response, analog_information, this->analog_information_fields_);
+	this->mark_response_decoded_(result);
+	if (result == false) {
+		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
+		return;
+	}
+
+	// dispatch to any child components that registered for a callback with us
+	for (int i = 0; i < this->system_analog_information_callbacks_v20_.size(); i++) {
+		system_analog_information_callbacks_v20_[i](analog_information);
+	}
+}
+void PaceBms::handle_read_system_status_information_response_v20(std::vector<uint8_t>& response) {
+	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
+
+	std::vector<PaceBmsProtocolV20::StatusInformation> status_information;
+	bool result = this->pace_bms_v20_->ProcessReadSystemStatusInformationResponse_PYLON(this->address_, response, status_information, this->status_information_fields_);
+	this->mark_response_decoded_(result);
+	if (result == false) {
+		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
+		return;
+	}
+
+	// dispatch to any child components that registered for a callback with us
+	for (int i = 0; i < this->system_status_information_callbacks_v20_.size(); i++) {
+		system_status_information_callbacks_v20_[i](status_information);
+	}
+}
+
+void PaceBms::handle_read_charge_discharge_management_information_response_v20(std::vector<uint8_t>& response) {
+	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
+
+	PaceBmsProtocolV20::ChargeDischargeManagementInformation management_information;
+	bool result = this->pace_bms_v20_->ProcessReadChargeDischargeManagementInformationResponse(this->address_, response, management_information);
+	this->mark_response_decoded_(result);
+	if (result == false) {
+		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
+		return;
+	}
+
+	// dispatch to any child components that registered for a callback with us
+	for (int i = 0; i < this->charge_discharge_management_information_callbacks_v20_.size(); i++) {
+		charge_discharge_management_information_callbacks_v20_[i](management_information);
+	}
+}
+#endif
 
 void PaceBms::handle_read_hardware_version_response_v20(std::vector<uint8_t>& response) {
 	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
 
 	std::string hardware_version;
 	bool result = this->pace_bms_v20_->ProcessReadHardwareVersionResponse(this->address_, response, hardware_version);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -906,6 +1805,7 @@ void PaceBms::handle_read_serial_number_response_v20(std::vector<uint8_t>& respo
 
 	std::string serial_number;
 	bool result = this->pace_bms_v20_->ProcessReadSerialNumberResponse(this->address_, response, serial_number);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -921,6 +1821,7 @@ void PaceBms::handle_write_shutdown_command_response_v20(std::vector<uint8_t>& r
 	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
 
 	bool result = this->pace_bms_v20_->ProcessWriteShutdownCommandResponse(this->address_, response);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -932,6 +1833,7 @@ void PaceBms::handle_read_system_datetime_response_v20(std::vector<uint8_t>& res
 
 	PaceBmsProtocolV20::DateTime dt;
 	bool result = this->pace_bms_v20_->ProcessReadSystemDateTimeResponse(this->address_, response, dt);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
@@ -946,11 +1848,13 @@ void PaceBms::handle_write_system_datetime_response_v20(std::vector<uint8_t>& re
 	ESP_LOGD(TAG, "Processing '%s' response", this->last_request_description.c_str());
 
 	bool result = this->pace_bms_v20_->ProcessWriteSystemDateTimeResponse(this->address_, response);
+	this->mark_response_decoded_(result);
 	if (result == false) {
 		ESP_LOGE(TAG, "Unable to decode '%s' response", this->last_request_description.c_str());
 		return;
 	}
 }
+#endif
 
 /*
 * these are called from from user-settable child sensors to set BMS state
@@ -972,6 +1876,7 @@ void PaceBms::write_queue_push_back_with_deduplication(command_item* item) {
 	}
 }
 
+#ifdef PACE_BMS_COMMANDSET_V25
 void PaceBms::write_switch_state_v25(PaceBmsProtocolV25::SwitchCommand state) {
 	command_item* item = new command_item;
 
@@ -1219,7 +2124,21 @@ void PaceBms::write_system_datetime_v25(PaceBmsProtocolV25::DateTime& dt) {
 	ESP_LOGV(TAG, "Write commands queued: %i", write_queue_.size());
 }
 
+void PaceBms::write_charge_current_limiter_start_current_v25(uint8_t current) {
+	command_item* item = new command_item;
+
+	item->description_ = std::string("write charge current limiter start current");
+	ESP_LOGV(TAG, "Queueing write command '%s'", item->description_.c_str());
+	item->create_request_frame_ = [this, current](std::vector<uint8_t>& request) -> bool { return this->pace_bms_v25_->CreateWriteChargeCurrentLimiterStartCurrentRequest(this->address_, current, request); };
+	item->process_response_frame_ = [this](std::vector<uint8_t>& response) -> void { this->handle_write_charge_current_limiter_start_current_response_v25(response); };
+	write_queue_push_back_with_deduplication(item);
+	ESP_LOGV(TAG, "Write commands queued: %i", write_queue_.size());
+}
+
+
+#endif
 
+#ifdef PACE_BMS_COMMANDSET_V20
 void PaceBms::write_shutdown_v20() {
 	command_item* item = new command_item;
 	ESP_LOGE(TAG, "SHUTTING DOWN");
@@ -1241,6 +2160,7 @@ void PaceBms::write_system_datetime_v20(PaceBmsProtocolV20::DateTime& dt) {
 	write_queue_push_back_with_deduplication(item);
 	ESP_LOGV(TAG, "Write commands queued: %i", write_queue_.size());
 }
+#endif
 
 }  // namespace pace_bms
 }  // namespace esphome
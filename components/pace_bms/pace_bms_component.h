@@ -4,12 +4,17 @@
 #include <functional>
 #include <queue>
 #include <list>
+#include <map>
+#include <utility>
 
 #include "esphome/core/component.h"
+#include "esphome/core/preferences.h"
 #include "esphome/components/uart/uart.h"
 
 #include "pace_bms_protocol_v25.h"
+#include "pace_bms_protocol_modbus.h"
 #include "pace_bms_protocol_v20.h"
+#include "pace_bms_capture.h"
 
 namespace esphome {
 namespace pace_bms {
@@ -28,11 +33,26 @@ public:
 	void set_chemistry(uint8_t chemistry) { this->chemistry_ = chemistry; }
 	void set_request_throttle(int request_throttle) { this->request_throttle_ = request_throttle; }
 	void set_response_timeout(int response_timeout) { this->response_timeout_ = response_timeout; }
+	void set_flight_recorder_size(uint8_t flight_recorder_size) { this->flight_recorder_size_ = flight_recorder_size; }
+	void set_bus_capture(bool bus_capture) { this->bus_capture_enabled_ = bus_capture; }
+	void set_fast_poll_interval(uint32_t fast_poll_interval) { this->fast_poll_interval_ = fast_poll_interval; }
+	void set_transport_modbus(bool transport_modbus) { this->transport_modbus_ = transport_modbus; }
+	void set_modbus_max_registers_per_request(uint16_t max_registers) { this->modbus_max_registers_per_request_ = max_registers; }
+	void set_modbus_register_gap_tolerance(uint16_t gap_tolerance) { this->modbus_register_gap_tolerance_ = gap_tolerance; }
 
 	// make accessible to sensors
 	int get_protocol_commandset() { return this->protocol_commandset_; }
 	void queue_sensor_update(std::function<void()> update) { this->sensor_update_queue_.push(update); }
 
+	// where the request throttle, response timeout, bus metrics, flight recorder, bus capture and profiler get the time from,
+	//     millis() / micros() unless something else is injected here, which only host tests do (see: "Test PACE BMS/Scheduler
+	//     PACE BMS") to put the hub anywhere in time, e.g. just short of the 32 bit wrap, nothing else needs to follow it
+	//     either function may be empty to leave that one alone
+	void set_clock(std::function<uint32_t()> millis_function, std::function<uint32_t()> micros_function) {
+		this->clock_millis_ = std::move(millis_function);
+		this->clock_micros_ = std::move(micros_function);
+	}
+
 	// standard overrides to implement component behavior, update() queues periodic commands to request updates from the BMS
 	void dump_config() override;
 	void setup() override;
@@ -44,11 +64,72 @@ public:
 	//     be missed in that case
 	float get_setup_priority() const { return setup_priority::LATE; }
 
+	// bus health metrics, kept for each command (keyed by command description) and for the bus as a whole
+	//     the counters are cumulative since boot, the latency and utilization values are calculated over a recent window
+	//     and only filled in for the bus-wide totals, per command there is latency_sum_ms_ / responses_ok_ and latency_max_ms_
+	struct bus_metrics
+	{
+		uint32_t requests_sent_{ 0 };
+		uint32_t responses_ok_{ 0 };
+		uint32_t timeouts_{ 0 };
+		uint32_t checksum_errors_{ 0 };
+		uint32_t return_code_errors_{ 0 };
+		uint32_t other_errors_{ 0 };
+		uint32_t latency_sum_ms_{ 0 };
+		uint32_t latency_max_ms_{ 0 };
+
+		float mean_latency_ms_{ 0 };
+		float p95_latency_ms_{ 0 };
+		float utilization_percent_{ 0 };
+	};
+
+	// child sensors call this to be handed the bus-wide metrics once per update()
+	void register_bus_metrics_callback(std::function<void(bus_metrics&)> callback) { bus_metrics_callbacks_.push_back(std::move(callback)); }
+	// and this to be handed the metrics of each command that has been sent so far, keyed by command description, once per update()
+	void register_command_metrics_callback(std::function<void(const std::map<std::string, bus_metrics>&)> callback) { command_metrics_callbacks_.push_back(std::move(callback)); }
+
+	// optional timing of each stage of a request/response cycle, to find out where loop() time is going, all times are in 
+	//     microseconds and cover the window since the previous update()
+	enum profiler_stage
+	{
+		PROFILER_STAGE_ENCODE,          // building the request frame
+		PROFILER_STAGE_TRANSMIT,        // write + flush
+		PROFILER_STAGE_WAIT_FIRST_BYTE, // end of transmit until the first byte of the response arrives
+		PROFILER_STAGE_RECEIVE,         // first byte of the response until EOI
+		PROFILER_STAGE_DECODE,          // response validation and decode
+		PROFILER_STAGE_DISPATCH,        // fan-out to child callbacks
+		PROFILER_STAGE_PUBLISH,         // a single queued sensor publish
+		PROFILER_STAGE_LOOP,            // the entirety of loop()
+		PROFILER_STAGE_COUNT,
+	};
+	struct profiler_stage_stats
+	{
+		uint32_t count_{ 0 };
+		uint32_t total_us_{ 0 };
+		uint32_t min_us_{ 0 };
+		uint32_t max_us_{ 0 };
+	};
+	struct profiler_stats
+	{
+		profiler_stage_stats stages_[PROFILER_STAGE_COUNT];
+	};
+	static const char* profiler_stage_to_string(profiler_stage stage);
+
+	// child sensors call this to enable the profiler and be handed the stage timings once per update()
+	void register_profiler_callback(std::function<void(profiler_stats&)> callback) { profiler_callbacks_.push_back(std::move(callback)); this->profiler_enabled_ = true; }
+
+	// writes the flight recorder contents to the log at INFO level (oldest first) so they can be seen without turning up the 
+	//     log level, and re-arms the recorder if it had frozen
+	void dump_flight_recorder();
+
 	// child sensors call these to register for notification upon reciept of various types of data from the BMS, and the 
 	//     callbacks lists not being empty is what prompts update() to queue command_items for BMS communication in order to 
 	//     periodically gather these updates for fan-out to the sensors the first place
-	void register_analog_information_callback_v25(std::function<void(PaceBmsProtocolV25::AnalogInformation&)> callback) { analog_information_callbacks_v25_.push_back(std::move(callback)); }
-	void register_status_information_callback_v25(std::function<void(PaceBmsProtocolV25::StatusInformation&)> callback) { status_information_callbacks_v25_.push_back(std::move(callback)); }
+	// the analog and status information callbacks also take a mask of the fields the child actually publishes, the union of 
+	//     all registered masks is handed to the decoder so that it can skip calculating or building anything nobody consumes
+#ifdef PACE_BMS_COMMANDSET_V25
+	void register_analog_information_callback_v25(std::function<void(PaceBmsProtocolV25::AnalogInformation&)> callback, uint32_t fields = PaceBmsProtocolBase::AIF_All) { analog_information_callbacks_v25_.push_back(std::move(callback)); this->analog_information_fields_ |= fields; }
+	void register_status_information_callback_v25(std::function<void(PaceBmsProtocolV25::StatusInformation&)> callback, uint32_t fields = PaceBmsProtocolBase::SIF_All) { status_information_callbacks_v25_.push_back(std::move(callback)); this->status_information_fields_ |= fields; }
 	void register_hardware_version_callback_v25(std::function<void(std::string&)> callback) { hardware_version_callbacks_v25_.push_back(std::move(callback)); }
 	void register_serial_number_callback_v25(std::function<void(std::string&) > callback) { serial_number_callbacks_v25_.push_back(std::move(callback)); }
 	void register_protocols_callback_v25(std::function<void(PaceBmsProtocolV25::Protocols&) > callback) { protocols_callbacks_v25_.push_back(std::move(callback)); }
@@ -68,14 +149,34 @@ public:
 	void register_mosfet_over_temperature_configuration_callback_v25(std::function<void(PaceBmsProtocolV25::MosfetOverTemperatureConfiguration&)> callback) { mosfet_over_temperature_configuration_callbacks_v25_.push_back(std::move(callback)); }
 	void register_environment_over_under_temperature_configuration_callback_v25(std::function<void(PaceBmsProtocolV25::EnvironmentOverUnderTemperatureConfiguration&)> callback) { environment_over_under_temperature_configuration_callbacks_v25_.push_back(std::move(callback)); }
 	void register_system_datetime_callback_v25(std::function<void(PaceBmsProtocolV25::DateTime&)> callback) { system_datetime_callbacks_v25_.push_back(std::move(callback)); }
+	// remaining / actual / design capacity in mAh, read on the fast tier if there is one, this is a much smaller frame than 
+	//     analog information so it's the cheap way to follow state of charge closely
+	// without a fast tier, or once the pack has rejected that request, the same values are taken from the analog information
+	void register_remaining_capacity_callback_v25(std::function<void(uint32_t&, uint32_t&, uint32_t&)> callback) { remaining_capacity_callbacks_v25_.push_back(std::move(callback)); }
+	void register_charge_current_limiter_start_current_callback_v25(std::function<void(uint8_t&)> callback) { charge_current_limiter_start_current_callbacks_v25_.push_back(std::move(callback)); }
+	// history records are handed over newest first as they're downloaded in the background, and only once each (across reboots)
+	void register_history_record_callback_v25(std::function<void(PaceBmsProtocolV25::HistoryRecord&)> callback) { history_record_callbacks_v25_.push_back(std::move(callback)); }
+#endif
 	
-	void register_analog_information_callback_v20(std::function<void(PaceBmsProtocolV20::AnalogInformation&)> callback) { analog_information_callbacks_v20_.push_back(std::move(callback)); }
-	void register_status_information_callback_v20(std::function<void(PaceBmsProtocolV20::StatusInformation&)> callback) { status_information_callbacks_v20_.push_back(std::move(callback)); }
+#ifdef PACE_BMS_COMMANDSET_V20
+	void register_analog_information_callback_v20(std::function<void(PaceBmsProtocolV20::AnalogInformation&)> callback, uint32_t fields = PaceBmsProtocolBase::AIF_All) { analog_information_callbacks_v20_.push_back(std::move(callback)); this->analog_information_fields_ |= fields; }
+	void register_status_information_callback_v20(std::function<void(PaceBmsProtocolV20::StatusInformation&)> callback, uint32_t fields = PaceBmsProtocolBase::SIF_All) { status_information_callbacks_v20_.push_back(std::move(callback)); this->status_information_fields_ |= fields; }
 	void register_hardware_version_callback_v20(std::function<void(std::string&)> callback) { hardware_version_callbacks_v20_.push_back(std::move(callback)); }
 	void register_serial_number_callback_v20(std::function<void(std::string&) > callback) { serial_number_callbacks_v20_.push_back(std::move(callback)); }
 	void register_system_datetime_callback_v20(std::function<void(PaceBmsProtocolV20::DateTime&)> callback) { system_datetime_callbacks_v20_.push_back(std::move(callback)); }
+#endif
+#if defined(PACE_BMS_COMMANDSET_V20) && defined(PACE_BMS_V20_VARIANT_PYLON)
+	// PYLON only, this instance must be addressing the master pack of the stack, the callback is handed one entry per pack 
+	//     in the stack from a single request/response, the response is large so this also grows the receive buffer
+	void register_system_analog_information_callback_v20(std::function<void(std::vector<PaceBmsProtocolV20::AnalogInformation>&)> callback, uint32_t fields = PaceBmsProtocolBase::AIF_All) { system_analog_information_callbacks_v20_.push_back(std::move(callback)); this->analog_information_fields_ |= fields; }
+	// PYLON only, the charge/discharge limits an inverter should follow, read every fast_poll_interval if one is configured 
+	//     and with everything else every update() if not
+	void register_charge_discharge_management_information_callback_v20(std::function<void(PaceBmsProtocolV20::ChargeDischargeManagementInformation&)> callback) { charge_discharge_management_information_callbacks_v20_.push_back(std::move(callback)); }
+	void register_system_status_information_callback_v20(std::function<void(std::vector<PaceBmsProtocolV20::StatusInformation>&)> callback, uint32_t fields = PaceBmsProtocolBase::SIF_All) { system_status_information_callbacks_v20_.push_back(std::move(callback)); this->status_information_fields_ |= fields; }
+#endif
 
 	// child sensors call these to schedule new values be written out to the hardware
+#ifdef PACE_BMS_COMMANDSET_V25
 	void write_switch_state_v25(PaceBmsProtocolV25::SwitchCommand state);
 	void write_mosfet_state_v25(PaceBmsProtocolV25::MosfetType type, PaceBmsProtocolV25::MosfetState state);
 	void write_shutdown_v25();
@@ -96,9 +197,13 @@ public:
 	void write_mosfet_over_temperature_configuration_v25(PaceBmsProtocolV25::MosfetOverTemperatureConfiguration& config);
 	void write_environment_over_under_temperature_configuration_v25(PaceBmsProtocolV25::EnvironmentOverUnderTemperatureConfiguration& config);
 	void write_system_datetime_v25(PaceBmsProtocolV25::DateTime& dt);
+	void write_charge_current_limiter_start_current_v25(uint8_t current);
+#endif
 
+#ifdef PACE_BMS_COMMANDSET_V20
 	void write_shutdown_v20();
 	void write_system_datetime_v20(PaceBmsProtocolV20::DateTime& dt);
+#endif
 
 
 protected:
@@ -113,8 +218,15 @@ protected:
 
 	int request_throttle_{ 0 };
 	int response_timeout_{ 0 };
+	uint32_t fast_poll_interval_{ 0 };
+	// carry the version 25 commandset over MODBUS RTU instead of paceic, see: PaceBmsProtocolModbus
+	bool transport_modbus_{ false };
+	// limits for merging neighbouring register reads into a single request, see: plan_modbus_reads_
+	uint16_t modbus_max_registers_per_request_{ 125 };
+	uint16_t modbus_register_gap_tolerance_{ 8 };
 
 	// put into command_item as a pointer to handle the BMS response
+#ifdef PACE_BMS_COMMANDSET_V25
 	void handle_read_analog_information_response_v25(std::vector<uint8_t>& response);
 	void handle_read_status_information_response_v25(std::vector<uint8_t>& response);
 	void handle_read_hardware_version_response_v25(std::vector<uint8_t>& response);
@@ -142,7 +254,13 @@ protected:
 	void handle_read_system_datetime_response_v25(std::vector<uint8_t>& response);
 	void handle_write_system_datetime_response_v25(std::vector<uint8_t>& response);
 	void handle_write_configuration_response_v25(std::vector<uint8_t>& response);
+	void handle_read_history_record_response_v25(uint16_t record_index, std::vector<uint8_t>& response);
+	void handle_read_remaining_capacity_response_v25(std::vector<uint8_t>& response);
+	void handle_read_charge_current_limiter_start_current_response_v25(std::vector<uint8_t>& response);
+	void handle_write_charge_current_limiter_start_current_response_v25(std::vector<uint8_t>& response);
+#endif
 
+#ifdef PACE_BMS_COMMANDSET_V20
 	void handle_read_analog_information_response_v20(std::vector<uint8_t>& response);
 	void handle_read_status_information_response_v20(std::vector<uint8_t>& response);
 	void handle_read_hardware_version_response_v20(std::vector<uint8_t>& response);
@@ -150,8 +268,15 @@ protected:
 	void handle_write_shutdown_command_response_v20(std::vector<uint8_t>& response);
 	void handle_read_system_datetime_response_v20(std::vector<uint8_t>& response);
 	void handle_write_system_datetime_response_v20(std::vector<uint8_t>& response);
+#endif
+#if defined(PACE_BMS_COMMANDSET_V20) && defined(PACE_BMS_V20_VARIANT_PYLON)
+	void handle_read_system_analog_information_response_v20(std::vector<uint8_t>& response);
+	void handle_read_system_status_information_response_v20(std::vector<uint8_t>& response);
+	void handle_read_charge_discharge_management_information_response_v20(std::vector<uint8_t>& response);
+#endif
 
 	// child sensor requested callback lists
+#ifdef PACE_BMS_COMMANDSET_V25
 	std::vector<std::function<void(PaceBmsProtocolV25::AnalogInformation&)>>                               analog_information_callbacks_v25_;
 	std::vector<std::function<void(PaceBmsProtocolV25::StatusInformation&)>>                               status_information_callbacks_v25_;
 	std::vector<std::function<void(std::string&)>>                                                 hardware_version_callbacks_v25_;
@@ -173,28 +298,79 @@ protected:
 	std::vector<std::function<void(PaceBmsProtocolV25::MosfetOverTemperatureConfiguration&)>>              mosfet_over_temperature_configuration_callbacks_v25_;
 	std::vector<std::function<void(PaceBmsProtocolV25::EnvironmentOverUnderTemperatureConfiguration&)>>    environment_over_under_temperature_configuration_callbacks_v25_;
 	std::vector<std::function<void(PaceBmsProtocolV25::DateTime&)>>                                        system_datetime_callbacks_v25_;
+	std::vector<std::function<void(PaceBmsProtocolV25::HistoryRecord&)>>                                   history_record_callbacks_v25_;
+	std::vector<std::function<void(uint32_t&, uint32_t&, uint32_t&)>>                                      remaining_capacity_callbacks_v25_;
+	std::vector<std::function<void(uint8_t&)>>                                                             charge_current_limiter_start_current_callbacks_v25_;
+	// cleared if the pack answers the remaining capacity request with an error return code, not every firmware has it
+	bool remaining_capacity_supported_v25_{ true };
+	bool capacity_from_analog_information_v25_() { return this->remaining_capacity_callbacks_v25_.size() > 0 && (this->fast_poll_interval_ == 0 || !this->remaining_capacity_supported_v25_); }
+#endif
 
+#ifdef PACE_BMS_COMMANDSET_V20
 	std::vector<std::function<void(PaceBmsProtocolV20::AnalogInformation&)>>                               analog_information_callbacks_v20_;
 	std::vector<std::function<void(PaceBmsProtocolV20::StatusInformation&)>>                               status_information_callbacks_v20_;
 	std::vector<std::function<void(std::string&)>>                                                 hardware_version_callbacks_v20_;
 	std::vector<std::function<void(std::string&)>>                                                 serial_number_callbacks_v20_;
 	std::vector<std::function<void(PaceBmsProtocolV20::DateTime&)>>                                        system_datetime_callbacks_v20_;
+#endif
+#if defined(PACE_BMS_COMMANDSET_V20) && defined(PACE_BMS_V20_VARIANT_PYLON)
+	std::vector<std::function<void(std::vector<PaceBmsProtocolV20::AnalogInformation>&)>>                  system_analog_information_callbacks_v20_;
+	std::vector<std::function<void(std::vector<PaceBmsProtocolV20::StatusInformation>&)>>                  system_status_information_callbacks_v20_;
+	std::vector<std::function<void(PaceBmsProtocolV20::ChargeDischargeManagementInformation&)>>            charge_discharge_management_information_callbacks_v20_;
+#endif
+
+	std::vector<std::function<void(bus_metrics&)>>                                                         bus_metrics_callbacks_;
+	std::vector<std::function<void(const std::map<std::string, bus_metrics>&)>>                            command_metrics_callbacks_;
+	std::vector<std::function<void(profiler_stats&)>>                                                      profiler_callbacks_;
+
+	// union of the fields requested by every registered analog / status information callback
+	uint32_t analog_information_fields_{ PaceBmsProtocolBase::AIF_None };
+	uint32_t status_information_fields_{ PaceBmsProtocolBase::SIF_None };
 
 	// along with loop() this is the "engine" of BMS communications
 	//     - send_next_request_frame_ will pop a command_item from the queue and dispatch a frame to the BMS
 	//     - process_response_frame_ will call next_response_handler_ (which was saved from the command_item popped in 
 	//           send_next_request_frame_) once a response arrives
-	PaceBmsProtocolV25* pace_bms_v25_;
-	PaceBmsProtocolV20* pace_bms_v20_;
-	// this is currently "right sized" as it's only slightly larger than the largest 0x20 response I've seen
+	PaceBmsProtocolV25* pace_bms_v25_{ nullptr };
+	PaceBmsProtocolV20* pace_bms_v20_{ nullptr };
+#ifdef PACE_BMS_TRANSPORT_MODBUS
+	// the same object as pace_bms_v25_ when the MODBUS transport is in use, otherwise nullptr
+	PaceBmsProtocolModbus* pace_bms_modbus_{ nullptr };
+#endif
+	// this is currently "right sized" as it's only slightly larger than the largest 16 cell 0x20 response I've seen
 	static const uint16_t max_data_len_ = 256;
-	uint8_t raw_data_[max_data_len_];
-	uint8_t raw_data_index_{ 0 };
+	// frames are only bounded by the 12 bit payload length (plus SOI, header, checksum, and EOI), but rather than reserve that 
+	//     up front the buffer grows to the length announced by the header of whichever frame is arriving (see: 
+	//     GetResponseFrameLength), but only for a request queued with command_item.large_response_ set (24/32 cell packs,
+	//     PYLON multi-pack responses, history records, MODBUS block reads), any other frame announcing more than
+	//     max_data_len_ is dropped as too long
+	// once that frame is complete or abandoned the buffer goes back to max_data_len_, rather than holding on to the largest
+	//     frame seen for the rest of uptime
+	std::vector<uint8_t> raw_data_ = std::vector<uint8_t>(max_data_len_);
+	uint16_t raw_data_index_{ 0 };
+	uint16_t raw_data_expected_length_{ 0 };
+	bool large_response_expected_{ false };
+	void grow_receive_buffer_(uint16_t size) { if (this->raw_data_.size() < size) this->raw_data_.resize(size); }
+	void reset_receive_buffer_() {
+		this->raw_data_index_ = 0;
+		this->raw_data_expected_length_ = 0;
+		if (this->raw_data_.size() > max_data_len_) {
+			this->raw_data_.resize(max_data_len_);
+			this->raw_data_.shrink_to_fit();
+		}
+	}
+	uint32_t now_ms_() { return this->clock_millis_ ? this->clock_millis_() : millis(); }
+	uint32_t now_us_() { return this->clock_micros_ ? this->clock_micros_() : micros(); }
+	std::function<uint32_t()> clock_millis_;
+	std::function<uint32_t()> clock_micros_;
 	uint32_t last_transmit_{ 0 };
 	uint32_t last_receive_{ 0 };
 	bool request_outstanding_ = false;
-	void send_next_request_frame_();
-	void process_response_frame_(uint8_t* frame_bytes, uint8_t frame_length);
+	// returns false if no request could be created, in which case there is nothing to wait for
+	bool send_next_request_frame_();
+	void process_response_frame_(uint8_t* frame_bytes, uint16_t frame_length);
+	// paceic frames are ASCII apart from SOI/EOI, MODBUS frames are binary and are shown as hex instead
+	std::string format_frame_(const uint8_t* frame_bytes, uint16_t frame_length);
 
 	// each item points to:
 	//     a description of what is happening such as "Read Analog Information" for logging purposes
@@ -205,6 +381,8 @@ protected:
 		std::string description_;
 		std::function<bool(std::vector<uint8_t>&)> create_request_frame_;
 		std::function<void(std::vector<uint8_t>&)> process_response_frame_;
+		// the response may be longer than max_data_len_, see: raw_data_
+		bool large_response_{ false };
 	};
 	// when the bus is clear:
 	//     the next command_item will be popped from either the read or the write queue (writes always take priority)
@@ -215,14 +393,137 @@ protected:
 	//         see section: "along with loop() this is the "engine" of BMS communications" for how this works
 	// commands generated as a result of user interaction are pushed to the write queue which has priority over the read queue
 	// the read queue is filled each update() with only the commands necessary to refresh child components that have been declared in the yaml config and requested a callback for the information
+	// the fast queue is filled every fast_poll_interval with the few small commands that control loops need to see quickly, it 
+	//     sits between the two so that a long update() cycle doesn't hold them up
 	std::queue<std::function<void()>> sensor_update_queue_;
 	std::queue<command_item*> read_queue_;
+	std::queue<command_item*> fast_queue_;
 	std::list<command_item*> write_queue_;
 	std::function<void(std::vector<uint8_t>&)> next_response_handler_ = nullptr;
 	std::string last_request_description;
 
 	// helper to avoid pushing redundant write requests
 	void write_queue_push_back_with_deduplication(command_item* item);
+
+	// called every fast_poll_interval, or from update() if that isn't configured, to queue the fast tier commands onto queue
+	void queue_fast_poll_commands_(std::queue<command_item*>& queue);
+
+#ifdef PACE_BMS_COMMANDSET_V25
+	// the history log is downloaded one record per request, newest first, at the lowest priority: a request is only made when 
+	//     the write, fast, and read queues are all empty, so it fills the idle time between update() cycles
+	// update() starts a pass, which runs until it reaches a record that was already handed out (or the end of the log), the
+	//     cursor is saved to flash as it goes so that a reboot part way through picks up where it left off rather than 
+	//     starting over, and records already handed out before a reboot aren't repeated
+	struct history_cursor
+	{
+		uint32_t synced_newest_{ 0 };        // history_key_ of the newest record handed out by a completed pass
+		uint32_t pass_newest_{ 0 };          // newest record handed out by the pass in progress
+		uint32_t pass_oldest_{ UINT32_MAX }; // oldest record handed out by the pass in progress
+		uint16_t next_index_{ 0 };           // where the pass in progress is up to, 0 if no pass is in progress
+	};
+	history_cursor history_cursor_;
+	ESPPreferenceObject history_preference_;
+	bool history_pass_active_{ false };
+	// still set when the bus next goes idle means the last history request never got a decodable response
+	bool history_request_sent_{ false };
+	uint16_t history_records_this_pass_{ 0 };
+	// sortable packing of a record timestamp
+	static uint32_t history_key_(const PaceBmsProtocolV25::DateTime& date_time);
+	void finish_history_pass_(bool completed);
+	command_item* create_history_command_item_();
+#endif
+#ifdef PACE_BMS_COMMANDSET_V25
+	bool history_pending_() { return this->history_pass_active_; }
+#else
+	bool history_pending_() { return false; }
+#endif
+
+#ifdef PACE_BMS_TRANSPORT_MODBUS
+	// one of the reads that were merged into a single register block request, and the part of the block it wants
+	struct modbus_block_member
+	{
+		PaceBmsProtocolModbus::RegisterRange range_;
+		std::function<void(std::vector<uint8_t>&)> process_response_frame_;
+	};
+	// merges neighbouring register reads in queue into block reads, called from update() once the read queue is filled
+	void plan_modbus_reads_(std::queue<command_item*>& queue);
+	void handle_read_register_block_response_modbus(PaceBmsProtocolModbus::RegisterRange block, const std::vector<modbus_block_member>& members, std::vector<uint8_t>& response);
+	// the register range each command reads never changes, so its request frame is only built the first time it's planned 
+	//     to find out, keyed by command description, a registerCount of 0 means the command isn't a plain register read
+	std::map<std::string, PaceBmsProtocolModbus::RegisterRange> modbus_read_ranges_;
+#endif
+
+	// how a request/response cycle ended, for bus metrics
+	enum request_outcome
+	{
+		OUTCOME_OK,
+		OUTCOME_TIMEOUT,
+		OUTCOME_CHECKSUM_ERROR,
+		OUTCOME_RETURN_CODE_ERROR,
+		OUTCOME_OTHER_ERROR,
+	};
+	// set by the response handler through mark_response_decoded_, reset before each dispatch
+	request_outcome response_outcome_{ OUTCOME_OTHER_ERROR };
+	void mark_response_decoded_(bool decoded);
+	request_outcome get_decode_failure_outcome_();
+	void record_request_sent_();
+	void record_request_outcome_(request_outcome outcome, uint32_t now);
+	void publish_bus_metrics_(uint32_t now);
+
+	// bus metrics bookkeeping, current_command_metrics_ points into command_metrics_ for the outstanding request
+	bus_metrics bus_metrics_;
+	std::map<std::string, bus_metrics> command_metrics_;
+	bus_metrics* current_command_metrics_{ nullptr };
+	// the last N response latencies, for mean/p95
+	static const uint8_t latency_sample_count_ = 64;
+	uint16_t latency_samples_[latency_sample_count_];
+	uint8_t latency_sample_index_{ 0 };
+	uint8_t latency_sample_fill_{ 0 };
+	// time spent with a request outstanding since the last publish, for utilization
+	uint32_t bus_busy_ms_{ 0 };
+	uint32_t last_bus_metrics_publish_{ 0 };
+
+	// flight recorder: a fixed size ring of the most recent request and response frames, recorded without any formatting
+	//     so that it costs next to nothing until someone asks for a dump
+	// it freezes itself when a protection or fault condition first appears in the status information so that the frames 
+	//     leading up to the event aren't overwritten before they can be dumped, this piggybacks on status information that 
+	//     is already being read for other entities rather than requesting it itself
+	struct flight_recorder_entry
+	{
+		uint32_t timestamp_{ 0 };
+		bool is_request_{ false };
+		request_outcome outcome_{ OUTCOME_OK }; // only meaningful for responses
+		std::vector<uint8_t> frame_;            // reserved to max_data_len_ in setup() so recording never allocates, longer frames are truncated
+	};
+	void flight_recorder_record_(bool is_request, const uint8_t* frame_bytes, uint16_t frame_length, request_outcome outcome, uint32_t now);
+	void flight_recorder_check_for_event_(bool event_active);
+	static const char* request_outcome_to_string_(request_outcome outcome);
+	uint8_t flight_recorder_size_{ 0 };
+	std::vector<flight_recorder_entry> flight_recorder_;
+	uint8_t flight_recorder_index_{ 0 };
+	bool flight_recorder_frozen_{ false };
+	// set from within a response handler, the freeze happens once that response itself has been recorded
+	bool flight_recorder_freeze_pending_{ false };
+	bool flight_recorder_event_active_{ false };
+
+	// bus capture: every byte written or read, timestamped, streamed to the log in compact base64 encoded blocks for replay
+	//     on a host (see: pace_bms_capture.h), created in setup() only when enabled so that it costs a branch otherwise
+	void bus_capture_record_(bool transmitted, const uint8_t* data, size_t length) { if (this->bus_capture_ != nullptr) this->bus_capture_->Record(transmitted, this->now_us_(), data, length); }
+	bool bus_capture_enabled_{ false };
+	PaceBmsCaptureWriter* bus_capture_{ nullptr };
+
+	// profiler bookkeeping, every timing point checks profiler_enabled_ first so this costs a branch when nobody is listening
+	void profiler_record_(profiler_stage stage, uint32_t elapsed_us);
+	void profiler_mark_decoded_() { if (this->profiler_enabled_) this->profiler_decoded_us_ = this->now_us_(); }
+	void publish_profiler_stats_();
+	bool profiler_enabled_{ false };
+	profiler_stats profiler_stats_;
+	uint32_t profiler_transmit_end_us_{ 0 };
+	uint32_t profiler_first_byte_us_{ 0 };
+	uint32_t profiler_decoded_us_{ 0 };
+
+	// the body of loop(), split out so that loop() can time it
+	void loop_internal_();
 };
 
 }  // namespace pace_bms
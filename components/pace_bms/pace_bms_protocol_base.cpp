@@ -79,6 +79,35 @@ bool PaceBmsProtocolBase::ValidateChecksummedLength(const uint16_t cklen)
 	return lcksumtest == lcksum;
 }
 
+// the receiving side calls this as bytes arrive to find out how long the frame will be, see header for return values
+uint16_t PaceBmsProtocolBase::GetResponseFrameLength(const uint8_t* frame, const uint16_t received)
+{
+	if (received < 13)
+		return 0;
+
+	// HexToNibble isn't static (and quietly maps garbage to 0), CKLEN needs to be strict here
+	uint16_t cklen = 0;
+	for (int i = 9; i < 13; i++)
+	{
+		uint8_t hex = frame[i];
+		uint8_t nibble;
+		if (hex >= '0' && hex <= '9')
+			nibble = hex - '0';
+		else if (hex >= 'A' && hex <= 'F')
+			nibble = hex - 'A' + 10;
+		else if (hex >= 'a' && hex <= 'f')
+			nibble = hex - 'a' + 10;
+		else
+			return received;
+		cklen = (cklen << 4) | nibble;
+	}
+	if (!ValidateChecksummedLength(cklen))
+		return received;
+
+	// SOI + VER + ADR + CID1 + RTN + CKLEN = 13, then LENID of payload, then CHKSUM (4) and EOI (1)
+	return 13 + LengthFromChecksummedLength(cklen) + 5;
+}
+
 // Length is just the lower 12 bits of the checksummed length 
 uint16_t PaceBmsProtocolBase::LengthFromChecksummedLength(const uint16_t cklen)
 {
@@ -137,7 +166,7 @@ uint8_t PaceBmsProtocolBase::HexToNibble(const uint8_t hex)
 // decode a 'real' byte from the stream by reading two ASCII hex encoded bytes
 uint8_t PaceBmsProtocolBase::ReadHexEncodedByte(const std::vector<uint8_t>& data, uint16_t& dataOffset)
 {
-	if (data.size() - dataOffset < 2)
+	if (dataOffset + 2 > data.size())
 	{
 		LogError("Attempt to read past end of array");
 		return 0;
@@ -151,7 +180,7 @@ uint8_t PaceBmsProtocolBase::ReadHexEncodedByte(const std::vector<uint8_t>& data
 // decode a 'real' uint16_t from the stream by reading four ASCII hex encoded bytes
 uint16_t PaceBmsProtocolBase::ReadHexEncodedUShort(const std::vector<uint8_t>& data, uint16_t& dataOffset)
 {
-	if (data.size() - dataOffset < 4)
+	if (dataOffset + 4 > data.size())
 	{
 		LogError("Attempt to read past end of array");
 		return 0;
@@ -167,7 +196,7 @@ uint16_t PaceBmsProtocolBase::ReadHexEncodedUShort(const std::vector<uint8_t>& d
 // decode a 'real' int16_t from the stream by reading four ASCII hex encoded bytes
 int16_t PaceBmsProtocolBase::ReadHexEncodedSShort(const std::vector<uint8_t>& data, uint16_t& dataOffset)
 {
-	if (data.size() - dataOffset < 4)
+	if (dataOffset + 4 > data.size())
 	{
 		LogError("Attempt to read past end of array");
 		return 0;
@@ -183,27 +212,27 @@ int16_t PaceBmsProtocolBase::ReadHexEncodedSShort(const std::vector<uint8_t>& da
 // decode a 'real' uint32_t from the stream by reading four ASCII hex encoded bytes
 uint32_t PaceBmsProtocolBase::ReadHexEncodedULong(const std::vector<uint8_t>& data, uint16_t& dataOffset)
 {
-	if (data.size() - dataOffset < 8)
+	if (dataOffset + 8 > data.size())
 	{
 		LogError("Attempt to read past end of array");
 		return 0;
 	}
 	uint32_t ulong = 0;
-	ulong |= ((HexToNibble(data[dataOffset++]) << 28) & 0xF0000000);
-	ulong |= ((HexToNibble(data[dataOffset++]) << 24) & 0x0F000000);
-	ulong |= ((HexToNibble(data[dataOffset++]) << 20) & 0x00F00000);
-	ulong |= ((HexToNibble(data[dataOffset++]) << 16) & 0x000F0000);
-	ulong |= ((HexToNibble(data[dataOffset++]) << 12) & 0x0000F000);
-	ulong |= ((HexToNibble(data[dataOffset++]) << 8)  & 0x00000F00);
-	ulong |= ((HexToNibble(data[dataOffset++]) << 4)  & 0x000000F0);
-	ulong |= ((HexToNibble(data[dataOffset++]) << 0)  & 0x0000000F);
+	ulong |= (((uint32_t)HexToNibble(data[dataOffset++]) << 28) & 0xF0000000);
+	ulong |= (((uint32_t)HexToNibble(data[dataOffset++]) << 24) & 0x0F000000);
+	ulong |= (((uint32_t)HexToNibble(data[dataOffset++]) << 20) & 0x00F00000);
+	ulong |= (((uint32_t)HexToNibble(data[dataOffset++]) << 16) & 0x000F0000);
+	ulong |= (((uint32_t)HexToNibble(data[dataOffset++]) << 12) & 0x0000F000);
+	ulong |= (((uint32_t)HexToNibble(data[dataOffset++]) << 8)  & 0x00000F00);
+	ulong |= (((uint32_t)HexToNibble(data[dataOffset++]) << 4)  & 0x000000F0);
+	ulong |= (((uint32_t)HexToNibble(data[dataOffset++]) << 0)  & 0x0000000F);
 	return ulong;
 }
 
 // encode a 'real' byte to the stream by writing two ASCII hex encoded bytes
 void PaceBmsProtocolBase::WriteHexEncodedByte(std::vector<uint8_t>& data, uint16_t& dataOffset, uint8_t byte)
 {
-	if (data.size() - dataOffset < 2)
+	if (dataOffset + 2 > data.size())
 	{
 		LogError("Attempt to write past end of array");
 		return;
@@ -215,7 +244,7 @@ void PaceBmsProtocolBase::WriteHexEncodedByte(std::vector<uint8_t>& data, uint16
 // encode a 'real' uint16_t to the stream by writing four ASCII hex encoded bytes
 void PaceBmsProtocolBase::WriteHexEncodedUShort(std::vector<uint8_t>& data, uint16_t& dataOffset, uint16_t ushort)
 {
-	if (data.size() - dataOffset < 4)
+	if (dataOffset + 4 > data.size())
 	{
 		LogError("Attempt to write past end of array");
 		return;
@@ -229,7 +258,7 @@ void PaceBmsProtocolBase::WriteHexEncodedUShort(std::vector<uint8_t>& data, uint
 // encode a 'real' int16_t to the stream by writing four ASCII hex encoded bytes
 void PaceBmsProtocolBase::WriteHexEncodedSShort(std::vector<uint8_t>& data, uint16_t& dataOffset, int16_t sshort)
 {
-	if (data.size() - dataOffset < 4)
+	if (dataOffset + 4 > data.size())
 	{
 		LogError("Attempt to write past end of array");
 		return;
@@ -345,15 +374,18 @@ void PaceBmsProtocolBase::CreateRequest(const uint8_t busId, const uint8_t cid2,
 
 // validate all fields in the response except the payload data: SOI marker, header values, checksum, EOI marker
 // returns the detected payload length (payload always starts at offset 13), or -1 for error
-int16_t PaceBmsProtocolBase::ValidateResponseAndGetPayloadLength(const uint8_t busId, const std::vector<uint8_t> response)
+int16_t PaceBmsProtocolBase::ValidateResponseAndGetPayloadLength(const uint8_t busId, const std::vector<uint8_t> response, uint8_t* returnCode)
 {
 	uint16_t byteOffset = 0;
 
+	this->last_validation_result = RVR_Ok;
+
 	// the number of bytes for a response with zero payload, we'll check again once we decode the checksummed length embedded 
 	// in the response to make sure we don't run past the end of the buffer
 	if (response.size() < 18)
 	{
 		LogError("Response is truncated, even a response without payload should be 18 bytes long");
+		this->last_validation_result = RVR_Malformed;
 		return -1;
 	}
 
@@ -361,6 +393,7 @@ int16_t PaceBmsProtocolBase::ValidateResponseAndGetPayloadLength(const uint8_t b
 	if (response[byteOffset++] != '~')
 	{
 		LogError("Response does not begin with SOI marker");
+		this->last_validation_result = RVR_Malformed;
 		return -1;
 	}
 
@@ -372,6 +405,7 @@ int16_t PaceBmsProtocolBase::ValidateResponseAndGetPayloadLength(const uint8_t b
 	if (ver != target_ver)
 	{
 		LogError("Response has wrong protocol version number");
+		this->last_validation_result = RVR_WrongDevice;
 		return -1;
 	}
 
@@ -380,6 +414,7 @@ int16_t PaceBmsProtocolBase::ValidateResponseAndGetPayloadLength(const uint8_t b
 	if (addr != busId)
 	{
 		LogError("Response from wrong Bus Id");
+		this->last_validation_result = RVR_WrongDevice;
 		return -1;
 	}
 
@@ -388,14 +423,20 @@ int16_t PaceBmsProtocolBase::ValidateResponseAndGetPayloadLength(const uint8_t b
 	if (cid != cid1)
 	{
 		LogError("Response has wrong CID1 (battery chemistry)");
+		this->last_validation_result = RVR_WrongDevice;
 		return -1;
 	}
 
 	// Return Code
-	uint8_t returnCode = ReadHexEncodedByte(response, byteOffset);
-	if (returnCode != 0)
+	uint8_t rtn = ReadHexEncodedByte(response, byteOffset);
+	if (returnCode != nullptr)
 	{
-		LogError(std::string("Error code returned by device: ") + FormatReturnCode(returnCode));
+		*returnCode = rtn;
+	}
+	else if (rtn != 0)
+	{
+		LogError(std::string("Error code returned by device: ") + FormatReturnCode(rtn));
+		this->last_validation_result = RVR_ReturnCodeError;
 		return -1;
 	}
 
@@ -404,6 +445,7 @@ int16_t PaceBmsProtocolBase::ValidateResponseAndGetPayloadLength(const uint8_t b
 	if (!ValidateChecksummedLength(cklen))
 	{
 		LogError("Response contains an incorrect payload length checksum, ignoring since this is a known firmware bug");
+		this->last_validation_result = RVR_ChecksumError;
 		return -1;
 	}
 
@@ -421,11 +463,13 @@ int16_t PaceBmsProtocolBase::ValidateResponseAndGetPayloadLength(const uint8_t b
 	if ((uint16_t)response.size() < payloadLen + 18)
 	{
 		LogError("Response is truncated, should be 18 bytes + decoded payload length");
+		this->last_validation_result = RVR_Malformed;
 		return -1;
 	}
 	if ((uint16_t)response.size() > payloadLen + 18)
 	{
 		LogError("Response is oversize");
+		this->last_validation_result = RVR_Malformed;
 		return -1;
 	}
 
@@ -436,20 +480,60 @@ int16_t PaceBmsProtocolBase::ValidateResponseAndGetPayloadLength(const uint8_t b
 	if (givenCksum != calcCksum)
 	{
 		LogError("Response contains an incorrect frame checksum");
+		this->last_validation_result = RVR_ChecksumError;
 		return -1;
 	}
 
 	if (response[byteOffset++] != '\r')
 	{
 		LogError("Response does not end with EOI marker");
+		this->last_validation_result = RVR_Malformed;
 		return -1;
 	}
 
 	if (byteOffset != payloadLen + 18)
 	{
 		LogError("Length mismatch validating response, this is a code bug in PACE_BMS");
+		this->last_validation_result = RVR_Malformed;
+		return -1;
+	}
+
+	// deferred from above, the caller asked to see the return code itself
+	if (rtn != 0)
+	{
+		this->last_validation_result = RVR_ReturnCodeError;
 		return -1;
 	}
 
 	return payloadLen;
 }
+
+void PaceBmsProtocolBase::CalculateCellStatistics(const uint16_t* cellVoltagesMillivolts, const uint8_t cellCount, const uint32_t fields,
+	uint16_t& minCellVoltageMillivolts, uint16_t& maxCellVoltageMillivolts, uint16_t& avgCellVoltageMillivolts, uint16_t& maxCellDifferentialMillivolts)
+{
+	if (cellCount == 0)
+		return;
+
+	uint16_t minMillivolts = 65535;
+	uint16_t maxMillivolts = 0;
+	uint32_t sumMillivolts = 0;
+	for (int i = 0; i < cellCount; i++)
+	{
+		if (cellVoltagesMillivolts[i] > maxMillivolts)
+			maxMillivolts = cellVoltagesMillivolts[i];
+		if (cellVoltagesMillivolts[i] < minMillivolts)
+			minMillivolts = cellVoltagesMillivolts[i];
+		sumMillivolts += cellVoltagesMillivolts[i];
+	}
+
+	if ((fields & AIF_CellMinMax) != 0)
+	{
+		minCellVoltageMillivolts = minMillivolts;
+		maxCellVoltageMillivolts = maxMillivolts;
+		maxCellDifferentialMillivolts = maxMillivolts - minMillivolts;
+	}
+	if ((fields & AIF_CellAverage) != 0)
+	{
+		avgCellVoltageMillivolts = sumMillivolts / cellCount;
+	}
+}
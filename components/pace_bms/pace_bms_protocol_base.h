@@ -3,11 +3,41 @@
 #include <string>
 #include <vector>
 
-// uncomment the std version if using a C++17 compiler, otherwise esphome provides an equivalent implementation
+// esphome provides an equivalent of std::optional for pre C++17 toolchains, builds outside of ESPHome (the test harness 
+//     for example) define PACE_BMS_STD_OPTIONAL to use the std version instead
+#ifdef PACE_BMS_STD_OPTIONAL
+#include <optional>
+#define OPTIONAL_NS std
+#else
 #include "esphome/core/optional.h"
 #define OPTIONAL_NS esphome
-//#include <optional>
-//#define OPTIONAL_NS std
+#endif
+
+// when built by ESPHome, __init__.py passes a define for each protocol commandset (and version 20 variant) that is actually
+//     configured so that code for the others compiles out, when nothing is defined (the test harness for example) everything is built
+// the same goes for the MODBUS transport, which is only built when it has been asked for
+#if !defined(PACE_BMS_COMMANDSET_V25) && !defined(PACE_BMS_COMMANDSET_V20)
+#define PACE_BMS_COMMANDSET_V25
+#define PACE_BMS_COMMANDSET_V20
+#define PACE_BMS_TRANSPORT_MODBUS
+#endif
+#if defined(PACE_BMS_TRANSPORT_MODBUS) && !defined(PACE_BMS_COMMANDSET_V25)
+#error "The MODBUS transport carries the version 25 commandset, PACE_BMS_COMMANDSET_V25 must also be defined"
+#endif
+#if !defined(PACE_BMS_V20_VARIANT_PYLON) && !defined(PACE_BMS_V20_VARIANT_SEPLOS) && !defined(PACE_BMS_V20_VARIANT_EG4)
+#define PACE_BMS_V20_VARIANT_PYLON
+#define PACE_BMS_V20_VARIANT_SEPLOS
+#define PACE_BMS_V20_VARIANT_EG4
+#endif
+// how many cell and temperature readings the decoded structs (and the sensor platform) have room for, set by codegen from
+//     max_cell_count / max_temperature_count in yaml so that 24S packs fit and 8S/15S packs don't pay for slots they'll never use
+//     readings beyond these are skipped with a warning
+#ifndef PACE_BMS_MAX_CELL_COUNT
+#define PACE_BMS_MAX_CELL_COUNT 16
+#endif
+#ifndef PACE_BMS_MAX_TEMP_COUNT
+#define PACE_BMS_MAX_TEMP_COUNT 6
+#endif
 
 /*
 General format of requests/responses:
@@ -63,7 +93,59 @@ public:
 		uint8_t Second;
 	};
 
+	// callers pass a mask of these to ProcessReadAnalogInformationResponse in order to skip work for values nobody is going to
+	//     look at, the "plain" values (counts, current, total voltage, capacities, cycle count) are always decoded since
+	//     they have to be read off the wire anyway to advance through the payload and cost nothing to store
+	enum AnalogInformationFields : uint32_t
+	{
+		AIF_None            = 0,
+		AIF_CellVoltages    = (1 << 0), // also kept for AIF_CellMinMax and AIF_CellAverage, which are worked out from them
+		AIF_Temperatures    = (1 << 1),
+		AIF_StateOfCharge   = (1 << 2),
+		AIF_StateOfHealth   = (1 << 3),
+		AIF_Power           = (1 << 4),
+		AIF_CellMinMax      = (1 << 5), // min, max, and max differential
+		AIF_CellAverage     = (1 << 6),
+		AIF_All             = 0xFFFFFFFF,
+	};
+
+	// callers pass a mask of these to ProcessReadStatusInformationResponse in order to skip building human readable text
+	//     that nobody is going to look at, the raw status values are always decoded
+	enum StatusInformationFields : uint32_t
+	{
+		SIF_None              = 0,
+		SIF_WarningText       = (1 << 0),
+		SIF_BalancingText     = (1 << 1),
+		SIF_SystemText        = (1 << 2),
+		SIF_ConfigurationText = (1 << 3),
+		SIF_ProtectionText    = (1 << 4),
+		SIF_FaultText         = (1 << 5),
+		SIF_All               = 0xFFFFFFFF,
+	};
+
+	// the outcome of the most recent response validation, so that a caller can tell *why* a Process----Response call failed
+	//     without having to scrape the logs (bus metrics for example want to count checksum errors separately from the 
+	//     BMS rejecting a request)
+	enum ResponseValidationResult
+	{
+		RVR_Ok,
+		RVR_Malformed,       // truncated, oversize, missing SOI/EOI
+		RVR_WrongDevice,     // wrong protocol version, bus id, or CID1 - probably someone else's response
+		RVR_ReturnCodeError, // the BMS answered with a non-zero return code
+		RVR_ChecksumError,   // length checksum (LCHKSUM) or frame checksum (CHKSUM) mismatch
+	};
+	ResponseValidationResult GetLastResponseValidationResult() { return this->last_validation_result; }
+
+	// the receiving side calls this as bytes arrive so that it can size its buffer from the header of the frame actually in 
+	//     flight rather than reserving for the largest frame the 12 bit LENID allows up front
+	//     returns 0 until SOI through CKLEN (13 bytes) has arrived, after that the full frame length including CHKSUM and EOI
+	//     a header that can't belong to a valid frame (non-hex CKLEN, bad LCHKSUM) returns the bytes received so far, which 
+	//     ends the frame right there and leaves it to response validation to reject
+	static uint16_t GetResponseFrameLength(const uint8_t* frame, const uint16_t received);
+
 protected:
+	ResponseValidationResult last_validation_result{ RVR_Ok };
+
 	uint8_t protocol_commandset;
 	OPTIONAL_NS::optional<std::string> protocol_variant;
 	OPTIONAL_NS::optional<uint8_t> protocol_version;
@@ -132,6 +214,13 @@ protected:
 
 	void CreateRequest(const uint8_t busId, const uint8_t cid2, const std::vector<uint8_t> payload, std::vector<uint8_t>& request);
 
-	int16_t ValidateResponseAndGetPayloadLength(const uint8_t busId, const std::vector<uint8_t> response);
+	// when returnCode is given a non-zero return code is only reported once the rest of the frame (checksums, EOI) has also 
+	//     validated, and it's handed back there for the caller to judge rather than being logged as an error
+	int16_t ValidateResponseAndGetPayloadLength(const uint8_t busId, const std::vector<uint8_t> response, uint8_t* returnCode = nullptr);
+
+	// helper for: ProcessReadAnalogInformationResponse
+	// fills in whichever of min/max/differential (AIF_CellMinMax) and average (AIF_CellAverage) were requested in fields
+	static void CalculateCellStatistics(const uint16_t* cellVoltagesMillivolts, const uint8_t cellCount, const uint32_t fields,
+		uint16_t& minCellVoltageMillivolts, uint16_t& maxCellVoltageMillivolts, uint16_t& avgCellVoltageMillivolts, uint16_t& maxCellDifferentialMillivolts);
 };
 
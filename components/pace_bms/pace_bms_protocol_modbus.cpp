@@ -0,0 +1,1061 @@
+
+#include <algorithm>
+
+#include "pace_bms_protocol_modbus.h"
+
+#ifdef PACE_BMS_TRANSPORT_MODBUS
+
+// takes pointers to the "real" logging functions
+PaceBmsProtocolModbus::PaceBmsProtocolModbus(
+		OPTIONAL_NS::optional<std::string> protocol_variant, OPTIONAL_NS::optional<uint8_t> protocol_version_override, OPTIONAL_NS::optional<uint8_t> batteryChemistry,
+		LogFuncPtr logError, LogFuncPtr logWarning, LogFuncPtr logInfo, LogFuncPtr logDebug, LogFuncPtr logVerbose, LogFuncPtr logVeryVerbose) :
+	PaceBmsProtocolV25(
+		protocol_variant, protocol_version_override, batteryChemistry,
+		logError, logWarning, logInfo, logDebug, logVerbose, logVeryVerbose)
+{
+}
+
+// ============================================================================
+//
+// Framing
+//
+// ============================================================================
+
+uint16_t PaceBmsProtocolModbus::GetResponseFrameLength(const uint8_t* frame, const uint16_t received)
+{
+	if (received < 2)
+		return 0;
+
+	// exception response: ADR, FUNCTION + 0x80, ERRORCODE, CRC(lo), CRC(hi)
+	if ((frame[1] & FC_ErrorFlag) != 0)
+		return 5;
+
+	// read response: ADR, 0x03, BYTECOUNT, DATA..., CRC(lo), CRC(hi)
+	if (frame[1] == FC_ReadHoldingRegisters)
+	{
+		if (received < 3)
+			return 0;
+		return 5 + frame[2];
+	}
+
+	// write response: ADR, 0x10, START(hi), START(lo), COUNT(hi), COUNT(lo), CRC(lo), CRC(hi)
+	if (frame[1] == FC_WriteMultipleRegisters)
+		return 8;
+
+	// not something we'd ever ask for, call it complete and let validation reject it
+	return received;
+}
+
+uint16_t PaceBmsProtocolModbus::CalculateCrc(const uint8_t* data, const uint16_t length)
+{
+	uint16_t crc = 0xFFFF;
+
+	for (int i = 0; i < length; i++)
+	{
+		crc ^= data[i];
+		for (int bit = 0; bit < 8; bit++)
+		{
+			if ((crc & 0x0001) != 0)
+				crc = (crc >> 1) ^ 0xA001;
+			else
+				crc = crc >> 1;
+		}
+	}
+
+	return crc;
+}
+
+void PaceBmsProtocolModbus::CreateReadRegistersRequest(const uint8_t busId, const uint16_t firstRegister, const uint16_t registerCount, std::vector<uint8_t>& request)
+{
+	request.resize(8);
+	request[0] = busId;
+	request[1] = FC_ReadHoldingRegisters;
+	request[2] = firstRegister >> 8;
+	request[3] = firstRegister & 0xFF;
+	request[4] = registerCount >> 8;
+	request[5] = registerCount & 0xFF;
+
+	uint16_t crc = CalculateCrc(request.data(), 6);
+	request[6] = crc & 0xFF;
+	request[7] = crc >> 8;
+}
+
+void PaceBmsProtocolModbus::CreateWriteRegistersRequest(const uint8_t busId, const uint16_t firstRegister, const std::vector<uint16_t>& registers, std::vector<uint8_t>& request)
+{
+	const uint16_t registerCount = (uint16_t)registers.size();
+
+	request.resize(9 + registerCount * 2);
+	request[0] = busId;
+	request[1] = FC_WriteMultipleRegisters;
+	request[2] = firstRegister >> 8;
+	request[3] = firstRegister & 0xFF;
+	request[4] = registerCount >> 8;
+	request[5] = registerCount & 0xFF;
+	request[6] = (uint8_t)(registerCount * 2);
+
+	uint16_t byteOffset = 7;
+	for (int i = 0; i < registerCount; i++)
+	{
+		request[byteOffset++] = registers[i] >> 8;
+		request[byteOffset++] = registers[i] & 0xFF;
+	}
+
+	uint16_t crc = CalculateCrc(request.data(), byteOffset);
+	request[byteOffset++] = crc & 0xFF;
+	request[byteOffset++] = crc >> 8;
+}
+
+bool PaceBmsProtocolModbus::ValidateReadRegistersResponse(const uint8_t busId, const std::vector<uint8_t>& response, const uint16_t registerCount, std::vector<uint16_t>& registers)
+{
+	this->last_validation_result = RVR_Ok;
+
+	// the smallest valid response is an exception response
+	if (response.size() < 5)
+	{
+		LogError("Response is truncated, even an exception response should be 5 bytes long");
+		this->last_validation_result = RVR_Malformed;
+		return false;
+	}
+
+	uint16_t crc = CalculateCrc(response.data(), (uint16_t)response.size() - 2);
+	if (response[response.size() - 2] != (crc & 0xFF) || response[response.size() - 1] != (crc >> 8))
+	{
+		LogError("Response contains an incorrect CRC");
+		this->last_validation_result = RVR_ChecksumError;
+		return false;
+	}
+
+	if (response[0] != busId)
+	{
+		LogError("Response from wrong Bus Id");
+		this->last_validation_result = RVR_WrongDevice;
+		return false;
+	}
+
+	if (response[1] == (FC_ReadHoldingRegisters | FC_ErrorFlag))
+	{
+		LogError(std::string("Exception code returned by device: ") + std::to_string(response[2]));
+		this->last_validation_result = RVR_ReturnCodeError;
+		return false;
+	}
+
+	if (response[1] != FC_ReadHoldingRegisters)
+	{
+		LogError("Response has wrong function code");
+		this->last_validation_result = RVR_WrongDevice;
+		return false;
+	}
+
+	if (response[2] != registerCount * 2 || response.size() != (size_t)(5 + response[2]))
+	{
+		LogError(std::string("Response should contain ") + std::to_string(registerCount) + " registers, but its byte count is " + std::to_string(response[2]) + " and its length is " + std::to_string(response.size()));
+		this->last_validation_result = RVR_Malformed;
+		return false;
+	}
+
+	registers.resize(registerCount);
+	uint16_t byteOffset = 3;
+	for (int i = 0; i < registerCount; i++)
+	{
+		registers[i] = (response[byteOffset] << 8) | response[byteOffset + 1];
+		byteOffset += 2;
+	}
+
+	return true;
+}
+
+bool PaceBmsProtocolModbus::ValidateWriteRegistersResponse(const uint8_t busId, const std::vector<uint8_t>& response)
+{
+	this->last_validation_result = RVR_Ok;
+
+	if (response.size() < 5)
+	{
+		LogError("Response is truncated, even an exception response should be 5 bytes long");
+		this->last_validation_result = RVR_Malformed;
+		return false;
+	}
+
+	uint16_t crc = CalculateCrc(response.data(), (uint16_t)response.size() - 2);
+	if (response[response.size() - 2] != (crc & 0xFF) || response[response.size() - 1] != (crc >> 8))
+	{
+		LogError("Response contains an incorrect CRC");
+		this->last_validation_result = RVR_ChecksumError;
+		return false;
+	}
+
+	if (response[0] != busId)
+	{
+		LogError("Response from wrong Bus Id");
+		this->last_validation_result = RVR_WrongDevice;
+		return false;
+	}
+
+	if (response[1] == (FC_WriteMultipleRegisters | FC_ErrorFlag))
+	{
+		LogError(std::string("Exception code returned by device: ") + std::to_string(response[2]));
+		this->last_validation_result = RVR_ReturnCodeError;
+		return false;
+	}
+
+	if (response[1] != FC_WriteMultipleRegisters)
+	{
+		LogError("Response has wrong function code");
+		this->last_validation_result = RVR_WrongDevice;
+		return false;
+	}
+
+	if (response.size() != 8)
+	{
+		LogError("Write response should be 8 bytes long");
+		this->last_validation_result = RVR_Malformed;
+		return false;
+	}
+
+	return true;
+}
+
+// ============================================================================
+//
+// Read planning
+//
+// ============================================================================
+
+bool PaceBmsProtocolModbus::GetReadRequestRange(const std::vector<uint8_t>& request, RegisterRange& range)
+{
+	if (request.size() != 8 || request[1] != FC_ReadHoldingRegisters)
+		return false;
+
+	range.firstRegister = (request[2] << 8) | request[3];
+	range.registerCount = (request[4] << 8) | request[5];
+	return true;
+}
+
+std::vector<PaceBmsProtocolModbus::ReadBlock> PaceBmsProtocolModbus::PlanReadBlocks(const std::vector<RegisterRange>& ranges, const uint16_t maxRegisters, const uint16_t maxGap)
+{
+	// walk the ranges in register order
+	std::vector<uint16_t> order(ranges.size());
+	for (uint16_t i = 0; i < ranges.size(); i++)
+		order[i] = i;
+	std::sort(order.begin(), order.end(), [&ranges](uint16_t a, uint16_t b) { return ranges[a].firstRegister < ranges[b].firstRegister; });
+
+	std::vector<ReadBlock> blocks;
+	for (uint16_t index : order)
+	{
+		const RegisterRange& range = ranges[index];
+		const uint32_t rangeEnd = (uint32_t)range.firstRegister + range.registerCount;
+
+		// extend the current block if this range overlaps it, or starts close enough after it, and the result still fits
+		if (!blocks.empty())
+		{
+			ReadBlock& block = blocks.back();
+			const uint32_t blockEnd = (uint32_t)block.range.firstRegister + block.range.registerCount;
+			const uint32_t newEnd = rangeEnd > blockEnd ? rangeEnd : blockEnd;
+			if (range.firstRegister <= blockEnd + maxGap && newEnd - block.range.firstRegister <= maxRegisters)
+			{
+				block.range.registerCount = (uint16_t)(newEnd - block.range.firstRegister);
+				block.members.push_back(index);
+				continue;
+			}
+		}
+
+		ReadBlock block;
+		block.range = range;
+		block.members.push_back(index);
+		blocks.push_back(block);
+	}
+
+	return blocks;
+}
+
+bool PaceBmsProtocolModbus::CreateReadBlockRequest(const uint8_t busId, const RegisterRange& block, std::vector<uint8_t>& request)
+{
+	CreateReadRegistersRequest(busId, block.firstRegister, block.registerCount, request);
+	return true;
+}
+
+bool PaceBmsProtocolModbus::ValidateReadBlockResponse(const uint8_t busId, const std::vector<uint8_t>& response, const RegisterRange& block)
+{
+	std::vector<uint16_t> registers;
+	return ValidateReadRegistersResponse(busId, response, block.registerCount, registers);
+}
+
+void PaceBmsProtocolModbus::ExtractReadBlockResponse(const uint8_t busId, const std::vector<uint8_t>& response, const RegisterRange& block, const RegisterRange& member, std::vector<uint8_t>& memberResponse)
+{
+	const uint16_t byteCount = member.registerCount * 2;
+	const uint16_t dataOffset = 3 + (member.firstRegister - block.firstRegister) * 2;
+
+	memberResponse.resize(5 + byteCount);
+	memberResponse[0] = busId;
+	memberResponse[1] = FC_ReadHoldingRegisters;
+	memberResponse[2] = (uint8_t)byteCount;
+	std::copy(response.begin() + dataOffset, response.begin() + dataOffset + byteCount, memberResponse.begin() + 3);
+
+	uint16_t crc = CalculateCrc(memberResponse.data(), 3 + byteCount);
+	memberResponse[3 + byteCount] = crc & 0xFF;
+	memberResponse[4 + byteCount] = crc >> 8;
+}
+
+bool PaceBmsProtocolModbus::NotSupported(const std::string& command)
+{
+	LogError(command + " is not available over MODBUS");
+	return false;
+}
+
+// ============================================================================
+//
+// Realtime data
+//
+// ============================================================================
+
+const uint8_t PaceBmsProtocolModbus::exampleReadAnalogInformationRequestModbus[] = { 0x01, 0x03, 0x00, 0x00, 0x00, 0x25, 0x84, 0x11 };
+const uint8_t PaceBmsProtocolModbus::exampleReadAnalogInformationResponseModbus[] = {
+	0x01, 0x03, 0x4A,
+	0xFF, 0x1F, 0x14, 0x73, 0x00, 0x3F, 0x00, 0x64, 0x18, 0x3C, 0x28, 0x6A, 0x27, 0x10, 0x00, 0x8C,
+	0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x0C, 0xC7, 0x0C, 0xC8, 0x0C, 0xC7, 0x0C, 0xC7, 0x0C, 0xC7, 0x0C, 0xC5, 0x0C, 0xC6, 0x0C, 0xC7,
+	0x0C, 0xC7, 0x0C, 0xC6, 0x0C, 0xC7, 0x0C, 0xC6, 0x0C, 0xC6, 0x0C, 0xC7, 0x0C, 0xC6, 0x0C, 0xC7,
+	0x00, 0xFB, 0x00, 0xF9, 0x00, 0xF9, 0x00, 0xF9, 0x01, 0x13, 0x01, 0x1C,
+	0x15, 0xA4 };
+
+bool PaceBmsProtocolModbus::CreateReadAnalogInformationRequest(const uint8_t busId, std::vector<uint8_t>& request)
+{
+	CreateReadRegistersRequest(busId, REG_Current, REG_RealtimeCount, request);
+	return true;
+}
+bool PaceBmsProtocolModbus::ProcessReadAnalogInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation, const uint32_t fields)
+{
+	std::vector<uint16_t> registers;
+	if (!ValidateReadRegistersResponse(busId, response, REG_RealtimeCount, registers))
+	{
+		// failed to validate, the call would have done it's own logging
+		return false;
+	}
+
+	// there is no cell count register, unpopulated cells read as 0 mV
+	//     the register map always has room for 16, which may be more or less than this build was configured to keep
+	analogInformation.cellCount = 0;
+	for (int i = 0; i < REG_CellTemperatures - REG_CellVoltages; i++)
+	{
+		uint16_t cellVoltage = registers[REG_CellVoltages + i];
+		if (cellVoltage == 0)
+			break;
+
+		analogInformation.cellCount++;
+
+		if (i > MAX_CELL_COUNT - 1 || (fields & (AIF_CellVoltages | AIF_CellMinMax | AIF_CellAverage)) == 0)
+			continue;
+
+		analogInformation.cellVoltagesMillivolts[i] = cellVoltage;
+	}
+
+	// 4 cell readings, then MOSFET then Environment, same as paceic but already in tenths of a degree C
+	analogInformation.temperatureCount = REG_RealtimeCount - REG_CellTemperatures;
+	for (int i = 0; i < analogInformation.temperatureCount && i < MAX_TEMP_COUNT && (fields & AIF_Temperatures) != 0; i++)
+	{
+		analogInformation.temperaturesTenthsCelcius[i] = (int16_t)registers[REG_CellTemperatures + i];
+	}
+
+	analogInformation.currentMilliamps = (int16_t)registers[REG_Current] * 10;
+	analogInformation.totalVoltageMillivolts = registers[REG_PackVoltage] * 10;
+	analogInformation.remainingCapacityMilliampHours = registers[REG_RemainingCapacity] * 10;
+	analogInformation.fullCapacityMilliampHours = registers[REG_FullCapacity] * 10;
+	analogInformation.designCapacityMilliampHours = registers[REG_DesignCapacity] * 10;
+	analogInformation.cycleCount = registers[REG_CycleCount];
+
+	// unlike paceic, the BMS reports these itself rather than leaving them to be calculated
+	if ((fields & AIF_StateOfCharge) != 0)
+	{
+		analogInformation.SoC = registers[REG_SoC];
+	}
+	if ((fields & AIF_StateOfHealth) != 0)
+	{
+		analogInformation.SoH = registers[REG_SoH];
+	}
+	if ((fields & AIF_Power) != 0)
+	{
+		analogInformation.powerWatts = ((float)analogInformation.totalVoltageMillivolts * (float)analogInformation.currentMilliamps) / 1000000.0f;
+	}
+	if ((fields & (AIF_CellMinMax | AIF_CellAverage)) != 0)
+	{
+		CalculateCellStatistics(analogInformation.cellVoltagesMillivolts, (analogInformation.cellCount > MAX_CELL_COUNT ? MAX_CELL_COUNT : analogInformation.cellCount), fields,
+			analogInformation.minCellVoltageMillivolts, analogInformation.maxCellVoltageMillivolts, analogInformation.avgCellVoltageMillivolts, analogInformation.maxCellDifferentialMillivolts);
+	}
+
+	return true;
+}
+
+const uint8_t PaceBmsProtocolModbus::exampleReadStatusInformationRequestModbus[] = { 0x01, 0x03, 0x00, 0x09, 0x00, 0x04, 0x94, 0x0B };
+const uint8_t PaceBmsProtocolModbus::exampleReadStatusInformationResponseModbus[] = { 0x01, 0x03, 0x08, 0x00, 0x01, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x00, 0x87, 0xFF };
+
+bool PaceBmsProtocolModbus::CreateReadStatusInformationRequest(const uint8_t busId, std::vector<uint8_t>& request)
+{
+	CreateReadRegistersRequest(busId, REG_WarningFlags, REG_BalanceStatus - REG_WarningFlags + 1, request);
+	return true;
+}
+bool PaceBmsProtocolModbus::ProcessReadStatusInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation, const uint32_t fields)
+{
+	statusInformation.warningText.clear();
+	statusInformation.balancingText.clear();
+	statusInformation.systemText.clear();
+	statusInformation.configurationText.clear();
+	statusInformation.protectionText.clear();
+	statusInformation.faultText.clear();
+
+	// when the status registers are read as part of a larger block, ExtractReadBlockResponse hands over just these
+	const uint16_t firstRegister = REG_WarningFlags;
+	std::vector<uint16_t> registers;
+	if (!ValidateReadRegistersResponse(busId, response, REG_BalanceStatus - REG_WarningFlags + 1, registers))
+	{
+		// failed to validate, the call would have done it's own logging
+		return false;
+	}
+
+	uint16_t warningFlags = registers[REG_WarningFlags - firstRegister];
+	uint16_t protectionFlags = registers[REG_ProtectionFlags - firstRegister];
+	uint16_t statusFaultFlags = registers[REG_StatusFaultFlags - firstRegister];
+	uint16_t balanceState = registers[REG_BalanceStatus - firstRegister];
+
+	// ========================== Warning / Alarm Status ==========================
+	// MODBUS only has the "summary" warning flags, there are no per-cell or per-temperature values
+	for (int i = 0; i < MAX_CELL_COUNT; i++)
+		statusInformation.warning_value_cell[i] = 0;
+	for (int i = 0; i < MAX_TEMP_COUNT; i++)
+		statusInformation.warning_value_temp[i] = 0;
+
+	statusInformation.warning_value1 = warningFlags & 0xFF;
+	statusInformation.warning_value2 = warningFlags >> 8;
+
+	// fill these in from the summary flags so that anything looking at them sees the same thing paceic would have reported
+	statusInformation.warning_value_charge_current = (statusInformation.warning_value1 & W1F_ChargeCurrentBit) != 0 ? WV_AboveUpperLimitValue : 0;
+	statusInformation.warning_value_discharge_current = (statusInformation.warning_value1 & W1F_DischargeCurrentBit) != 0 ? WV_AboveUpperLimitValue : 0;
+	if ((statusInformation.warning_value1 & W1F_HighTotalVoltageBit) != 0)
+		statusInformation.warning_value_total_voltage = WV_AboveUpperLimitValue;
+	else if ((statusInformation.warning_value1 & W1F_LowTotalVoltageBit) != 0)
+		statusInformation.warning_value_total_voltage = WV_BelowLowerLimitValue;
+	else
+		statusInformation.warning_value_total_voltage = 0;
+
+	if (statusInformation.warning_value1 != 0 && (fields & SIF_WarningText) != 0)
+	{
+		statusInformation.warningText.append(DecodeWarningStatus1Value(statusInformation.warning_value1));
+	}
+	if (statusInformation.warning_value2 != 0 && (fields & SIF_WarningText) != 0)
+	{
+		statusInformation.warningText.append(DecodeWarningStatus2Value(statusInformation.warning_value2));
+	}
+
+	// ========================== Protection Status ==========================
+	statusInformation.protection_value1 = protectionFlags & 0xFF;
+	statusInformation.protection_value2 = protectionFlags >> 8;
+	if (statusInformation.protection_value1 != 0 && (fields & SIF_ProtectionText) != 0)
+	{
+		statusInformation.protectionText.append(DecodeProtectionStatus1Value(statusInformation.protection_value1));
+	}
+	if (statusInformation.protection_value2 != 0 && (fields & SIF_ProtectionText) != 0)
+	{
+		statusInformation.protectionText.append(DecodeProtectionStatus2Value(statusInformation.protection_value2));
+	}
+
+	// ========================== System Status ==========================
+	// the bits are in a different order than paceic, translate them
+	uint8_t systemState = 0;
+	if ((statusFaultFlags & MSF_Charging) != 0)
+		systemState |= SF_ChargingBit;
+	if ((statusFaultFlags & MSF_Discharging) != 0)
+		systemState |= SF_DischargingBit;
+	if ((statusFaultFlags & MSF_ChargeMosfetOn) != 0)
+		systemState |= SF_ChargeMosfetOnBit;
+	if ((statusFaultFlags & MSF_DischargeMosfetOn) != 0)
+		systemState |= SF_DischargeMosfetOnBit;
+	if ((statusFaultFlags & MSF_ChargeCurrentLimiterOn) == 0)
+		systemState |= SF_ChargeCurrentLimiterTurnedOffBit;
+	if ((statusFaultFlags & MSF_ChargerReversed) != 0)
+		systemState |= SF_PositiveNegativeTerminalsReversedBit;
+	statusInformation.system_value = systemState;
+	if (systemState != 0 && (fields & SIF_SystemText) != 0)
+	{
+		statusInformation.systemText.append(DecodeStatusValue(systemState));
+	}
+	if ((statusFaultFlags & MSF_HeaterOn) != 0 && (fields & SIF_SystemText) != 0)
+	{
+		statusInformation.systemText.append("Heater On; ");
+	}
+
+	// ========================== Configuration Status ==========================
+	// not reported over MODBUS
+	statusInformation.configuration_value = 0;
+
+	// ========================== Fault Status ==========================
+	statusInformation.fault_value = statusFaultFlags & 0xFF;
+	if (statusInformation.fault_value != 0 && (fields & SIF_FaultText) != 0)
+	{
+		statusInformation.faultText.append(DecodeFaultStatusValue(statusInformation.fault_value));
+	}
+
+	// ========================== Balancing Status ==========================
+	statusInformation.balancing_value = balanceState;
+	for (int i = 0; i < 16 && (fields & SIF_BalancingText) != 0; i++)
+	{
+		if ((balanceState & (1 << i)) != 0)
+		{
+			statusInformation.balancingText.append(std::string("Cell ") + std::to_string(i + 1) + " is balancing; ");
+		}
+	}
+
+	// pop off any trailing "; " separator
+	if (statusInformation.warningText.length() > 2)
+	{
+		statusInformation.warningText.pop_back();
+		statusInformation.warningText.pop_back();
+	}
+	if (statusInformation.balancingText.length() > 2)
+	{
+		statusInformation.balancingText.pop_back();
+		statusInformation.balancingText.pop_back();
+	}
+	if (statusInformation.systemText.length() > 2)
+	{
+		statusInformation.systemText.pop_back();
+		statusInformation.systemText.pop_back();
+	}
+	if (statusInformation.protectionText.length() > 2)
+	{
+		statusInformation.protectionText.pop_back();
+		statusInformation.protectionText.pop_back();
+	}
+	if (statusInformation.faultText.length() > 2)
+	{
+		statusInformation.faultText.pop_back();
+		statusInformation.faultText.pop_back();
+	}
+
+	return true;
+}
+
+// helper for: ProcessReadHardwareVersionResponse / ProcessReadSerialNumberResponse
+bool PaceBmsProtocolModbus::ProcessReadStringResponse(const uint8_t busId, const std::vector<uint8_t>& response, std::string& str)
+{
+	str.clear();
+
+	std::vector<uint16_t> registers;
+	if (!ValidateReadRegistersResponse(busId, response, STRING_REGISTER_COUNT, registers))
+	{
+		// failed to validate, the call would have done it's own logging
+		return false;
+	}
+
+	str.resize(STRING_REGISTER_COUNT * 2);
+	for (int i = 0; i < STRING_REGISTER_COUNT; i++)
+	{
+		str[i * 2] = registers[i] >> 8;
+		str[i * 2 + 1] = registers[i] & 0xFF;
+	}
+
+	// remove trailing spaces
+	while (str.length() > 0 && (str[str.length() - 1] == ' ' || str[str.length() - 1] == 0))
+	{
+		str.pop_back();
+	}
+
+	return true;
+}
+
+const uint8_t PaceBmsProtocolModbus::exampleReadHardwareVersionRequestModbus[] = { 0x01, 0x03, 0x00, 0x96, 0x00, 0x0A, 0x25, 0xE1 };
+const uint8_t PaceBmsProtocolModbus::exampleReadHardwareVersionResponseModbus[] = {
+	0x01, 0x03, 0x14,
+	0x50, 0x31, 0x36, 0x53, 0x31, 0x30, 0x30, 0x41, 0x2D, 0x31, 0x38, 0x31, 0x32, 0x2D, 0x31, 0x2E, 0x30, 0x30, 0x20, 0x00,
+	0xDD, 0x76 };
+
+bool PaceBmsProtocolModbus::CreateReadHardwareVersionRequest(const uint8_t busId, std::vector<uint8_t>& request)
+{
+	CreateReadRegistersRequest(busId, REG_VersionInformation, STRING_REGISTER_COUNT, request);
+	return true;
+}
+bool PaceBmsProtocolModbus::ProcessReadHardwareVersionResponse(const uint8_t busId, const std::vector<uint8_t>& response, std::string& hardwareVersion)
+{
+	return ProcessReadStringResponse(busId, response, hardwareVersion);
+}
+
+const uint8_t PaceBmsProtocolModbus::exampleReadSerialNumberRequestModbus[] = { 0x01, 0x03, 0x00, 0xA0, 0x00, 0x0A, 0xC5, 0xEF };
+const uint8_t PaceBmsProtocolModbus::exampleReadSerialNumberResponseModbus[] = {
+	0x01, 0x03, 0x14,
+	0x31, 0x38, 0x31, 0x32, 0x31, 0x30, 0x31, 0x33, 0x38, 0x30, 0x33, 0x30, 0x39, 0x44, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+	0xA5, 0x48 };
+
+bool PaceBmsProtocolModbus::CreateReadSerialNumberRequest(const uint8_t busId, std::vector<uint8_t>& request)
+{
+	CreateReadRegistersRequest(busId, REG_ModelSerialNumber, STRING_REGISTER_COUNT, request);
+	return true;
+}
+bool PaceBmsProtocolModbus::ProcessReadSerialNumberResponse(const uint8_t busId, const std::vector<uint8_t>& response, std::string& serialNumber)
+{
+	return ProcessReadStringResponse(busId, response, serialNumber);
+}
+
+bool PaceBmsProtocolModbus::CreateReadRemainingCapacityRequest(const uint8_t busId, std::vector<uint8_t>& request)
+{
+	CreateReadRegistersRequest(busId, REG_RemainingCapacity, 3, request);
+	return true;
+}
+bool PaceBmsProtocolModbus::ProcessReadRemainingCapacityResponse(const uint8_t busId, const std::vector<uint8_t>& response, uint32_t& remainingCapacityMilliampHours, uint32_t& actualCapacityMilliampHours, uint32_t& designCapacityMilliampHours)
+{
+	std::vector<uint16_t> registers;
+	if (!ValidateReadRegistersResponse(busId, response, 3, registers))
+	{
+		// failed to validate, the call would have done it's own logging
+		return false;
+	}
+
+	remainingCapacityMilliampHours = registers[0] * 10;
+	actualCapacityMilliampHours = registers[1] * 10;
+	designCapacityMilliampHours = registers[2] * 10;
+
+	return true;
+}
+
+bool PaceBmsProtocolModbus::CreateWriteSwitchCommandRequest(const uint8_t /* busId */, const SwitchCommand /* command */, std::vector<uint8_t>& /* request */)
+{
+	return NotSupported("Switch command");
+}
+bool PaceBmsProtocolModbus::CreateWriteMosfetSwitchCommandRequest(const uint8_t /* busId */, const MosfetType /* type */, const MosfetState /* command */, std::vector<uint8_t>& /* request */)
+{
+	return NotSupported("MOSFET switch command");
+}
+bool PaceBmsProtocolModbus::CreateWriteShutdownCommandRequest(const uint8_t /* busId */, std::vector<uint8_t>& /* request */)
+{
+	return NotSupported("Shutdown command");
+}
+bool PaceBmsProtocolModbus::CreateReadSystemDateTimeRequest(const uint8_t /* busId */, std::vector<uint8_t>& /* request */)
+{
+	return NotSupported("System date and time");
+}
+bool PaceBmsProtocolModbus::CreateWriteSystemDateTimeRequest(const uint8_t /* busId */, const DateTime /* dateTime */, std::vector<uint8_t>& /* request */)
+{
+	return NotSupported("System date and time");
+}
+bool PaceBmsProtocolModbus::CreateReadHistoryRecordRequest(const uint8_t /* busId */, const uint16_t /* recordIndex */, std::vector<uint8_t>& /* request */)
+{
+	return NotSupported("History records");
+}
+bool PaceBmsProtocolModbus::CreateReadChargeCurrentLimiterStartCurrentRequest(const uint8_t /* busId */, std::vector<uint8_t>& /* request */)
+{
+	return NotSupported("Charge current limiter start current");
+}
+bool PaceBmsProtocolModbus::CreateWriteChargeCurrentLimiterStartCurrentRequest(const uint8_t /* busId */, const uint8_t /* current */, std::vector<uint8_t>& /* request */)
+{
+	return NotSupported("Charge current limiter start current");
+}
+bool PaceBmsProtocolModbus::CreateReadProtocolsRequest(const uint8_t /* busId */, std::vector<uint8_t>& /* request */)
+{
+	return NotSupported("Protocols");
+}
+bool PaceBmsProtocolModbus::CreateWriteProtocolsRequest(const uint8_t /* busId */, const Protocols& /* protocols */, std::vector<uint8_t>& /* request */)
+{
+	return NotSupported("Protocols");
+}
+
+// ============================================================================
+//
+// Configuration
+//
+// ============================================================================
+
+void PaceBmsProtocolModbus::RememberConfigurationRegisters(const uint16_t firstRegister, const std::vector<uint16_t>& registers)
+{
+	for (int i = 0; i < (int)registers.size(); i++)
+	{
+		this->configurationRegisters[firstRegister - REG_ConfigurationFirst + i] = registers[i];
+		this->configurationRegisterValid[firstRegister - REG_ConfigurationFirst + i] = true;
+	}
+}
+
+bool PaceBmsProtocolModbus::ReadConfigurationRegisters(const uint8_t busId, const std::vector<uint8_t>& response, const uint16_t firstRegister, const uint16_t registerCount, std::vector<uint16_t>& registers)
+{
+	if (!ValidateReadRegistersResponse(busId, response, registerCount, registers))
+	{
+		// failed to validate, the call would have done it's own logging
+		return false;
+	}
+
+	RememberConfigurationRegisters(firstRegister, registers);
+	return true;
+}
+
+bool PaceBmsProtocolModbus::CreateWriteConfigurationRegistersRequest(const uint8_t busId, const uint16_t firstRegister, const std::vector<uint16_t>& registers, std::vector<uint8_t>& request)
+{
+	RememberConfigurationRegisters(firstRegister, registers);
+	CreateWriteRegistersRequest(busId, firstRegister, registers, request);
+	return true;
+}
+
+const uint8_t PaceBmsProtocolModbus::exampleReadCellOverVoltageConfigurationRequestModbus[] = { 0x01, 0x03, 0x00, 0x40, 0x00, 0x04, 0x45, 0xDD };
+const uint8_t PaceBmsProtocolModbus::exampleReadCellOverVoltageConfigurationResponseModbus[] = { 0x01, 0x03, 0x08, 0x0E, 0x10, 0x0E, 0x74, 0x0D, 0x34, 0x00, 0x0A, 0x77, 0xDA };
+const uint8_t PaceBmsProtocolModbus::exampleWriteCellOverVoltageConfigurationRequestModbus[] = { 0x01, 0x10, 0x00, 0x40, 0x00, 0x04, 0x08, 0x0E, 0x10, 0x0E, 0x74, 0x0D, 0x34, 0x00, 0x0A, 0x55, 0x48 };
+const uint8_t PaceBmsProtocolModbus::exampleWriteCellOverVoltageConfigurationResponseModbus[] = { 0x01, 0x10, 0x00, 0x40, 0x00, 0x04, 0xC0, 0x1E };
+
+bool PaceBmsProtocolModbus::CreateReadConfigurationRequest(const uint8_t busId, const ReadConfigurationType configType, std::vector<uint8_t>& request)
+{
+	switch (configType)
+	{
+	case RC_CellOverVoltage:
+		CreateReadRegistersRequest(busId, REG_CellOverVoltageAlarm, 4, request);
+		return true;
+	case RC_PackOverVoltage:
+		CreateReadRegistersRequest(busId, REG_PackOverVoltageAlarm, 4, request);
+		return true;
+	case RC_CellUnderVoltage:
+		CreateReadRegistersRequest(busId, REG_CellUnderVoltageAlarm, 4, request);
+		return true;
+	case RC_PackUnderVoltage:
+		CreateReadRegistersRequest(busId, REG_PackUnderVoltageAlarm, 4, request);
+		return true;
+	case RC_ChargeOverCurrent:
+		CreateReadRegistersRequest(busId, REG_ChargeOverCurrentAlarm, 3, request);
+		return true;
+	case RC_DischargeOverCurrent1:
+		CreateReadRegistersRequest(busId, REG_DischargeOverCurrentAlarm, 3, request);
+		return true;
+	case RC_DischargeOverCurrent2:
+		CreateReadRegistersRequest(busId, REG_DischargeOverCurrent2Protection, 2, request);
+		return true;
+	case RC_ShortCircuitProtection:
+		CreateReadRegistersRequest(busId, REG_ShortCircuitProtectionDelay, 1, request);
+		return true;
+	case RC_CellBalancing:
+		CreateReadRegistersRequest(busId, REG_BalanceStartCellVoltage, 2, request);
+		return true;
+	case RC_Sleep:
+		CreateReadRegistersRequest(busId, REG_CellSleepVoltage, 2, request);
+		return true;
+	case RC_FullChargeLowCharge:
+		// includes the sleep and short circuit registers in between, see: CreateWriteConfigurationRequest(FullChargeLowChargeConfiguration)
+		CreateReadRegistersRequest(busId, REG_PackFullChargeVoltage, REG_SocAlarmThreshold - REG_PackFullChargeVoltage + 1, request);
+		return true;
+	case RC_ChargeAndDischargeOverTemperature:
+		CreateReadRegistersRequest(busId, REG_ChargeOverTemperatureAlarm, 6, request);
+		return true;
+	case RC_ChargeAndDischargeUnderTemperature:
+		CreateReadRegistersRequest(busId, REG_ChargeUnderTemperatureAlarm, 6, request);
+		return true;
+	case RC_MosfetOverTemperature:
+		CreateReadRegistersRequest(busId, REG_MosfetOverTemperatureAlarm, 3, request);
+		return true;
+	case RC_EnvironmentOverUnderTemperature:
+		CreateReadRegistersRequest(busId, REG_EnvironmentOverTemperatureAlarm, 6, request);
+		return true;
+	}
+
+	LogError("Unknown configuration type");
+	return false;
+}
+bool PaceBmsProtocolModbus::ProcessWriteConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response)
+{
+	return ValidateWriteRegistersResponse(busId, response);
+}
+
+bool PaceBmsProtocolModbus::ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, CellOverVoltageConfiguration& config)
+{
+	std::vector<uint16_t> registers;
+	if (!ReadConfigurationRegisters(busId, response, REG_CellOverVoltageAlarm, 4, registers))
+		return false;
+
+	config.AlarmMillivolts = registers[0];
+	config.ProtectionMillivolts = registers[1];
+	config.ProtectionReleaseMillivolts = registers[2];
+	config.ProtectionDelayMilliseconds = registers[3] * 100;
+	return true;
+}
+bool PaceBmsProtocolModbus::CreateWriteConfigurationRequest(const uint8_t busId, const CellOverVoltageConfiguration& config, std::vector<uint8_t>& request)
+{
+	std::vector<uint16_t> registers{ config.AlarmMillivolts, config.ProtectionMillivolts, config.ProtectionReleaseMillivolts, (uint16_t)(config.ProtectionDelayMilliseconds / 100) };
+	return CreateWriteConfigurationRegistersRequest(busId, REG_CellOverVoltageAlarm, registers, request);
+}
+
+bool PaceBmsProtocolModbus::ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t> response, PackOverVoltageConfiguration& config)
+{
+	std::vector<uint16_t> registers;
+	if (!ReadConfigurationRegisters(busId, response, REG_PackOverVoltageAlarm, 4, registers))
+		return false;
+
+	config.AlarmMillivolts = registers[0];
+	config.ProtectionMillivolts = registers[1];
+	config.ProtectionReleaseMillivolts = registers[2];
+	config.ProtectionDelayMilliseconds = registers[3] * 100;
+	return true;
+}
+bool PaceBmsProtocolModbus::CreateWriteConfigurationRequest(const uint8_t busId, const PackOverVoltageConfiguration& config, std::vector<uint8_t>& request)
+{
+	std::vector<uint16_t> registers{ config.AlarmMillivolts, config.ProtectionMillivolts, config.ProtectionReleaseMillivolts, (uint16_t)(config.ProtectionDelayMilliseconds / 100) };
+	return CreateWriteConfigurationRegistersRequest(busId, REG_PackOverVoltageAlarm, registers, request);
+}
+
+bool PaceBmsProtocolModbus::ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, CellUnderVoltageConfiguration& config)
+{
+	std::vector<uint16_t> registers;
+	if (!ReadConfigurationRegisters(busId, response, REG_CellUnderVoltageAlarm, 4, registers))
+		return false;
+
+	config.AlarmMillivolts = registers[0];
+	config.ProtectionMillivolts = registers[1];
+	config.ProtectionReleaseMillivolts = registers[2];
+	config.ProtectionDelayMilliseconds = registers[3] * 100;
+	return true;
+}
+bool PaceBmsProtocolModbus::CreateWriteConfigurationRequest(const uint8_t busId, const CellUnderVoltageConfiguration& config, std::vector<uint8_t>& request)
+{
+	std::vector<uint16_t> registers{ config.AlarmMillivolts, config.ProtectionMillivolts, config.ProtectionReleaseMillivolts, (uint16_t)(config.ProtectionDelayMilliseconds / 100) };
+	return CreateWriteConfigurationRegistersRequest(busId, REG_CellUnderVoltageAlarm, registers, request);
+}
+
+bool PaceBmsProtocolModbus::ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, PackUnderVoltageConfiguration& config)
+{
+	std::vector<uint16_t> registers;
+	if (!ReadConfigurationRegisters(busId, response, REG_PackUnderVoltageAlarm, 4, registers))
+		return false;
+
+	config.AlarmMillivolts = registers[0];
+	config.ProtectionMillivolts = registers[1];
+	config.ProtectionReleaseMillivolts = registers[2];
+	config.ProtectionDelayMilliseconds = registers[3] * 100;
+	return true;
+}
+bool PaceBmsProtocolModbus::CreateWriteConfigurationRequest(const uint8_t busId, const PackUnderVoltageConfiguration& config, std::vector<uint8_t>& request)
+{
+	std::vector<uint16_t> registers{ config.AlarmMillivolts, config.ProtectionMillivolts, config.ProtectionReleaseMillivolts, (uint16_t)(config.ProtectionDelayMilliseconds / 100) };
+	return CreateWriteConfigurationRegistersRequest(busId, REG_PackUnderVoltageAlarm, registers, request);
+}
+
+bool PaceBmsProtocolModbus::ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, ChargeOverCurrentConfiguration& config)
+{
+	std::vector<uint16_t> registers;
+	if (!ReadConfigurationRegisters(busId, response, REG_ChargeOverCurrentAlarm, 3, registers))
+		return false;
+
+	config.AlarmAmperage = registers[0];
+	config.ProtectionAmperage = registers[1];
+	config.ProtectionDelayMilliseconds = registers[2] * 100;
+	return true;
+}
+bool PaceBmsProtocolModbus::CreateWriteConfigurationRequest(const uint8_t busId, const ChargeOverCurrentConfiguration& config, std::vector<uint8_t>& request)
+{
+	std::vector<uint16_t> registers{ config.AlarmAmperage, config.ProtectionAmperage, (uint16_t)(config.ProtectionDelayMilliseconds / 100) };
+	return CreateWriteConfigurationRegistersRequest(busId, REG_ChargeOverCurrentAlarm, registers, request);
+}
+
+bool PaceBmsProtocolModbus::ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, DischargeOverCurrent1Configuration& config)
+{
+	std::vector<uint16_t> registers;
+	if (!ReadConfigurationRegisters(busId, response, REG_DischargeOverCurrentAlarm, 3, registers))
+		return false;
+
+	// unlike paceic these are plain positive values in both directions
+	config.AlarmAmperage = registers[0];
+	config.ProtectionAmperage = registers[1];
+	config.ProtectionDelayMilliseconds = registers[2] * 100;
+	return true;
+}
+bool PaceBmsProtocolModbus::CreateWriteConfigurationRequest(const uint8_t busId, const DischargeOverCurrent1Configuration& config, std::vector<uint8_t>& request)
+{
+	std::vector<uint16_t> registers{ config.AlarmAmperage, config.ProtectionAmperage, (uint16_t)(config.ProtectionDelayMilliseconds / 100) };
+	return CreateWriteConfigurationRegistersRequest(busId, REG_DischargeOverCurrentAlarm, registers, request);
+}
+
+bool PaceBmsProtocolModbus::ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, DischargeOverCurrent2Configuration& config)
+{
+	std::vector<uint16_t> registers;
+	if (!ReadConfigurationRegisters(busId, response, REG_DischargeOverCurrent2Protection, 2, registers))
+		return false;
+
+	config.ProtectionAmperage = (uint8_t)registers[0];
+	config.ProtectionDelayMilliseconds = registers[1] * 25;
+	return true;
+}
+bool PaceBmsProtocolModbus::CreateWriteConfigurationRequest(const uint8_t busId, const DischargeOverCurrent2Configuration& config, std::vector<uint8_t>& request)
+{
+	std::vector<uint16_t> registers{ config.ProtectionAmperage, (uint16_t)(config.ProtectionDelayMilliseconds / 25) };
+	return CreateWriteConfigurationRegistersRequest(busId, REG_DischargeOverCurrent2Protection, registers, request);
+}
+
+bool PaceBmsProtocolModbus::ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, ShortCircuitProtectionConfiguration& config)
+{
+	std::vector<uint16_t> registers;
+	if (!ReadConfigurationRegisters(busId, response, REG_ShortCircuitProtectionDelay, 1, registers))
+		return false;
+
+	config.ProtectionDelayMicroseconds = registers[0] * 25;
+	return true;
+}
+bool PaceBmsProtocolModbus::CreateWriteConfigurationRequest(const uint8_t busId, const ShortCircuitProtectionConfiguration& config, std::vector<uint8_t>& request)
+{
+	std::vector<uint16_t> registers{ (uint16_t)(config.ProtectionDelayMicroseconds / 25) };
+	return CreateWriteConfigurationRegistersRequest(busId, REG_ShortCircuitProtectionDelay, registers, request);
+}
+
+bool PaceBmsProtocolModbus::ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, CellBalancingConfiguration& config)
+{
+	std::vector<uint16_t> registers;
+	if (!ReadConfigurationRegisters(busId, response, REG_BalanceStartCellVoltage, 2, registers))
+		return false;
+
+	config.ThresholdMillivolts = registers[0];
+	config.DeltaCellMillivolts = registers[1];
+	return true;
+}
+bool PaceBmsProtocolModbus::CreateWriteConfigurationRequest(const uint8_t busId, const CellBalancingConfiguration& config, std::vector<uint8_t>& request)
+{
+	std::vector<uint16_t> registers{ config.ThresholdMillivolts, config.DeltaCellMillivolts };
+	return CreateWriteConfigurationRegistersRequest(busId, REG_BalanceStartCellVoltage, registers, request);
+}
+
+bool PaceBmsProtocolModbus::ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, SleepConfiguration& config)
+{
+	std::vector<uint16_t> registers;
+	if (!ReadConfigurationRegisters(busId, response, REG_CellSleepVoltage, 2, registers))
+		return false;
+
+	config.CellMillivolts = registers[0];
+	config.DelayMinutes = (uint8_t)registers[1];
+	return true;
+}
+bool PaceBmsProtocolModbus::CreateWriteConfigurationRequest(const uint8_t busId, const SleepConfiguration& config, std::vector<uint8_t>& request)
+{
+	std::vector<uint16_t> registers{ config.CellMillivolts, config.DelayMinutes };
+	return CreateWriteConfigurationRegistersRequest(busId, REG_CellSleepVoltage, registers, request);
+}
+
+bool PaceBmsProtocolModbus::ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, FullChargeLowChargeConfiguration& config)
+{
+	std::vector<uint16_t> registers;
+	if (!ReadConfigurationRegisters(busId, response, REG_PackFullChargeVoltage, REG_SocAlarmThreshold - REG_PackFullChargeVoltage + 1, registers))
+		return false;
+
+	config.FullChargeMillivolts = registers[REG_PackFullChargeVoltage - REG_PackFullChargeVoltage];
+	config.FullChargeMilliamps = registers[REG_PackFullChargeCurrent - REG_PackFullChargeVoltage];
+	config.LowChargeAlarmPercent = (uint8_t)registers[REG_SocAlarmThreshold - REG_PackFullChargeVoltage];
+	return true;
+}
+bool PaceBmsProtocolModbus::CreateWriteConfigurationRequest(const uint8_t busId, const FullChargeLowChargeConfiguration& config, std::vector<uint8_t>& request)
+{
+	// the state of charge alarm isn't next to the full charge registers, the ones in between have to be written back as they were
+	for (int reg = REG_CellSleepVoltage; reg <= REG_ShortCircuitProtectionDelay; reg++)
+	{
+		if (!this->configurationRegisterValid[reg - REG_ConfigurationFirst])
+		{
+			LogError("Full charge / low charge configuration must be read before it can be written");
+			return false;
+		}
+	}
+
+	std::vector<uint16_t> registers{
+		config.FullChargeMillivolts,
+		config.FullChargeMilliamps,
+		this->configurationRegisters[REG_CellSleepVoltage - REG_ConfigurationFirst],
+		this->configurationRegisters[REG_CellSleepDelay - REG_ConfigurationFirst],
+		this->configurationRegisters[REG_ShortCircuitProtectionDelay - REG_ConfigurationFirst],
+		config.LowChargeAlarmPercent };
+	return CreateWriteConfigurationRegistersRequest(busId, REG_PackFullChargeVoltage, registers, request);
+}
+
+bool PaceBmsProtocolModbus::ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, ChargeAndDischargeOverTemperatureConfiguration& config)
+{
+	std::vector<uint16_t> registers;
+	if (!ReadConfigurationRegisters(busId, response, REG_ChargeOverTemperatureAlarm, 6, registers))
+		return false;
+
+	// stored in tenths of a degree C
+	config.ChargeAlarm = (uint8_t)((int16_t)registers[0] / 10);
+	config.ChargeProtection = (uint8_t)((int16_t)registers[1] / 10);
+	config.ChargeProtectionRelease = (uint8_t)((int16_t)registers[2] / 10);
+	config.DischargeAlarm = (uint8_t)((int16_t)registers[3] / 10);
+	config.DischargeProtection = (uint8_t)((int16_t)registers[4] / 10);
+	config.DischargeProtectionRelease = (uint8_t)((int16_t)registers[5] / 10);
+	return true;
+}
+bool PaceBmsProtocolModbus::CreateWriteConfigurationRequest(const uint8_t busId, const ChargeAndDischargeOverTemperatureConfiguration& config, std::vector<uint8_t>& request)
+{
+	std::vector<uint16_t> registers{
+		(uint16_t)(config.ChargeAlarm * 10),
+		(uint16_t)(config.ChargeProtection * 10),
+		(uint16_t)(config.ChargeProtectionRelease * 10),
+		(uint16_t)(config.DischargeAlarm * 10),
+		(uint16_t)(config.DischargeProtection * 10),
+		(uint16_t)(config.DischargeProtectionRelease * 10) };
+	return CreateWriteConfigurationRegistersRequest(busId, REG_ChargeOverTemperatureAlarm, registers, request);
+}
+
+bool PaceBmsProtocolModbus::ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, ChargeAndDischargeUnderTemperatureConfiguration& config)
+{
+	std::vector<uint16_t> registers;
+	if (!ReadConfigurationRegisters(busId, response, REG_ChargeUnderTemperatureAlarm, 6, registers))
+		return false;
+
+	// stored in tenths of a degree C
+	config.ChargeAlarm = (int8_t)((int16_t)registers[0] / 10);
+	config.ChargeProtection = (int8_t)((int16_t)registers[1] / 10);
+	config.ChargeProtectionRelease = (int8_t)((int16_t)registers[2] / 10);
+	config.DischargeAlarm = (int8_t)((int16_t)registers[3] / 10);
+	config.DischargeProtection = (int8_t)((int16_t)registers[4] / 10);
+	config.DischargeProtectionRelease = (int8_t)((int16_t)registers[5] / 10);
+	return true;
+}
+bool PaceBmsProtocolModbus::CreateWriteConfigurationRequest(const uint8_t busId, const ChargeAndDischargeUnderTemperatureConfiguration& config, std::vector<uint8_t>& request)
+{
+	std::vector<uint16_t> registers{
+		(uint16_t)(int16_t)(config.ChargeAlarm * 10),
+		(uint16_t)(int16_t)(config.ChargeProtection * 10),
+		(uint16_t)(int16_t)(config.ChargeProtectionRelease * 10),
+		(uint16_t)(int16_t)(config.DischargeAlarm * 10),
+		(uint16_t)(int16_t)(config.DischargeProtection * 10),
+		(uint16_t)(int16_t)(config.DischargeProtectionRelease * 10) };
+	return CreateWriteConfigurationRegistersRequest(busId, REG_ChargeUnderTemperatureAlarm, registers, request);
+}
+
+bool PaceBmsProtocolModbus::ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, MosfetOverTemperatureConfiguration& config)
+{
+	std::vector<uint16_t> registers;
+	if (!ReadConfigurationRegisters(busId, response, REG_MosfetOverTemperatureAlarm, 3, registers))
+		return false;
+
+	// stored in tenths of a degree C
+	config.Alarm = (int8_t)((int16_t)registers[0] / 10);
+	config.Protection = (int8_t)((int16_t)registers[1] / 10);
+	config.ProtectionRelease = (int8_t)((int16_t)registers[2] / 10);
+	return true;
+}
+bool PaceBmsProtocolModbus::CreateWriteConfigurationRequest(const uint8_t busId, const MosfetOverTemperatureConfiguration& config, std::vector<uint8_t>& request)
+{
+	std::vector<uint16_t> registers{
+		(uint16_t)(int16_t)(config.Alarm * 10),
+		(uint16_t)(int16_t)(config.Protection * 10),
+		(uint16_t)(int16_t)(config.ProtectionRelease * 10) };
+	return CreateWriteConfigurationRegistersRequest(busId, REG_MosfetOverTemperatureAlarm, registers, request);
+}
+
+bool PaceBmsProtocolModbus::ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, EnvironmentOverUnderTemperatureConfiguration& config)
+{
+	std::vector<uint16_t> registers;
+	if (!ReadConfigurationRegisters(busId, response, REG_EnvironmentOverTemperatureAlarm, 6, registers))
+		return false;
+
+	// stored in tenths of a degree C, over temperature first (the reverse of paceic)
+	config.OverAlarm = (int8_t)((int16_t)registers[0] / 10);
+	config.OverProtection = (int8_t)((int16_t)registers[1] / 10);
+	config.OverProtectionRelease = (int8_t)((int16_t)registers[2] / 10);
+	config.UnderAlarm = (int8_t)((int16_t)registers[3] / 10);
+	config.UnderProtection = (int8_t)((int16_t)registers[4] / 10);
+	config.UnderProtectionRelease = (int8_t)((int16_t)registers[5] / 10);
+	return true;
+}
+bool PaceBmsProtocolModbus::CreateWriteConfigurationRequest(const uint8_t busId, const EnvironmentOverUnderTemperatureConfiguration& config, std::vector<uint8_t>& request)
+{
+	std::vector<uint16_t> registers{
+		(uint16_t)(int16_t)(config.OverAlarm * 10),
+		(uint16_t)(int16_t)(config.OverProtection * 10),
+		(uint16_t)(int16_t)(config.OverProtectionRelease * 10),
+		(uint16_t)(int16_t)(config.UnderAlarm * 10),
+		(uint16_t)(int16_t)(config.UnderProtection * 10),
+		(uint16_t)(int16_t)(config.UnderProtectionRelease * 10) };
+	return CreateWriteConfigurationRegistersRequest(busId, REG_EnvironmentOverTemperatureAlarm, registers, request);
+}
+
+#endif // PACE_BMS_TRANSPORT_MODBUS
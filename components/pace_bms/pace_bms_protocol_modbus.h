@@ -0,0 +1,289 @@
+#pragma once
+
+#include "pace_bms_protocol_v25.h"
+
+/*
+General format of MODBUS RTU requests/responses (see protocol_documentation/modbus/Pace):
+-------------------------------------
+note: unlike paceic everything is binary, big endian registers, little endian CRC, and there is no SOI/EOI, the length of a
+      response has to be worked out from its function code and byte count as it arrives, see: GetResponseFrameLength
+-------------------------------------
+read holding registers:
+	request:  ADR, 0x03, START(hi), START(lo), COUNT(hi), COUNT(lo), CRC(lo), CRC(hi)
+	response: ADR, 0x03, BYTECOUNT, DATA(hi), DATA(lo) (repeated COUNT times), CRC(lo), CRC(hi)
+write multiple registers:
+	request:  ADR, 0x10, START(hi), START(lo), COUNT(hi), COUNT(lo), BYTECOUNT, DATA(hi), DATA(lo) (repeated COUNT times), CRC(lo), CRC(hi)
+	response: ADR, 0x10, START(hi), START(lo), COUNT(hi), COUNT(lo), CRC(lo), CRC(hi)
+error:
+	response: ADR, FUNCTION + 0x80, ERRORCODE, CRC(lo), CRC(hi)
+*/
+
+// Many firmwares that speak paceic version 25 will also answer MODBUS on the RS485 port, the data is the same but the binary
+//     encoding moves it in roughly half the bytes
+// This is a drop-in replacement for PaceBmsProtocolV25, it fills the same structs so that the component and everything
+//     downstream of it doesn't need to know or care which transport is in use
+// Commands without a MODBUS register equivalent (switch / MOSFET commands, shutdown, date and time, protocols, and charge
+//     current limiter start current) fail to create a request
+class PaceBmsProtocolModbus : public PaceBmsProtocolV25
+{
+public:
+	// takes pointers to the "real" logging functions
+	PaceBmsProtocolModbus(
+		OPTIONAL_NS::optional<std::string> protocol_variant, OPTIONAL_NS::optional<uint8_t> protocol_version_override, OPTIONAL_NS::optional<uint8_t> batteryChemistry,
+		LogFuncPtr logError, LogFuncPtr logWarning, LogFuncPtr logInfo, LogFuncPtr logDebug, LogFuncPtr logVerbose, LogFuncPtr logVeryVerbose);
+
+	// responses have no EOI marker, so the receiving side calls this as bytes arrive to find out how long the frame will be
+	//     returns 0 until enough of the header has arrived to know
+	static uint16_t GetResponseFrameLength(const uint8_t* frame, const uint16_t received);
+
+protected:
+	enum FunctionCode : uint8_t
+	{
+		FC_ReadHoldingRegisters   = 0x03,
+		FC_WriteMultipleRegisters = 0x10,
+		FC_ErrorFlag              = 0x80,
+	};
+
+	enum Register : uint16_t
+	{
+		// data acquisition, read only
+		REG_Current                          = 0,   // INT16, 10mA
+		REG_PackVoltage                      = 1,   // UINT16, 10mV
+		REG_SoC                              = 2,   // %
+		REG_SoH                              = 3,   // %
+		REG_RemainingCapacity                = 4,   // UINT16, 10mAh
+		REG_FullCapacity                     = 5,   // UINT16, 10mAh
+		REG_DesignCapacity                   = 6,   // UINT16, 10mAh
+		REG_CycleCount                       = 7,
+		REG_WarningFlags                     = 9,   // bit layout matches paceic Warning1 (low byte) / Warning2 (high byte)
+		REG_ProtectionFlags                  = 10,  // bit layout matches paceic Protection1 (low byte) / Protection2 (high byte)
+		REG_StatusFaultFlags                 = 11,  // fault (low byte) matches paceic Fault, status (high byte) needs translating
+		REG_BalanceStatus                    = 12,  // one bit per cell
+		REG_CellVoltages                     = 15,  // 16 registers, mV
+		REG_CellTemperatures                 = 31,  // 4 registers, INT16, 0.1C
+		REG_MosfetTemperature                = 35,  // INT16, 0.1C
+		REG_EnvironmentTemperature           = 36,  // INT16, 0.1C
+		REG_RealtimeCount                    = 37,
+
+		// configuration, read / write
+		REG_PackOverVoltageAlarm             = 60,  // alarm / protection / release in mV, then delay in 0.1S
+		REG_CellOverVoltageAlarm             = 64,
+		REG_PackUnderVoltageAlarm            = 68,
+		REG_CellUnderVoltageAlarm            = 72,
+		REG_ChargeOverCurrentAlarm           = 76,  // alarm / protection in A, then delay in 0.1S
+		REG_DischargeOverCurrentAlarm        = 79,
+		REG_DischargeOverCurrent2Protection  = 82,  // protection in A, then delay in 0.025S
+		REG_ChargeOverTemperatureAlarm       = 84,  // charge alarm / protection / release, then discharge alarm / protection / release, INT16, 0.1C
+		REG_ChargeUnderTemperatureAlarm      = 90,
+		REG_MosfetOverTemperatureAlarm       = 96,  // alarm / protection / release, INT16, 0.1C
+		REG_EnvironmentOverTemperatureAlarm  = 99,
+		REG_EnvironmentUnderTemperatureAlarm = 102,
+		REG_BalanceStartCellVoltage          = 105, // mV
+		REG_BalanceStartDeltaVoltage         = 106, // mV
+		REG_PackFullChargeVoltage            = 107, // mV
+		REG_PackFullChargeCurrent            = 108, // mA
+		REG_CellSleepVoltage                 = 109, // mV
+		REG_CellSleepDelay                   = 110, // minutes
+		REG_ShortCircuitProtectionDelay      = 111, // 25uS
+		REG_SocAlarmThreshold                = 112, // %
+		REG_ConfigurationFirst               = 60,
+		REG_ConfigurationCount               = 55,
+
+		// information, read only
+		REG_VersionInformation               = 150, // 10 registers, 2 ASCII characters each
+		REG_ModelSerialNumber                = 160, // 10 registers, 2 ASCII characters each
+	};
+	// the length of REG_VersionInformation and REG_ModelSerialNumber, kept out of the enum since it isn't a register
+	static const uint16_t STRING_REGISTER_COUNT = 10;
+
+	// possible flags set in the high byte of REG_StatusFaultFlags, translated into StatusInformation_SystemFlags
+	enum StatusFlags : uint16_t
+	{
+		MSF_Charging                  = (1 << 8),
+		MSF_Discharging               = (1 << 9),
+		MSF_ChargeMosfetOn            = (1 << 10),
+		MSF_DischargeMosfetOn         = (1 << 11),
+		MSF_ChargeCurrentLimiterOn    = (1 << 12),
+		MSF_UndefinedStatusBit13      = (1 << 13),
+		MSF_ChargerReversed           = (1 << 14),
+		MSF_HeaterOn                  = (1 << 15), // no paceic equivalent
+	};
+
+	// standard MODBUS CRC16 (polynomial 0xA001, initial value 0xFFFF)
+	static uint16_t CalculateCrc(const uint8_t* data, const uint16_t length);
+
+	void CreateReadRegistersRequest(const uint8_t busId, const uint16_t firstRegister, const uint16_t registerCount, std::vector<uint8_t>& request);
+	void CreateWriteRegistersRequest(const uint8_t busId, const uint16_t firstRegister, const std::vector<uint16_t>& registers, std::vector<uint8_t>& request);
+
+	// on success registers is filled with the response data, which must be exactly registerCount long
+	bool ValidateReadRegistersResponse(const uint8_t busId, const std::vector<uint8_t>& response, const uint16_t registerCount, std::vector<uint16_t>& registers);
+	bool ValidateWriteRegistersResponse(const uint8_t busId, const std::vector<uint8_t>& response);
+
+	// helper for: ProcessReadHardwareVersionResponse / ProcessReadSerialNumberResponse
+	bool ProcessReadStringResponse(const uint8_t busId, const std::vector<uint8_t>& response, std::string& str);
+
+	// the full charge / low charge configuration is not contiguous (sleep and short circuit configuration sit in between), and
+	//     a MODBUS write is, so the whole configuration area is remembered as it's read or written in order to be able to
+	//     write those "in between" registers back unchanged
+	uint16_t configurationRegisters[REG_ConfigurationCount]{ 0 };
+	bool     configurationRegisterValid[REG_ConfigurationCount]{ false };
+	void RememberConfigurationRegisters(const uint16_t firstRegister, const std::vector<uint16_t>& registers);
+	bool ReadConfigurationRegisters(const uint8_t busId, const std::vector<uint8_t>& response, const uint16_t firstRegister, const uint16_t registerCount, std::vector<uint16_t>& registers);
+	bool CreateWriteConfigurationRegistersRequest(const uint8_t busId, const uint16_t firstRegister, const std::vector<uint16_t>& registers, std::vector<uint8_t>& request);
+
+	// helper for the commands that have no MODBUS equivalent
+	bool NotSupported(const std::string& command);
+
+public:
+
+// ============================================================================
+//
+// Read planning
+//
+// ============================================================================
+
+	// every read this class creates is a single contiguous block of holding registers, so rather than sending one request
+	//     per struct the caller can collect the ranges it's about to ask for and merge them into as few block reads as
+	//     possible, each member is then handed its own slice of the block response as if it had been read on its own
+	struct RegisterRange
+	{
+		uint16_t firstRegister;
+		uint16_t registerCount;
+	};
+	struct ReadBlock
+	{
+		RegisterRange range;
+		std::vector<uint16_t> members; // indexes into the ranges that were passed to PlanReadBlocks
+	};
+
+	// returns false if request isn't a read holding registers request
+	static bool GetReadRequestRange(const std::vector<uint8_t>& request, RegisterRange& range);
+
+	// merges ranges into blocks of at most maxRegisters, reading through (and discarding) up to maxGap unused registers
+	//     between ranges when that saves a request, a range that is larger than maxRegisters on its own gets its own block
+	static std::vector<ReadBlock> PlanReadBlocks(const std::vector<RegisterRange>& ranges, const uint16_t maxRegisters, const uint16_t maxGap);
+
+	bool CreateReadBlockRequest(const uint8_t busId, const RegisterRange& block, std::vector<uint8_t>& request);
+	bool ValidateReadBlockResponse(const uint8_t busId, const std::vector<uint8_t>& response, const RegisterRange& block);
+	// builds the response that reading member on its own would have produced (including the CRC), from a validated block response
+	void ExtractReadBlockResponse(const uint8_t busId, const std::vector<uint8_t>& response, const RegisterRange& block, const RegisterRange& member, std::vector<uint8_t>& memberResponse);
+
+// ============================================================================
+//
+// Realtime data
+//
+// ============================================================================
+
+	// ==== Read Analog Information / Read Status Information
+	// the status registers sit inside the analog block, when both are read at once (see PlanReadBlocks) each Process call is
+	//     handed its own slice of the block response by ExtractReadBlockResponse
+	// the cell count isn't reported, cells reading 0 mV at the end of the block are assumed to not exist
+	// per-cell / per-temperature warning values and configuration status aren't reported either, they will always read 0
+	// req:   01 03 0000 0025 8411
+	// resp:  01 03 4A FF1F 1473 003F 0064 183C 286A 2710 008C 0000 0001 0000 0E00 0000 0000 0000 0CC7 0CC8 0CC7 0CC7 0CC7 0CC5 0CC6 0CC7 0CC7 0CC6 0CC7 0CC6 0CC6 0CC7 0CC6 0CC7 00FB 00F9 00F9 00F9 0113 011C 15A4
+
+	static const uint8_t exampleReadAnalogInformationRequestModbus[];
+	static const uint8_t exampleReadAnalogInformationResponseModbus[];
+
+	bool CreateReadAnalogInformationRequest(const uint8_t busId, std::vector<uint8_t>& request) override;
+	bool ProcessReadAnalogInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation, const uint32_t fields = AIF_All) override;
+
+	// req:   01 03 0009 0004 940B
+	// resp:  01 03 08 0001 0000 0E00 0000 87FF
+	//                 9999 0000 1111 2222
+
+	static const uint8_t exampleReadStatusInformationRequestModbus[];
+	static const uint8_t exampleReadStatusInformationResponseModbus[];
+
+	bool CreateReadStatusInformationRequest(const uint8_t busId, std::vector<uint8_t>& request) override;
+	bool ProcessReadStatusInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation, const uint32_t fields = SIF_All) override;
+
+	// ==== Read Hardware Version (registers 150-159, "version information")
+	// req:   01 03 0096 000A 25E1
+	// resp:  01 03 14 50313653313030412D313831322D312E30302000 DD76
+
+	static const uint8_t exampleReadHardwareVersionRequestModbus[];
+	static const uint8_t exampleReadHardwareVersionResponseModbus[];
+
+	bool CreateReadHardwareVersionRequest(const uint8_t busId, std::vector<uint8_t>& request) override;
+	bool ProcessReadHardwareVersionResponse(const uint8_t busId, const std::vector<uint8_t>& response, std::string& hardwareVersion) override;
+
+	// ==== Read Serial Number (registers 160-169, "model SN", there is also a "pack SN" at 170-179 written by the pack manufacturer)
+	// req:   01 03 00A0 000A C5EF
+	// resp:  01 03 14 3138313231303133383033303944202020202020 A548
+
+	static const uint8_t exampleReadSerialNumberRequestModbus[];
+	static const uint8_t exampleReadSerialNumberResponseModbus[];
+
+	bool CreateReadSerialNumberRequest(const uint8_t busId, std::vector<uint8_t>& request) override;
+	bool ProcessReadSerialNumberResponse(const uint8_t busId, const std::vector<uint8_t>& response, std::string& serialNumber) override;
+
+	// ==== Read Remaining Capacity (registers 4-6)
+	bool CreateReadRemainingCapacityRequest(const uint8_t busId, std::vector<uint8_t>& request) override;
+	bool ProcessReadRemainingCapacityResponse(const uint8_t busId, const std::vector<uint8_t>& response, uint32_t& remainingCapacityMilliampHours, uint32_t& actualCapacityMilliampHours, uint32_t& designCapacityMilliampHours) override;
+
+	// ==== not available over MODBUS
+	bool CreateWriteSwitchCommandRequest(const uint8_t busId, const SwitchCommand command, std::vector<uint8_t>& request) override;
+	bool CreateWriteMosfetSwitchCommandRequest(const uint8_t busId, const MosfetType type, const MosfetState command, std::vector<uint8_t>& request) override;
+	bool CreateWriteShutdownCommandRequest(const uint8_t busId, std::vector<uint8_t>& request) override;
+	bool CreateReadSystemDateTimeRequest(const uint8_t busId, std::vector<uint8_t>& request) override;
+	bool CreateWriteSystemDateTimeRequest(const uint8_t busId, const DateTime dateTime, std::vector<uint8_t>& request) override;
+	bool CreateReadHistoryRecordRequest(const uint8_t busId, const uint16_t recordIndex, std::vector<uint8_t>& request) override;
+	bool CreateReadChargeCurrentLimiterStartCurrentRequest(const uint8_t busId, std::vector<uint8_t>& request) override;
+	bool CreateWriteChargeCurrentLimiterStartCurrentRequest(const uint8_t busId, const uint8_t current, std::vector<uint8_t>& request) override;
+	bool CreateReadProtocolsRequest(const uint8_t busId, std::vector<uint8_t>& request) override;
+	bool CreateWriteProtocolsRequest(const uint8_t busId, const Protocols& protocols, std::vector<uint8_t>& request) override;
+
+// ============================================================================
+//
+// Configuration
+//
+// ============================================================================
+
+	// each ReadConfigurationType reads just the registers it needs, all values are converted to the same units the paceic
+	//     structs use (delays in ms/us, temperatures in whole degrees C)
+	// read:  01 03 0040 0004 45DD
+	// resp:  01 03 08 0E10 0E74 0D34 000A 77DA
+	//                 1111 2222 3333 4444
+	// write: 01 10 0040 0004 08 0E10 0E74 0D34 000A 5548
+	// resp:  01 10 0040 0004 C01E
+
+	static const uint8_t exampleReadCellOverVoltageConfigurationRequestModbus[];
+	static const uint8_t exampleReadCellOverVoltageConfigurationResponseModbus[];
+	static const uint8_t exampleWriteCellOverVoltageConfigurationRequestModbus[];
+	static const uint8_t exampleWriteCellOverVoltageConfigurationResponseModbus[];
+
+	bool CreateReadConfigurationRequest(const uint8_t busId, const ReadConfigurationType configType, std::vector<uint8_t>& request) override;
+	bool ProcessWriteConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response) override;
+
+	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, CellOverVoltageConfiguration& config) override;
+	bool CreateWriteConfigurationRequest(const uint8_t busId, const CellOverVoltageConfiguration& config, std::vector<uint8_t>& request) override;
+	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t> response, PackOverVoltageConfiguration& config) override;
+	bool CreateWriteConfigurationRequest(const uint8_t busId, const PackOverVoltageConfiguration& config, std::vector<uint8_t>& request) override;
+	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, CellUnderVoltageConfiguration& config) override;
+	bool CreateWriteConfigurationRequest(const uint8_t busId, const CellUnderVoltageConfiguration& config, std::vector<uint8_t>& request) override;
+	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, PackUnderVoltageConfiguration& config) override;
+	bool CreateWriteConfigurationRequest(const uint8_t busId, const PackUnderVoltageConfiguration& config, std::vector<uint8_t>& request) override;
+	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, ChargeOverCurrentConfiguration& config) override;
+	bool CreateWriteConfigurationRequest(const uint8_t busId, const ChargeOverCurrentConfiguration& config, std::vector<uint8_t>& request) override;
+	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, DischargeOverCurrent1Configuration& config) override;
+	bool CreateWriteConfigurationRequest(const uint8_t busId, const DischargeOverCurrent1Configuration& config, std::vector<uint8_t>& request) override;
+	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, DischargeOverCurrent2Configuration& config) override;
+	bool CreateWriteConfigurationRequest(const uint8_t busId, const DischargeOverCurrent2Configuration& config, std::vector<uint8_t>& request) override;
+	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, ShortCircuitProtectionConfiguration& config) override;
+	bool CreateWriteConfigurationRequest(const uint8_t busId, const ShortCircuitProtectionConfiguration& config, std::vector<uint8_t>& request) override;
+	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, CellBalancingConfiguration& config) override;
+	bool CreateWriteConfigurationRequest(const uint8_t busId, const CellBalancingConfiguration& config, std::vector<uint8_t>& request) override;
+	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, SleepConfiguration& config) override;
+	bool CreateWriteConfigurationRequest(const uint8_t busId, const SleepConfiguration& config, std::vector<uint8_t>& request) override;
+	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, FullChargeLowChargeConfiguration& config) override;
+	bool CreateWriteConfigurationRequest(const uint8_t busId, const FullChargeLowChargeConfiguration& config, std::vector<uint8_t>& request) override;
+	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, ChargeAndDischargeOverTemperatureConfiguration& config) override;
+	bool CreateWriteConfigurationRequest(const uint8_t busId, const ChargeAndDischargeOverTemperatureConfiguration& config, std::vector<uint8_t>& request) override;
+	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, ChargeAndDischargeUnderTemperatureConfiguration& config) override;
+	bool CreateWriteConfigurationRequest(const uint8_t busId, const ChargeAndDischargeUnderTemperatureConfiguration& config, std::vector<uint8_t>& request) override;
+	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, MosfetOverTemperatureConfiguration& config) override;
+	bool CreateWriteConfigurationRequest(const uint8_t busId, const MosfetOverTemperatureConfiguration& config, std::vector<uint8_t>& request) override;
+	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, EnvironmentOverUnderTemperatureConfiguration& config) override;
+	bool CreateWriteConfigurationRequest(const uint8_t busId, const EnvironmentOverUnderTemperatureConfiguration& config, std::vector<uint8_t>& request) override;
+};
@@ -1,6 +1,8 @@
 
 #include "pace_bms_protocol_v20.h"
 
+#ifdef PACE_BMS_COMMANDSET_V20
+
 // takes pointers to the "real" logging functions
 PaceBmsProtocolV20::PaceBmsProtocolV20(
 	OPTIONAL_NS::optional<std::string> protocol_variant, OPTIONAL_NS::optional<uint8_t> protocol_version_override, OPTIONAL_NS::optional<uint8_t> batteryChemistry,
@@ -39,10 +41,10 @@ bool PaceBmsProtocolV20::CreateReadAnalogInformationRequest(const uint8_t busId,
 
 	return true;
 }
-bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation)
+bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation, const uint32_t fields)
 {
 	// save in order compare against what ProcessReadStatusInformationResponse sussed out
-	OPTIONAL_NS::optional<std::string> previously_detected_variant = OPTIONAL_NS::optional<std::string>(detected_variant.value());
+	OPTIONAL_NS::optional<std::string> previously_detected_variant = detected_variant;
 
 	// try to auto-detect the protocol variant
 	//if (!detected_variant.has_value()) 
@@ -51,7 +53,7 @@ bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse(const uint8_t busI
 
 		bool isEG4 = false;
 		byteOffset = 13 + 116;
-		if (response.size() - byteOffset > 2)
+		if (response.size() > byteOffset + 2u)
 		{
 			uint8_t byte = ReadHexEncodedByte(response, byteOffset);
 			if (byte == 15)
@@ -60,7 +62,7 @@ bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse(const uint8_t busI
 
 		bool isPylon = false;
 		byteOffset = 13 + 106;
-		if (response.size() - byteOffset > 2)
+		if (response.size() > byteOffset + 2u)
 		{
 			uint8_t byte = ReadHexEncodedByte(response, byteOffset);
 			if (byte == 02)
@@ -69,7 +71,7 @@ bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse(const uint8_t busI
 
 		bool isSeplos = false;
 		byteOffset = 13 + 106;
-		if (response.size() - byteOffset > 2)
+		if (response.size() > byteOffset + 2u)
 		{
 			uint8_t byte = ReadHexEncodedByte(response, byteOffset);
 			if (byte == 10)
@@ -116,7 +118,7 @@ bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse(const uint8_t busI
 	if (previously_detected_variant.has_value() && detected_variant.has_value() &&
 		previously_detected_variant.value() != detected_variant.value())
 	{
-		LogWarning("Auto-detected protocol variant '" + detected_variant.value() + "' does not match previously detected protocol variant '" + protocol_variant.value() + "' determined via a different method, using newly detected value.");
+		LogWarning("Auto-detected protocol variant '" + detected_variant.value() + "' does not match previously detected protocol variant '" + previously_detected_variant.value() + "' determined via a different method, using newly detected value.");
 	}
 
 	// decide what variant to use
@@ -133,26 +135,35 @@ bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse(const uint8_t busI
 	}
 
 	// fan-out to variant handlers
+#ifdef PACE_BMS_V20_VARIANT_PYLON
 	if (variant_to_use == "PYLON")
 	{
-		return ProcessReadAnalogInformationResponse_PYLON(busId, response, analogInformation);
+		return ProcessReadAnalogInformationResponse_PYLON(busId, response, analogInformation, fields);
 	}
-	else if (variant_to_use == "SEPLOS")
+	else
+#endif
+#ifdef PACE_BMS_V20_VARIANT_SEPLOS
+	if (variant_to_use == "SEPLOS")
 	{
-		return ProcessReadAnalogInformationResponse_SEPLOS(busId, response, analogInformation);
+		return ProcessReadAnalogInformationResponse_SEPLOS(busId, response, analogInformation, fields);
 	}
-	else if (variant_to_use == "EG4")
+	else
+#endif
+#ifdef PACE_BMS_V20_VARIANT_EG4
+	if (variant_to_use == "EG4")
 	{
-		return ProcessReadAnalogInformationResponse_EG4(busId, response, analogInformation);
+		return ProcessReadAnalogInformationResponse_EG4(busId, response, analogInformation, fields);
 	}
 	else
+#endif
 	{
-		LogError("Invalid protocol variant '" + variant_to_use + "'");
+		LogError("Invalid protocol variant '" + variant_to_use + "', or support for it was not compiled in");
 		return false;
 	}
 }
 
-bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse_PYLON(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation)
+#ifdef PACE_BMS_V20_VARIANT_PYLON
+bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse_PYLON(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation, const uint32_t fields)
 {
 	//std::memset(&analogInformation, 0, sizeof(AnalogInformation));
 
@@ -175,13 +186,25 @@ bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse_PYLON(const uint8_
 	if (pack_count != 01)
 		LogWarning("response contains data from more than one pack");
 
+	DecodeAnalogInformationBlock_PYLON(response, byteOffset, analogInformation, fields);
+
+	if (byteOffset != payloadLen + 13)
+		LogWarning("Length mismatch reading analog information response: " + std::to_string(payloadLen + 13 - byteOffset) + " bytes off");
+
+	return true;
+}
+
+// helper for: ProcessReadAnalogInformationResponse_PYLON and ProcessReadSystemAnalogInformationResponse_PYLON
+//     decodes a single pack's worth of analog information starting at byteOffset, which is left pointing just past it
+void PaceBmsProtocolV20::DecodeAnalogInformationBlock_PYLON(const std::vector<uint8_t>& response, uint16_t& byteOffset, AnalogInformation& analogInformation, const uint32_t fields)
+{
 	analogInformation.cellCount = ReadHexEncodedByte(response, byteOffset);
 	if (analogInformation.cellCount > MAX_CELL_COUNT)
 		LogWarning("Response contains more cell voltage readings than are supported, results will be truncated");
 	for (int i = 0; i < analogInformation.cellCount; i++)
 	{
 		uint16_t cellVoltage = ReadHexEncodedUShort(response, byteOffset);
-		if (i > MAX_CELL_COUNT - 1)
+		if (i > MAX_CELL_COUNT - 1 || (fields & (AIF_CellVoltages | AIF_CellMinMax | AIF_CellAverage)) == 0)
 			continue;
 		analogInformation.cellVoltagesMillivolts[i] = cellVoltage;
 	}
@@ -192,7 +215,7 @@ bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse_PYLON(const uint8_
 	for (int i = 0; i < analogInformation.temperatureCount; i++)
 	{
 		uint16_t temperature = ReadHexEncodedUShort(response, byteOffset);
-		if (i > MAX_TEMP_COUNT - 1)
+		if (i > MAX_TEMP_COUNT - 1 || (fields & AIF_Temperatures) == 0)
 			continue;
 		analogInformation.temperaturesTenthsCelcius[i] = (temperature - 2730);
 	}
@@ -201,38 +224,38 @@ bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse_PYLON(const uint8_
 	analogInformation.totalVoltageMillivolts = ReadHexEncodedUShort(response, byteOffset) * 10;
 	analogInformation.remainingCapacityMilliampHours = ReadHexEncodedUShort(response, byteOffset) * 10;
 
+	// 2 for packs up to 65Ah, 4 for larger packs which then put 0xFFFF in the 16 bit capacities and append 24 bit capacities at the end
 	uint8_t UD2 = ReadHexEncodedByte(response, byteOffset);
-	if (UD2 != 2)
+	if (UD2 != 2 && UD2 != 4)
 		LogWarning("Response contains a constant with an unexpected value, this may be an incorrect protocol variant");
 
 	analogInformation.fullCapacityMilliampHours = ReadHexEncodedUShort(response, byteOffset) * 10;
 	analogInformation.cycleCount = ReadHexEncodedUShort(response, byteOffset);
 
-	if (byteOffset != payloadLen + 13)
-		LogWarning("Length mismatch reading analog information response: " + std::to_string(payloadLen + 13 - byteOffset) + " bytes off");
-
-	// calculate some "extras"
-	analogInformation.SoC = ((float)analogInformation.remainingCapacityMilliampHours / (float)analogInformation.fullCapacityMilliampHours);
-	// SoH not possible without design capacity information
-	// todo: allow user specified design capacity override?
-	analogInformation.powerWatts = ((float)analogInformation.totalVoltageMillivolts * (float)analogInformation.currentMilliamps) / 1000000.0f;
-	analogInformation.minCellVoltageMillivolts = 65535;
-	analogInformation.maxCellVoltageMillivolts = 0;
-	analogInformation.avgCellVoltageMillivolts = 0;
-	for (int i = 0; i < analogInformation.cellCount; i++)
+	if (UD2 == 4)
 	{
-		if (analogInformation.cellVoltagesMillivolts[i] > analogInformation.maxCellVoltageMillivolts)
-			analogInformation.maxCellVoltageMillivolts = analogInformation.cellVoltagesMillivolts[i];
-		if (analogInformation.cellVoltagesMillivolts[i] < analogInformation.minCellVoltageMillivolts)
-			analogInformation.minCellVoltageMillivolts = analogInformation.cellVoltagesMillivolts[i];
-		analogInformation.avgCellVoltageMillivolts += analogInformation.cellVoltagesMillivolts[i];
+		uint32_t remainingCapacity = ReadHexEncodedByte(response, byteOffset);
+		remainingCapacity = (remainingCapacity << 16) | ReadHexEncodedUShort(response, byteOffset);
+		uint32_t fullCapacity = ReadHexEncodedByte(response, byteOffset);
+		fullCapacity = (fullCapacity << 16) | ReadHexEncodedUShort(response, byteOffset);
+		analogInformation.remainingCapacityMilliampHours = remainingCapacity;
+		analogInformation.fullCapacityMilliampHours = fullCapacity;
 	}
-	analogInformation.avgCellVoltageMillivolts /= analogInformation.cellCount;
-	analogInformation.maxCellDifferentialMillivolts = analogInformation.maxCellVoltageMillivolts - analogInformation.minCellVoltageMillivolts;
 
-	return true;
+	// calculate some "extras", but only the ones somebody is going to look at
+	if ((fields & AIF_StateOfCharge) != 0)
+		analogInformation.SoC = ((float)analogInformation.remainingCapacityMilliampHours / (float)analogInformation.fullCapacityMilliampHours);
+	// SoH not possible without design capacity information
+	// todo: allow user specified design capacity override?
+	if ((fields & AIF_Power) != 0)
+		analogInformation.powerWatts = ((float)analogInformation.totalVoltageMillivolts * (float)analogInformation.currentMilliamps) / 1000000.0f;
+	if ((fields & (AIF_CellMinMax | AIF_CellAverage)) != 0)
+		CalculateCellStatistics(analogInformation.cellVoltagesMillivolts, (analogInformation.cellCount > MAX_CELL_COUNT ? MAX_CELL_COUNT : analogInformation.cellCount), fields,
+			analogInformation.minCellVoltageMillivolts, analogInformation.maxCellVoltageMillivolts, analogInformation.avgCellVoltageMillivolts, analogInformation.maxCellDifferentialMillivolts);
 }
-bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse_SEPLOS(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation)
+#endif
+#ifdef PACE_BMS_V20_VARIANT_SEPLOS
+bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse_SEPLOS(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation, const uint32_t fields)
 {
 	//std::memset(&analogInformation, 0, sizeof(AnalogInformation));
 
@@ -260,7 +283,7 @@ bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse_SEPLOS(const uint8
 	for (int i = 0; i < analogInformation.cellCount; i++)
 	{
 		uint16_t cellVoltage = ReadHexEncodedUShort(response, byteOffset);
-		if (i > MAX_CELL_COUNT - 1)
+		if (i > MAX_CELL_COUNT - 1 || (fields & (AIF_CellVoltages | AIF_CellMinMax | AIF_CellAverage)) == 0)
 			continue;
 		analogInformation.cellVoltagesMillivolts[i] = cellVoltage;
 	}
@@ -271,7 +294,7 @@ bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse_SEPLOS(const uint8
 	for (int i = 0; i < analogInformation.temperatureCount; i++)
 	{
 		uint16_t temperature = ReadHexEncodedUShort(response, byteOffset);
-		if (i > MAX_TEMP_COUNT - 1)
+		if (i > MAX_TEMP_COUNT - 1 || (fields & AIF_Temperatures) == 0)
 			continue;
 		analogInformation.temperaturesTenthsCelcius[i] = (temperature - 2730);
 	}
@@ -299,25 +322,18 @@ bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse_SEPLOS(const uint8
 	if (byteOffset != payloadLen + 13)
 		LogWarning("Length mismatch reading analog information response: " + std::to_string(payloadLen + 13 - byteOffset) + " bytes off");
 
-	// calculate some "extras"
-	analogInformation.powerWatts = ((float)analogInformation.totalVoltageMillivolts * (float)analogInformation.currentMilliamps) / 1000000.0f;
-	analogInformation.minCellVoltageMillivolts = 65535;
-	analogInformation.maxCellVoltageMillivolts = 0;
-	analogInformation.avgCellVoltageMillivolts = 0;
-	for (int i = 0; i < analogInformation.cellCount; i++)
-	{
-		if (analogInformation.cellVoltagesMillivolts[i] > analogInformation.maxCellVoltageMillivolts)
-			analogInformation.maxCellVoltageMillivolts = analogInformation.cellVoltagesMillivolts[i];
-		if (analogInformation.cellVoltagesMillivolts[i] < analogInformation.minCellVoltageMillivolts)
-			analogInformation.minCellVoltageMillivolts = analogInformation.cellVoltagesMillivolts[i];
-		analogInformation.avgCellVoltageMillivolts += analogInformation.cellVoltagesMillivolts[i];
-	}
-	analogInformation.avgCellVoltageMillivolts /= analogInformation.cellCount;
-	analogInformation.maxCellDifferentialMillivolts = analogInformation.maxCellVoltageMillivolts - analogInformation.minCellVoltageMillivolts;
+	// calculate some "extras", but only the ones somebody is going to look at
+	if ((fields & AIF_Power) != 0)
+		analogInformation.powerWatts = ((float)analogInformation.totalVoltageMillivolts * (float)analogInformation.currentMilliamps) / 1000000.0f;
+	if ((fields & (AIF_CellMinMax | AIF_CellAverage)) != 0)
+		CalculateCellStatistics(analogInformation.cellVoltagesMillivolts, (analogInformation.cellCount > MAX_CELL_COUNT ? MAX_CELL_COUNT : analogInformation.cellCount), fields,
+			analogInformation.minCellVoltageMillivolts, analogInformation.maxCellVoltageMillivolts, analogInformation.avgCellVoltageMillivolts, analogInformation.maxCellDifferentialMillivolts);
 
 	return true;
 }
-bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse_EG4(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation)
+#endif
+#ifdef PACE_BMS_V20_VARIANT_EG4
+bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse_EG4(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation, const uint32_t fields)
 {
 	//std::memset(&analogInformation, 0, sizeof(AnalogInformation));
 
@@ -345,7 +361,7 @@ bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse_EG4(const uint8_t
 	for (int i = 0; i < analogInformation.cellCount; i++)
 	{
 		uint16_t cellVoltage = ReadHexEncodedUShort(response, byteOffset);
-		if (i > MAX_CELL_COUNT - 1)
+		if (i > MAX_CELL_COUNT - 1 || (fields & (AIF_CellVoltages | AIF_CellMinMax | AIF_CellAverage)) == 0)
 			continue;
 		analogInformation.cellVoltagesMillivolts[i] = cellVoltage;
 	}
@@ -359,7 +375,7 @@ bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse_EG4(const uint8_t
 	for (int i = 0; i < analogInformation.temperatureCount; i++)
 	{
 		uint16_t temperature = ReadHexEncodedUShort(response, byteOffset);
-		if (i > MAX_TEMP_COUNT - 1)
+		if (i > MAX_TEMP_COUNT - 1 || (fields & AIF_Temperatures) == 0)
 			continue;
 		analogInformation.temperaturesTenthsCelcius[i] = (temperature - 2730);
 	}
@@ -400,14 +416,16 @@ bool PaceBmsProtocolV20::ProcessReadAnalogInformationResponse_EG4(const uint8_t
 	if (byteOffset != payloadLen + 13)
 		LogWarning("Length mismatch reading analog information response: " + std::to_string(payloadLen + 13 - byteOffset) + " bytes off");
 
-	// calculate some "extras"
-	analogInformation.powerWatts = ((float)analogInformation.totalVoltageMillivolts * (float)analogInformation.currentMilliamps) / 1000000.0f;
-	for (int i = 0; i < analogInformation.cellCount; i++)
-		analogInformation.avgCellVoltageMillivolts += analogInformation.cellVoltagesMillivolts[i];
-	analogInformation.avgCellVoltageMillivolts /= analogInformation.cellCount;
+	// calculate some "extras", but only the ones somebody is going to look at (min/max/differential came over the wire)
+	if ((fields & AIF_Power) != 0)
+		analogInformation.powerWatts = ((float)analogInformation.totalVoltageMillivolts * (float)analogInformation.currentMilliamps) / 1000000.0f;
+	if ((fields & AIF_CellAverage) != 0)
+		CalculateCellStatistics(analogInformation.cellVoltagesMillivolts, (analogInformation.cellCount > MAX_CELL_COUNT ? MAX_CELL_COUNT : analogInformation.cellCount), AIF_CellAverage,
+			analogInformation.minCellVoltageMillivolts, analogInformation.maxCellVoltageMillivolts, analogInformation.avgCellVoltageMillivolts, analogInformation.maxCellDifferentialMillivolts);
 
 	return true;
 }
+#endif
 
 const unsigned char PaceBmsProtocolV20::exampleReadStatusInformationRequestV20[] = "~20014A440000FDA0\r";
 const unsigned char PaceBmsProtocolV20::exampleReadStatusInformationResponseV20[] = "~20014A007054100110000000000000000000000000000000000400000000000000000900000000000003020000000000EDC3\r";
@@ -455,6 +473,7 @@ const std::string PaceBmsProtocolV20::DecodeWarningValue(const uint8_t val)
 	return std::string("Unknown Fault Value");
 }
 
+#ifdef PACE_BMS_V20_VARIANT_PYLON
 // helper for: ProcessStatusInformationResponse
 // note: in docs some of these are labeled protection and the rest are unlabeled as to "category" so I'm assuming protection also since it's in the same flags register?
 void PaceBmsProtocolV20::StatusDecode_PYLON::DecodeStatus1Value(const uint8_t val, std::string& protectionText)
@@ -636,7 +655,9 @@ void PaceBmsProtocolV20::StatusDecode_PYLON::DecodeStatus5Value(const uint8_t va
 		faultText.append("Cell 09 Fault (cell > 4.2v or cell < 1.0v); ");
 	}
 }
+#endif
 
+#ifdef PACE_BMS_V20_VARIANT_SEPLOS
 // helper for: ProcessStatusInformationResponse
 void PaceBmsProtocolV20::StatusDecode_SEPLOS::DecodeWarning1Value(const uint8_t val, std::string& faultText)
 {
@@ -997,7 +1018,9 @@ void PaceBmsProtocolV20::StatusDecode_SEPLOS::DecodeWarning8Value(const uint8_t
 		faultText.append("EEP Storage Failure; ");
 	}
 }
+#endif
 
+#ifdef PACE_BMS_V20_VARIANT_EG4
 // helper for: ProcessStatusInformationResponse
 void PaceBmsProtocolV20::StatusDecode_EG4::DecodeBalanceEvent(const uint8_t val, std::string& warningText, std::string& faultText)
 {
@@ -1282,11 +1305,12 @@ void PaceBmsProtocolV20::StatusDecode_EG4::DecodeSystemStatus(const uint8_t val,
 		systemText.append("Discharging; ");
 	}
 }
+#endif
 
-bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation)
+bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation, const uint32_t fields)
 {
 	// save in order compare against what ProcessReadAnalogInformationResponse sussed out
-	OPTIONAL_NS::optional<std::string> previously_detected_variant = OPTIONAL_NS::optional<std::string>(detected_variant.value());
+	OPTIONAL_NS::optional<std::string> previously_detected_variant = detected_variant;
 
 	// try to auto-detect the protocol variant
 	//if (!detected_variant.has_value())
@@ -1295,7 +1319,7 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse(const uint8_t busI
 
 		bool isEG4 = false;
 		byteOffset = 13 + 56;
-		if (response.size() - byteOffset > 2)
+		if (response.size() > byteOffset + 2u)
 		{
 			uint8_t byte = ReadHexEncodedByte(response, byteOffset);
 			if (byte == 9)
@@ -1314,7 +1338,7 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse(const uint8_t busI
 
 		bool isSeplos = false;
 		byteOffset = 13 + 56;
-		if (response.size() - byteOffset > 2)
+		if (response.size() > byteOffset + 2u)
 		{
 			uint8_t byte = ReadHexEncodedByte(response, byteOffset);
 			if (byte == 20)
@@ -1361,7 +1385,7 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse(const uint8_t busI
 	if (previously_detected_variant.has_value() && detected_variant.has_value() &&
 		previously_detected_variant.value() != detected_variant.value())
 	{
-		LogWarning("Auto-detected protocol variant '" + detected_variant.value() + "' does not match previously detected protocol variant '" + protocol_variant.value() + "' determined via a different method, using newly detected value.");
+		LogWarning("Auto-detected protocol variant '" + detected_variant.value() + "' does not match previously detected protocol variant '" + previously_detected_variant.value() + "' determined via a different method, using newly detected value.");
 	}
 
 	// decide what variant to use
@@ -1378,26 +1402,53 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse(const uint8_t busI
 	}
 
 	// fan-out to variant handlers
+	bool result;
+#ifdef PACE_BMS_V20_VARIANT_PYLON
 	if (variant_to_use == "PYLON")
 	{
-		return ProcessReadStatusInformationResponse_PYLON(busId, response, statusInformation);
+		result = ProcessReadStatusInformationResponse_PYLON(busId, response, statusInformation, fields);
 	}
-	else if (variant_to_use == "SEPLOS")
+	else
+#endif
+#ifdef PACE_BMS_V20_VARIANT_SEPLOS
+	if (variant_to_use == "SEPLOS")
 	{
-		return ProcessReadStatusInformationResponse_SEPLOS(busId, response, statusInformation);
+		result = ProcessReadStatusInformationResponse_SEPLOS(busId, response, statusInformation, fields);
 	}
-	else if (variant_to_use == "EG4")
+	else
+#endif
+#ifdef PACE_BMS_V20_VARIANT_EG4
+	if (variant_to_use == "EG4")
 	{
-		return ProcessReadStatusInformationResponse_EG4(busId, response, statusInformation);
+		result = ProcessReadStatusInformationResponse_EG4(busId, response, statusInformation, fields);
 	}
 	else
+#endif
 	{
-		LogError("Invalid protocol variant '" + variant_to_use + "'");
+		LogError("Invalid protocol variant '" + variant_to_use + "', or support for it was not compiled in");
 		return false;
 	}
+
+	// the StatusDecode_ helpers append to several text fields at once, so one that nobody asked for can still pick up 
+	//     some text as a side effect of decoding one that somebody did ask for, throw those away
+	if ((fields & SIF_WarningText) == 0)
+		statusInformation.warningText.clear();
+	if ((fields & SIF_BalancingText) == 0)
+		statusInformation.balancingText.clear();
+	if ((fields & SIF_SystemText) == 0)
+		statusInformation.systemText.clear();
+	if ((fields & SIF_ConfigurationText) == 0)
+		statusInformation.configurationText.clear();
+	if ((fields & SIF_ProtectionText) == 0)
+		statusInformation.protectionText.clear();
+	if ((fields & SIF_FaultText) == 0)
+		statusInformation.faultText.clear();
+
+	return result;
 }
 
-bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_PYLON(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation)
+#ifdef PACE_BMS_V20_VARIANT_PYLON
+bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_PYLON(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation, const uint32_t fields)
 {
 	int16_t payloadLen = ValidateResponseAndGetPayloadLength(busId, response);
 	if (payloadLen == -1)
@@ -1416,6 +1467,18 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_PYLON(const uint8_
 	if (pack_count != 01)
 		LogWarning("response contains data for more than one pack");
 
+	DecodeStatusInformationBlock_PYLON(response, byteOffset, statusInformation, fields);
+
+	if (byteOffset != payloadLen + 13)
+		LogWarning("Length mismatch reading status information response: " + std::to_string(payloadLen + 13 - byteOffset) + " bytes off");
+
+	return true;
+}
+
+// helper for: ProcessReadStatusInformationResponse_PYLON and ProcessReadSystemStatusInformationResponse_PYLON
+//     decodes a single pack's worth of status information starting at byteOffset, which is left pointing just past it
+void PaceBmsProtocolV20::DecodeStatusInformationBlock_PYLON(const std::vector<uint8_t>& response, uint16_t& byteOffset, StatusInformation& statusInformation, const uint32_t fields)
+{
 	// ========================== Warning / Alarm Status ==========================
 	uint8_t cellCount = ReadHexEncodedByte(response, byteOffset);
 	if (cellCount > MAX_CELL_COUNT)
@@ -1423,10 +1486,10 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_PYLON(const uint8_
 	for (int i = 0; i < cellCount; i++)
 	{
 		uint8_t cw = ReadHexEncodedByte(response, byteOffset);
-		statusInformation.warning_value_cell[i] = cw;
 		if (i > MAX_CELL_COUNT - 1)
 			continue;
-		if (cw == 0)
+		statusInformation.warning_value_cell[i] = cw;
+		if (cw == 0 || (fields & SIF_WarningText) == 0)
 			continue;
 		// below/above limit
 		statusInformation.warningText.append(std::string("Cell ") + std::to_string(i + 1) + std::string(": ") + DecodeWarningValue(cw) + std::string("; "));
@@ -1438,10 +1501,10 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_PYLON(const uint8_
 	for (int i = 0; i < tempCount; i++)
 	{
 		uint8_t tw = ReadHexEncodedByte(response, byteOffset);
-		statusInformation.warning_value_temp[i] = tw;
 		if (i > MAX_TEMP_COUNT - 1)
 			continue;
-		if (tw == 0)
+		statusInformation.warning_value_temp[i] = tw;
+		if (tw == 0 || (fields & SIF_WarningText) == 0)
 			continue;
 		// below/above limit
 		statusInformation.warningText.append(std::string("Temperature ") + std::to_string(i + 1) + ": " + DecodeWarningValue(tw) + std::string("; "));
@@ -1449,46 +1512,43 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_PYLON(const uint8_
 
 	uint8_t chargeCurrentWarn = ReadHexEncodedByte(response, byteOffset);
 	statusInformation.warning_value_charge_current = chargeCurrentWarn;
-	if (chargeCurrentWarn != 0)
+	if (chargeCurrentWarn != 0 && (fields & SIF_WarningText) != 0)
 		// below/above limit
 		statusInformation.warningText.append(std::string("Charge current: ") + DecodeWarningValue(chargeCurrentWarn) + std::string("; "));
 
 	uint8_t totalVoltageWarn = ReadHexEncodedByte(response, byteOffset);
 	statusInformation.warning_value_total_voltage = totalVoltageWarn;
-	if (totalVoltageWarn != 0)
+	if (totalVoltageWarn != 0 && (fields & SIF_WarningText) != 0)
 		// below/above limit
 		statusInformation.warningText.append(std::string("Total voltage: ") + DecodeWarningValue(totalVoltageWarn) + std::string("; "));
 
 	uint8_t dischargeCurrentWarn = ReadHexEncodedByte(response, byteOffset);
 	statusInformation.warning_value_discharge_current = dischargeCurrentWarn;
-	if (dischargeCurrentWarn != 0)
+	if (dischargeCurrentWarn != 0 && (fields & SIF_WarningText) != 0)
 		// below/above limit
 		statusInformation.warningText.append(std::string("Discharge current: ") + DecodeWarningValue(dischargeCurrentWarn) + std::string("; "));
 
 	// ========================== Status 1-5 Flags ==========================
 	statusInformation.status1_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.status1_value != 0)
+	if (statusInformation.status1_value != 0 && (fields & SIF_ProtectionText) != 0)
 		StatusDecode_PYLON::DecodeStatus1Value(statusInformation.status1_value, statusInformation.protectionText);
 
 	statusInformation.status2_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.status2_value != 0)
+	if (statusInformation.status2_value != 0 && (fields & SIF_ConfigurationText) != 0)
 		StatusDecode_PYLON::DecodeStatus2Value(statusInformation.status2_value, statusInformation.configurationText);
 
 	statusInformation.status3_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.status3_value != 0)
+	if (statusInformation.status3_value != 0 && (fields & SIF_SystemText) != 0)
 		StatusDecode_PYLON::DecodeStatus3Value(statusInformation.status3_value, statusInformation.systemText);
 
 	statusInformation.status4_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.status4_value != 0)
+	if (statusInformation.status4_value != 0 && (fields & SIF_FaultText) != 0)
 		StatusDecode_PYLON::DecodeStatus4Value(statusInformation.status4_value, statusInformation.faultText);
 
 	statusInformation.status5_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.status5_value != 0)
+	if (statusInformation.status5_value != 0 && (fields & SIF_FaultText) != 0)
 		StatusDecode_PYLON::DecodeStatus5Value(statusInformation.status5_value, statusInformation.faultText);
 
-	if (byteOffset != payloadLen + 13)
-		LogWarning("Length mismatch reading status information response: " + std::to_string(payloadLen + 13 - byteOffset) + " bytes off");
-
 	// pop off any trailing "; " separator
 	if (statusInformation.warningText.length() > 2)
 	{
@@ -1520,10 +1580,10 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_PYLON(const uint8_
 		statusInformation.faultText.pop_back();
 		statusInformation.faultText.pop_back();
 	}
-
-	return true;
 }
-bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_SEPLOS(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation)
+#endif
+#ifdef PACE_BMS_V20_VARIANT_SEPLOS
+bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_SEPLOS(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation, const uint32_t fields)
 {
 	int16_t payloadLen = ValidateResponseAndGetPayloadLength(busId, response);
 	if (payloadLen == -1)
@@ -1550,10 +1610,10 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_SEPLOS(const uint8
 	for (int i = 0; i < cellCount; i++)
 	{
 		uint8_t cw = ReadHexEncodedByte(response, byteOffset);
-		statusInformation.warning_value_cell[i] = cw;
 		if (i > MAX_CELL_COUNT - 1)
 			continue;
-		if (cw == 0)
+		statusInformation.warning_value_cell[i] = cw;
+		if (cw == 0 || (fields & SIF_WarningText) == 0)
 			continue;
 		// below/above limit
 		statusInformation.warningText.append(std::string("Cell ") + std::to_string(i + 1) + std::string(": ") + DecodeWarningValue(cw) + std::string("; "));
@@ -1565,10 +1625,10 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_SEPLOS(const uint8
 	for (int i = 0; i < tempCount; i++)
 	{
 		uint8_t tw = ReadHexEncodedByte(response, byteOffset);
-		statusInformation.warning_value_temp[i] = tw;
 		if (i > MAX_TEMP_COUNT - 1)
 			continue;
-		if (tw == 0)
+		statusInformation.warning_value_temp[i] = tw;
+		if (tw == 0 || (fields & SIF_WarningText) == 0)
 			continue;
 		// below/above limit
 		statusInformation.warningText.append(std::string("Temperature ") + std::to_string(i + 1) + ": " + DecodeWarningValue(tw) + std::string("; "));
@@ -1578,14 +1638,14 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_SEPLOS(const uint8
 	// SEPLOS combines these two into a single value, so setting both
 	statusInformation.warning_value_charge_current = currentWarn;
 	statusInformation.warning_value_discharge_current = currentWarn;
-	if (currentWarn != 0)
+	if (currentWarn != 0 && (fields & SIF_WarningText) != 0)
 		// below/above limit
 		// SEPLOS combines these two into a single value, so adjusting text
 		statusInformation.warningText.append(std::string("Current: ") + DecodeWarningValue(currentWarn) + std::string("; "));
 
 	uint8_t totalVoltageWarn = ReadHexEncodedByte(response, byteOffset);
 	statusInformation.warning_value_total_voltage = totalVoltageWarn;
-	if (totalVoltageWarn != 0)
+	if (totalVoltageWarn != 0 && (fields & SIF_WarningText) != 0)
 		// below/above limit
 		statusInformation.warningText.append(std::string("Total voltage: ") + DecodeWarningValue(totalVoltageWarn) + std::string("; "));
 
@@ -1601,35 +1661,35 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_SEPLOS(const uint8
 
 	// ========================== Status Flags ==========================
 	statusInformation.warning1_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.warning1_value != 0)
+	if (statusInformation.warning1_value != 0 && (fields & SIF_FaultText) != 0)
 		StatusDecode_SEPLOS::DecodeWarning1Value(statusInformation.warning1_value, statusInformation.faultText);
 
 	statusInformation.warning2_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.warning2_value != 0)
+	if (statusInformation.warning2_value != 0 && (fields & (SIF_WarningText | SIF_ProtectionText)) != 0)
 		StatusDecode_SEPLOS::DecodeWarning2Value(statusInformation.warning2_value, statusInformation.warningText, statusInformation.protectionText);
 
 	statusInformation.warning3_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.warning3_value != 0)
+	if (statusInformation.warning3_value != 0 && (fields & (SIF_WarningText | SIF_ProtectionText)) != 0)
 		StatusDecode_SEPLOS::DecodeWarning3Value(statusInformation.warning3_value, statusInformation.warningText, statusInformation.protectionText);
 
 	statusInformation.warning4_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.warning4_value != 0)
+	if (statusInformation.warning4_value != 0 && (fields & (SIF_WarningText | SIF_ProtectionText | SIF_SystemText)) != 0)
 		StatusDecode_SEPLOS::DecodeWarning4Value(statusInformation.warning4_value, statusInformation.warningText, statusInformation.protectionText, statusInformation.systemText);
 
 	statusInformation.warning5_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.warning5_value != 0)
+	if (statusInformation.warning5_value != 0 && (fields & (SIF_WarningText | SIF_ProtectionText | SIF_FaultText)) != 0)
 		StatusDecode_SEPLOS::DecodeWarning5Value(statusInformation.warning5_value, statusInformation.warningText, statusInformation.protectionText, statusInformation.faultText);
 
 	statusInformation.warning6_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.warning6_value != 0)
+	if (statusInformation.warning6_value != 0 && (fields & (SIF_WarningText | SIF_ProtectionText | SIF_FaultText)) != 0)
 		StatusDecode_SEPLOS::DecodeWarning6Value(statusInformation.warning6_value, statusInformation.warningText, statusInformation.protectionText, statusInformation.faultText);
 
 	statusInformation.power_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.power_value != 0)
+	if (statusInformation.power_value != 0 && (fields & SIF_ConfigurationText) != 0)
 		StatusDecode_SEPLOS::DecodePowerStatusValue(statusInformation.power_value, statusInformation.configurationText);
 
 	statusInformation.balancing_value = ReadHexEncodedUShort(response, byteOffset);
-	for (int i = 0; i < 16; i++)
+	for (int i = 0; i < 16 && (fields & SIF_BalancingText) != 0; i++)
 	{
 		if ((statusInformation.balancing_value & (1 << i)) != 0)
 		{
@@ -1638,11 +1698,11 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_SEPLOS(const uint8
 	}
 
 	statusInformation.system_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.system_value != 0)
+	if (statusInformation.system_value != 0 && (fields & (SIF_WarningText | SIF_ProtectionText | SIF_FaultText)) != 0)
 		StatusDecode_SEPLOS::DecodeWarning6Value(statusInformation.system_value, statusInformation.warningText, statusInformation.protectionText, statusInformation.faultText);
 
 	statusInformation.disconnection_value = ReadHexEncodedUShort(response, byteOffset);
-	for (int i = 0; i < 16; i++)
+	for (int i = 0; i < 16 && (fields & SIF_FaultText) != 0; i++)
 	{
 		if ((statusInformation.disconnection_value & (1 << i)) != 0)
 		{
@@ -1651,11 +1711,11 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_SEPLOS(const uint8
 	}
 
 	statusInformation.warning7_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.warning7_value != 0)
+	if (statusInformation.warning7_value != 0 && (fields & SIF_WarningText) != 0)
 		StatusDecode_SEPLOS::DecodeWarning7Value(statusInformation.warning7_value, statusInformation.warningText);
 
 	statusInformation.warning8_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.warning8_value != 0)
+	if (statusInformation.warning8_value != 0 && (fields & SIF_FaultText) != 0)
 		StatusDecode_SEPLOS::DecodeWarning8Value(statusInformation.warning8_value, statusInformation.faultText);
 
 	// reserved 1-6
@@ -1698,7 +1758,9 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_SEPLOS(const uint8
 
 	return true;
 }
-bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_EG4(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation)
+#endif
+#ifdef PACE_BMS_V20_VARIANT_EG4
+bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_EG4(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation, const uint32_t fields)
 {
 	int16_t payloadLen = ValidateResponseAndGetPayloadLength(busId, response);
 	if (payloadLen == -1)
@@ -1725,10 +1787,10 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_EG4(const uint8_t
 	for (int i = 0; i < cellCount; i++)
 	{
 		uint8_t cw = ReadHexEncodedByte(response, byteOffset);
-		statusInformation.warning_value_cell[i] = cw;
 		if (i > MAX_CELL_COUNT - 1)
 			continue;
-		if (cw == 0)
+		statusInformation.warning_value_cell[i] = cw;
+		if (cw == 0 || (fields & SIF_WarningText) == 0)
 			continue;
 		// below/above limit
 		statusInformation.warningText.append(std::string("Cell ") + std::to_string(i + 1) + std::string(": ") + DecodeWarningValue(cw) + std::string("; "));
@@ -1743,10 +1805,10 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_EG4(const uint8_t
 	for (int i = 0; i < tempCount; i++)
 	{
 		uint8_t tw = ReadHexEncodedByte(response, byteOffset);
-		statusInformation.warning_value_temp[i] = tw;
 		if (i > MAX_TEMP_COUNT - 1)
 			continue;
-		if (tw == 0)
+		statusInformation.warning_value_temp[i] = tw;
+		if (tw == 0 || (fields & SIF_WarningText) == 0)
 			continue;
 		// below/above limit
 		statusInformation.warningText.append(std::string("Temperature ") + std::to_string(i + 1) + ": " + DecodeWarningValue(tw) + std::string("; "));
@@ -1756,14 +1818,14 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_EG4(const uint8_t
 	// EG4 combines these two into a single value, so setting both
 	statusInformation.warning_value_charge_current = currentWarn;
 	statusInformation.warning_value_discharge_current = currentWarn;
-	if (currentWarn != 0)
+	if (currentWarn != 0 && (fields & SIF_WarningText) != 0)
 		// below/above limit
 		// EG4 combines these two into a single value, so adjusting text
 		statusInformation.warningText.append(std::string("Current: ") + DecodeWarningValue(currentWarn) + std::string("; "));
 
 	uint8_t totalVoltageWarn = ReadHexEncodedByte(response, byteOffset);
 	statusInformation.warning_value_total_voltage = totalVoltageWarn;
-	if (totalVoltageWarn != 0)
+	if (totalVoltageWarn != 0 && (fields & SIF_WarningText) != 0)
 		// below/above limit
 		statusInformation.warningText.append(std::string("Total voltage: ") + DecodeWarningValue(totalVoltageWarn) + std::string("; "));
 
@@ -1779,35 +1841,35 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_EG4(const uint8_t
 
 	// ========================== Status Flags ==========================
 	statusInformation.balance_event_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.balance_event_value != 0)
+	if (statusInformation.balance_event_value != 0 && (fields & (SIF_WarningText | SIF_FaultText)) != 0)
 		StatusDecode_EG4::DecodeBalanceEvent(statusInformation.balance_event_value, statusInformation.warningText, statusInformation.faultText);
 
 	statusInformation.voltage_event_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.voltage_event_value != 0)
+	if (statusInformation.voltage_event_value != 0 && (fields & (SIF_WarningText | SIF_ProtectionText)) != 0)
 		StatusDecode_EG4::DecodeVoltageEvent(statusInformation.voltage_event_value, statusInformation.warningText, statusInformation.protectionText);
 
 	statusInformation.temperature_event_value = ReadHexEncodedUShort(response, byteOffset);
-	if (statusInformation.temperature_event_value != 0)
+	if (statusInformation.temperature_event_value != 0 && (fields & (SIF_WarningText | SIF_ProtectionText | SIF_FaultText)) != 0)
 		StatusDecode_EG4::DecodeTemperatureEvent(statusInformation.temperature_event_value, statusInformation.warningText, statusInformation.protectionText, statusInformation.faultText);
 
 	statusInformation.current_event_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.current_event_value != 0)
+	if (statusInformation.current_event_value != 0 && (fields & (SIF_WarningText | SIF_ProtectionText | SIF_FaultText)) != 0)
 		StatusDecode_EG4::DecodeCurrentEvent(statusInformation.current_event_value, statusInformation.warningText, statusInformation.protectionText, statusInformation.faultText);
 
 	statusInformation.remaining_capacity_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.remaining_capacity_value != 0)
+	if (statusInformation.remaining_capacity_value != 0 && (fields & SIF_WarningText) != 0)
 		StatusDecode_EG4::DecodeRemainingCapacity(statusInformation.remaining_capacity_value, statusInformation.warningText);
 
 	statusInformation.fet_status_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.fet_status_value != 0)
+	if (statusInformation.fet_status_value != 0 && (fields & SIF_ConfigurationText) != 0)
 		StatusDecode_EG4::DecodeFetStatus(statusInformation.fet_status_value, statusInformation.configurationText);
 
 	statusInformation.system_value = ReadHexEncodedByte(response, byteOffset);
-	if (statusInformation.system_value != 0)
+	if (statusInformation.system_value != 0 && (fields & SIF_SystemText) != 0)
 		StatusDecode_EG4::DecodeSystemStatus(statusInformation.system_value, statusInformation.systemText);
 
 	statusInformation.balancing_value = ReadHexEncodedULong(response, byteOffset);
-	for (int i = 0; i < 16; i++)
+	for (int i = 0; i < 16 && (fields & SIF_BalancingText) != 0; i++)
 	{
 		if ((statusInformation.balancing_value & (1 << i)) != 0)
 		{
@@ -1855,6 +1917,192 @@ bool PaceBmsProtocolV20::ProcessReadStatusInformationResponse_EG4(const uint8_t
 
 	return true;
 }
+#endif
+
+#ifdef PACE_BMS_V20_VARIANT_PYLON
+const unsigned char PaceBmsProtocolV20::exampleReadSystemAnalogInformationRequestV20_PYLON[] = "~20024642E002FFFD09\r";
+const unsigned char PaceBmsProtocolV20::exampleReadSystemAnalogInformationResponseV20_PYLON[] = "~2002460020E01002100CE50CE60CE40CE50CE70CE60CE50CE40CE60CE50CE80CE50CE40CE60CE50CE5050BA50BA60BA40BA30BAE009614A21194021388002A100CD80CDA0CD90CDB0CDA0CD80CD70CDA0CDB0CD90CDA0CD80CDA0CD90CDB0CDA050BA20BA30BA10BA10BA9FF88148F0BB80213880039CACF\r";
+const unsigned char PaceBmsProtocolV20::exampleReadSystemStatusInformationRequestV20_PYLON[] = "~20024644E002FFFD07\r";
+const unsigned char PaceBmsProtocolV20::exampleReadSystemStatusInformationResponseV20_PYLON[] = "~20024600808010021000000000000000000000000000000000050000000000000000000E0000001000000100000000000000000000000000050000000000000000010E000000E567\r";
+
+bool PaceBmsProtocolV20::CreateReadSystemAnalogInformationRequest_PYLON(const uint8_t busId, std::vector<uint8_t>& request)
+{
+	// the payload is 0xFF rather than the requested busId, which asks the master for every pack in the stack
+	const uint16_t payloadLen = 2;
+	std::vector<uint8_t> payload(payloadLen);
+	uint16_t payloadOffset = 0;
+	WriteHexEncodedByte(payload, payloadOffset, SYSTEM_COMMAND_PYLON);
+
+	CreateRequest(busId, CID2_ReadAnalogInformation, payload, request);
+
+	return true;
+}
+
+bool PaceBmsProtocolV20::ProcessReadSystemAnalogInformationResponse_PYLON(const uint8_t busId, const std::vector<uint8_t>& response, std::vector<AnalogInformation>& analogInformation, const uint32_t fields)
+{
+	int16_t payloadLen = ValidateResponseAndGetPayloadLength(busId, response);
+	if (payloadLen == -1)
+	{
+		// failed to validate, the call would have done it's own logging
+		return false;
+	}
+
+	// payload starts here, everything else was validated by the initial call to ValidateResponseAndGetPayloadLength
+	uint16_t byteOffset = 13;
+	const uint16_t payloadEnd = payloadLen + 13;
+
+	// the info flag, which the spec doesn't explain, same as the single pack response
+	ReadHexEncodedByte(response, byteOffset);
+
+	uint8_t pack_count = ReadHexEncodedByte(response, byteOffset);
+	if (pack_count > MAX_SYSTEM_PACK_COUNT_PYLON)
+	{
+		LogError("Response contains data from " + std::to_string(pack_count) + " packs, more than a PYLON stack supports");
+		return false;
+	}
+
+	analogInformation.resize(pack_count);
+	for (int i = 0; i < pack_count; i++)
+	{
+		if (byteOffset >= payloadEnd)
+		{
+			LogError("Response ended after " + std::to_string(i) + " of " + std::to_string(pack_count) + " packs");
+			return false;
+		}
+		DecodeAnalogInformationBlock_PYLON(response, byteOffset, analogInformation[i], fields);
+		if (byteOffset > payloadEnd)
+		{
+			LogError("Response ended part way through pack " + std::to_string(i + 1) + " of " + std::to_string(pack_count));
+			return false;
+		}
+	}
+
+	if (byteOffset != payloadEnd)
+		LogWarning("Length mismatch reading system analog information response: " + std::to_string(payloadEnd - byteOffset) + " bytes off");
+
+	return true;
+}
+
+bool PaceBmsProtocolV20::CreateReadSystemStatusInformationRequest_PYLON(const uint8_t busId, std::vector<uint8_t>& request)
+{
+	// the payload is 0xFF rather than the requested busId, which asks the master for every pack in the stack
+	const uint16_t payloadLen = 2;
+	std::vector<uint8_t> payload(payloadLen);
+	uint16_t payloadOffset = 0;
+	WriteHexEncodedByte(payload, payloadOffset, SYSTEM_COMMAND_PYLON);
+
+	CreateRequest(busId, CID2_ReadStatusInformation, payload, request);
+
+	return true;
+}
+
+bool PaceBmsProtocolV20::ProcessReadSystemStatusInformationResponse_PYLON(const uint8_t busId, const std::vector<uint8_t>& response, std::vector<StatusInformation>& statusInformation, const uint32_t fields)
+{
+	int16_t payloadLen = ValidateResponseAndGetPayloadLength(busId, response);
+	if (payloadLen == -1)
+		// failed to validate, the call would have done it's own logging
+		return false;
+
+	// payload starts here, everything else was validated by the initial call to ValidateResponseAndGetPayloadLength
+	uint16_t byteOffset = 13;
+	const uint16_t payloadEnd = payloadLen + 13;
+
+	// the data flag, which the spec doesn't explain, same as the single pack response
+	ReadHexEncodedByte(response, byteOffset);
+
+	uint8_t pack_count = ReadHexEncodedByte(response, byteOffset);
+	if (pack_count > MAX_SYSTEM_PACK_COUNT_PYLON)
+	{
+		LogError("Response contains data from " + std::to_string(pack_count) + " packs, more than a PYLON stack supports");
+		return false;
+	}
+
+	statusInformation.resize(pack_count);
+	for (int i = 0; i < pack_count; i++)
+	{
+		if (byteOffset >= payloadEnd)
+		{
+			LogError("Response ended after " + std::to_string(i) + " of " + std::to_string(pack_count) + " packs");
+			return false;
+		}
+		DecodeStatusInformationBlock_PYLON(response, byteOffset, statusInformation[i], fields);
+		if (byteOffset > payloadEnd)
+		{
+			LogError("Response ended part way through pack " + std::to_string(i + 1) + " of " + std::to_string(pack_count));
+			return false;
+		}
+
+		// same as ProcessReadStatusInformationResponse, throw away any text that was built as a side effect but not asked for
+		if ((fields & SIF_WarningText) == 0)
+			statusInformation[i].warningText.clear();
+		if ((fields & SIF_SystemText) == 0)
+			statusInformation[i].systemText.clear();
+		if ((fields & SIF_ConfigurationText) == 0)
+			statusInformation[i].configurationText.clear();
+		if ((fields & SIF_ProtectionText) == 0)
+			statusInformation[i].protectionText.clear();
+		if ((fields & SIF_FaultText) == 0)
+			statusInformation[i].faultText.clear();
+	}
+
+	if (byteOffset != payloadEnd)
+		LogWarning("Length mismatch reading system status information response: " + std::to_string(payloadEnd - byteOffset) + " bytes off");
+
+	return true;
+}
+#endif
+
+#ifdef PACE_BMS_V20_VARIANT_PYLON
+const unsigned char PaceBmsProtocolV20::exampleReadChargeDischargeManagementInformationRequestV20[] = "~20024692E00202FD2E\r";
+const unsigned char PaceBmsProtocolV20::exampleReadChargeDischargeManagementInformationResponseV20[] = "~20024600B01402D002B7980172FE8EC0F934\r";
+
+bool PaceBmsProtocolV20::CreateReadChargeDischargeManagementInformationRequest(const uint8_t busId, std::vector<uint8_t>& request)
+{
+	// the payload is the requested busId, same as analog information
+	const uint16_t payloadLen = 2;
+	std::vector<uint8_t> payload(payloadLen);
+	uint16_t payloadOffset = 0;
+	WriteHexEncodedByte(payload, payloadOffset, busId);
+
+	CreateRequest(busId, CID2_ReadChargeDischargeManagementInformation, payload, request);
+
+	return true;
+}
+
+bool PaceBmsProtocolV20::ProcessReadChargeDischargeManagementInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, ChargeDischargeManagementInformation& managementInformation)
+{
+	int16_t payloadLen = ValidateResponseAndGetPayloadLength(busId, response);
+	if (payloadLen == -1)
+		// failed to validate, the call would have done it's own logging
+		return false;
+
+	if (payloadLen != 20)
+	{
+		LogError("Charge/discharge management information response has an unexpected payload length: " + std::to_string(payloadLen));
+		return false;
+	}
+
+	// payload starts here, everything else was validated by the initial call to ValidateResponseAndGetPayloadLength
+	uint16_t byteOffset = 13;
+
+	uint8_t respondingBusId = ReadHexEncodedByte(response, byteOffset);
+	if (respondingBusId != busId)
+		LogWarning("Charge/discharge management information response is for bus id " + std::to_string(respondingBusId) + " rather than " + std::to_string(busId));
+
+	managementInformation.chargeVoltageLimitMillivolts = ReadHexEncodedUShort(response, byteOffset);
+	managementInformation.dischargeVoltageLimitMillivolts = ReadHexEncodedUShort(response, byteOffset);
+	managementInformation.chargeCurrentLimitMilliamps = ReadHexEncodedSShort(response, byteOffset) * 100;
+	managementInformation.dischargeCurrentLimitMilliamps = ReadHexEncodedSShort(response, byteOffset) * 100;
+	managementInformation.status_value = ReadHexEncodedByte(response, byteOffset);
+
+	managementInformation.chargeEnable = (managementInformation.status_value & CDSF_ChargeEnable) != 0;
+	managementInformation.dischargeEnable = (managementInformation.status_value & CDSF_DischargeEnable) != 0;
+	managementInformation.chargeImmediately = (managementInformation.status_value & (CDSF_ChargeImmediately1 | CDSF_ChargeImmediately2)) != 0;
+	managementInformation.fullChargeRequest = (managementInformation.status_value & CDSF_FullChargeRequest) != 0;
+
+	return true;
+}
+#endif
 
 const unsigned char PaceBmsProtocolV20::exampleReadHardwareVersionRequestV20[] = "~20014A510000FDA2\r";
 const unsigned char PaceBmsProtocolV20::exampleReadHardwareVersionResponseV20[] = "~20014A00F05C202020202020202020202020202020202020202000005154484E2020202020202020202020202020202030640306EBA8\r";
@@ -2083,3 +2331,5 @@ bool PaceBmsProtocolV20::ProcessWriteSystemDateTimeResponse(const uint8_t busId,
 
 	return true;
 }
+
+#endif // PACE_BMS_COMMANDSET_V20
@@ -51,6 +51,7 @@ protected:
 		CID2_ReadStatusInformation = 0x44,
 		CID2_ReadHardwareVersion = 0x51,
 		CID2_ReadSerialNumber = 0x93,
+		CID2_ReadChargeDischargeManagementInformation = 0x92, // PYLON only
 
 		CID2_WriteShutdownCommand = 0x95,
 
@@ -82,14 +83,15 @@ public:
 	static const uint8_t exampleReadAnalogInformationRequestV20[];
 	static const uint8_t exampleReadAnalogInformationResponseV20[];
 
-	static const uint8_t MAX_CELL_COUNT = 16;
-	static const uint8_t MAX_TEMP_COUNT = 6;
+	// set from yaml, see: PACE_BMS_MAX_CELL_COUNT
+	static const uint8_t MAX_CELL_COUNT = PACE_BMS_MAX_CELL_COUNT;
+	static const uint8_t MAX_TEMP_COUNT = PACE_BMS_MAX_TEMP_COUNT;
 	struct AnalogInformation
 	{
 		uint8_t  cellCount{ 0 };
-		uint16_t cellVoltagesMillivolts[MAX_CELL_COUNT]{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+		uint16_t cellVoltagesMillivolts[MAX_CELL_COUNT]{ };
 		uint8_t  temperatureCount{ 0 };
-		int16_t  temperaturesTenthsCelcius[MAX_TEMP_COUNT]{ 0, 0, 0, 0, 0, 0 }; // first 4 are Cell readings, then MOSFET then Environment
+		int16_t  temperaturesTenthsCelcius[MAX_TEMP_COUNT]{ }; // first 4 are Cell readings, then MOSFET then Environment
 		int32_t  currentMilliamps{ 0 };
 		uint16_t totalVoltageMillivolts{ 0 };
 		uint32_t remainingCapacityMilliampHours{ 0 };
@@ -107,13 +109,13 @@ public:
 	};
 
 	bool CreateReadAnalogInformationRequest(const uint8_t busId, std::vector<uint8_t>& request);
-	bool ProcessReadAnalogInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation);
+	bool ProcessReadAnalogInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation, const uint32_t fields = AIF_All);
 
 protected:
 	// protocol variants
-	bool ProcessReadAnalogInformationResponse_PYLON(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation);
-	bool ProcessReadAnalogInformationResponse_SEPLOS(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation);
-	bool ProcessReadAnalogInformationResponse_EG4(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation);
+	bool ProcessReadAnalogInformationResponse_PYLON(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation, const uint32_t fields);
+	bool ProcessReadAnalogInformationResponse_SEPLOS(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation, const uint32_t fields);
+	bool ProcessReadAnalogInformationResponse_EG4(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation, const uint32_t fields);
 
 public:
 	// ==== Read Status Information
@@ -449,8 +451,8 @@ public:
 	struct StatusInformation
 	{
 		std::string warningText;
-		uint8_t     warning_value_cell[MAX_CELL_COUNT]{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // DecodeWarningValue / enum StatusInformation_WarningValues
-		uint8_t     warning_value_temp[MAX_TEMP_COUNT]{ 0, 0, 0, 0, 0, 0 }; // DecodeWarningValue / enum StatusInformation_WarningValues
+		uint8_t     warning_value_cell[MAX_CELL_COUNT]{ }; // DecodeWarningValue / enum StatusInformation_WarningValues
+		uint8_t     warning_value_temp[MAX_TEMP_COUNT]{ }; // DecodeWarningValue / enum StatusInformation_WarningValues
 		uint8_t     warning_value_charge_current{ 0 };       // DecodeWarningValue / enum StatusInformation_WarningValues
 		uint8_t     warning_value_total_voltage{ 0 };        // DecodeWarningValue / enum StatusInformation_WarningValues
 		uint8_t     warning_value_discharge_current{ 0 };    // DecodeWarningValue / enum StatusInformation_WarningValues
@@ -502,13 +504,99 @@ public:
 	// helper for: ProcessStatusInformationResponse
 	const std::string DecodeWarningValue(const uint8_t val);
 
-	bool ProcessReadStatusInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation);
+	bool ProcessReadStatusInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation, const uint32_t fields = SIF_All);
 
 protected:
 	// protocol variants
-	bool ProcessReadStatusInformationResponse_PYLON(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation);
-	bool ProcessReadStatusInformationResponse_SEPLOS(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation);
-	bool ProcessReadStatusInformationResponse_EG4(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation);
+	bool ProcessReadStatusInformationResponse_PYLON(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation, const uint32_t fields);
+	bool ProcessReadStatusInformationResponse_SEPLOS(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation, const uint32_t fields);
+	bool ProcessReadStatusInformationResponse_EG4(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation, const uint32_t fields);
+
+public:
+	// ==== PYLON only: Read System Analog Information / Read System Status Information
+	// sent to the master pack of a stack (address 0x02 + 0x10 * group number) with 0xFF in place of the pack address, the master 
+	//     answers for every pack in the stack in a single frame, saving 2 * (pack count - 1) request/response cycles per update
+	// the response payload is the INFOFLAG / DATAFLAG and a pack count, followed by the same data as the single pack response 
+	//     repeated once per pack, in stack order (master first)
+	// note that at roughly 120 bytes per 16 cell pack, the response is far larger than any single pack response
+	// 0 info flag
+	// 1 Pack Count
+	// 2 the same per-pack data as ProcessReadAnalogInformationResponse_PYLON (repeated Pack Count times)
+	// req:   ~20024642E002FFFD09.
+	// resp:  ~2002460020E01002100CE50CE60CE40CE50CE70CE60CE50CE40CE60CE50CE80CE50CE40CE60CE50CE5050BA50BA60BA40BA30BAE009614A21194021388002A100CD80CDA0CD90CDB0CDA0CD80CD70CDA0CDB0CD90CDA0CD80CDA0CD90CDB0CDA050BA20BA30BA10BA10BA9FF88148F0BB80213880039CACF.
+	//                     00112222...
+	// 0 data flag
+	// 1 Pack Count
+	// 2 the same per-pack data as ProcessReadStatusInformationResponse_PYLON (repeated Pack Count times)
+	// req:   ~20024644E002FFFD07.
+	// resp:  ~20024600808010021000000000000000000000000000000000050000000000000000000E0000001000000100000000000000000000000000050000000000000000010E000000E567.
+	//                     00112222...
+	// there's no capture from a real stack, the example responses are built from the spec for a stack of two 16 cell packs, 
+	//     the second of which has a cell 3 warning and a protection (status1) bit set
+
+	static const uint8_t exampleReadSystemAnalogInformationRequestV20_PYLON[];
+	static const uint8_t exampleReadSystemAnalogInformationResponseV20_PYLON[];
+	static const uint8_t exampleReadSystemStatusInformationRequestV20_PYLON[];
+	static const uint8_t exampleReadSystemStatusInformationResponseV20_PYLON[];
+
+	static const uint8_t MAX_SYSTEM_PACK_COUNT_PYLON = 16;
+
+	bool CreateReadSystemAnalogInformationRequest_PYLON(const uint8_t busId, std::vector<uint8_t>& request);
+	bool ProcessReadSystemAnalogInformationResponse_PYLON(const uint8_t busId, const std::vector<uint8_t>& response, std::vector<AnalogInformation>& analogInformation, const uint32_t fields = AIF_All);
+	bool CreateReadSystemStatusInformationRequest_PYLON(const uint8_t busId, std::vector<uint8_t>& request);
+	bool ProcessReadSystemStatusInformationResponse_PYLON(const uint8_t busId, const std::vector<uint8_t>& response, std::vector<StatusInformation>& statusInformation, const uint32_t fields = SIF_All);
+
+protected:
+	// the payload "address" that asks the master for the whole stack
+	static const uint8_t SYSTEM_COMMAND_PYLON = 0xFF;
+
+	// helpers shared by the single pack and system-wide PYLON responses
+	void DecodeAnalogInformationBlock_PYLON(const std::vector<uint8_t>& response, uint16_t& byteOffset, AnalogInformation& analogInformation, const uint32_t fields);
+	void DecodeStatusInformationBlock_PYLON(const std::vector<uint8_t>& response, uint16_t& byteOffset, StatusInformation& statusInformation, const uint32_t fields);
+
+public:
+	// ==== PYLON only: Read Charge / Discharge Management Information
+	// the limits and flags the BMS recommends an inverter follow, small enough to be polled far more often than everything else
+	// 0 Responding Bus Id
+	// 1 Charge Voltage Limit - stored as v * 1000, so 53.25 is 53250
+	// 2 Discharge Voltage Limit - stored as v * 1000
+	// 3 Charge Current Limit - stored as value * 10
+	// 4 Discharge Current Limit - stored as value * 10
+	// 5 Charge / Discharge Status see: enum ChargeDischargeStatusFlags
+	// req:   ~20024692E00202FD2E.
+	// resp:  ~20024600B01402D002B7980172FE8EC0F934.
+	//                     0011112222333344445
+
+	static const uint8_t exampleReadChargeDischargeManagementInformationRequestV20[];
+	static const uint8_t exampleReadChargeDischargeManagementInformationResponseV20[];
+
+	enum ChargeDischargeStatusFlags
+	{
+		CDSF_ChargeEnable = (1 << 7),         // 0 means the BMS is requesting that charging stop
+		CDSF_DischargeEnable = (1 << 6),      // 0 means the BMS is requesting that discharging stop
+		CDSF_ChargeImmediately1 = (1 << 5),   // SoC is low enough that the BMS would like to be charged immediately, threshold depends on model
+		CDSF_ChargeImmediately2 = (1 << 4),   // same, at a different threshold
+		CDSF_FullChargeRequest = (1 << 3),    // SoC hasn't reached 97% in 30 days, the BMS would like a full charge to recalibrate
+		CDSF_UndefinedBit3 = (1 << 2),
+		CDSF_UndefinedBit2 = (1 << 1),
+		CDSF_UndefinedBit1 = (1 << 0),
+	};
+	struct ChargeDischargeManagementInformation
+	{
+		uint16_t chargeVoltageLimitMillivolts{ 0 };
+		uint16_t dischargeVoltageLimitMillivolts{ 0 };
+		int32_t  chargeCurrentLimitMilliamps{ 0 };
+		int32_t  dischargeCurrentLimitMilliamps{ 0 };
+		uint8_t  status_value{ 0 };                   // see: enum ChargeDischargeStatusFlags
+
+		bool     chargeEnable{ false };
+		bool     dischargeEnable{ false };
+		bool     chargeImmediately{ false };          // either of the "charge immediately" flags
+		bool     fullChargeRequest{ false };
+	};
+
+	bool CreateReadChargeDischargeManagementInformationRequest(const uint8_t busId, std::vector<uint8_t>& request);
+	bool ProcessReadChargeDischargeManagementInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, ChargeDischargeManagementInformation& managementInformation);
 
 public:
 	// ==== Read Hardware Version
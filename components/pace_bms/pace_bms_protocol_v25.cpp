@@ -1,6 +1,8 @@
 
 #include "pace_bms_protocol_v25.h"
 
+#ifdef PACE_BMS_COMMANDSET_V25
+
 // takes pointers to the "real" logging functions
 PaceBmsProtocolV25::PaceBmsProtocolV25(
 		OPTIONAL_NS::optional<std::string> protocol_variant, OPTIONAL_NS::optional<uint8_t> protocol_version_override, OPTIONAL_NS::optional<uint8_t> batteryChemistry,
@@ -36,7 +38,7 @@ bool PaceBmsProtocolV25::CreateReadAnalogInformationRequest(const uint8_t busId,
 
 	return true;
 }
-bool PaceBmsProtocolV25::ProcessReadAnalogInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation)
+bool PaceBmsProtocolV25::ProcessReadAnalogInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation, const uint32_t fields)
 {
 	//std::memset(&analogInformation, 0, sizeof(AnalogInformation));
 
@@ -73,7 +75,7 @@ bool PaceBmsProtocolV25::ProcessReadAnalogInformationResponse(const uint8_t busI
 	{
 		uint16_t cellVoltage = ReadHexEncodedUShort(response, byteOffset);
 
-		if (i > MAX_CELL_COUNT - 1)
+		if (i > MAX_CELL_COUNT - 1 || (fields & (AIF_CellVoltages | AIF_CellMinMax | AIF_CellAverage)) == 0)
 			continue;
 
 		analogInformation.cellVoltagesMillivolts[i] = cellVoltage;
@@ -88,7 +90,7 @@ bool PaceBmsProtocolV25::ProcessReadAnalogInformationResponse(const uint8_t busI
 	{
 		uint16_t temperature = ReadHexEncodedUShort(response, byteOffset);
 
-		if (i > MAX_TEMP_COUNT - 1)
+		if (i > MAX_TEMP_COUNT - 1 || (fields & AIF_Temperatures) == 0)
 			continue;
 
 		analogInformation.temperaturesTenthsCelcius[i] = (temperature - 2730);
@@ -119,28 +121,29 @@ bool PaceBmsProtocolV25::ProcessReadAnalogInformationResponse(const uint8_t busI
 		// return false;
 	}
 
-	// calculate some "extras"
-	analogInformation.SoC = ((float)analogInformation.remainingCapacityMilliampHours / (float)analogInformation.fullCapacityMilliampHours) * 100.0f;
-	analogInformation.SoH = ((float)analogInformation.fullCapacityMilliampHours / (float)analogInformation.designCapacityMilliampHours) * 100.0f;
-	if (analogInformation.SoH > 100)
+	// calculate some "extras", but only the ones somebody is going to look at
+	if ((fields & AIF_StateOfCharge) != 0)
 	{
-		// many packs have a little bit "extra" capacity to make sure they hit their nameplate value
-		analogInformation.SoH = 100;
+		analogInformation.SoC = ((float)analogInformation.remainingCapacityMilliampHours / (float)analogInformation.fullCapacityMilliampHours) * 100.0f;
 	}
-	analogInformation.powerWatts = ((float)analogInformation.totalVoltageMillivolts * (float)analogInformation.currentMilliamps) / 1000000.0f;
-	analogInformation.minCellVoltageMillivolts = 65535;
-	analogInformation.maxCellVoltageMillivolts = 0;
-	analogInformation.avgCellVoltageMillivolts = 0;
-	for (int i = 0; i < analogInformation.cellCount; i++)
+	if ((fields & AIF_StateOfHealth) != 0)
+	{
+		analogInformation.SoH = ((float)analogInformation.fullCapacityMilliampHours / (float)analogInformation.designCapacityMilliampHours) * 100.0f;
+		if (analogInformation.SoH > 100)
+		{
+			// many packs have a little bit "extra" capacity to make sure they hit their nameplate value
+			analogInformation.SoH = 100;
+		}
+	}
+	if ((fields & AIF_Power) != 0)
+	{
+		analogInformation.powerWatts = ((float)analogInformation.totalVoltageMillivolts * (float)analogInformation.currentMilliamps) / 1000000.0f;
+	}
+	if ((fields & (AIF_CellMinMax | AIF_CellAverage)) != 0)
 	{
-		if (analogInformation.cellVoltagesMillivolts[i] > analogInformation.maxCellVoltageMillivolts)
-			analogInformation.maxCellVoltageMillivolts = analogInformation.cellVoltagesMillivolts[i];
-		if (analogInformation.cellVoltagesMillivolts[i] < analogInformation.minCellVoltageMillivolts)
-			analogInformation.minCellVoltageMillivolts = analogInformation.cellVoltagesMillivolts[i];
-		analogInformation.avgCellVoltageMillivolts += analogInformation.cellVoltagesMillivolts[i];
+		CalculateCellStatistics(analogInformation.cellVoltagesMillivolts, (analogInformation.cellCount > MAX_CELL_COUNT ? MAX_CELL_COUNT : analogInformation.cellCount), fields,
+			analogInformation.minCellVoltageMillivolts, analogInformation.maxCellVoltageMillivolts, analogInformation.avgCellVoltageMillivolts, analogInformation.maxCellDifferentialMillivolts);
 	}
-	analogInformation.avgCellVoltageMillivolts /= analogInformation.cellCount;
-	analogInformation.maxCellDifferentialMillivolts = analogInformation.maxCellVoltageMillivolts - analogInformation.minCellVoltageMillivolts;
 
 	return true;
 }
@@ -472,7 +475,7 @@ const std::string PaceBmsProtocolV25::DecodeWarningStatus2Value(const uint8_t va
 	return str;
 }
 
-bool PaceBmsProtocolV25::ProcessReadStatusInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation)
+bool PaceBmsProtocolV25::ProcessReadStatusInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation, const uint32_t fields)
 {
 	//std::memset(&statusInformation, 0, sizeof(StatusInformation));
 
@@ -516,12 +519,12 @@ bool PaceBmsProtocolV25::ProcessReadStatusInformationResponse(const uint8_t busI
 	for (int i = 0; i < cellCount; i++)
 	{
 		uint8_t cw = ReadHexEncodedByte(response, byteOffset);
-		statusInformation.warning_value_cell[i] = cw;
-
 		if (i > MAX_CELL_COUNT - 1)
 			continue;
 
-		if (cw == 0)
+		statusInformation.warning_value_cell[i] = cw;
+
+		if (cw == 0 || (fields & SIF_WarningText) == 0)
 			continue;
 
 		// below/above limit
@@ -536,12 +539,12 @@ bool PaceBmsProtocolV25::ProcessReadStatusInformationResponse(const uint8_t busI
 	for (int i = 0; i < tempCount; i++)
 	{
 		uint8_t tw = ReadHexEncodedByte(response, byteOffset);
-		statusInformation.warning_value_temp[i] = tw;
-
 		if (i > MAX_TEMP_COUNT - 1)
 			continue;
 
-		if (tw == 0)
+		statusInformation.warning_value_temp[i] = tw;
+
+		if (tw == 0 || (fields & SIF_WarningText) == 0)
 			continue;
 
 		// below/above limit
@@ -550,7 +553,7 @@ bool PaceBmsProtocolV25::ProcessReadStatusInformationResponse(const uint8_t busI
 
 	uint8_t chargeCurrentWarn = ReadHexEncodedByte(response, byteOffset);
 	statusInformation.warning_value_charge_current = chargeCurrentWarn;
-	if (chargeCurrentWarn != 0)
+	if (chargeCurrentWarn != 0 && (fields & SIF_WarningText) != 0)
 	{
 		// below/above limit
 		statusInformation.warningText.append(std::string("Charge current: ") + DecodeWarningValue(chargeCurrentWarn) + std::string("; "));
@@ -558,7 +561,7 @@ bool PaceBmsProtocolV25::ProcessReadStatusInformationResponse(const uint8_t busI
 
 	uint8_t totalVoltageWarn = ReadHexEncodedByte(response, byteOffset);
 	statusInformation.warning_value_total_voltage = totalVoltageWarn;
-	if (totalVoltageWarn != 0)
+	if (totalVoltageWarn != 0 && (fields & SIF_WarningText) != 0)
 	{
 		// below/above limit
 		statusInformation.warningText.append(std::string("Total voltage: ") + DecodeWarningValue(totalVoltageWarn) + std::string("; "));
@@ -566,7 +569,7 @@ bool PaceBmsProtocolV25::ProcessReadStatusInformationResponse(const uint8_t busI
 
 	uint8_t dischargeCurrentWarn = ReadHexEncodedByte(response, byteOffset);
 	statusInformation.warning_value_discharge_current = dischargeCurrentWarn;
-	if (dischargeCurrentWarn != 0)
+	if (dischargeCurrentWarn != 0 && (fields & SIF_WarningText) != 0)
 	{
 		// below/above limit
 		statusInformation.warningText.append(std::string("Discharge current: ") + DecodeWarningValue(dischargeCurrentWarn) + std::string("; "));
@@ -575,14 +578,14 @@ bool PaceBmsProtocolV25::ProcessReadStatusInformationResponse(const uint8_t busI
 	// ========================== Protection Status ==========================
 	uint8_t protectState1 = ReadHexEncodedByte(response, byteOffset);
 	statusInformation.protection_value1 = protectState1;
-	if (protectState1 != 0)
+	if (protectState1 != 0 && (fields & SIF_ProtectionText) != 0)
 	{
 		statusInformation.protectionText.append(DecodeProtectionStatus1Value(protectState1));
 	}
 
 	uint8_t protectState2 = ReadHexEncodedByte(response, byteOffset);
 	statusInformation.protection_value2 = protectState2;
-	if (protectState2 != 0)
+	if (protectState2 != 0 && (fields & SIF_ProtectionText) != 0)
 	{
 		statusInformation.protectionText.append(DecodeProtectionStatus2Value(protectState2));
 	}
@@ -590,7 +593,7 @@ bool PaceBmsProtocolV25::ProcessReadStatusInformationResponse(const uint8_t busI
 	// ========================== System Status ==========================
 	uint8_t systemState = ReadHexEncodedByte(response, byteOffset);
 	statusInformation.system_value = systemState;
-	if (systemState != 0)
+	if (systemState != 0 && (fields & SIF_SystemText) != 0)
 	{
 		statusInformation.systemText.append(DecodeStatusValue(systemState));
 	}
@@ -598,7 +601,7 @@ bool PaceBmsProtocolV25::ProcessReadStatusInformationResponse(const uint8_t busI
 	// ========================== Configuration Status ==========================
 	uint8_t controlState = ReadHexEncodedByte(response, byteOffset);
 	statusInformation.configuration_value = controlState;
-	if (controlState != 0)
+	if (controlState != 0 && (fields & SIF_ConfigurationText) != 0)
 	{
 		statusInformation.configurationText.append(DecodeConfigurationStatusValue(controlState));
 	}
@@ -606,7 +609,7 @@ bool PaceBmsProtocolV25::ProcessReadStatusInformationResponse(const uint8_t busI
 	// ========================== Fault Status ==========================
 	uint8_t faultState = ReadHexEncodedByte(response, byteOffset);
 	statusInformation.fault_value = faultState;
-	if (faultState != 0)
+	if (faultState != 0 && (fields & SIF_FaultText) != 0)
 	{
 		statusInformation.faultText.append(DecodeFaultStatusValue(faultState));
 	}
@@ -614,7 +617,7 @@ bool PaceBmsProtocolV25::ProcessReadStatusInformationResponse(const uint8_t busI
 	// ========================== Balancing Status ==========================
 	uint16_t balanceState = ReadHexEncodedUShort(response, byteOffset);
 	statusInformation.balancing_value = balanceState;
-	for (int i = 0; i < 16; i++)
+	for (int i = 0; i < 16 && (fields & SIF_BalancingText) != 0; i++)
 	{
 		if ((balanceState & (1 << i)) != 0)
 		{
@@ -627,14 +630,14 @@ bool PaceBmsProtocolV25::ProcessReadStatusInformationResponse(const uint8_t busI
 	//       but I'll leave it for completeness or in case the bit shows up in one place but not the other in practice.
 	uint8_t warnState1 = ReadHexEncodedByte(response, byteOffset);
 	statusInformation.warning_value1 = warnState1;
-	if (warnState1 != 0)
+	if (warnState1 != 0 && (fields & SIF_WarningText) != 0)
 	{
 		statusInformation.warningText.append(DecodeWarningStatus1Value(warnState1));
 	}
 
 	uint8_t warnState2 = ReadHexEncodedByte(response, byteOffset);
-	statusInformation.warning_value2 = warnState1;
-	if (warnState2 != 0)
+	statusInformation.warning_value2 = warnState2;
+	if (warnState2 != 0 && (fields & SIF_WarningText) != 0)
 	{
 		statusInformation.warningText.append(DecodeWarningStatus2Value(warnState2));
 	}
@@ -773,10 +776,10 @@ bool PaceBmsProtocolV25::ProcessReadSerialNumberResponse(const uint8_t busId, co
 // 
 // ============================================================================
 
-const unsigned char PaceBmsProtocolV25::exampleWriteDisableBuzzerSwitchCommandRequestV25[] = "~25004699E0020DFD12\r";
-const unsigned char PaceBmsProtocolV25::exampleWriteDisableBuzzerSwitchCommandResponseV25[] = "~25004600C0040D01FCC3\r";
-const unsigned char PaceBmsProtocolV25::exampleWriteEnableBuzzerSwitchCommandRequestV25[] = "~25004699E0020CFD13\r";
-const unsigned char PaceBmsProtocolV25::exampleWriteEnableBuzzerSwitchCommandResponseV25[] = "~25004600C0040C00FCC5\r";
+const unsigned char PaceBmsProtocolV25::exampleWriteDisableBuzzerSwitchCommandRequestV25[] = "~25004699E0020CFD13\r";
+const unsigned char PaceBmsProtocolV25::exampleWriteDisableBuzzerSwitchCommandResponseV25[] = "~25004600C0040C00FCC5\r";
+const unsigned char PaceBmsProtocolV25::exampleWriteEnableBuzzerSwitchCommandRequestV25[] = "~25004699E0020DFD12\r";
+const unsigned char PaceBmsProtocolV25::exampleWriteEnableBuzzerSwitchCommandResponseV25[] = "~25004600C0040D01FCC3\r";
 
 const unsigned char PaceBmsProtocolV25::exampleWriteDisableLedWarningSwitchCommandRequestV25[] = "~25004699E00206FD20\r";
 const unsigned char PaceBmsProtocolV25::exampleWriteDisableLedWarningSwitchCommandResponseV25[] = "~25004600C0040602FCD0\r";
@@ -840,13 +843,13 @@ bool PaceBmsProtocolV25::ProcessWriteSwitchCommandResponse(const uint8_t busId,
 	switch (command)
 	{
 	case SC_DisableBuzzer:
-		if (unknown != 0x01)
+		if (unknown != 0x00)
 		{
 			LogWarning("Undocumented payload byte does not match reverse engineering observation");
 		}
 		break;
 	case SC_EnableBuzzer:
-		if (unknown != 0x00)
+		if (unknown != 0x01)
 		{
 			LogWarning("Undocumented payload byte does not match reverse engineering observation");
 		}
@@ -892,15 +895,15 @@ bool PaceBmsProtocolV25::ProcessWriteSwitchCommandResponse(const uint8_t busId,
 	return true;
 }
 
-const unsigned char PaceBmsProtocolV25::exampleWriteMosfetChargeOpenSwitchCommandRequestV25[] = "~2500469AE00200FD1E\r";
-const unsigned char PaceBmsProtocolV25::exampleWriteMosfetChargeOpenSwitchCommandResponseV25[] = "~25004600E00226FD30\r";
-const unsigned char PaceBmsProtocolV25::exampleWriteMosfetChargeCloseSwitchCommandRequestV25[] = "~2500469AE00201FD1D\r";
-const unsigned char PaceBmsProtocolV25::exampleWriteMosfetChargeCloseSwitchCommandResponseV25[] = "~25004600E00224FD32\r";
+const unsigned char PaceBmsProtocolV25::exampleWriteMosfetChargeOpenSwitchCommandRequestV25[] = "~2500469AE00201FD1D\r";
+const unsigned char PaceBmsProtocolV25::exampleWriteMosfetChargeOpenSwitchCommandResponseV25[] = "~25004600E00224FD32\r";
+const unsigned char PaceBmsProtocolV25::exampleWriteMosfetChargeCloseSwitchCommandRequestV25[] = "~2500469AE00200FD1E\r";
+const unsigned char PaceBmsProtocolV25::exampleWriteMosfetChargeCloseSwitchCommandResponseV25[] = "~25004600E00226FD30\r";
 
-const unsigned char PaceBmsProtocolV25::exampleWriteMosfetDischargeOpenSwitchCommandRequestV25[] = "~2500469BE00200FD1D\r";
-const unsigned char PaceBmsProtocolV25::exampleWriteMosfetDischargeOpenSwitchCommandResponseV25[] = "~25004600E00204FD34\r";
-const unsigned char PaceBmsProtocolV25::exampleWriteMosfetDischargeCloseSwitchCommandRequestV25[] = "~2500469BE00201FD1C\r";
-const unsigned char PaceBmsProtocolV25::exampleWriteMosfetDischargeCloseSwitchCommandResponseV25[] = "~25004609E00204FD2B\r";
+const unsigned char PaceBmsProtocolV25::exampleWriteMosfetDischargeOpenSwitchCommandRequestV25[] = "~2500469BE00201FD1C\r";
+const unsigned char PaceBmsProtocolV25::exampleWriteMosfetDischargeOpenSwitchCommandResponseV25[] = "~25004609E00204FD2B\r";
+const unsigned char PaceBmsProtocolV25::exampleWriteMosfetDischargeCloseSwitchCommandRequestV25[] = "~2500469BE00200FD1D\r";
+const unsigned char PaceBmsProtocolV25::exampleWriteMosfetDischargeCloseSwitchCommandResponseV25[] = "~25004600E00204FD34\r";
 
 bool PaceBmsProtocolV25::CreateWriteMosfetSwitchCommandRequest(const uint8_t busId, const MosfetType type, const MosfetState command, std::vector<uint8_t>& request)
 {
@@ -939,14 +942,14 @@ bool PaceBmsProtocolV25::ProcessWriteMosfetSwitchCommandResponse(const uint8_t b
 	uint8_t unknown = ReadHexEncodedByte(response, byteOffset);
 	if (type == MT_Charge && command == MS_Open)
 	{
-		if (unknown != 0x26)
+		if (unknown != 0x24)
 		{
 			LogWarning("Undocumented payload byte does not match reverse engineering observation");
 		}
 	}
 	if (type == MT_Charge && command == MS_Close)
 	{
-		if (unknown != 0x24)
+		if (unknown != 0x26)
 		{
 			LogWarning("Undocumented payload byte does not match reverse engineering observation");
 		}
@@ -1014,6 +1017,131 @@ bool PaceBmsProtocolV25::ProcessWriteShutdownCommandResponse(const uint8_t busId
 // 
 // ============================================================================
 
+const unsigned char PaceBmsProtocolV25::exampleReadHistoryRecordRequestV25[] = "~250046A1C004018FFCA7\r";
+const unsigned char PaceBmsProtocolV25::exampleReadHistoryRecordResponseV25[] = "~25004600709018021D020038100D970D990D9A0D990D990D970D990D980D990D980D800D980D980D990D980D98060B740B750B770B760B710B79FF6ED9D7286A286A0000000000060043FFFFFFFFDDE3\r";
+const unsigned char PaceBmsProtocolV25::exampleReadHistoryRecordEndResponseV25[] = "~250046000000FDAF\r";
+
+bool PaceBmsProtocolV25::CreateReadHistoryRecordRequest(const uint8_t busId, const uint16_t recordIndex, std::vector<uint8_t>& request)
+{
+	const uint16_t payloadLen = 4;
+	std::vector<uint8_t> payload(payloadLen);
+	uint16_t payloadOffset = 0;
+	WriteHexEncodedUShort(payload, payloadOffset, recordIndex);
+
+	CreateRequest(busId, CID2_ReadHistoryRecord, payload, request);
+
+	return true;
+}
+bool PaceBmsProtocolV25::ProcessReadHistoryRecordResponse(const uint8_t busId, const std::vector<uint8_t>& response, HistoryRecord& record, bool& endOfHistory)
+{
+	endOfHistory = false;
+
+	// some firmwares signal the end of the history with a return code rather than an empty payload, so the return code is
+	//     taken back here rather than being logged as an error, but only once the rest of the frame has validated
+	uint8_t returnCode = 0;
+	int16_t payloadLen = ValidateResponseAndGetPayloadLength(busId, response, &returnCode);
+	if (payloadLen == -1)
+	{
+		if (this->last_validation_result == RVR_ReturnCodeError)
+		{
+			if (returnCode == 0x07) // "No Data (historical record)"
+			{
+				this->last_validation_result = RVR_Ok;
+				endOfHistory = true;
+				return true;
+			}
+			LogError(std::string("Error code returned by device: ") + FormatReturnCode(returnCode));
+		}
+		// otherwise failed to validate, the call would have done it's own logging
+		return false;
+	}
+
+	if (payloadLen == 0)
+	{
+		endOfHistory = true;
+		return true;
+	}
+
+	// payload starts here, everything else was validated by the initial call to ValidateResponseAndGetPayloadLength
+	uint16_t byteOffset = 13;
+
+	// make sure there's enough payload for the counts before trusting them
+	if (payloadLen < 14)
+	{
+		LogError("History record response is too short to contain a record");
+		return false;
+	}
+
+	record.dateTime.Year = ReadHexEncodedByte(response, byteOffset) + 2000;
+	record.dateTime.Month = ReadHexEncodedByte(response, byteOffset);
+	record.dateTime.Day = ReadHexEncodedByte(response, byteOffset);
+	record.dateTime.Hour = ReadHexEncodedByte(response, byteOffset);
+	record.dateTime.Minute = ReadHexEncodedByte(response, byteOffset);
+	record.dateTime.Second = ReadHexEncodedByte(response, byteOffset);
+
+	record.cellCount = ReadHexEncodedByte(response, byteOffset);
+	if (record.cellCount > MAX_CELL_COUNT)
+	{
+		LogWarning("Response contains more cell voltage readings than are supported, results will be truncated");
+	}
+	// cell voltages + temperature count + current, voltage, and two capacities
+	if (payloadLen < 14 + record.cellCount * 4 + 2 + 16)
+	{
+		LogError("History record response is too short for its cell count");
+		return false;
+	}
+	record.minCellVoltageMillivolts = 0;
+	record.maxCellVoltageMillivolts = 0;
+	for (int i = 0; i < record.cellCount; i++)
+	{
+		uint16_t cellVoltage = ReadHexEncodedUShort(response, byteOffset);
+
+		if (i == 0 || cellVoltage < record.minCellVoltageMillivolts)
+			record.minCellVoltageMillivolts = cellVoltage;
+		if (i == 0 || cellVoltage > record.maxCellVoltageMillivolts)
+			record.maxCellVoltageMillivolts = cellVoltage;
+
+		if (i > MAX_CELL_COUNT - 1)
+			continue;
+
+		record.cellVoltagesMillivolts[i] = cellVoltage;
+	}
+
+	record.temperatureCount = ReadHexEncodedByte(response, byteOffset);
+	if (record.temperatureCount > MAX_TEMP_COUNT)
+	{
+		LogWarning("Response contains more temperature readings than are supported, results will be truncated");
+	}
+	if (payloadLen < 14 + record.cellCount * 4 + 2 + record.temperatureCount * 4 + 16)
+	{
+		LogError("History record response is too short for its temperature count");
+		return false;
+	}
+	for (int i = 0; i < record.temperatureCount; i++)
+	{
+		uint16_t temperature = ReadHexEncodedUShort(response, byteOffset);
+
+		if (i > MAX_TEMP_COUNT - 1)
+			continue;
+
+		record.temperaturesTenthsCelcius[i] = (temperature - 2730);
+	}
+
+	record.currentMilliamps = ReadHexEncodedSShort(response, byteOffset) * 10;
+	record.totalVoltageMillivolts = ReadHexEncodedUShort(response, byteOffset);
+	record.remainingCapacityMilliampHours = ReadHexEncodedUShort(response, byteOffset) * 10;
+	record.fullCapacityMilliampHours = ReadHexEncodedUShort(response, byteOffset) * 10;
+
+	// whatever is left is the alarm / protect / fault type
+	record.statusBytes.clear();
+	while (byteOffset + 1 < payloadLen + 13)
+	{
+		record.statusBytes.push_back(ReadHexEncodedByte(response, byteOffset));
+	}
+
+	return true;
+}
+
 const unsigned char PaceBmsProtocolV25::exampleReadSystemTimeRequestV25[] = "~250046B10000FD9C\r";
 const unsigned char PaceBmsProtocolV25::exampleReadSystemTimeResponseV25[] = "~25004600400C180815051D1FFB10\r";
 const unsigned char PaceBmsProtocolV25::exampleWriteSystemTimeRequestV25[] = "~250046B2400C1808140E0F25FAFC\r";
@@ -2379,3 +2507,5 @@ bool PaceBmsProtocolV25::ProcessWriteProtocolsResponse(const uint8_t busId, cons
 
 	return true;
 }
+
+#endif // PACE_BMS_COMMANDSET_V25
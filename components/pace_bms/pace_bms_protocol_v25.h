@@ -18,6 +18,8 @@ public:
 	PaceBmsProtocolV25(
 		OPTIONAL_NS::optional<std::string> protocol_variant, OPTIONAL_NS::optional<uint8_t> protocol_version_override, OPTIONAL_NS::optional<uint8_t> batteryChemistry,
 		LogFuncPtr logError, LogFuncPtr logWarning, LogFuncPtr logInfo, LogFuncPtr logDebug, LogFuncPtr logVerbose, LogFuncPtr logVeryVerbose);
+	// the request / response methods are virtual so that PaceBmsProtocolModbus can carry the same data over a different transport
+	virtual ~PaceBmsProtocolV25() = default;
 
 protected:
 	enum CID2 : uint8_t
@@ -37,6 +39,7 @@ protected:
 		CID2_WriteShutdownCommand                                 = 0x9C,
 
 		// "Memory Information" tab of PBmsTools 2.4
+		CID2_ReadHistoryRecord                                    = 0xA1,
 		CID2_ReadDateTime                                         = 0xB1,
 		CID2_WriteDateTime                                        = 0xB2,
 
@@ -114,14 +117,15 @@ public:
 	static const uint8_t exampleReadAnalogInformationRequestV25[];
 	static const uint8_t exampleReadAnalogInformationResponseV25[];
 
-	static const uint8_t MAX_CELL_COUNT = 16;
-	static const uint8_t MAX_TEMP_COUNT = 6;
+	// set from yaml, see: PACE_BMS_MAX_CELL_COUNT
+	static const uint8_t MAX_CELL_COUNT = PACE_BMS_MAX_CELL_COUNT;
+	static const uint8_t MAX_TEMP_COUNT = PACE_BMS_MAX_TEMP_COUNT;
 	struct AnalogInformation
 	{
 		uint8_t  cellCount{ 0 };
-		uint16_t cellVoltagesMillivolts[MAX_CELL_COUNT]{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+		uint16_t cellVoltagesMillivolts[MAX_CELL_COUNT]{ };
 		uint8_t  temperatureCount{ 0 };
-		int16_t  temperaturesTenthsCelcius[MAX_TEMP_COUNT]{ 0, 0, 0, 0, 0, 0 }; // first 4 are Cell readings, then MOSFET then Environment
+		int16_t  temperaturesTenthsCelcius[MAX_TEMP_COUNT]{ }; // first 4 are Cell readings, then MOSFET then Environment
 		int32_t  currentMilliamps{ 0 };
 		uint16_t totalVoltageMillivolts{ 0 };
 		uint32_t remainingCapacityMilliampHours{ 0 };
@@ -138,8 +142,8 @@ public:
 		uint16_t maxCellDifferentialMillivolts{ 0 };
 	};
 
-	bool CreateReadAnalogInformationRequest(const uint8_t busId, std::vector<uint8_t>& request);
-	bool ProcessReadAnalogInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation);
+	virtual bool CreateReadAnalogInformationRequest(const uint8_t busId, std::vector<uint8_t>& request);
+	virtual bool ProcessReadAnalogInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, AnalogInformation& analogInformation, const uint32_t fields = AIF_All);
 
 	// ==== Read Status Information
 	// 0 Responding Bus Id
@@ -282,8 +286,8 @@ public:
 	struct StatusInformation
 	{
 		std::string warningText{ "" };
-		uint8_t     warning_value_cell[MAX_CELL_COUNT]{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; // DecodeWarningValue / enum StatusInformation_WarningValues
-		uint8_t     warning_value_temp[MAX_TEMP_COUNT]{ 0, 0, 0, 0, 0, 0 }; // DecodeWarningValue / enum StatusInformation_WarningValues
+		uint8_t     warning_value_cell[MAX_CELL_COUNT]{ }; // DecodeWarningValue / enum StatusInformation_WarningValues
+		uint8_t     warning_value_temp[MAX_TEMP_COUNT]{ }; // DecodeWarningValue / enum StatusInformation_WarningValues
 		uint8_t     warning_value_charge_current{ 0 };       // DecodeWarningValue / enum StatusInformation_WarningValues
 		uint8_t     warning_value_total_voltage{ 0 };        // DecodeWarningValue / enum StatusInformation_WarningValues
 		uint8_t     warning_value_discharge_current{ 0 };    // DecodeWarningValue / enum StatusInformation_WarningValues
@@ -302,7 +306,7 @@ public:
 		uint8_t     fault_value{ 0 };                        // DecodeFaultStatusValue / enum StatusInformation_FaultFlags
 	};
 
-	bool CreateReadStatusInformationRequest(const uint8_t busId, std::vector<uint8_t>& request);
+	virtual bool CreateReadStatusInformationRequest(const uint8_t busId, std::vector<uint8_t>& request);
 
 protected:
 	// helper for: ProcessStatusInformationResponse
@@ -330,7 +334,7 @@ protected:
 	const std::string DecodeWarningStatus2Value(const uint8_t val);
 
 public:
-	bool ProcessReadStatusInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation);
+	virtual bool ProcessReadStatusInformationResponse(const uint8_t busId, const std::vector<uint8_t>& response, StatusInformation& statusInformation, const uint32_t fields = SIF_All);
 
 	// ==== Read Hardware Version
 	// 1 Hardware Version string (may be ' ' padded at the end), the length header value will tell you how long it is, should be 20 'actual character' bytes (40 ASCII hex chars)
@@ -341,8 +345,8 @@ public:
 	static const uint8_t exampleReadHardwareVersionRequestV25[];
 	static const uint8_t exampleReadHardwareVersionResponseV25[];
 
-	bool CreateReadHardwareVersionRequest(const uint8_t busId, std::vector<uint8_t>& request);
-	bool ProcessReadHardwareVersionResponse(const uint8_t busId, const std::vector<uint8_t>& response, std::string& hardwareVersion);
+	virtual bool CreateReadHardwareVersionRequest(const uint8_t busId, std::vector<uint8_t>& request);
+	virtual bool ProcessReadHardwareVersionResponse(const uint8_t busId, const std::vector<uint8_t>& response, std::string& hardwareVersion);
 
 	// ==== Read Serial Number
 	// 1 Serial Number string (may be ' ' padded at the end), the length header value will tell you how long it is, should be 20 or 40 'actual character' bytes (40 or 80 ASCII hex chars)
@@ -353,8 +357,8 @@ public:
 	static const uint8_t exampleReadSerialNumberRequestV25[];
 	static const uint8_t exampleReadSerialNumberResponseV25[];
 
-	bool CreateReadSerialNumberRequest(const uint8_t busId, std::vector<uint8_t>& request);
-	bool ProcessReadSerialNumberResponse(const uint8_t busId, const std::vector<uint8_t>& response, std::string& serialNumber);
+	virtual bool CreateReadSerialNumberRequest(const uint8_t busId, std::vector<uint8_t>& request);
+	virtual bool ProcessReadSerialNumberResponse(const uint8_t busId, const std::vector<uint8_t>& response, std::string& serialNumber);
 
 	// ============================================================================
 	// 
@@ -364,6 +368,7 @@ public:
 	// ============================================================================
 
 	// ==== Sound Alarm Switch
+	// note: PBmsTools labels these buttons "open" (turn on) and "close" (turn off), the example names below follow enum SwitchCommand instead
 	// 1: The "on/off" switch command, see: enum SwitchCommand
 	// open:  ~25004699E0020DFD12.
 	//                     11
@@ -446,13 +451,14 @@ public:
 		SC_SetChargeCurrentLimiterCurrentLimitLowGear = 0x09,
 	};
 
-	bool CreateWriteSwitchCommandRequest(const uint8_t busId, const SwitchCommand command, std::vector<uint8_t>& request);
-	bool ProcessWriteSwitchCommandResponse(const uint8_t busId, const SwitchCommand command, const std::vector<uint8_t>& response);
+	virtual bool CreateWriteSwitchCommandRequest(const uint8_t busId, const SwitchCommand command, std::vector<uint8_t>& request);
+	virtual bool ProcessWriteSwitchCommandResponse(const uint8_t busId, const SwitchCommand command, const std::vector<uint8_t>& response);
 
 	// ==== Charge MOSFET Switch
 	// note: I have seen the BMS enforce that at least one of Charge MOSFET or Discharge MOSFET must always be on, 
 	//       you cannot turn both off but you can turn them off individually
 	// note: Additionally, I can turn the charge mosfet OFF when the BMS is idle, or already charging, but not while discharging, which is... strange
+	// note: PBmsTools labels these buttons "open" (turn on, MS_Close) and "close" (turn off, MS_Open), the example names below follow enum MosfetState instead
 	// 1: The "on/off" state, see: enum MosfetState
 	// open:  ~2500469AE00200FD1E.
 	//                     11
@@ -472,6 +478,7 @@ public:
 	// note: I have seen the BMS enforce that at least one of Charge MOSFET or Discharge MOSFET must always be on, 
 	//       you cannot turn both off but you can turn them off individually
 	// note: Additionally, I can turn the discharge mosfet OFF when the BMS is idle, or already discharging, but not while charging, which is... strange
+	// note: PBmsTools labels these buttons "open" (turn on, MS_Close) and "close" (turn off, MS_Open), the example names below follow enum MosfetState instead
 	// 1: The "on/off" state, see: enum MosfetState
 	// open:  ~2500469BE00200FD1D.
 	//                     11
@@ -499,8 +506,8 @@ public:
 		MS_Close = 0x00
 	};
 
-	bool CreateWriteMosfetSwitchCommandRequest(const uint8_t busId, const MosfetType type, const MosfetState command, std::vector<uint8_t>& request);
-	bool ProcessWriteMosfetSwitchCommandResponse(const uint8_t busId, const MosfetType type, const MosfetState command, const std::vector<uint8_t>& response);
+	virtual bool CreateWriteMosfetSwitchCommandRequest(const uint8_t busId, const MosfetType type, const MosfetState command, std::vector<uint8_t>& request);
+	virtual bool ProcessWriteMosfetSwitchCommandResponse(const uint8_t busId, const MosfetType type, const MosfetState command, const std::vector<uint8_t>& response);
 
 	// ==== Shutdown (if the BMS is active charge/discharging it will immediately reboot after shutdown)
 	// x: unknown payload, this may be a command code and there may be more but I'm not going to test that due to potentially unknown consequences
@@ -511,8 +518,8 @@ public:
 	static const uint8_t exampleWriteRebootCommandRequestV25[];
 	static const uint8_t exampleWriteRebootCommandResponseV25[];
 
-	bool CreateWriteShutdownCommandRequest(const uint8_t busId, std::vector<uint8_t>& request);
-	bool ProcessWriteShutdownCommandResponse(const uint8_t busId, const std::vector<uint8_t>& response);
+	virtual bool CreateWriteShutdownCommandRequest(const uint8_t busId, std::vector<uint8_t>& request);
+	virtual bool ProcessWriteShutdownCommandResponse(const uint8_t busId, const std::vector<uint8_t>& response);
 
 // ============================================================================
 // 
@@ -525,7 +532,7 @@ public:
 	// I'm not sure what prompts the battery to create a "history record" entry - the number of entries per day varies from 2-6 at a glance and there is sometimes a week or two missing between records
 	// My battery contained 400 records (and it's been on for over a year continuous, so I believe this is the limit)
 	// The last 4 (ASCII hex digits) request payload digits are a "count up" starting at 0000 and ending at 0x0190 = 400 dec, record index is zero-based with newest first (lowest payload value)
-	// I haven't decoded the response yet, but it contains
+	// PBmsTools shows these columns:
 	//         Date/Time
 	//         Pack Amps (-in/out)
 	//         Pack Voltage
@@ -538,8 +545,20 @@ public:
 	//         Fault Type
 	//         Cell Voltage 1-16
 	//         Temperatures 1-6
+	// MaxVolt/MinVolt aren't on the wire, they're calculated from the cell voltages, and I haven't worked out how the alarm/protect/fault types are encoded so those are kept raw
+	// 1 Date/Time: year - 2000, month, day, hour, minute, second
+	// 2 Cell Count (16)
+	// 3 Cell Voltage (repeated Cell Count times) - stored as v * 1000, so 56 is 56000
+	// 4 Temperature Count (6)
+	// 5 Temperature (repeated Temperature Count times) - stored as (value * 10) + 2730, to decode (value - 2730) / 10.0 = value
+	// 6 Current - stored as v * 100 (signed, negative is discharge)
+	// 7 Total Voltage - stored as mV
+	// 8 Remaining Capacity - stored as mAh / 10
+	// 9 Full Capacity - stored as mAh / 10
+	// 0 Alarm/Protect/Fault Type - the remainder of the payload, undecoded
 	// req:   ~250046A1C004018FFCA7.
 	// resp:  ~25004600709018021D020038100D970D990D9A0D990D990D970D990D980D990D980D800D980D980D990D980D98060B740B750B770B760B710B79FF6ED9D7286A286A0000000000060043FFFFFFFFDDE3.
+	//                     111111111111223333333333333333333333333333333333333333333333333333333333333333445555555555555555555555556666777788889999000000000000000000000000
 	//            the values in this response:  
 	//                2024-2-29 2:00:56 - 1.460	
 	//                55.767	
@@ -550,7 +569,36 @@ public:
 	//                3479	3481	3482	3481	3481	3479	3481	3480	3481	3480	3456	3480	3480	3481	3480	3480	
 	//                20.2	20.3	20.5	20.4	19.9	20.7
 	// resp:  ~250046000000FDAF.
-	//            this means "no more records available"
+	//            this means "no more records available", some firmwares return RTN 0x07 "No Data (historical record)" instead
+
+	static const uint8_t exampleReadHistoryRecordRequestV25[];
+	static const uint8_t exampleReadHistoryRecordResponseV25[];
+	static const uint8_t exampleReadHistoryRecordEndResponseV25[];
+
+	// the most records I've seen a pack hold, once full the oldest are dropped as new ones are added
+	static const uint16_t MAX_HISTORY_RECORD_COUNT = 400;
+
+	struct HistoryRecord
+	{
+		DateTime dateTime;
+		uint8_t  cellCount;
+		uint16_t cellVoltagesMillivolts[MAX_CELL_COUNT]{ };
+		uint8_t  temperatureCount;
+		int16_t  temperaturesTenthsCelcius[MAX_TEMP_COUNT]{ }; // first 4 are Cell readings, then MOSFET then Environment
+		int32_t  currentMilliamps;
+		uint32_t totalVoltageMillivolts;
+		uint32_t remainingCapacityMilliampHours;
+		uint32_t fullCapacityMilliampHours;
+		// calculated
+		uint16_t minCellVoltageMillivolts;
+		uint16_t maxCellVoltageMillivolts;
+		// alarm / protect / fault type, undecoded
+		std::vector<uint8_t> statusBytes;
+	};
+
+	// endOfHistory is set (and record left untouched) if there is no record at recordIndex, the return value is still true in that case
+	virtual bool CreateReadHistoryRecordRequest(const uint8_t busId, const uint16_t recordIndex, std::vector<uint8_t>& request);
+	virtual bool ProcessReadHistoryRecordResponse(const uint8_t busId, const std::vector<uint8_t>& response, HistoryRecord& record, bool& endOfHistory);
 
 
 	// -------- NOT IMPLEMENTED --------
@@ -574,10 +622,10 @@ public:
 	static const uint8_t exampleWriteSystemTimeRequestV25[];
 	static const uint8_t exampleWriteSystemTimeResponseV25[];
 
-	bool CreateReadSystemDateTimeRequest(const uint8_t busId, std::vector<uint8_t>& request);
-	bool ProcessReadSystemDateTimeResponse(const uint8_t busId, const std::vector<uint8_t>& response, DateTime& dateTime);
-	bool CreateWriteSystemDateTimeRequest(const uint8_t busId, const DateTime dateTime, std::vector<uint8_t>& request);
-	bool ProcessWriteSystemDateTimeResponse(const uint8_t busId, const std::vector<uint8_t>& response);
+	virtual bool CreateReadSystemDateTimeRequest(const uint8_t busId, std::vector<uint8_t>& request);
+	virtual bool ProcessReadSystemDateTimeResponse(const uint8_t busId, const std::vector<uint8_t>& response, DateTime& dateTime);
+	virtual bool CreateWriteSystemDateTimeRequest(const uint8_t busId, const DateTime dateTime, std::vector<uint8_t>& request);
+	virtual bool ProcessWriteSystemDateTimeResponse(const uint8_t busId, const std::vector<uint8_t>& response);
 
 // ============================================================================
 // 
@@ -606,8 +654,8 @@ public:
 	// these are used for all of the individual configurations, "book-ending" them, while individual configuration's 
 	// process response / create write request are differentiated via parameter overload, taking or returning one of 
 	// the configuration structs
-	bool CreateReadConfigurationRequest(const uint8_t busId, const ReadConfigurationType configType, std::vector<uint8_t>& request);
-	bool ProcessWriteConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response);
+	virtual bool CreateReadConfigurationRequest(const uint8_t busId, const ReadConfigurationType configType, std::vector<uint8_t>& request);
+	virtual bool ProcessWriteConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response);
 
 	// ==== Cell Over Voltage Configuration
 	// 1 Cell OV Alarm (V): 3.60 - stored as v * 1000, so 3.6 is 3600 - valid range reported by PBmsTools as 2.5-4.5 in steps of 0.01
@@ -633,8 +681,8 @@ public:
 		uint16_t ProtectionDelayMilliseconds;
 	};
 
-	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, CellOverVoltageConfiguration& config);
-	bool CreateWriteConfigurationRequest(const uint8_t busId, const CellOverVoltageConfiguration& config, std::vector<uint8_t>& request);
+	virtual bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, CellOverVoltageConfiguration& config);
+	virtual bool CreateWriteConfigurationRequest(const uint8_t busId, const CellOverVoltageConfiguration& config, std::vector<uint8_t>& request);
 
 	// ==== Pack Over Voltage Configuration
 	// 1 Pack OV Alarm (V): 57.6 (write: 57.61) - stored as v * 100, so 57.6 is 57600 - valid range reported by PBmsTools as 20-65 in steps of 0.01
@@ -660,8 +708,8 @@ public:
 		uint16_t ProtectionDelayMilliseconds;
 	};
 
-	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t> response, PackOverVoltageConfiguration& config);
-	bool CreateWriteConfigurationRequest(const uint8_t busId, const PackOverVoltageConfiguration& config, std::vector<uint8_t>& request);
+	virtual bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t> response, PackOverVoltageConfiguration& config);
+	virtual bool CreateWriteConfigurationRequest(const uint8_t busId, const PackOverVoltageConfiguration& config, std::vector<uint8_t>& request);
 
 	// ==== Cell Under Voltage Configuration
 	// 1 Cell UV Alarm (V): 2.8 - stored as v * 1000, so 2.8 is 2800 - valid range reported by PBmsTools as 2-3.5 in steps of 0.01
@@ -687,8 +735,8 @@ public:
 		uint16_t ProtectionDelayMilliseconds;
 	};
 
-	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, CellUnderVoltageConfiguration& config);
-	bool CreateWriteConfigurationRequest(const uint8_t busId, const CellUnderVoltageConfiguration& config, std::vector<uint8_t>& request);
+	virtual bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, CellUnderVoltageConfiguration& config);
+	virtual bool CreateWriteConfigurationRequest(const uint8_t busId, const CellUnderVoltageConfiguration& config, std::vector<uint8_t>& request);
 
 	// ==== Pack Under Voltage Configuration
 	// 1 Pack UV Alarm (V): 44.8 - stored as v * 1000, so 44.8 is 44800 - valid range reported by PBmsTools as 15-50 in steps of 0.01
@@ -714,8 +762,8 @@ public:
 		uint16_t ProtectionDelayMilliseconds;
 	};
 
-	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, PackUnderVoltageConfiguration& config);
-	bool CreateWriteConfigurationRequest(const uint8_t busId, const PackUnderVoltageConfiguration& config, std::vector<uint8_t>& request);
+	virtual bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, PackUnderVoltageConfiguration& config);
+	virtual bool CreateWriteConfigurationRequest(const uint8_t busId, const PackUnderVoltageConfiguration& config, std::vector<uint8_t>& request);
 
 	// ==== Charge Over Current Configuration
 	// 1 Charge OC Alarm (A): 104 - stored directly in amps - valid range reported by PBmsTools as 1-220
@@ -739,8 +787,8 @@ public:
 		uint16_t ProtectionDelayMilliseconds;
 	};
 
-	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, ChargeOverCurrentConfiguration& config);
-	bool CreateWriteConfigurationRequest(const uint8_t busId, const ChargeOverCurrentConfiguration& config, std::vector<uint8_t>& request);
+	virtual bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, ChargeOverCurrentConfiguration& config);
+	virtual bool CreateWriteConfigurationRequest(const uint8_t busId, const ChargeOverCurrentConfiguration& config, std::vector<uint8_t>& request);
 
 	// ==== Discharge Over Current 1 Configuration
 	// 1 Discharge OC Alarm (A): 105 - stored as negative two's complement in amps***, -105 is FF97 - valid range reported by PBmsTools as 1-220
@@ -765,8 +813,8 @@ public:
 		uint16_t ProtectionDelayMilliseconds;
 	};
 
-	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, DischargeOverCurrent1Configuration& config);
-	bool CreateWriteConfigurationRequest(const uint8_t busId, const DischargeOverCurrent1Configuration& config, std::vector<uint8_t>& request);
+	virtual bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, DischargeOverCurrent1Configuration& config);
+	virtual bool CreateWriteConfigurationRequest(const uint8_t busId, const DischargeOverCurrent1Configuration& config, std::vector<uint8_t>& request);
 
 	// ==== Dicharge Over Current 2 Configuration
 	// 1 Discharge OC 2 Protect: 150 - stored directly in amps - valid range reported by PBmsTools as 5-300 in steps of 5, but since this is an 8 bit store location, the actual max is 255????????
@@ -789,8 +837,8 @@ public:
 		uint16_t ProtectionDelayMilliseconds;
 	};
 
-	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, DischargeOverCurrent2Configuration& config);
-	bool CreateWriteConfigurationRequest(const uint8_t busId, const DischargeOverCurrent2Configuration& config, std::vector<uint8_t>& request);
+	virtual bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, DischargeOverCurrent2Configuration& config);
+	virtual bool CreateWriteConfigurationRequest(const uint8_t busId, const DischargeOverCurrent2Configuration& config, std::vector<uint8_t>& request);
 
 	// ==== Short Circuit Protection Configuration
 	// 1 Delay Time (us): 300 - stored in 25 microsecond steps, 300 is 12 - valid range reported by PBmsTools as as 100-500 in steps of 50
@@ -810,8 +858,8 @@ public:
 		uint16_t ProtectionDelayMicroseconds;
 	};
 
-	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, ShortCircuitProtectionConfiguration& config);
-	bool CreateWriteConfigurationRequest(const uint8_t busId, const ShortCircuitProtectionConfiguration& config, std::vector<uint8_t>& request);
+	virtual bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, ShortCircuitProtectionConfiguration& config);
+	virtual bool CreateWriteConfigurationRequest(const uint8_t busId, const ShortCircuitProtectionConfiguration& config, std::vector<uint8_t>& request);
 
 	// ==== Cell Balancing Configuration
 	// 1 Balance Threshold (V): 3.4 - stored as v * 1000, so 3.4 is 3400 - valid range reported by PBmsTools as 3.3-4.5 in steps of 0.01
@@ -833,8 +881,8 @@ public:
 		uint16_t DeltaCellMillivolts;
 	};
 
-	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, CellBalancingConfiguration& config);
-	bool CreateWriteConfigurationRequest(const uint8_t busId, const CellBalancingConfiguration& config, std::vector<uint8_t>& request);
+	virtual bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, CellBalancingConfiguration& config);
+	virtual bool CreateWriteConfigurationRequest(const uint8_t busId, const CellBalancingConfiguration& config, std::vector<uint8_t>& request);
 
 	// ==== Sleep Configuration
 	// 1 Sleep v-cell: 3.1 - stored as v * 1000, so 3.1 is 3100 - valid range reported by PBmsTools as 2-4 in steps of 0.01
@@ -856,8 +904,8 @@ public:
 		uint8_t DelayMinutes;
 	};
 
-	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, SleepConfiguration& config);
-	bool CreateWriteConfigurationRequest(const uint8_t busId, const SleepConfiguration& config, std::vector<uint8_t>& request);
+	virtual bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, SleepConfiguration& config);
+	virtual bool CreateWriteConfigurationRequest(const uint8_t busId, const SleepConfiguration& config, std::vector<uint8_t>& request);
 
 	// ==== Full Charge and Low Charge
 	// 1 Pack Full Charge Voltage: 56.0 - stored as v * 1000, so 56 is 56000 - valid range reported by PBmsTools as 20-65 in steps of 0.01
@@ -881,8 +929,8 @@ public:
 		uint8_t LowChargeAlarmPercent;
 	};
 
-	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, FullChargeLowChargeConfiguration& config);
-	bool CreateWriteConfigurationRequest(const uint8_t busId, const FullChargeLowChargeConfiguration& config, std::vector<uint8_t>& request);
+	virtual bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, FullChargeLowChargeConfiguration& config);
+	virtual bool CreateWriteConfigurationRequest(const uint8_t busId, const FullChargeLowChargeConfiguration& config, std::vector<uint8_t>& request);
 
 	// ==== Charge / Discharge Over Temperature Protection Configuration
 	// 1 Charge Over Temperature Alarm: 51 - stored as (value * 10) + 2730 = 3240, to decode (value - 2730) / 10.0 = 51 - valid range reported by PBmsTools as 20-100
@@ -912,8 +960,8 @@ public:
 		uint8_t DischargeProtectionRelease;
 	};
 
-	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, ChargeAndDischargeOverTemperatureConfiguration& config);
-	bool CreateWriteConfigurationRequest(const uint8_t busId, const ChargeAndDischargeOverTemperatureConfiguration& config, std::vector<uint8_t>& request);
+	virtual bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, ChargeAndDischargeOverTemperatureConfiguration& config);
+	virtual bool CreateWriteConfigurationRequest(const uint8_t busId, const ChargeAndDischargeOverTemperatureConfiguration& config, std::vector<uint8_t>& request);
 
 	// ==== Charge / Discharge Under Temperature Protection Configuration   
 	// 1 Charge Under Temperature Alarm: 0 - stored as (value * 10) + 2730 = , to decode (value - 2730) / 10.0 =  - valid range reported by PBmsTools as (-35)-30
@@ -943,8 +991,8 @@ public:
 		int8_t DischargeProtectionRelease;
 	};
 
-	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, ChargeAndDischargeUnderTemperatureConfiguration& config);
-	bool CreateWriteConfigurationRequest(const uint8_t busId, const ChargeAndDischargeUnderTemperatureConfiguration& config, std::vector<uint8_t>& request);
+	virtual bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, ChargeAndDischargeUnderTemperatureConfiguration& config);
+	virtual bool CreateWriteConfigurationRequest(const uint8_t busId, const ChargeAndDischargeUnderTemperatureConfiguration& config, std::vector<uint8_t>& request);
 
 	// ==== Mosfet Over Temperature Protection Configuration
 	// 1 Mosfet Over Temperature Alarm: 90 - stored as (value * 10) + 2730 = , to decode (value - 2730) / 10.0 =  - valid range reported by PBmsTools as 30-120
@@ -968,8 +1016,8 @@ public:
 		int8_t ProtectionRelease;
 	};
 
-	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, MosfetOverTemperatureConfiguration& config);
-	bool CreateWriteConfigurationRequest(const uint8_t busId, const MosfetOverTemperatureConfiguration& config, std::vector<uint8_t>& request);
+	virtual bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, MosfetOverTemperatureConfiguration& config);
+	virtual bool CreateWriteConfigurationRequest(const uint8_t busId, const MosfetOverTemperatureConfiguration& config, std::vector<uint8_t>& request);
 
 	// ==== Environment Over/Under Temperature Protection Configuration
 	// 1 Environment Under Temperature Alarm: (-20) - stored as (value * 10) + 2730 = , to decode (value - 2730) / 10.0 =  - valid range reported by PBmsTools as (-35)-30
@@ -999,8 +1047,8 @@ public:
 		int8_t OverProtectionRelease;
 	};
 
-	bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, EnvironmentOverUnderTemperatureConfiguration& config);
-	bool CreateWriteConfigurationRequest(const uint8_t busId, const EnvironmentOverUnderTemperatureConfiguration& config, std::vector<uint8_t>& request);
+	virtual bool ProcessReadConfigurationResponse(const uint8_t busId, const std::vector<uint8_t>& response, EnvironmentOverUnderTemperatureConfiguration& config);
+	virtual bool CreateWriteConfigurationRequest(const uint8_t busId, const EnvironmentOverUnderTemperatureConfiguration& config, std::vector<uint8_t>& request);
 
 // ============================================================================
 // 
@@ -1025,10 +1073,10 @@ public:
 	static const uint8_t exampleWriteChargeCurrentLimiterStartCurrentRequestV25[];
 	static const uint8_t exampleWriteChargeCurrentLimiterStartCurrentResponseV25[];
 
-	bool CreateReadChargeCurrentLimiterStartCurrentRequest(const uint8_t busId, std::vector<uint8_t>& request);
-	bool ProcessReadChargeCurrentLimiterStartCurrentResponse(const uint8_t busId, const std::vector<uint8_t>& response, uint8_t& current);
-	bool CreateWriteChargeCurrentLimiterStartCurrentRequest(const uint8_t busId, const uint8_t current, std::vector<uint8_t>& request);
-	bool ProcessWriteChargeCurrentLimiterStartCurrentResponse(const uint8_t busId, const std::vector<uint8_t>& response);
+	virtual bool CreateReadChargeCurrentLimiterStartCurrentRequest(const uint8_t busId, std::vector<uint8_t>& request);
+	virtual bool ProcessReadChargeCurrentLimiterStartCurrentResponse(const uint8_t busId, const std::vector<uint8_t>& response, uint8_t& current);
+	virtual bool CreateWriteChargeCurrentLimiterStartCurrentRequest(const uint8_t busId, const uint8_t current, std::vector<uint8_t>& request);
+	virtual bool ProcessWriteChargeCurrentLimiterStartCurrentResponse(const uint8_t busId, const std::vector<uint8_t>& response);
 
 	// ==== Read Remaining Capacity
 	// 1 Remaining Capacity (mAh): 62040 - stored in 10mAh hours, so 62040 is 6204
@@ -1041,8 +1089,8 @@ public:
 	static const uint8_t exampleReadRemainingCapacityRequestV25[];
 	static const uint8_t exampleReadRemainingCapacityResponseV25[];
 
-	bool CreateReadRemainingCapacityRequest(const uint8_t busId, std::vector<uint8_t>& request);
-	bool ProcessReadRemainingCapacityResponse(const uint8_t busId, const std::vector<uint8_t>& response, uint32_t& remainingCapacityMilliampHours, uint32_t& actualCapacityMilliampHours, uint32_t& designCapacityMilliampHours);
+	virtual bool CreateReadRemainingCapacityRequest(const uint8_t busId, std::vector<uint8_t>& request);
+	virtual bool ProcessReadRemainingCapacityResponse(const uint8_t busId, const std::vector<uint8_t>& response, uint32_t& remainingCapacityMilliampHours, uint32_t& actualCapacityMilliampHours, uint32_t& designCapacityMilliampHours);
 
 	// ==== Protocol
 	// 1 - CAN protocol, see enum, this example is "AFORE"
@@ -1131,10 +1179,10 @@ public:
 		ProtocolList_Type  Type;
 	};
 
-	bool CreateReadProtocolsRequest(const uint8_t busId, std::vector<uint8_t>& request);
-	bool ProcessReadProtocolsResponse(const uint8_t busId, const std::vector<uint8_t>& response, Protocols& protocols);
-	bool CreateWriteProtocolsRequest(const uint8_t busId, const Protocols& protocols, std::vector<uint8_t>& request);
-	bool ProcessWriteProtocolsResponse(const uint8_t busId, const std::vector<uint8_t>& response);
+	virtual bool CreateReadProtocolsRequest(const uint8_t busId, std::vector<uint8_t>& request);
+	virtual bool ProcessReadProtocolsResponse(const uint8_t busId, const std::vector<uint8_t>& response, Protocols& protocols);
+	virtual bool CreateWriteProtocolsRequest(const uint8_t busId, const Protocols& protocols, std::vector<uint8_t>& request);
+	virtual bool ProcessWriteProtocolsResponse(const uint8_t busId, const std::vector<uint8_t>& response);
 
 
 	// There are many other settings in "System Configuration" that can be written and/or calibrated here, 
@@ -11,6 +11,7 @@ static const char* const TAG = "pace_bms.select";
 
 void PaceBmsSelect::setup() {
 	if (this->parent_->get_protocol_commandset() == 0x25) {
+#ifdef PACE_BMS_COMMANDSET_V25
 		if (this->charge_current_limiter_gear_select_ != nullptr) {
 			this->parent_->register_status_information_callback_v25([this](PaceBmsProtocolV25::StatusInformation& status_information) {
 				if (this->charge_current_limiter_gear_select_ != nullptr) {
@@ -22,7 +23,7 @@ void PaceBmsSelect::setup() {
 					ESP_LOGV(TAG, "'charge_current_limiter_gear': Publishing state due to update from the hardware: %s", state.c_str());
 					this->parent_->queue_sensor_update([this, value = state]() { this->charge_current_limiter_gear_select_->publish_state(value); });
 				}
-			});
+			}, PaceBmsProtocolBase::SIF_None);
 		}
 		if (this->charge_current_limiter_gear_select_ != nullptr) {
 			this->charge_current_limiter_gear_select_->add_on_control_callback([this](std::string text, uint8_t value) {
@@ -91,6 +92,7 @@ void PaceBmsSelect::setup() {
 		else {
 			ESP_LOGE(TAG, "Protocol version not supported: 0x%02X", this->parent_->get_protocol_commandset());
 		}
+#endif
 	}
 }
 void PaceBmsSelect::dump_config() {
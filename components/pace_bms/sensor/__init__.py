@@ -17,8 +17,15 @@ from esphome.const import (
     #UNIT_AMP_HOURS,   <--------- added to const.py but need to check in
     UNIT_WATT,
     UNIT_PERCENT,
+    UNIT_MILLISECOND,
+    STATE_CLASS_TOTAL_INCREASING,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+)
+import esphome.final_validate as fv
+from .. import (
+    pace_bms_ns, CONF_PACE_BMS_ID, PaceBms,
+    CONF_MAX_CELL_COUNT, CONF_MAX_TEMPERATURE_COUNT, LIMIT_MAX_CELL_COUNT, LIMIT_MAX_TEMPERATURE_COUNT,
 )
-from .. import pace_bms_ns, CONF_PACE_BMS_ID, PaceBms
 
 UNIT_AMP_HOURS = "Ah" # todo: use existing
 
@@ -29,55 +36,11 @@ DEPENDENCIES = ["pace_bms"]
 PaceBmsSensor = pace_bms_ns.class_("PaceBmsSensor", cg.Component)
 
 CONF_CELL_COUNT = "cell_count"
-CONF_CELL_VOLTAGE_01 = "cell_voltage_01"
-CONF_CELL_VOLTAGE_02 = "cell_voltage_02"
-CONF_CELL_VOLTAGE_03 = "cell_voltage_03"
-CONF_CELL_VOLTAGE_04 = "cell_voltage_04"
-CONF_CELL_VOLTAGE_05 = "cell_voltage_05"
-CONF_CELL_VOLTAGE_06 = "cell_voltage_06"
-CONF_CELL_VOLTAGE_07 = "cell_voltage_07"
-CONF_CELL_VOLTAGE_08 = "cell_voltage_08"
-CONF_CELL_VOLTAGE_09 = "cell_voltage_09"
-CONF_CELL_VOLTAGE_10 = "cell_voltage_10"
-CONF_CELL_VOLTAGE_11 = "cell_voltage_11"
-CONF_CELL_VOLTAGE_12 = "cell_voltage_12"
-CONF_CELL_VOLTAGE_13 = "cell_voltage_13"
-CONF_CELL_VOLTAGE_14 = "cell_voltage_14"
-CONF_CELL_VOLTAGE_15 = "cell_voltage_15"
-CONF_CELL_VOLTAGE_16 = "cell_voltage_16"
-CELL_VOLTAGES = [
-    CONF_CELL_VOLTAGE_01,
-    CONF_CELL_VOLTAGE_02,
-    CONF_CELL_VOLTAGE_03,
-    CONF_CELL_VOLTAGE_04,
-    CONF_CELL_VOLTAGE_05,
-    CONF_CELL_VOLTAGE_06,
-    CONF_CELL_VOLTAGE_07,
-    CONF_CELL_VOLTAGE_08,
-    CONF_CELL_VOLTAGE_09,
-    CONF_CELL_VOLTAGE_10,
-    CONF_CELL_VOLTAGE_11,
-    CONF_CELL_VOLTAGE_12,
-    CONF_CELL_VOLTAGE_13,
-    CONF_CELL_VOLTAGE_14,
-    CONF_CELL_VOLTAGE_15,
-    CONF_CELL_VOLTAGE_16,
-]
+# cell_voltage_01 .. cell_voltage_32, only as many as the pace_bms max_cell_count can actually be used
+CELL_VOLTAGES = [f"cell_voltage_{i:02d}" for i in range(1, LIMIT_MAX_CELL_COUNT + 1)]
 CONF_TEMPERATURE_COUNT = "temperature_count"
-CONF_TEMPERATURE_01 = "temperature_01"
-CONF_TEMPERATURE_02 = "temperature_02"
-CONF_TEMPERATURE_03 = "temperature_03"
-CONF_TEMPERATURE_04 = "temperature_04"
-CONF_TEMPERATURE_05 = "temperature_05"
-CONF_TEMPERATURE_06 = "temperature_06"
-TEMPERATURES = [
-    CONF_TEMPERATURE_01,
-    CONF_TEMPERATURE_02,
-    CONF_TEMPERATURE_03,
-    CONF_TEMPERATURE_04,
-    CONF_TEMPERATURE_05,
-    CONF_TEMPERATURE_06,
-]
+# temperature_01 .. temperature_16, only as many as the pace_bms max_temperature_count can actually be used
+TEMPERATURES = [f"temperature_{i:02d}" for i in range(1, LIMIT_MAX_TEMPERATURE_COUNT + 1)]
 CONF_CURRENT = "current"
 CONF_TOTAL_VOLTAGE = "total_voltage"
 CONF_REMAINING_CAPACITY = "remaining_capacity"
@@ -91,54 +54,8 @@ CONF_MAX_CELL_VOLTAGE = "max_cell_voltage"
 CONF_AVG_CELL_VOLTAGE = "avg_cell_voltage"
 CONF_MAX_CELL_DIFFERENTIAL = "max_cell_differential"
 
-CONF_WARNING_STATUS_VALUE_CELL_01           = "warning_status_value_cell_01"
-CONF_WARNING_STATUS_VALUE_CELL_02           = "warning_status_value_cell_02"
-CONF_WARNING_STATUS_VALUE_CELL_03           = "warning_status_value_cell_03"
-CONF_WARNING_STATUS_VALUE_CELL_04           = "warning_status_value_cell_04"
-CONF_WARNING_STATUS_VALUE_CELL_05           = "warning_status_value_cell_05"
-CONF_WARNING_STATUS_VALUE_CELL_06           = "warning_status_value_cell_06"
-CONF_WARNING_STATUS_VALUE_CELL_07           = "warning_status_value_cell_07"
-CONF_WARNING_STATUS_VALUE_CELL_08           = "warning_status_value_cell_08"
-CONF_WARNING_STATUS_VALUE_CELL_09           = "warning_status_value_cell_09"
-CONF_WARNING_STATUS_VALUE_CELL_10           = "warning_status_value_cell_10"
-CONF_WARNING_STATUS_VALUE_CELL_11           = "warning_status_value_cell_11"
-CONF_WARNING_STATUS_VALUE_CELL_12           = "warning_status_value_cell_12"
-CONF_WARNING_STATUS_VALUE_CELL_13           = "warning_status_value_cell_13"
-CONF_WARNING_STATUS_VALUE_CELL_14           = "warning_status_value_cell_14"
-CONF_WARNING_STATUS_VALUE_CELL_15           = "warning_status_value_cell_15"
-CONF_WARNING_STATUS_VALUE_CELL_16           = "warning_status_value_cell_16"
-CONF_WARNING_STATUS_VALUE_CELLS = [
-    CONF_WARNING_STATUS_VALUE_CELL_01,
-    CONF_WARNING_STATUS_VALUE_CELL_02,
-    CONF_WARNING_STATUS_VALUE_CELL_03,
-    CONF_WARNING_STATUS_VALUE_CELL_04,
-    CONF_WARNING_STATUS_VALUE_CELL_05,
-    CONF_WARNING_STATUS_VALUE_CELL_06,
-    CONF_WARNING_STATUS_VALUE_CELL_07,
-    CONF_WARNING_STATUS_VALUE_CELL_08,
-    CONF_WARNING_STATUS_VALUE_CELL_09,
-    CONF_WARNING_STATUS_VALUE_CELL_10,
-    CONF_WARNING_STATUS_VALUE_CELL_11,
-    CONF_WARNING_STATUS_VALUE_CELL_12,
-    CONF_WARNING_STATUS_VALUE_CELL_13,
-    CONF_WARNING_STATUS_VALUE_CELL_14,
-    CONF_WARNING_STATUS_VALUE_CELL_15,
-    CONF_WARNING_STATUS_VALUE_CELL_16,
-]
-CONF_WARNING_STATUS_VALUE_TEMP_01           = "warning_status_value_temperature_01"
-CONF_WARNING_STATUS_VALUE_TEMP_02           = "warning_status_value_temperature_02"
-CONF_WARNING_STATUS_VALUE_TEMP_03           = "warning_status_value_temperature_03"
-CONF_WARNING_STATUS_VALUE_TEMP_04           = "warning_status_value_temperature_04"
-CONF_WARNING_STATUS_VALUE_TEMP_05           = "warning_status_value_temperature_05"
-CONF_WARNING_STATUS_VALUE_TEMP_06           = "warning_status_value_temperature_06"
-CONF_WARNING_STATUS_VALUE_TEMPS = [
-    CONF_WARNING_STATUS_VALUE_TEMP_01,
-    CONF_WARNING_STATUS_VALUE_TEMP_02,
-    CONF_WARNING_STATUS_VALUE_TEMP_03,
-    CONF_WARNING_STATUS_VALUE_TEMP_04,
-    CONF_WARNING_STATUS_VALUE_TEMP_05,
-    CONF_WARNING_STATUS_VALUE_TEMP_06,
-]
+CONF_WARNING_STATUS_VALUE_CELLS = [f"warning_status_value_cell_{i:02d}" for i in range(1, LIMIT_MAX_CELL_COUNT + 1)]
+CONF_WARNING_STATUS_VALUE_TEMPS = [f"warning_status_value_temperature_{i:02d}" for i in range(1, LIMIT_MAX_TEMPERATURE_COUNT + 1)]
 CONF_WARNING_STATUS_VALUE_CHARGE_CURRENT    = "warning_status_value_charge_current"
 CONF_WARNING_STATUS_VALUE_TOTAL_VOLTAGE     = "warning_status_value_total_voltage"
 CONF_WARNING_STATUS_VALUE_DISCHARGE_CURRENT = "warning_status_value_discharge_current"
@@ -180,6 +97,23 @@ CONF_CURRENT_EVENT_VALUE      = "current_event_value"
 CONF_REMAINING_CAPACITY_VALUE = "remaining_capacity_value"
 CONF_FET_STATUS_VALUE         = "fet_status_value"
 
+######## charge / discharge management, 0x20 PYLON variant only
+CONF_CHARGE_VOLTAGE_LIMIT          = "charge_voltage_limit"
+CONF_DISCHARGE_VOLTAGE_LIMIT       = "discharge_voltage_limit"
+CONF_CHARGE_CURRENT_LIMIT          = "charge_current_limit"
+CONF_DISCHARGE_CURRENT_LIMIT       = "discharge_current_limit"
+CONF_CHARGE_DISCHARGE_STATUS_VALUE = "charge_discharge_status_value"
+
+######## bus metrics (diagnostic, not protocol specific)
+CONF_REQUESTS_SENT      = "requests_sent"
+CONF_RESPONSES_OK       = "responses_ok"
+CONF_TIMEOUTS           = "timeouts"
+CONF_CHECKSUM_ERRORS    = "checksum_errors"
+CONF_RETURN_CODE_ERRORS = "return_code_errors"
+CONF_MEAN_LATENCY       = "mean_latency"
+CONF_P95_LATENCY        = "p95_latency"
+CONF_BUS_UTILIZATION    = "bus_utilization"
+
 
 CONFIG_SCHEMA = cv.Schema(
     {
@@ -192,144 +126,28 @@ CONFIG_SCHEMA = cv.Schema(
             #device_class=,
             state_class=STATE_CLASS_MEASUREMENT,
         ),
-        cv.Optional(CONF_CELL_VOLTAGE_01): sensor.sensor_schema(
-            unit_of_measurement=UNIT_VOLT,
-            accuracy_decimals=3,
-            device_class=DEVICE_CLASS_VOLTAGE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_CELL_VOLTAGE_02): sensor.sensor_schema(
-            unit_of_measurement=UNIT_VOLT,
-            accuracy_decimals=3,
-            device_class=DEVICE_CLASS_VOLTAGE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_CELL_VOLTAGE_03): sensor.sensor_schema(
-            unit_of_measurement=UNIT_VOLT,
-            accuracy_decimals=3,
-            device_class=DEVICE_CLASS_VOLTAGE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_CELL_VOLTAGE_04): sensor.sensor_schema(
-            unit_of_measurement=UNIT_VOLT,
-            accuracy_decimals=3,
-            device_class=DEVICE_CLASS_VOLTAGE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_CELL_VOLTAGE_05): sensor.sensor_schema(
-            unit_of_measurement=UNIT_VOLT,
-            accuracy_decimals=3,
-            device_class=DEVICE_CLASS_VOLTAGE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_CELL_VOLTAGE_06): sensor.sensor_schema(
-            unit_of_measurement=UNIT_VOLT,
-            accuracy_decimals=3,
-            device_class=DEVICE_CLASS_VOLTAGE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_CELL_VOLTAGE_07): sensor.sensor_schema(
-            unit_of_measurement=UNIT_VOLT,
-            accuracy_decimals=3,
-            device_class=DEVICE_CLASS_VOLTAGE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_CELL_VOLTAGE_08): sensor.sensor_schema(
-            unit_of_measurement=UNIT_VOLT,
-            accuracy_decimals=3,
-            device_class=DEVICE_CLASS_VOLTAGE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_CELL_VOLTAGE_09): sensor.sensor_schema(
-            unit_of_measurement=UNIT_VOLT,
-            accuracy_decimals=3,
-            device_class=DEVICE_CLASS_VOLTAGE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_CELL_VOLTAGE_10): sensor.sensor_schema(
-            unit_of_measurement=UNIT_VOLT,
-            accuracy_decimals=3,
-            device_class=DEVICE_CLASS_VOLTAGE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_CELL_VOLTAGE_11): sensor.sensor_schema(
-            unit_of_measurement=UNIT_VOLT,
-            accuracy_decimals=3,
-            device_class=DEVICE_CLASS_VOLTAGE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_CELL_VOLTAGE_12): sensor.sensor_schema(
-            unit_of_measurement=UNIT_VOLT,
-            accuracy_decimals=3,
-            device_class=DEVICE_CLASS_VOLTAGE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_CELL_VOLTAGE_13): sensor.sensor_schema(
-            unit_of_measurement=UNIT_VOLT,
-            accuracy_decimals=3,
-            device_class=DEVICE_CLASS_VOLTAGE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_CELL_VOLTAGE_14): sensor.sensor_schema(
-            unit_of_measurement=UNIT_VOLT,
-            accuracy_decimals=3,
-            device_class=DEVICE_CLASS_VOLTAGE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_CELL_VOLTAGE_15): sensor.sensor_schema(
-            unit_of_measurement=UNIT_VOLT,
-            accuracy_decimals=3,
-            device_class=DEVICE_CLASS_VOLTAGE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_CELL_VOLTAGE_16): sensor.sensor_schema(
-            unit_of_measurement=UNIT_VOLT,
-            accuracy_decimals=3,
-            device_class=DEVICE_CLASS_VOLTAGE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
+        **{
+            cv.Optional(key): sensor.sensor_schema(
+                unit_of_measurement=UNIT_VOLT,
+                accuracy_decimals=3,
+                device_class=DEVICE_CLASS_VOLTAGE,
+                state_class=STATE_CLASS_MEASUREMENT,
+            ) for key in CELL_VOLTAGES
+        },
         cv.Optional(CONF_TEMPERATURE_COUNT): sensor.sensor_schema(
             #unit_of_measurement=,
             accuracy_decimals=0,
             #device_class=,
             state_class=STATE_CLASS_MEASUREMENT,
         ),
-        cv.Optional(CONF_TEMPERATURE_01): sensor.sensor_schema(
-            unit_of_measurement=UNIT_CELSIUS,
-            accuracy_decimals=1,
-            device_class=DEVICE_CLASS_TEMPERATURE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_TEMPERATURE_02): sensor.sensor_schema(
-            unit_of_measurement=UNIT_CELSIUS,
-            accuracy_decimals=1,
-            device_class=DEVICE_CLASS_TEMPERATURE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_TEMPERATURE_03): sensor.sensor_schema(
-            unit_of_measurement=UNIT_CELSIUS,
-            accuracy_decimals=1,
-            device_class=DEVICE_CLASS_TEMPERATURE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_TEMPERATURE_04): sensor.sensor_schema(
-            unit_of_measurement=UNIT_CELSIUS,
-            accuracy_decimals=1,
-            device_class=DEVICE_CLASS_TEMPERATURE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_TEMPERATURE_05): sensor.sensor_schema(
-            unit_of_measurement=UNIT_CELSIUS,
-            accuracy_decimals=1,
-            device_class=DEVICE_CLASS_TEMPERATURE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_TEMPERATURE_06): sensor.sensor_schema(
-            unit_of_measurement=UNIT_CELSIUS,
-            accuracy_decimals=1,
-            device_class=DEVICE_CLASS_TEMPERATURE,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
+        **{
+            cv.Optional(key): sensor.sensor_schema(
+                unit_of_measurement=UNIT_CELSIUS,
+                accuracy_decimals=1,
+                device_class=DEVICE_CLASS_TEMPERATURE,
+                state_class=STATE_CLASS_MEASUREMENT,
+            ) for key in TEMPERATURES
+        },
         cv.Optional(CONF_CURRENT): sensor.sensor_schema(
             unit_of_measurement=UNIT_AMPERE,
             accuracy_decimals=2,
@@ -409,139 +227,23 @@ CONFIG_SCHEMA = cv.Schema(
             state_class=STATE_CLASS_MEASUREMENT,
         ),
 
-        cv.Optional(CONF_WARNING_STATUS_VALUE_CELL_01): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_CELL_02): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_CELL_03): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_CELL_04): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_CELL_05): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_CELL_06): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_CELL_07): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_CELL_08): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_CELL_09): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_CELL_10): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_CELL_11): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_CELL_12): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_CELL_13): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_CELL_14): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_CELL_15): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_CELL_16): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
+        **{
+            cv.Optional(key): sensor.sensor_schema(
+                #unit_of_measurement=,
+                accuracy_decimals=0,
+                #device_class=,
+                state_class=STATE_CLASS_MEASUREMENT,
+            ) for key in CONF_WARNING_STATUS_VALUE_CELLS
+        },
 
-        cv.Optional(CONF_WARNING_STATUS_VALUE_TEMP_01): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_TEMP_02): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_TEMP_03): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_TEMP_04): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_TEMP_05): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
-        cv.Optional(CONF_WARNING_STATUS_VALUE_TEMP_06): sensor.sensor_schema(
-            #unit_of_measurement=,
-            accuracy_decimals=0,
-            #device_class=,
-            state_class=STATE_CLASS_MEASUREMENT,
-        ),
+        **{
+            cv.Optional(key): sensor.sensor_schema(
+                #unit_of_measurement=,
+                accuracy_decimals=0,
+                #device_class=,
+                state_class=STATE_CLASS_MEASUREMENT,
+            ) for key in CONF_WARNING_STATUS_VALUE_TEMPS
+        },
 
         cv.Optional(CONF_WARNING_STATUS_VALUE_CHARGE_CURRENT): sensor.sensor_schema(
             #unit_of_measurement=,
@@ -740,9 +442,99 @@ CONFIG_SCHEMA = cv.Schema(
             state_class=STATE_CLASS_MEASUREMENT,
         ),
 
+        cv.Optional(CONF_CHARGE_VOLTAGE_LIMIT): sensor.sensor_schema(
+            unit_of_measurement=UNIT_VOLT,
+            accuracy_decimals=3,
+            device_class=DEVICE_CLASS_VOLTAGE,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_DISCHARGE_VOLTAGE_LIMIT): sensor.sensor_schema(
+            unit_of_measurement=UNIT_VOLT,
+            accuracy_decimals=3,
+            device_class=DEVICE_CLASS_VOLTAGE,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_CHARGE_CURRENT_LIMIT): sensor.sensor_schema(
+            unit_of_measurement=UNIT_AMPERE,
+            accuracy_decimals=1,
+            device_class=DEVICE_CLASS_CURRENT,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_DISCHARGE_CURRENT_LIMIT): sensor.sensor_schema(
+            unit_of_measurement=UNIT_AMPERE,
+            accuracy_decimals=1,
+            device_class=DEVICE_CLASS_CURRENT,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_CHARGE_DISCHARGE_STATUS_VALUE): sensor.sensor_schema(
+            #unit_of_measurement=,
+            accuracy_decimals=0,
+            #device_class=,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+
+        cv.Optional(CONF_REQUESTS_SENT): sensor.sensor_schema(
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_RESPONSES_OK): sensor.sensor_schema(
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_TIMEOUTS): sensor.sensor_schema(
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_CHECKSUM_ERRORS): sensor.sensor_schema(
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_RETURN_CODE_ERRORS): sensor.sensor_schema(
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_MEAN_LATENCY): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MILLISECOND,
+            accuracy_decimals=1,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_P95_LATENCY): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MILLISECOND,
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_BUS_UTILIZATION): sensor.sensor_schema(
+            unit_of_measurement=UNIT_PERCENT,
+            accuracy_decimals=1,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+
     }
 )
 
+def _final_validate(config):
+    # the per-cell / per-temperature arrays are sized by the parent's max_cell_count / max_temperature_count, anything past that has no slot
+    full_config = fv.full_config.get()
+    parent_path = full_config.get_path_for_id(config[CONF_PACE_BMS_ID])[:-1]
+    parent_config = full_config.get_config_for_path(parent_path)
+    for keys, limit_key in ((CELL_VOLTAGES, CONF_MAX_CELL_COUNT), (CONF_WARNING_STATUS_VALUE_CELLS, CONF_MAX_CELL_COUNT),
+                            (TEMPERATURES, CONF_MAX_TEMPERATURE_COUNT), (CONF_WARNING_STATUS_VALUE_TEMPS, CONF_MAX_TEMPERATURE_COUNT)):
+        for key in keys[parent_config[limit_key]:]:
+            if key in config:
+                raise cv.Invalid(f"{key} requires {limit_key} of at least {keys.index(key) + 1} on the pace_bms component")
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = _final_validate
+
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
@@ -943,3 +735,44 @@ async def to_code(config):
     if fet_status_value := config.get(CONF_FET_STATUS_VALUE):
         sens = await sensor.new_sensor(fet_status_value)
         cg.add(var.set_fet_status_value_sensor(sens))
+
+    if charge_voltage_limit := config.get(CONF_CHARGE_VOLTAGE_LIMIT):
+        sens = await sensor.new_sensor(charge_voltage_limit)
+        cg.add(var.set_charge_voltage_limit_sensor(sens))
+    if discharge_voltage_limit := config.get(CONF_DISCHARGE_VOLTAGE_LIMIT):
+        sens = await sensor.new_sensor(discharge_voltage_limit)
+        cg.add(var.set_discharge_voltage_limit_sensor(sens))
+    if charge_current_limit := config.get(CONF_CHARGE_CURRENT_LIMIT):
+        sens = await sensor.new_sensor(charge_current_limit)
+        cg.add(var.set_charge_current_limit_sensor(sens))
+    if discharge_current_limit := config.get(CONF_DISCHARGE_CURRENT_LIMIT):
+        sens = await sensor.new_sensor(discharge_current_limit)
+        cg.add(var.set_discharge_current_limit_sensor(sens))
+    if charge_discharge_status_value := config.get(CONF_CHARGE_DISCHARGE_STATUS_VALUE):
+        sens = await sensor.new_sensor(charge_discharge_status_value)
+        cg.add(var.set_charge_discharge_status_value_sensor(sens))
+
+    if requests_sent := config.get(CONF_REQUESTS_SENT):
+        sens = await sensor.new_sensor(requests_sent)
+        cg.add(var.set_requests_sent_sensor(sens))
+    if responses_ok := config.get(CONF_RESPONSES_OK):
+        sens = await sensor.new_sensor(responses_ok)
+        cg.add(var.set_responses_ok_sensor(sens))
+    if timeouts := config.get(CONF_TIMEOUTS):
+        sens = await sensor.new_sensor(timeouts)
+        cg.add(var.set_timeouts_sensor(sens))
+    if checksum_errors := config.get(CONF_CHECKSUM_ERRORS):
+        sens = await sensor.new_sensor(checksum_errors)
+        cg.add(var.set_checksum_errors_sensor(sens))
+    if return_code_errors := config.get(CONF_RETURN_CODE_ERRORS):
+        sens = await sensor.new_sensor(return_code_errors)
+        cg.add(var.set_return_code_errors_sensor(sens))
+    if mean_latency := config.get(CONF_MEAN_LATENCY):
+        sens = await sensor.new_sensor(mean_latency)
+        cg.add(var.set_mean_latency_sensor(sens))
+    if p95_latency := config.get(CONF_P95_LATENCY):
+        sens = await sensor.new_sensor(p95_latency)
+        cg.add(var.set_p95_latency_sensor(sens))
+    if bus_utilization := config.get(CONF_BUS_UTILIZATION):
+        sens = await sensor.new_sensor(bus_utilization)
+        cg.add(var.set_bus_utilization_sensor(sens))
@@ -10,35 +10,82 @@ namespace pace_bms {
 static const char* const TAG = "pace_bms.sensor";
 
 void PaceBmsSensor::setup() {
+	// tell the decoder which of the calculated values we're actually going to publish, and that we only publish 
+	//     raw status values so it doesn't need to build any status text on our behalf
+	uint32_t analog_fields = this->get_analog_information_fields_();
+	uint32_t status_fields = PaceBmsProtocolBase::SIF_None;
+
 	if (this->parent_->get_protocol_commandset() == 0x25) {
+#ifdef PACE_BMS_COMMANDSET_V25
 		if (request_analog_info_callback_ == true) {
-			this->parent_->register_analog_information_callback_v25([this](PaceBmsProtocolV25::AnalogInformation& analog_information) { this->analog_information_callback_v25(analog_information); });
+			this->parent_->register_analog_information_callback_v25([this](PaceBmsProtocolV25::AnalogInformation& analog_information) { this->analog_information_callback_v25(analog_information); }, analog_fields & ~PaceBmsProtocolBase::AIF_StateOfCharge);
+		}
+		if (request_capacity_callback_ == true) {
+			this->parent_->register_remaining_capacity_callback_v25([this](uint32_t& remaining_capacity, uint32_t& actual_capacity, uint32_t& design_capacity) { this->remaining_capacity_callback_v25(remaining_capacity, actual_capacity, design_capacity); });
 		}
 		if (request_status_info_callback_ == true) {
-			this->parent_->register_status_information_callback_v25([this](PaceBmsProtocolV25::StatusInformation& status_information) { this->status_information_callback_v25(status_information); });
+			this->parent_->register_status_information_callback_v25([this](PaceBmsProtocolV25::StatusInformation& status_information) { this->status_information_callback_v25(status_information); }, status_fields);
 		}
+#endif
 	}
 	else if (this->parent_->get_protocol_commandset() == 0x20) {
-		if (request_analog_info_callback_ == true) {
-			this->parent_->register_analog_information_callback_v20([this](PaceBmsProtocolV20::AnalogInformation& analog_information) { this->analog_information_callback_v20(analog_information); });
+#ifdef PACE_BMS_COMMANDSET_V20
+		if (request_analog_info_callback_ == true || request_capacity_callback_ == true) {
+			this->parent_->register_analog_information_callback_v20([this](PaceBmsProtocolV20::AnalogInformation& analog_information) { this->analog_information_callback_v20(analog_information); }, analog_fields);
 		}
 		if (request_status_info_callback_ == true) {
-			this->parent_->register_status_information_callback_v20([this](PaceBmsProtocolV20::StatusInformation& status_information) { this->status_information_callback_v20(status_information); });
+			this->parent_->register_status_information_callback_v20([this](PaceBmsProtocolV20::StatusInformation& status_information) { this->status_information_callback_v20(status_information); }, status_fields);
 		}
+#ifdef PACE_BMS_V20_VARIANT_PYLON
+		if (request_charge_discharge_management_info_callback_ == true) {
+			this->parent_->register_charge_discharge_management_information_callback_v20([this](PaceBmsProtocolV20::ChargeDischargeManagementInformation& management_information) { this->charge_discharge_management_information_callback_v20(management_information); });
+		}
+#endif
+#endif
 	}
 	else {
 		ESP_LOGE(TAG, "Protocol version not supported: 0x%02X", this->parent_->get_protocol_commandset());
 	}
+
+	// not protocol specific
+	if (request_bus_metrics_callback_ == true) {
+		this->parent_->register_bus_metrics_callback([this](PaceBms::bus_metrics& metrics) { this->bus_metrics_callback(metrics); });
+	}
+}
+
+uint32_t PaceBmsSensor::get_analog_information_fields_() {
+	uint32_t fields = PaceBmsProtocolBase::AIF_None;
+	for (int i = 0; i < PACE_BMS_MAX_CELL_COUNT; i++) {
+		if (this->cell_voltage_sensor_[i] != nullptr)
+			fields |= PaceBmsProtocolBase::AIF_CellVoltages;
+	}
+	for (int i = 0; i < PACE_BMS_MAX_TEMP_COUNT; i++) {
+		if (this->temperature_sensor_[i] != nullptr)
+			fields |= PaceBmsProtocolBase::AIF_Temperatures;
+	}
+	if (this->state_of_charge_sensor_ != nullptr)
+		fields |= PaceBmsProtocolBase::AIF_StateOfCharge;
+	if (this->state_of_health_sensor_ != nullptr)
+		fields |= PaceBmsProtocolBase::AIF_StateOfHealth;
+	if (this->power_sensor_ != nullptr)
+		fields |= PaceBmsProtocolBase::AIF_Power;
+	if (this->min_cell_voltage_sensor_ != nullptr ||
+		this->max_cell_voltage_sensor_ != nullptr ||
+		this->max_cell_differential_sensor_ != nullptr)
+		fields |= PaceBmsProtocolBase::AIF_CellMinMax;
+	if (this->avg_cell_voltage_sensor_ != nullptr)
+		fields |= PaceBmsProtocolBase::AIF_CellAverage;
+	return fields;
 }
 
 void PaceBmsSensor::dump_config() {
 	ESP_LOGCONFIG(TAG, "pace_bms_sensor:");
 	LOG_SENSOR("  ", "Cell Count", this->cell_count_sensor_);
-	for (int i = 0; i < 16; i++)
-		LOG_SENSOR("  ", "Cell Voltage X of 16", this->cell_voltage_sensor_[i]);
+	for (int i = 0; i < PACE_BMS_MAX_CELL_COUNT; i++)
+		LOG_SENSOR("  ", "Cell Voltage X", this->cell_voltage_sensor_[i]);
 	LOG_SENSOR("  ", "Temperature Count", this->temperature_count_sensor_);
-	for (int i = 0; i < 6; i++)
-		LOG_SENSOR("  ", "Temperature X of 6", this->temperature_sensor_[i]);
+	for (int i = 0; i < PACE_BMS_MAX_TEMP_COUNT; i++)
+		LOG_SENSOR("  ", "Temperature X", this->temperature_sensor_[i]);
 	LOG_SENSOR("  ", "Current", this->current_sensor_);
 	LOG_SENSOR("  ", "Total Voltage", this->total_voltage_sensor_);
 	LOG_SENSOR("  ", "Remaining Capacity", this->remaining_capacity_sensor_);
@@ -52,10 +99,10 @@ void PaceBmsSensor::dump_config() {
 	LOG_SENSOR("  ", "Max Cell Voltage", this->max_cell_voltage_sensor_);
 	LOG_SENSOR("  ", "Avg Cell Voltage", this->avg_cell_voltage_sensor_);
 	LOG_SENSOR("  ", "Max Cell Differential", this->max_cell_differential_sensor_);
-	for (int i = 0; i < 16; i++)
-		LOG_SENSOR("  ", "Warning Status Value Cell X of 16", this->warning_status_value_cells_sensor_[i]);
-	for (int i = 0; i < 6; i++)
-		LOG_SENSOR("  ", "Warning Status Value Temperature X of 6", this->temperature_sensor_[i]);
+	for (int i = 0; i < PACE_BMS_MAX_CELL_COUNT; i++)
+		LOG_SENSOR("  ", "Warning Status Value Cell X", this->warning_status_value_cells_sensor_[i]);
+	for (int i = 0; i < PACE_BMS_MAX_TEMP_COUNT; i++)
+		LOG_SENSOR("  ", "Warning Status Value Temperature X", this->warning_status_value_temps_sensor_[i]);
 	LOG_SENSOR("  ", "Warning Status Value Charge Current", this->warning_status_value_charge_current_sensor_);
 	LOG_SENSOR("  ", "Warning Status Value Total Voltage", this->warning_status_value_total_voltage_sensor_);
 	LOG_SENSOR("  ", "Warning Status Value Discharge Current", this->warning_status_value_discharge_current_sensor_);
@@ -72,13 +119,26 @@ void PaceBmsSensor::dump_config() {
 	LOG_SENSOR("  ", "Status 3 Value", this->status3_value_sensor_);
 	LOG_SENSOR("  ", "Status 4 Value", this->status4_value_sensor_);
 	LOG_SENSOR("  ", "Status 5 Value", this->status5_value_sensor_);
+	LOG_SENSOR("  ", "Charge Voltage Limit", this->charge_voltage_limit_sensor_);
+	LOG_SENSOR("  ", "Discharge Voltage Limit", this->discharge_voltage_limit_sensor_);
+	LOG_SENSOR("  ", "Charge Current Limit", this->charge_current_limit_sensor_);
+	LOG_SENSOR("  ", "Discharge Current Limit", this->discharge_current_limit_sensor_);
+	LOG_SENSOR("  ", "Charge Discharge Status Value", this->charge_discharge_status_value_sensor_);
+	LOG_SENSOR("  ", "Requests Sent", this->requests_sent_sensor_);
+	LOG_SENSOR("  ", "Responses OK", this->responses_ok_sensor_);
+	LOG_SENSOR("  ", "Timeouts", this->timeouts_sensor_);
+	LOG_SENSOR("  ", "Checksum Errors", this->checksum_errors_sensor_);
+	LOG_SENSOR("  ", "Return Code Errors", this->return_code_errors_sensor_);
+	LOG_SENSOR("  ", "Mean Latency", this->mean_latency_sensor_);
+	LOG_SENSOR("  ", "P95 Latency", this->p95_latency_sensor_);
+	LOG_SENSOR("  ", "Bus Utilization", this->bus_utilization_sensor_);
 }
 
 void PaceBmsSensor::analog_information_callback_v25(PaceBmsProtocolV25::AnalogInformation& analog_information) {
 	if (this->cell_count_sensor_ != nullptr) {
 		this->parent_->queue_sensor_update([this, value = analog_information.cellCount]() { this->cell_count_sensor_->publish_state(value); });
 	}
-	for (int i = 0; i < 16; i++) {
+	for (int i = 0; i < PACE_BMS_MAX_CELL_COUNT; i++) {
 		if (this->cell_voltage_sensor_[i] != nullptr) {
 			this->parent_->queue_sensor_update([this, i, value = analog_information.cellVoltagesMillivolts[i] / 1000.0f]() { this->cell_voltage_sensor_[i]->publish_state(value); });
 		}
@@ -86,7 +146,7 @@ void PaceBmsSensor::analog_information_callback_v25(PaceBmsProtocolV25::AnalogIn
 	if (this->temperature_count_sensor_ != nullptr) {
 		this->temperature_count_sensor_->publish_state(analog_information.temperatureCount);
 	}
-	for (int i = 0; i < 6; i++) {
+	for (int i = 0; i < PACE_BMS_MAX_TEMP_COUNT; i++) {
 		if (this->temperature_sensor_[i] != nullptr) {
 			this->parent_->queue_sensor_update([this, i, value = analog_information.temperaturesTenthsCelcius[i] / 10.0f]() { this->temperature_sensor_[i]->publish_state(value); });
 		}
@@ -97,21 +157,9 @@ void PaceBmsSensor::analog_information_callback_v25(PaceBmsProtocolV25::AnalogIn
 	if (this->total_voltage_sensor_ != nullptr) {
 		this->parent_->queue_sensor_update([this, value = analog_information.totalVoltageMillivolts / 1000.0f]() { this->total_voltage_sensor_->publish_state(value); });
 	}
-	if (this->remaining_capacity_sensor_ != nullptr) {
-		this->parent_->queue_sensor_update([this, value = analog_information.remainingCapacityMilliampHours / 1000.0f]() { this->remaining_capacity_sensor_->publish_state(value); });
-	}
-	if (this->full_capacity_sensor_ != nullptr) {
-		this->parent_->queue_sensor_update([this, value = analog_information.fullCapacityMilliampHours / 1000.0f]() { this->full_capacity_sensor_->publish_state(value); });
-	}
-	if (this->design_capacity_sensor_ != nullptr) {
-		this->parent_->queue_sensor_update([this, value = analog_information.designCapacityMilliampHours / 1000.0f]() { this->design_capacity_sensor_->publish_state(value); });
-	}
 	if (this->cycle_count_sensor_ != nullptr) {
 		this->parent_->queue_sensor_update([this, value = analog_information.cycleCount]() { this->cycle_count_sensor_->publish_state(value); });
 	}
-	if (this->state_of_charge_sensor_ != nullptr) {
-		this->parent_->queue_sensor_update([this, value = analog_information.SoC]() { this->state_of_charge_sensor_->publish_state(value); });
-	}
 	if (this->state_of_health_sensor_ != nullptr) {
 		this->parent_->queue_sensor_update([this, value = analog_information.SoH]() { this->state_of_health_sensor_->publish_state(value); });
 	}
@@ -132,13 +180,28 @@ void PaceBmsSensor::analog_information_callback_v25(PaceBmsProtocolV25::AnalogIn
 	}
 }
 
+void PaceBmsSensor::remaining_capacity_callback_v25(uint32_t& remaining_capacity, uint32_t& actual_capacity, uint32_t& design_capacity) {
+	if (this->remaining_capacity_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = remaining_capacity / 1000.0f]() { this->remaining_capacity_sensor_->publish_state(value); });
+	}
+	if (this->full_capacity_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = actual_capacity / 1000.0f]() { this->full_capacity_sensor_->publish_state(value); });
+	}
+	if (this->design_capacity_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = design_capacity / 1000.0f]() { this->design_capacity_sensor_->publish_state(value); });
+	}
+	if (this->state_of_charge_sensor_ != nullptr && actual_capacity != 0) {
+		this->parent_->queue_sensor_update([this, value = ((float)remaining_capacity / (float)actual_capacity) * 100.0f]() { this->state_of_charge_sensor_->publish_state(value); });
+	}
+}
+
 void PaceBmsSensor::status_information_callback_v25(PaceBmsProtocolV25::StatusInformation& status_information) {
-	for (int i = 0; i < 16; i++) {
+	for (int i = 0; i < PACE_BMS_MAX_CELL_COUNT; i++) {
 		if (this->warning_status_value_cells_sensor_[i] != nullptr) {
 			this->parent_->queue_sensor_update([this, i, value = status_information.warning_value_cell[i]]() { this->warning_status_value_cells_sensor_[i]->publish_state(value); });
 		}
 	}
-	for (int i = 0; i < 6; i++) {
+	for (int i = 0; i < PACE_BMS_MAX_TEMP_COUNT; i++) {
 		if (this->warning_status_value_temps_sensor_[i] != nullptr) {
 			this->parent_->queue_sensor_update([this, i, value = status_information.warning_value_temp[i]]() { this->warning_status_value_temps_sensor_[i]->publish_state(value); });
 		}
@@ -182,7 +245,7 @@ void PaceBmsSensor::analog_information_callback_v20(PaceBmsProtocolV20::AnalogIn
 	if (this->cell_count_sensor_ != nullptr) {
 		this->parent_->queue_sensor_update([this, value = analog_information.cellCount]() { this->cell_count_sensor_->publish_state(value); });
 	}
-	for (int i = 0; i < 16; i++) {
+	for (int i = 0; i < PACE_BMS_MAX_CELL_COUNT; i++) {
 		if (this->cell_voltage_sensor_[i] != nullptr) {
 			this->parent_->queue_sensor_update([this, i, value = analog_information.cellVoltagesMillivolts[i] / 1000.0f]() { this->cell_voltage_sensor_[i]->publish_state(value); });
 		}
@@ -190,7 +253,7 @@ void PaceBmsSensor::analog_information_callback_v20(PaceBmsProtocolV20::AnalogIn
 	if (this->temperature_count_sensor_ != nullptr) {
 		this->parent_->queue_sensor_update([this, value = analog_information.temperatureCount]() { this->temperature_count_sensor_->publish_state(value); });
 	}
-	for (int i = 0; i < 6; i++) {
+	for (int i = 0; i < PACE_BMS_MAX_TEMP_COUNT; i++) {
 		if (this->temperature_sensor_[i] != nullptr) {
 			this->parent_->queue_sensor_update([this, i, value = analog_information.temperaturesTenthsCelcius[i] / 10.0f]() { this->temperature_sensor_[i]->publish_state(value); });
 		}
@@ -237,12 +300,12 @@ void PaceBmsSensor::analog_information_callback_v20(PaceBmsProtocolV20::AnalogIn
 }
 
 void PaceBmsSensor::status_information_callback_v20(PaceBmsProtocolV20::StatusInformation& status_information) {
-	for (int i = 0; i < 16; i++) {
+	for (int i = 0; i < PACE_BMS_MAX_CELL_COUNT; i++) {
 		if (this->warning_status_value_cells_sensor_[i] != nullptr) {
 			this->parent_->queue_sensor_update([this, i, value = status_information.warning_value_cell[i]]() { this->warning_status_value_cells_sensor_[i]->publish_state(value); });
 		}
 	}
-	for (int i = 0; i < 6; i++) {
+	for (int i = 0; i < PACE_BMS_MAX_TEMP_COUNT; i++) {
 		if (this->warning_status_value_temps_sensor_[i] != nullptr) {
 			this->parent_->queue_sensor_update([this, i, value = status_information.warning_value_temp[i]]() { this->warning_status_value_temps_sensor_[i]->publish_state(value); });
 		}
@@ -334,5 +397,52 @@ void PaceBmsSensor::status_information_callback_v20(PaceBmsProtocolV20::StatusIn
 	}
 }
 
+#if defined(PACE_BMS_COMMANDSET_V20) && defined(PACE_BMS_V20_VARIANT_PYLON)
+void PaceBmsSensor::charge_discharge_management_information_callback_v20(PaceBmsProtocolV20::ChargeDischargeManagementInformation& management_information) {
+	if (this->charge_voltage_limit_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = management_information.chargeVoltageLimitMillivolts / 1000.0f]() { this->charge_voltage_limit_sensor_->publish_state(value); });
+	}
+	if (this->discharge_voltage_limit_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = management_information.dischargeVoltageLimitMillivolts / 1000.0f]() { this->discharge_voltage_limit_sensor_->publish_state(value); });
+	}
+	if (this->charge_current_limit_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = management_information.chargeCurrentLimitMilliamps / 1000.0f]() { this->charge_current_limit_sensor_->publish_state(value); });
+	}
+	if (this->discharge_current_limit_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = management_information.dischargeCurrentLimitMilliamps / 1000.0f]() { this->discharge_current_limit_sensor_->publish_state(value); });
+	}
+	if (this->charge_discharge_status_value_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = management_information.status_value]() { this->charge_discharge_status_value_sensor_->publish_state(value); });
+	}
+}
+#endif
+
+void PaceBmsSensor::bus_metrics_callback(PaceBms::bus_metrics& metrics) {
+	if (this->requests_sent_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = metrics.requests_sent_]() { this->requests_sent_sensor_->publish_state(value); });
+	}
+	if (this->responses_ok_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = metrics.responses_ok_]() { this->responses_ok_sensor_->publish_state(value); });
+	}
+	if (this->timeouts_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = metrics.timeouts_]() { this->timeouts_sensor_->publish_state(value); });
+	}
+	if (this->checksum_errors_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = metrics.checksum_errors_]() { this->checksum_errors_sensor_->publish_state(value); });
+	}
+	if (this->return_code_errors_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = metrics.return_code_errors_]() { this->return_code_errors_sensor_->publish_state(value); });
+	}
+	if (this->mean_latency_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = metrics.mean_latency_ms_]() { this->mean_latency_sensor_->publish_state(value); });
+	}
+	if (this->p95_latency_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = metrics.p95_latency_ms_]() { this->p95_latency_sensor_->publish_state(value); });
+	}
+	if (this->bus_utilization_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = metrics.utilization_percent_]() { this->bus_utilization_sensor_->publish_state(value); });
+	}
+}
+
 }  // namespace pace_bms
 }  // namespace esphome
@@ -19,11 +19,11 @@ public:
 	void set_temperature_sensor(int index, sensor::Sensor* sens) { temperature_sensor_[index] = sens;    request_analog_info_callback_ = true; }
 	void set_current_sensor(sensor::Sensor* sens) { current_sensor_ = sens;               request_analog_info_callback_ = true; }
 	void set_total_voltage_sensor(sensor::Sensor* sens) { total_voltage_sensor_ = sens;         request_analog_info_callback_ = true; }
-	void set_remaining_capacity_sensor(sensor::Sensor* sens) { remaining_capacity_sensor_ = sens;    request_analog_info_callback_ = true; }
-	void set_full_capacity_sensor(sensor::Sensor* sens) { full_capacity_sensor_ = sens;         request_analog_info_callback_ = true; }
-	void set_design_capacity_sensor(sensor::Sensor* sens) { design_capacity_sensor_ = sens;       request_analog_info_callback_ = true; }
+	void set_remaining_capacity_sensor(sensor::Sensor* sens) { remaining_capacity_sensor_ = sens;    request_capacity_callback_ = true; }
+	void set_full_capacity_sensor(sensor::Sensor* sens) { full_capacity_sensor_ = sens;         request_capacity_callback_ = true; }
+	void set_design_capacity_sensor(sensor::Sensor* sens) { design_capacity_sensor_ = sens;       request_capacity_callback_ = true; }
 	void set_cycle_count_sensor(sensor::Sensor* sens) { cycle_count_sensor_ = sens;           request_analog_info_callback_ = true; }
-	void set_state_of_charge_sensor(sensor::Sensor* sens) { state_of_charge_sensor_ = sens;       request_analog_info_callback_ = true; }
+	void set_state_of_charge_sensor(sensor::Sensor* sens) { state_of_charge_sensor_ = sens;       request_capacity_callback_ = true; }
 	void set_state_of_health_sensor(sensor::Sensor* sens) { state_of_health_sensor_ = sens;       request_analog_info_callback_ = true; }
 	void set_power_sensor(sensor::Sensor* sens) { power_sensor_ = sens;                 request_analog_info_callback_ = true; }
 	void set_min_cell_voltage_sensor(sensor::Sensor* sens) { min_cell_voltage_sensor_ = sens;      request_analog_info_callback_ = true; }
@@ -70,6 +70,23 @@ public:
 	void set_remaining_capacity_value_sensor(sensor::Sensor* sens) { remaining_capacity_value_sensor_ = sens;                     request_status_info_callback_ = true; }
 	void set_fet_status_value_sensor(sensor::Sensor* sens)         { fet_status_value_sensor_ = sens;                     request_status_info_callback_ = true; }
 
+	// charge / discharge management info (PYLON)
+	void set_charge_voltage_limit_sensor(sensor::Sensor* sens)          { charge_voltage_limit_sensor_ = sens;          request_charge_discharge_management_info_callback_ = true; }
+	void set_discharge_voltage_limit_sensor(sensor::Sensor* sens)       { discharge_voltage_limit_sensor_ = sens;       request_charge_discharge_management_info_callback_ = true; }
+	void set_charge_current_limit_sensor(sensor::Sensor* sens)          { charge_current_limit_sensor_ = sens;          request_charge_discharge_management_info_callback_ = true; }
+	void set_discharge_current_limit_sensor(sensor::Sensor* sens)       { discharge_current_limit_sensor_ = sens;       request_charge_discharge_management_info_callback_ = true; }
+	void set_charge_discharge_status_value_sensor(sensor::Sensor* sens) { charge_discharge_status_value_sensor_ = sens; request_charge_discharge_management_info_callback_ = true; }
+
+	// bus metrics (diagnostic)
+	void set_requests_sent_sensor(sensor::Sensor* sens)      { requests_sent_sensor_ = sens;      request_bus_metrics_callback_ = true; }
+	void set_responses_ok_sensor(sensor::Sensor* sens)       { responses_ok_sensor_ = sens;       request_bus_metrics_callback_ = true; }
+	void set_timeouts_sensor(sensor::Sensor* sens)           { timeouts_sensor_ = sens;           request_bus_metrics_callback_ = true; }
+	void set_checksum_errors_sensor(sensor::Sensor* sens)    { checksum_errors_sensor_ = sens;    request_bus_metrics_callback_ = true; }
+	void set_return_code_errors_sensor(sensor::Sensor* sens) { return_code_errors_sensor_ = sens; request_bus_metrics_callback_ = true; }
+	void set_mean_latency_sensor(sensor::Sensor* sens)       { mean_latency_sensor_ = sens;       request_bus_metrics_callback_ = true; }
+	void set_p95_latency_sensor(sensor::Sensor* sens)        { p95_latency_sensor_ = sens;        request_bus_metrics_callback_ = true; }
+	void set_bus_utilization_sensor(sensor::Sensor* sens)    { bus_utilization_sensor_ = sens;    request_bus_metrics_callback_ = true; }
+
 	void setup() override;
 	float get_setup_priority() const override { return setup_priority::DATA; };
 	void dump_config() override;
@@ -79,9 +96,9 @@ protected:
 
 	// analog info
 	sensor::Sensor* cell_count_sensor_{ nullptr };
-	sensor::Sensor* cell_voltage_sensor_[16]{ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
+	sensor::Sensor* cell_voltage_sensor_[PACE_BMS_MAX_CELL_COUNT]{ };
 	sensor::Sensor* temperature_count_sensor_{ nullptr };
-	sensor::Sensor* temperature_sensor_[6]{ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
+	sensor::Sensor* temperature_sensor_[PACE_BMS_MAX_TEMP_COUNT]{ };
 	sensor::Sensor* current_sensor_{ nullptr };
 	sensor::Sensor* total_voltage_sensor_{ nullptr };
 	sensor::Sensor* remaining_capacity_sensor_{ nullptr };
@@ -97,8 +114,8 @@ protected:
 	sensor::Sensor* max_cell_differential_sensor_{ nullptr };
 
 	// status info
-	sensor::Sensor* warning_status_value_cells_sensor_[16]{ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
-	sensor::Sensor* warning_status_value_temps_sensor_[6]{ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
+	sensor::Sensor* warning_status_value_cells_sensor_[PACE_BMS_MAX_CELL_COUNT]{ };
+	sensor::Sensor* warning_status_value_temps_sensor_[PACE_BMS_MAX_TEMP_COUNT]{ };
 	sensor::Sensor* warning_status_value_charge_current_sensor_{ nullptr };
 	sensor::Sensor* warning_status_value_total_voltage_sensor_{ nullptr };
 	sensor::Sensor* warning_status_value_discharge_current_sensor_{ nullptr };
@@ -135,14 +152,43 @@ protected:
 	sensor::Sensor* remaining_capacity_value_sensor_{ nullptr };
 	sensor::Sensor* fet_status_value_sensor_{ nullptr };
 
+	// charge / discharge management info (PYLON)
+	sensor::Sensor* charge_voltage_limit_sensor_{ nullptr };
+	sensor::Sensor* discharge_voltage_limit_sensor_{ nullptr };
+	sensor::Sensor* charge_current_limit_sensor_{ nullptr };
+	sensor::Sensor* discharge_current_limit_sensor_{ nullptr };
+	sensor::Sensor* charge_discharge_status_value_sensor_{ nullptr };
+
+	// bus metrics (diagnostic)
+	sensor::Sensor* requests_sent_sensor_{ nullptr };
+	sensor::Sensor* responses_ok_sensor_{ nullptr };
+	sensor::Sensor* timeouts_sensor_{ nullptr };
+	sensor::Sensor* checksum_errors_sensor_{ nullptr };
+	sensor::Sensor* return_code_errors_sensor_{ nullptr };
+	sensor::Sensor* mean_latency_sensor_{ nullptr };
+	sensor::Sensor* p95_latency_sensor_{ nullptr };
+	sensor::Sensor* bus_utilization_sensor_{ nullptr };
+
 	bool request_analog_info_callback_ = false;
+	// capacity and state of charge come from analog information on v20, and from the much smaller remaining capacity request on v25
+	bool request_capacity_callback_ = false;
 	bool request_status_info_callback_ = false;
+	bool request_bus_metrics_callback_ = false;
+	bool request_charge_discharge_management_info_callback_ = false;
+	// which calculated analog values need to be decoded in order to satisfy the sensors declared in yaml
+	uint32_t get_analog_information_fields_();
 
 	void analog_information_callback_v25(PaceBmsProtocolV25::AnalogInformation& analog_information);
 	void status_information_callback_v25(PaceBmsProtocolV25::StatusInformation& status_information);
+	void remaining_capacity_callback_v25(uint32_t& remaining_capacity, uint32_t& actual_capacity, uint32_t& design_capacity);
 
 	void analog_information_callback_v20(PaceBmsProtocolV20::AnalogInformation& analog_information);
 	void status_information_callback_v20(PaceBmsProtocolV20::StatusInformation& status_information);
+#if defined(PACE_BMS_COMMANDSET_V20) && defined(PACE_BMS_V20_VARIANT_PYLON)
+	void charge_discharge_management_information_callback_v20(PaceBmsProtocolV20::ChargeDischargeManagementInformation& management_information);
+#endif
+
+	void bus_metrics_callback(PaceBms::bus_metrics& metrics);
 };
 
 }  // namespace pace_bms
@@ -11,6 +11,7 @@ static const char* const TAG = "pace_bms.switch";
 
 void PaceBmsSwitch::setup() {
 	if (this->parent_->get_protocol_commandset() == 0x25) {
+#ifdef PACE_BMS_COMMANDSET_V25
 		if (this->buzzer_alarm_switch_ != nullptr ||
 			this->led_alarm_switch_ != nullptr ||
 			this->charge_current_limiter_switch_ != nullptr ||
@@ -42,7 +43,7 @@ void PaceBmsSwitch::setup() {
 					ESP_LOGV(TAG, "'discharge_mosfet_switch': Publishing state due to update from the hardware: %s", ONOFF(state));
 					this->parent_->queue_sensor_update([this, value = state]() { this->discharge_mosfet_switch_->publish_state(value); });
 				}
-			});
+			}, PaceBmsProtocolBase::SIF_None);
 		}
 		if (this->buzzer_alarm_switch_ != nullptr) {
 			this->buzzer_alarm_switch_->add_on_write_state_callback([this](bool state) {
@@ -69,6 +70,7 @@ void PaceBmsSwitch::setup() {
 				this->parent_->write_mosfet_state_v25(PaceBmsProtocolV25::MT_Discharge, state ? PaceBmsProtocolV25::MS_Close : PaceBmsProtocolV25::MS_Open);
 			});
 		}
+#endif
 	}
 	else {
 		ESP_LOGE(TAG, "Protocol version not supported: 0x%02X", this->parent_->get_protocol_commandset());
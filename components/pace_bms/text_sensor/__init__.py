@@ -3,6 +3,7 @@ import esphome.config_validation as cv
 from esphome.components import text_sensor
 from esphome.const import (
     CONF_ID,
+    ENTITY_CATEGORY_DIAGNOSTIC,
 )
 from .. import pace_bms_ns, CONF_PACE_BMS_ID, PaceBms
 
@@ -22,6 +23,14 @@ CONF_FAULT_STATUS         = "fault_status"
 CONF_HARDWARE_VERSION     = "hardware_version"
 CONF_SERIAL_NUMBER        = "serial_number"
 
+CONF_CELL_VOLTAGES        = "cell_voltages"
+CONF_CELL_WARNING_VALUES  = "cell_warning_values"
+
+CONF_HISTORY_RECORD       = "history_record"
+
+CONF_STAGE_TIMINGS        = "stage_timings"
+CONF_COMMAND_METRICS      = "command_metrics"
+
 CONFIG_SCHEMA = cv.Schema(
     {
         cv.GenerateID(): cv.declare_id(PaceBmsTextSensor),
@@ -36,6 +45,14 @@ CONFIG_SCHEMA = cv.Schema(
 
         cv.Optional(CONF_HARDWARE_VERSION): text_sensor.text_sensor_schema(),
         cv.Optional(CONF_SERIAL_NUMBER): text_sensor.text_sensor_schema(),
+
+        cv.Optional(CONF_CELL_VOLTAGES): text_sensor.text_sensor_schema(),
+        cv.Optional(CONF_CELL_WARNING_VALUES): text_sensor.text_sensor_schema(),
+
+        cv.Optional(CONF_HISTORY_RECORD): text_sensor.text_sensor_schema(),
+
+        cv.Optional(CONF_STAGE_TIMINGS): text_sensor.text_sensor_schema(entity_category=ENTITY_CATEGORY_DIAGNOSTIC),
+        cv.Optional(CONF_COMMAND_METRICS): text_sensor.text_sensor_schema(entity_category=ENTITY_CATEGORY_DIAGNOSTIC),
     }
 )
 
@@ -77,3 +94,23 @@ async def to_code(config):
     if serial_number_config := config.get(CONF_SERIAL_NUMBER):
         sens = await text_sensor.new_text_sensor(serial_number_config)
         cg.add(var.set_serial_number_sensor(sens))
+
+    if cell_voltages_config := config.get(CONF_CELL_VOLTAGES):
+        sens = await text_sensor.new_text_sensor(cell_voltages_config)
+        cg.add(var.set_cell_voltages_sensor(sens))
+
+    if cell_warning_values_config := config.get(CONF_CELL_WARNING_VALUES):
+        sens = await text_sensor.new_text_sensor(cell_warning_values_config)
+        cg.add(var.set_cell_warning_values_sensor(sens))
+
+    if history_record_config := config.get(CONF_HISTORY_RECORD):
+        sens = await text_sensor.new_text_sensor(history_record_config)
+        cg.add(var.set_history_record_sensor(sens))
+
+    if stage_timings_config := config.get(CONF_STAGE_TIMINGS):
+        sens = await text_sensor.new_text_sensor(stage_timings_config)
+        cg.add(var.set_stage_timings_sensor(sens))
+
+    if command_metrics_config := config.get(CONF_COMMAND_METRICS):
+        sens = await text_sensor.new_text_sensor(command_metrics_config)
+        cg.add(var.set_command_metrics_sensor(sens))
@@ -1,3 +1,4 @@
+#include <cinttypes>
 #include <functional>
 
 #include "esphome/core/log.h"
@@ -9,8 +10,36 @@ namespace pace_bms {
 
 static const char* const TAG = "pace_bms.textsensor";
 
+// "v1,v2,v3..." packed into a single state so that a pack's worth of cells goes out as one API message per poll rather than one per cell, 
+//     32 cells of "NNNN," still fits within the 255 character limit for text sensor state
+template<typename T> static std::string join_cell_values(const T* values, uint8_t count) {
+	std::string value;
+	char buf[8];
+	for (int i = 0; i < count; i++) {
+		snprintf(buf, sizeof(buf), "%s%u", i == 0 ? "" : ",", (unsigned)values[i]);
+		value.append(buf);
+	}
+	return value;
+}
+
 void PaceBmsTextSensor::setup() {
+	// only ask the decoder to build the status text that we're actually going to publish
+	uint32_t status_fields = PaceBmsProtocolBase::SIF_None;
+	if (this->warning_status_sensor_ != nullptr)
+		status_fields |= PaceBmsProtocolBase::SIF_WarningText;
+	if (this->balancing_status_sensor_ != nullptr)
+		status_fields |= PaceBmsProtocolBase::SIF_BalancingText;
+	if (this->system_status_sensor_ != nullptr)
+		status_fields |= PaceBmsProtocolBase::SIF_SystemText;
+	if (this->configuration_status_sensor_ != nullptr)
+		status_fields |= PaceBmsProtocolBase::SIF_ConfigurationText;
+	if (this->protection_status_sensor_ != nullptr)
+		status_fields |= PaceBmsProtocolBase::SIF_ProtectionText;
+	if (this->fault_status_sensor_ != nullptr)
+		status_fields |= PaceBmsProtocolBase::SIF_FaultText;
+
 	if (this->parent_->get_protocol_commandset() == 0x25) {
+#ifdef PACE_BMS_COMMANDSET_V25
 		if (this->warning_status_sensor_ != nullptr ||
 			this->balancing_status_sensor_ != nullptr ||
 			this->system_status_sensor_ != nullptr ||
@@ -36,7 +65,7 @@ void PaceBmsTextSensor::setup() {
 				if (this->fault_status_sensor_ != nullptr) {
 					this->parent_->queue_sensor_update([this, value = status_information.faultText]() { this->fault_status_sensor_->publish_state(value); });
 				}
-			});
+			}, status_fields);
 		}
 		if (this->hardware_version_sensor_ != nullptr) {
 			this->parent_->register_hardware_version_callback_v25([this](std::string& hardware_version) {
@@ -52,8 +81,50 @@ void PaceBmsTextSensor::setup() {
 				}
 			});
 		}
+		if (this->cell_voltages_sensor_ != nullptr || this->cell_warning_values_sensor_ != nullptr) {
+			this->parent_->register_analog_information_callback_v25([this](PaceBmsProtocolV25::AnalogInformation& analog_information) {
+				this->cell_count_ = analog_information.cellCount < PaceBmsProtocolV25::MAX_CELL_COUNT ? analog_information.cellCount : (uint8_t)PaceBmsProtocolV25::MAX_CELL_COUNT;
+				if (this->cell_voltages_sensor_ != nullptr) {
+					this->parent_->queue_sensor_update([this, value = join_cell_values(analog_information.cellVoltagesMillivolts, this->cell_count_)]() { this->cell_voltages_sensor_->publish_state(value); });
+				}
+			}, this->cell_voltages_sensor_ != nullptr ? PaceBmsProtocolBase::AIF_CellVoltages : PaceBmsProtocolBase::AIF_None);
+		}
+		if (this->cell_warning_values_sensor_ != nullptr) {
+			this->parent_->register_status_information_callback_v25([this](PaceBmsProtocolV25::StatusInformation& status_information) {
+				// until the first analog response arrives report every slot rather than nothing
+				uint8_t count = this->cell_count_ != 0 ? this->cell_count_ : (uint8_t)PaceBmsProtocolV25::MAX_CELL_COUNT;
+				this->parent_->queue_sensor_update([this, value = join_cell_values(status_information.warning_value_cell, count)]() { this->cell_warning_values_sensor_->publish_state(value); });
+			}, PaceBmsProtocolBase::SIF_None);
+		}
+		if (this->history_record_sensor_ != nullptr) {
+			this->parent_->register_history_record_callback_v25([this](PaceBmsProtocolV25::HistoryRecord& record) {
+				if (this->history_record_sensor_ != nullptr) {
+					// "date time, current, voltage, remaining/full capacity, min-max cell, temperatures, status" kept terse to fit within 
+					//     the 255 character limit for text sensor state
+					char buf[96];
+					snprintf(buf, sizeof(buf), "%04u-%02u-%02u %02u:%02u:%02u, %.2f A, %.3f V, %.2f/%.2f Ah, cell %u-%u mV, temp",
+						record.dateTime.Year, record.dateTime.Month, record.dateTime.Day, record.dateTime.Hour, record.dateTime.Minute, record.dateTime.Second,
+						record.currentMilliamps / 1000.0f, record.totalVoltageMillivolts / 1000.0f,
+						record.remainingCapacityMilliampHours / 1000.0f, record.fullCapacityMilliampHours / 1000.0f,
+						record.minCellVoltageMillivolts, record.maxCellVoltageMillivolts);
+					std::string value(buf);
+					for (int i = 0; i < record.temperatureCount && i < PaceBmsProtocolV25::MAX_TEMP_COUNT; i++) {
+						snprintf(buf, sizeof(buf), " %.1f", record.temperaturesTenthsCelcius[i] / 10.0f);
+						value.append(buf);
+					}
+					value.append(" C, status ");
+					for (uint8_t status_byte : record.statusBytes) {
+						snprintf(buf, sizeof(buf), "%02X", status_byte);
+						value.append(buf);
+					}
+					this->parent_->queue_sensor_update([this, value]() { this->history_record_sensor_->publish_state(value); });
+				}
+			});
+		}
+#endif
 	}
 	else if (this->parent_->get_protocol_commandset() == 0x20) {
+#ifdef PACE_BMS_COMMANDSET_V20
 		if (this->warning_status_sensor_ != nullptr ||
 			this->balancing_status_sensor_ != nullptr ||
 			this->system_status_sensor_ != nullptr ||
@@ -79,7 +150,7 @@ void PaceBmsTextSensor::setup() {
 				if (this->fault_status_sensor_ != nullptr) {
 					this->parent_->queue_sensor_update([this, value = status_information.faultText]() { this->fault_status_sensor_->publish_state(value); });
 				}
-			});
+			}, status_fields);
 		}
 		if (this->hardware_version_sensor_ != nullptr) {
 			this->parent_->register_hardware_version_callback_v20([this](std::string& hardware_version) {
@@ -95,10 +166,59 @@ void PaceBmsTextSensor::setup() {
 				}
 			});
 		}
+		if (this->cell_voltages_sensor_ != nullptr || this->cell_warning_values_sensor_ != nullptr) {
+			this->parent_->register_analog_information_callback_v20([this](PaceBmsProtocolV20::AnalogInformation& analog_information) {
+				this->cell_count_ = analog_information.cellCount < PaceBmsProtocolV20::MAX_CELL_COUNT ? analog_information.cellCount : (uint8_t)PaceBmsProtocolV20::MAX_CELL_COUNT;
+				if (this->cell_voltages_sensor_ != nullptr) {
+					this->parent_->queue_sensor_update([this, value = join_cell_values(analog_information.cellVoltagesMillivolts, this->cell_count_)]() { this->cell_voltages_sensor_->publish_state(value); });
+				}
+			}, this->cell_voltages_sensor_ != nullptr ? PaceBmsProtocolBase::AIF_CellVoltages : PaceBmsProtocolBase::AIF_None);
+		}
+		if (this->cell_warning_values_sensor_ != nullptr) {
+			this->parent_->register_status_information_callback_v20([this](PaceBmsProtocolV20::StatusInformation& status_information) {
+				// until the first analog response arrives report every slot rather than nothing
+				uint8_t count = this->cell_count_ != 0 ? this->cell_count_ : (uint8_t)PaceBmsProtocolV20::MAX_CELL_COUNT;
+				this->parent_->queue_sensor_update([this, value = join_cell_values(status_information.warning_value_cell, count)]() { this->cell_warning_values_sensor_->publish_state(value); });
+			}, PaceBmsProtocolBase::SIF_None);
+		}
+#endif
 	}
 	else {
 		ESP_LOGE(TAG, "Protocol version not supported: 0x%02X", this->parent_->get_protocol_commandset());
 	}
+
+	// not protocol specific
+	if (this->stage_timings_sensor_ != nullptr) {
+		this->parent_->register_profiler_callback([this](PaceBms::profiler_stats& stats) {
+			// "stage min/avg/max" in microseconds, kept terse to fit within the 255 character limit for text sensor state
+			std::string value;
+			char buf[48];
+			for (int i = 0; i < PaceBms::PROFILER_STAGE_COUNT; i++) {
+				const PaceBms::profiler_stage_stats& stage = stats.stages_[i];
+				snprintf(buf, sizeof(buf), "%s%s %" PRIu32 "/%" PRIu32 "/%" PRIu32, i == 0 ? "" : ", ",
+					PaceBms::profiler_stage_to_string((PaceBms::profiler_stage)i), stage.min_us_, stage.count_ == 0 ? (uint32_t)0 : stage.total_us_ / stage.count_, stage.max_us_);
+				value.append(buf);
+			}
+			this->parent_->queue_sensor_update([this, value]() { this->stage_timings_sensor_->publish_state(value); });
+		});
+	}
+	if (this->command_metrics_sensor_ != nullptr) {
+		this->parent_->register_command_metrics_callback([this](const std::map<std::string, PaceBms::bus_metrics>& metrics) {
+			// "command ok/sent mean-latency" per command, stopping short of the 255 character limit for text sensor state, so the
+			//     commands last in alphabetical order are the ones left off, the VERBOSE log has all of them
+			std::string value;
+			char buf[96];
+			for (auto& it : metrics) {
+				const PaceBms::bus_metrics& m = it.second;
+				int len = snprintf(buf, sizeof(buf), "%s%s %" PRIu32 "/%" PRIu32 " %" PRIu32 "ms", value.empty() ? "" : ", ",
+					it.first.c_str(), m.responses_ok_, m.requests_sent_, m.responses_ok_ == 0 ? (uint32_t)0 : m.latency_sum_ms_ / m.responses_ok_);
+				if (len < 0 || len >= (int)sizeof(buf) || value.size() + len > 255)
+					break;
+				value.append(buf);
+			}
+			this->parent_->queue_sensor_update([this, value]() { this->command_metrics_sensor_->publish_state(value); });
+		});
+	}
 }
 
 void PaceBmsTextSensor::dump_config() {
@@ -111,6 +231,11 @@ void PaceBmsTextSensor::dump_config() {
 	LOG_TEXT_SENSOR("  ", "Fault Status", this->fault_status_sensor_);
 	LOG_TEXT_SENSOR("  ", "Hardware Version", this->hardware_version_sensor_);
 	LOG_TEXT_SENSOR("  ", "Serial Number", this->serial_number_sensor_);
+	LOG_TEXT_SENSOR("  ", "Cell Voltages", this->cell_voltages_sensor_);
+	LOG_TEXT_SENSOR("  ", "Cell Warning Values", this->cell_warning_values_sensor_);
+	LOG_TEXT_SENSOR("  ", "History Record", this->history_record_sensor_);
+	LOG_TEXT_SENSOR("  ", "Stage Timings", this->stage_timings_sensor_);
+	LOG_TEXT_SENSOR("  ", "Command Metrics", this->command_metrics_sensor_);
 }
 
 }  // namespace pace_bms
@@ -21,6 +21,14 @@ public:
 	void set_hardware_version_sensor(text_sensor::TextSensor* hardware_version_sensor) { hardware_version_sensor_ = hardware_version_sensor; }
 	void set_serial_number_sensor(text_sensor::TextSensor* serial_number_sensor) { serial_number_sensor_ = serial_number_sensor; }
 
+	void set_cell_voltages_sensor(text_sensor::TextSensor* cell_voltages_sensor) { cell_voltages_sensor_ = cell_voltages_sensor; }
+	void set_cell_warning_values_sensor(text_sensor::TextSensor* cell_warning_values_sensor) { cell_warning_values_sensor_ = cell_warning_values_sensor; }
+
+	void set_history_record_sensor(text_sensor::TextSensor* history_record_sensor) { history_record_sensor_ = history_record_sensor; }
+
+	void set_stage_timings_sensor(text_sensor::TextSensor* stage_timings_sensor) { stage_timings_sensor_ = stage_timings_sensor; }
+	void set_command_metrics_sensor(text_sensor::TextSensor* command_metrics_sensor) { command_metrics_sensor_ = command_metrics_sensor; }
+
 	void setup() override;
 	float get_setup_priority() const override { return setup_priority::DATA; };
 	void dump_config() override;
@@ -36,6 +44,16 @@ protected:
 
 	text_sensor::TextSensor* hardware_version_sensor_{ nullptr };
 	text_sensor::TextSensor* serial_number_sensor_{ nullptr };
+
+	text_sensor::TextSensor* cell_voltages_sensor_{ nullptr };
+	text_sensor::TextSensor* cell_warning_values_sensor_{ nullptr };
+	// the status response doesn't say how many cells are actually present, so borrow it from the last analog response
+	uint8_t cell_count_{ 0 };
+
+	text_sensor::TextSensor* history_record_sensor_{ nullptr };
+
+	text_sensor::TextSensor* stage_timings_sensor_{ nullptr };
+	text_sensor::TextSensor* command_metrics_sensor_{ nullptr };
 };
 
 }  // namespace pace_bms
@@ -0,0 +1,54 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.const import (
+    CONF_ID,
+)
+from esphome.components.pace_bms import pace_bms_ns, PaceBms
+
+CODEOWNERS = ["@nkinnan"]
+
+DEPENDENCIES = ["pace_bms"]
+
+PaceBmsBank = pace_bms_ns.class_("PaceBmsBank", cg.PollingComponent)
+
+# "this" for pace_bms_bank sensors to get parent from
+CONF_PACE_BMS_BANK_ID = "pace_bms_bank_id"
+
+
+CONF_PACE_BMS_IDS                = "pace_bms_ids"
+CONF_PACK_TIMEOUT                = "pack_timeout"
+CONF_PYLON_STACK_REQUESTS        = "pylon_stack_requests"
+
+
+DEFAULT_PACK_TIMEOUT = "5min"
+
+
+def validate_pylon_stack_requests(config):
+    if config[CONF_PYLON_STACK_REQUESTS] and len(config[CONF_PACE_BMS_IDS]) != 1:
+        raise cv.Invalid(f"{CONF_PYLON_STACK_REQUESTS} requires exactly one entry in {CONF_PACE_BMS_IDS}, the master pack of the stack")
+    return config
+
+CONFIG_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.GenerateID(): cv.declare_id(PaceBmsBank),
+
+            cv.Required(CONF_PACE_BMS_IDS): cv.All(cv.ensure_list(cv.use_id(PaceBms)), cv.Length(min=1, max=32)),
+            cv.Optional(CONF_PACK_TIMEOUT, default=DEFAULT_PACK_TIMEOUT): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_PYLON_STACK_REQUESTS, default=False): cv.boolean,
+        }
+    )
+    .extend(cv.polling_component_schema("10s")),
+    validate_pylon_stack_requests,
+)
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+
+    for pace_bms_id in config[CONF_PACE_BMS_IDS]:
+        pack = await cg.get_variable(pace_bms_id)
+        cg.add(var.add_pack(pack))
+    if CONF_PACK_TIMEOUT in config:
+        cg.add(var.set_pack_timeout(config[CONF_PACK_TIMEOUT]))
+    cg.add(var.set_pylon_stack_requests(config[CONF_PYLON_STACK_REQUESTS]))
@@ -0,0 +1,199 @@
+#include <cinttypes>
+#include <functional>
+
+#include "esphome/core/log.h"
+#include "pace_bms_bank.h"
+
+namespace esphome {
+namespace pace_bms {
+
+static const char* const TAG = "pace_bms_bank";
+
+/*
+* log configuration
+*/
+
+void PaceBmsBank::dump_config() {
+	ESP_LOGCONFIG(TAG, "pace_bms_bank:");
+	ESP_LOGCONFIG(TAG, "  Packs: %i", (int) this->packs_.size());
+	ESP_LOGCONFIG(TAG, "  Pack Timeout (ms): %" PRIu32, this->pack_timeout_);
+	ESP_LOGCONFIG(TAG, "  PYLON Stack Requests: %s", this->pylon_stack_requests_ ? "true" : "false");
+}
+
+/*
+* setup this component
+*/
+
+void PaceBmsBank::setup() {
+	// only the values we actually aggregate, the min/max cell is found here rather than by the decoder since we need to know which cell it was
+	uint32_t analog_fields = PaceBmsProtocolBase::AIF_CellVoltages | PaceBmsProtocolBase::AIF_Temperatures | PaceBmsProtocolBase::AIF_Power;
+
+	if (this->pylon_stack_requests_) {
+#if defined(PACE_BMS_COMMANDSET_V20) && defined(PACE_BMS_V20_VARIANT_PYLON)
+		this->packs_[0]->register_system_analog_information_callback_v20([this](std::vector<PaceBmsProtocolV20::AnalogInformation>& analog_information) {
+			this->ensure_pack_snapshots_(analog_information.size());
+			for (uint8_t i = 0; i < analog_information.size(); i++)
+				this->analog_information_callback_(i, analog_information[i]);
+		}, analog_fields);
+#else
+		ESP_LOGE(TAG, "pylon_stack_requests requires support for protocol version 0x20 variant PYLON to be compiled in");
+#endif
+		return;
+	}
+
+	for (uint8_t i = 0; i < this->packs_.size(); i++) {
+		PaceBms* pack = this->packs_[i];
+		if (pack->get_protocol_commandset() == 0x25) {
+#ifdef PACE_BMS_COMMANDSET_V25
+			pack->register_analog_information_callback_v25([this, i](PaceBmsProtocolV25::AnalogInformation& analog_information) { this->analog_information_callback_(i, analog_information); }, analog_fields);
+#endif
+		}
+		else if (pack->get_protocol_commandset() == 0x20) {
+#ifdef PACE_BMS_COMMANDSET_V20
+			pack->register_analog_information_callback_v20([this, i](PaceBmsProtocolV20::AnalogInformation& analog_information) { this->analog_information_callback_(i, analog_information); }, analog_fields);
+#endif
+		}
+		else {
+			ESP_LOGE(TAG, "Protocol version not supported: 0x%02X", pack->get_protocol_commandset());
+		}
+	}
+}
+
+// registration with PaceBms is allowed after setup(), it just misses an update cycle, so this doesn't need to happen before our setup()
+void PaceBmsBank::enable_alarm_tracking() {
+	if (this->alarm_tracking_enabled_)
+		return;
+	this->alarm_tracking_enabled_ = true;
+
+	if (this->pylon_stack_requests_) {
+#if defined(PACE_BMS_COMMANDSET_V20) && defined(PACE_BMS_V20_VARIANT_PYLON)
+		this->packs_[0]->register_system_status_information_callback_v20([this](std::vector<PaceBmsProtocolV20::StatusInformation>& status_information) {
+			this->ensure_pack_snapshots_(status_information.size());
+			for (uint8_t i = 0; i < status_information.size(); i++)
+				this->pack_snapshots_[i].alarm_ = !status_information[i].protectionText.empty() || !status_information[i].faultText.empty();
+		}, PaceBmsProtocolBase::SIF_ProtectionText | PaceBmsProtocolBase::SIF_FaultText);
+#endif
+		return;
+	}
+
+	for (uint8_t i = 0; i < this->packs_.size(); i++) {
+		PaceBms* pack = this->packs_[i];
+		if (pack->get_protocol_commandset() == 0x25) {
+#ifdef PACE_BMS_COMMANDSET_V25
+			pack->register_status_information_callback_v25([this, i](PaceBmsProtocolV25::StatusInformation& status_information) {
+				this->pack_snapshots_[i].alarm_ = status_information.protection_value1 != 0 || status_information.protection_value2 != 0 || status_information.fault_value != 0;
+			}, PaceBmsProtocolBase::SIF_None);
+#endif
+		}
+		else if (pack->get_protocol_commandset() == 0x20) {
+#ifdef PACE_BMS_COMMANDSET_V20
+			// v20 variants scatter protection and fault flags across different status bytes so rely on the decoder's text for those
+			pack->register_status_information_callback_v20([this, i](PaceBmsProtocolV20::StatusInformation& status_information) {
+				this->pack_snapshots_[i].alarm_ = !status_information.protectionText.empty() || !status_information.faultText.empty();
+			}, PaceBmsProtocolBase::SIF_ProtectionText | PaceBmsProtocolBase::SIF_FaultText);
+#endif
+		}
+	}
+}
+
+/*
+* combine the latest snapshot from each pack and hand the result to child sensors
+*/
+
+void PaceBmsBank::update() {
+	const uint32_t now = millis();
+
+	bank_information bank;
+	uint32_t total_voltage_millivolts = 0;
+	int32_t current_milliamps = 0;
+	uint32_t remaining_capacity_milliamp_hours = 0;
+	uint32_t full_capacity_milliamp_hours = 0;
+	uint16_t min_cell_voltage_millivolts = 0;
+	uint16_t max_cell_voltage_millivolts = 0;
+	int16_t min_temperature_tenths_celsius = 0;
+	int16_t max_temperature_tenths_celsius = 0;
+	uint8_t temperature_pack_count = 0;
+
+	for (uint8_t i = 0; i < this->pack_snapshots_.size(); i++) {
+		const pack_snapshot& snapshot = this->pack_snapshots_[i];
+		if (!snapshot.valid_)
+			continue;
+		if (now - snapshot.last_update_ > this->pack_timeout_) {
+			ESP_LOGV(TAG, "Pack %i has not reported in %" PRIu32 " ms, leaving it out", i + 1, now - snapshot.last_update_);
+			continue;
+		}
+
+		bank.pack_count_++;
+		if (snapshot.alarm_)
+			bank.alarm_pack_count_++;
+
+		current_milliamps += snapshot.current_milliamps_;
+		bank.power_watts_ += snapshot.power_watts_;
+		total_voltage_millivolts += snapshot.total_voltage_millivolts_;
+		remaining_capacity_milliamp_hours += snapshot.remaining_capacity_milliamp_hours_;
+		full_capacity_milliamp_hours += snapshot.full_capacity_milliamp_hours_;
+
+		if (bank.pack_count_ == 1 || snapshot.min_cell_voltage_millivolts_ < min_cell_voltage_millivolts) {
+			min_cell_voltage_millivolts = snapshot.min_cell_voltage_millivolts_;
+			bank.min_cell_voltage_pack_ = i + 1;
+			bank.min_cell_voltage_cell_ = snapshot.min_cell_voltage_cell_;
+		}
+		if (bank.pack_count_ == 1 || snapshot.max_cell_voltage_millivolts_ > max_cell_voltage_millivolts) {
+			max_cell_voltage_millivolts = snapshot.max_cell_voltage_millivolts_;
+			bank.max_cell_voltage_pack_ = i + 1;
+			bank.max_cell_voltage_cell_ = snapshot.max_cell_voltage_cell_;
+		}
+
+		if (snapshot.temperature_count_ > 0) {
+			temperature_pack_count++;
+			if (temperature_pack_count == 1 || snapshot.min_temperature_tenths_celsius_ < min_temperature_tenths_celsius) {
+				min_temperature_tenths_celsius = snapshot.min_temperature_tenths_celsius_;
+				bank.min_temperature_pack_ = i + 1;
+			}
+			if (temperature_pack_count == 1 || snapshot.max_temperature_tenths_celsius_ > max_temperature_tenths_celsius) {
+				max_temperature_tenths_celsius = snapshot.max_temperature_tenths_celsius_;
+				bank.max_temperature_pack_ = i + 1;
+			}
+		}
+	}
+
+	if (bank.pack_count_ == 0) {
+		ESP_LOGW(TAG, "No packs have reported within pack_timeout, nothing to publish");
+		return;
+	}
+
+	bank.current_amps_ = current_milliamps / 1000.0f;
+	bank.voltage_volts_ = (total_voltage_millivolts / bank.pack_count_) / 1000.0f;
+	bank.remaining_capacity_amp_hours_ = remaining_capacity_milliamp_hours / 1000.0f;
+	bank.full_capacity_amp_hours_ = full_capacity_milliamp_hours / 1000.0f;
+	// weighted by capacity, so a small pack at 10% doesn't drag the bank down as much as a large one would
+	if (full_capacity_milliamp_hours != 0)
+		bank.state_of_charge_ = ((float)remaining_capacity_milliamp_hours / full_capacity_milliamp_hours) * 100.0f;
+	bank.min_cell_voltage_volts_ = min_cell_voltage_millivolts / 1000.0f;
+	bank.max_cell_voltage_volts_ = max_cell_voltage_millivolts / 1000.0f;
+	bank.max_cell_differential_volts_ = (max_cell_voltage_millivolts - min_cell_voltage_millivolts) / 1000.0f;
+	bank.min_temperature_celsius_ = min_temperature_tenths_celsius / 10.0f;
+	bank.max_temperature_celsius_ = max_temperature_tenths_celsius / 10.0f;
+
+	ESP_LOGD(TAG, "Bank of %i packs: %.2f A, %.1f%% SoC, min cell %.3f V (pack %i cell %i), max cell %.3f V (pack %i cell %i)",
+		bank.pack_count_, bank.current_amps_, bank.state_of_charge_,
+		bank.min_cell_voltage_volts_, bank.min_cell_voltage_pack_, bank.min_cell_voltage_cell_,
+		bank.max_cell_voltage_volts_, bank.max_cell_voltage_pack_, bank.max_cell_voltage_cell_);
+
+	// dispatch to any child components that registered for a callback with us
+	for (int i = 0; i < this->bank_information_callbacks_.size(); i++) {
+		bank_information_callbacks_[i](bank);
+	}
+}
+
+// update a single sensor per loop, same as PaceBms, to avoid excessive loop times with many sensors
+void PaceBmsBank::loop() {
+	if (this->sensor_update_queue_.size() != 0) {
+		std::function<void()> sensor_update_method = this->sensor_update_queue_.front();
+		this->sensor_update_queue_.pop();
+		sensor_update_method();
+	}
+}
+
+}  // namespace pace_bms
+}  // namespace esphome
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <queue>
+
+#include "esphome/core/component.h"
+
+#include "esphome/components/pace_bms/pace_bms_component.h"
+
+namespace esphome {
+namespace pace_bms {
+
+// aggregates the analog (and optionally status) information of several PaceBms instances that make up a single bank / rack 
+//     into a handful of bank-level values, so that summing, weighting, and searching for the weakest cell happens on-device 
+//     rather than in home assistant templates fed by hundreds of per-pack entities
+class PaceBmsBank : public PollingComponent {
+public:
+	// called by the codegen to set our YAML property values
+	void add_pack(PaceBms* pack) { this->packs_.push_back(pack); this->pack_snapshots_.push_back(pack_snapshot()); }
+	void set_pack_timeout(uint32_t pack_timeout) { this->pack_timeout_ = pack_timeout; }
+	void set_pylon_stack_requests(bool pylon_stack_requests) { this->pylon_stack_requests_ = pylon_stack_requests; }
+
+	// the bank-level values calculated each update(), pack and cell "indexes" are 1-based to match the rest of this component's 
+	//     naming (pack 1 is the first entry of pace_bms_ids, cell 1 is cell_voltage_01)
+	struct bank_information
+	{
+		uint8_t  pack_count_{ 0 };       // packs that have reported within pack_timeout, only these are included below
+		uint8_t  alarm_pack_count_{ 0 }; // of those, how many are reporting a protection or fault condition
+
+		float    current_amps_{ 0 };
+		float    power_watts_{ 0 };
+		float    voltage_volts_{ 0 };    // average, packs in a bank are in parallel
+		float    remaining_capacity_amp_hours_{ 0 };
+		float    full_capacity_amp_hours_{ 0 };
+		float    state_of_charge_{ 0 };  // capacity weighted, in percent
+
+		float    min_cell_voltage_volts_{ 0 };
+		uint8_t  min_cell_voltage_pack_{ 0 };
+		uint8_t  min_cell_voltage_cell_{ 0 };
+		float    max_cell_voltage_volts_{ 0 };
+		uint8_t  max_cell_voltage_pack_{ 0 };
+		uint8_t  max_cell_voltage_cell_{ 0 };
+		float    max_cell_differential_volts_{ 0 };
+
+		float    min_temperature_celsius_{ 0 };
+		uint8_t  min_temperature_pack_{ 0 };
+		float    max_temperature_celsius_{ 0 };
+		uint8_t  max_temperature_pack_{ 0 };
+	};
+
+	// child sensors call this to be handed the bank information once per update()
+	void register_bank_information_callback(std::function<void(bank_information&)> callback) { bank_information_callbacks_.push_back(std::move(callback)); }
+	// child sensors call this if they need alarm_pack_count, which costs an additional status information request per pack
+	void enable_alarm_tracking();
+
+	void queue_sensor_update(std::function<void()> update) { this->sensor_update_queue_.push(update); }
+
+	// standard overrides to implement component behavior
+	void dump_config() override;
+	void setup() override;
+	void update() override;
+	void loop() override;
+
+	// needs to register callbacks with the PaceBms instances, which are LATE
+	float get_setup_priority() const override { return setup_priority::DATA; }
+
+protected:
+	// config values set in YAML
+	std::vector<PaceBms*> packs_;
+	uint32_t pack_timeout_{ 0 };
+	// the single pack is the master of a PYLON stack, read every pack through it with one request each for analog and status
+	bool pylon_stack_requests_{ false };
+
+	// the most recent values received from each pack, already reduced to what the bank needs
+	struct pack_snapshot
+	{
+		uint32_t last_update_{ 0 };
+		bool     valid_{ false };
+		bool     alarm_{ false };
+
+		int32_t  current_milliamps_{ 0 };
+		float    power_watts_{ 0 };
+		uint32_t total_voltage_millivolts_{ 0 };
+		uint32_t remaining_capacity_milliamp_hours_{ 0 };
+		uint32_t full_capacity_milliamp_hours_{ 0 };
+
+		uint16_t min_cell_voltage_millivolts_{ 0 };
+		uint8_t  min_cell_voltage_cell_{ 0 };
+		uint16_t max_cell_voltage_millivolts_{ 0 };
+		uint8_t  max_cell_voltage_cell_{ 0 };
+
+		uint8_t  temperature_count_{ 0 };
+		int16_t  min_temperature_tenths_celsius_{ 0 };
+		int16_t  max_temperature_tenths_celsius_{ 0 };
+	};
+	std::vector<pack_snapshot> pack_snapshots_;
+	// with pylon_stack_requests the number of packs isn't known until the master answers
+	void ensure_pack_snapshots_(size_t count) { if (this->pack_snapshots_.size() < count) this->pack_snapshots_.resize(count); }
+
+	// PaceBmsProtocolV25::AnalogInformation and PaceBmsProtocolV20::AnalogInformation have the same layout as far as we're concerned
+	template<typename AnalogInformation>
+	void analog_information_callback_(uint8_t pack_index, AnalogInformation& analog_information) {
+		pack_snapshot& snapshot = this->pack_snapshots_[pack_index];
+		snapshot.last_update_ = millis();
+		snapshot.valid_ = true;
+
+		snapshot.current_milliamps_ = analog_information.currentMilliamps;
+		snapshot.power_watts_ = analog_information.powerWatts;
+		snapshot.total_voltage_millivolts_ = analog_information.totalVoltageMillivolts;
+		snapshot.remaining_capacity_milliamp_hours_ = analog_information.remainingCapacityMilliampHours;
+		snapshot.full_capacity_milliamp_hours_ = analog_information.fullCapacityMilliampHours;
+
+		// the decoder's own min/max doesn't say which cell, so find them here
+		snapshot.min_cell_voltage_millivolts_ = 0;
+		snapshot.max_cell_voltage_millivolts_ = 0;
+		for (uint8_t i = 0; i < analog_information.cellCount && i < PACE_BMS_MAX_CELL_COUNT; i++) {
+			uint16_t cell = analog_information.cellVoltagesMillivolts[i];
+			if (i == 0 || cell < snapshot.min_cell_voltage_millivolts_) {
+				snapshot.min_cell_voltage_millivolts_ = cell;
+				snapshot.min_cell_voltage_cell_ = i + 1;
+			}
+			if (i == 0 || cell > snapshot.max_cell_voltage_millivolts_) {
+				snapshot.max_cell_voltage_millivolts_ = cell;
+				snapshot.max_cell_voltage_cell_ = i + 1;
+			}
+		}
+
+		snapshot.temperature_count_ = analog_information.temperatureCount;
+		for (uint8_t i = 0; i < analog_information.temperatureCount && i < PACE_BMS_MAX_TEMP_COUNT; i++) {
+			int16_t temperature = analog_information.temperaturesTenthsCelcius[i];
+			if (i == 0 || temperature < snapshot.min_temperature_tenths_celsius_)
+				snapshot.min_temperature_tenths_celsius_ = temperature;
+			if (i == 0 || temperature > snapshot.max_temperature_tenths_celsius_)
+				snapshot.max_temperature_tenths_celsius_ = temperature;
+		}
+	}
+
+	std::vector<std::function<void(bank_information&)>> bank_information_callbacks_;
+	bool alarm_tracking_enabled_{ false };
+
+	// publish a single sensor per loop, same as PaceBms
+	std::queue<std::function<void()>> sensor_update_queue_;
+};
+
+}  // namespace pace_bms
+}  // namespace esphome
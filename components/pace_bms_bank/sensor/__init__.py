@@ -0,0 +1,234 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor
+from esphome.const import (
+    CONF_ID,
+    DEVICE_CLASS_VOLTAGE,
+    DEVICE_CLASS_TEMPERATURE,
+    DEVICE_CLASS_CURRENT,
+    DEVICE_CLASS_POWER,
+    DEVICE_CLASS_BATTERY,
+    STATE_CLASS_MEASUREMENT,
+    UNIT_VOLT,
+    UNIT_CELSIUS,
+    UNIT_AMPERE,
+    UNIT_WATT,
+    UNIT_PERCENT,
+)
+from .. import pace_bms_ns, CONF_PACE_BMS_BANK_ID, PaceBmsBank
+
+UNIT_AMP_HOURS = "Ah" # todo: use existing
+
+CODEOWNERS = ["@nkinnan"]
+
+DEPENDENCIES = ["pace_bms_bank"]
+
+PaceBmsBankSensor = pace_bms_ns.class_("PaceBmsBankSensor", cg.Component)
+
+CONF_PACK_COUNT                 = "pack_count"
+CONF_ALARM_PACK_COUNT           = "alarm_pack_count"
+CONF_CURRENT                    = "current"
+CONF_POWER                      = "power"
+CONF_VOLTAGE                    = "voltage"
+CONF_REMAINING_CAPACITY         = "remaining_capacity"
+CONF_FULL_CAPACITY              = "full_capacity"
+CONF_STATE_OF_CHARGE            = "state_of_charge"
+CONF_MIN_CELL_VOLTAGE           = "min_cell_voltage"
+CONF_MIN_CELL_VOLTAGE_PACK      = "min_cell_voltage_pack"
+CONF_MIN_CELL_VOLTAGE_CELL      = "min_cell_voltage_cell"
+CONF_MAX_CELL_VOLTAGE           = "max_cell_voltage"
+CONF_MAX_CELL_VOLTAGE_PACK      = "max_cell_voltage_pack"
+CONF_MAX_CELL_VOLTAGE_CELL      = "max_cell_voltage_cell"
+CONF_MAX_CELL_DIFFERENTIAL      = "max_cell_differential"
+CONF_MIN_TEMPERATURE            = "min_temperature"
+CONF_MIN_TEMPERATURE_PACK       = "min_temperature_pack"
+CONF_MAX_TEMPERATURE            = "max_temperature"
+CONF_MAX_TEMPERATURE_PACK       = "max_temperature_pack"
+
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(PaceBmsBankSensor),
+        cv.GenerateID(CONF_PACE_BMS_BANK_ID): cv.use_id(PaceBmsBank),
+
+        cv.Optional(CONF_PACK_COUNT): sensor.sensor_schema(
+            #unit_of_measurement=,
+            accuracy_decimals=0,
+            #device_class=,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_ALARM_PACK_COUNT): sensor.sensor_schema(
+            #unit_of_measurement=,
+            accuracy_decimals=0,
+            #device_class=,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_CURRENT): sensor.sensor_schema(
+            unit_of_measurement=UNIT_AMPERE,
+            accuracy_decimals=2,
+            device_class=DEVICE_CLASS_CURRENT,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_POWER): sensor.sensor_schema(
+            unit_of_measurement=UNIT_WATT,
+            accuracy_decimals=1,
+            device_class=DEVICE_CLASS_POWER,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_VOLTAGE): sensor.sensor_schema(
+            unit_of_measurement=UNIT_VOLT,
+            accuracy_decimals=2,
+            device_class=DEVICE_CLASS_VOLTAGE,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_REMAINING_CAPACITY): sensor.sensor_schema(
+            unit_of_measurement=UNIT_AMP_HOURS,
+            accuracy_decimals=2,
+            #device_class=,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_FULL_CAPACITY): sensor.sensor_schema(
+            unit_of_measurement=UNIT_AMP_HOURS,
+            accuracy_decimals=2,
+            #device_class=,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_STATE_OF_CHARGE): sensor.sensor_schema(
+            unit_of_measurement=UNIT_PERCENT,
+            accuracy_decimals=1,
+            device_class=DEVICE_CLASS_BATTERY,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_MIN_CELL_VOLTAGE): sensor.sensor_schema(
+            unit_of_measurement=UNIT_VOLT,
+            accuracy_decimals=3,
+            device_class=DEVICE_CLASS_VOLTAGE,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_MIN_CELL_VOLTAGE_PACK): sensor.sensor_schema(
+            #unit_of_measurement=,
+            accuracy_decimals=0,
+            #device_class=,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_MIN_CELL_VOLTAGE_CELL): sensor.sensor_schema(
+            #unit_of_measurement=,
+            accuracy_decimals=0,
+            #device_class=,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_MAX_CELL_VOLTAGE): sensor.sensor_schema(
+            unit_of_measurement=UNIT_VOLT,
+            accuracy_decimals=3,
+            device_class=DEVICE_CLASS_VOLTAGE,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_MAX_CELL_VOLTAGE_PACK): sensor.sensor_schema(
+            #unit_of_measurement=,
+            accuracy_decimals=0,
+            #device_class=,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_MAX_CELL_VOLTAGE_CELL): sensor.sensor_schema(
+            #unit_of_measurement=,
+            accuracy_decimals=0,
+            #device_class=,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_MAX_CELL_DIFFERENTIAL): sensor.sensor_schema(
+            unit_of_measurement=UNIT_VOLT,
+            accuracy_decimals=3,
+            device_class=DEVICE_CLASS_VOLTAGE,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_MIN_TEMPERATURE): sensor.sensor_schema(
+            unit_of_measurement=UNIT_CELSIUS,
+            accuracy_decimals=1,
+            device_class=DEVICE_CLASS_TEMPERATURE,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_MIN_TEMPERATURE_PACK): sensor.sensor_schema(
+            #unit_of_measurement=,
+            accuracy_decimals=0,
+            #device_class=,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_MAX_TEMPERATURE): sensor.sensor_schema(
+            unit_of_measurement=UNIT_CELSIUS,
+            accuracy_decimals=1,
+            device_class=DEVICE_CLASS_TEMPERATURE,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_MAX_TEMPERATURE_PACK): sensor.sensor_schema(
+            #unit_of_measurement=,
+            accuracy_decimals=0,
+            #device_class=,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+    }
+)
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+
+    parent = await cg.get_variable(config[CONF_PACE_BMS_BANK_ID])
+    cg.add(var.set_parent(parent))
+
+    if pack_count := config.get(CONF_PACK_COUNT):
+        sens = await sensor.new_sensor(pack_count)
+        cg.add(var.set_pack_count_sensor(sens))
+    if alarm_pack_count := config.get(CONF_ALARM_PACK_COUNT):
+        sens = await sensor.new_sensor(alarm_pack_count)
+        cg.add(var.set_alarm_pack_count_sensor(sens))
+    if current := config.get(CONF_CURRENT):
+        sens = await sensor.new_sensor(current)
+        cg.add(var.set_current_sensor(sens))
+    if power := config.get(CONF_POWER):
+        sens = await sensor.new_sensor(power)
+        cg.add(var.set_power_sensor(sens))
+    if voltage := config.get(CONF_VOLTAGE):
+        sens = await sensor.new_sensor(voltage)
+        cg.add(var.set_voltage_sensor(sens))
+    if remaining_capacity := config.get(CONF_REMAINING_CAPACITY):
+        sens = await sensor.new_sensor(remaining_capacity)
+        cg.add(var.set_remaining_capacity_sensor(sens))
+    if full_capacity := config.get(CONF_FULL_CAPACITY):
+        sens = await sensor.new_sensor(full_capacity)
+        cg.add(var.set_full_capacity_sensor(sens))
+    if state_of_charge := config.get(CONF_STATE_OF_CHARGE):
+        sens = await sensor.new_sensor(state_of_charge)
+        cg.add(var.set_state_of_charge_sensor(sens))
+    if min_cell_voltage := config.get(CONF_MIN_CELL_VOLTAGE):
+        sens = await sensor.new_sensor(min_cell_voltage)
+        cg.add(var.set_min_cell_voltage_sensor(sens))
+    if min_cell_voltage_pack := config.get(CONF_MIN_CELL_VOLTAGE_PACK):
+        sens = await sensor.new_sensor(min_cell_voltage_pack)
+        cg.add(var.set_min_cell_voltage_pack_sensor(sens))
+    if min_cell_voltage_cell := config.get(CONF_MIN_CELL_VOLTAGE_CELL):
+        sens = await sensor.new_sensor(min_cell_voltage_cell)
+        cg.add(var.set_min_cell_voltage_cell_sensor(sens))
+    if max_cell_voltage := config.get(CONF_MAX_CELL_VOLTAGE):
+        sens = await sensor.new_sensor(max_cell_voltage)
+        cg.add(var.set_max_cell_voltage_sensor(sens))
+    if max_cell_voltage_pack := config.get(CONF_MAX_CELL_VOLTAGE_PACK):
+        sens = await sensor.new_sensor(max_cell_voltage_pack)
+        cg.add(var.set_max_cell_voltage_pack_sensor(sens))
+    if max_cell_voltage_cell := config.get(CONF_MAX_CELL_VOLTAGE_CELL):
+        sens = await sensor.new_sensor(max_cell_voltage_cell)
+        cg.add(var.set_max_cell_voltage_cell_sensor(sens))
+    if max_cell_differential := config.get(CONF_MAX_CELL_DIFFERENTIAL):
+        sens = await sensor.new_sensor(max_cell_differential)
+        cg.add(var.set_max_cell_differential_sensor(sens))
+    if min_temperature := config.get(CONF_MIN_TEMPERATURE):
+        sens = await sensor.new_sensor(min_temperature)
+        cg.add(var.set_min_temperature_sensor(sens))
+    if min_temperature_pack := config.get(CONF_MIN_TEMPERATURE_PACK):
+        sens = await sensor.new_sensor(min_temperature_pack)
+        cg.add(var.set_min_temperature_pack_sensor(sens))
+    if max_temperature := config.get(CONF_MAX_TEMPERATURE):
+        sens = await sensor.new_sensor(max_temperature)
+        cg.add(var.set_max_temperature_sensor(sens))
+    if max_temperature_pack := config.get(CONF_MAX_TEMPERATURE_PACK):
+        sens = await sensor.new_sensor(max_temperature_pack)
+        cg.add(var.set_max_temperature_pack_sensor(sens))
@@ -0,0 +1,105 @@
+#include <functional>
+
+#include "esphome/core/log.h"
+
+#include "pace_bms_bank_sensor.h"
+
+namespace esphome {
+namespace pace_bms {
+
+static const char* const TAG = "pace_bms_bank.sensor";
+
+void PaceBmsBankSensor::setup() {
+	this->parent_->register_bank_information_callback([this](PaceBmsBank::bank_information& bank) { this->bank_information_callback(bank); });
+
+	// status information is only requested from the packs if something is going to look at it
+	if (this->alarm_pack_count_sensor_ != nullptr) {
+		this->parent_->enable_alarm_tracking();
+	}
+}
+
+void PaceBmsBankSensor::dump_config() {
+	ESP_LOGCONFIG(TAG, "pace_bms_bank_sensor:");
+	LOG_SENSOR("  ", "Pack Count", this->pack_count_sensor_);
+	LOG_SENSOR("  ", "Alarm Pack Count", this->alarm_pack_count_sensor_);
+	LOG_SENSOR("  ", "Current", this->current_sensor_);
+	LOG_SENSOR("  ", "Power", this->power_sensor_);
+	LOG_SENSOR("  ", "Voltage", this->voltage_sensor_);
+	LOG_SENSOR("  ", "Remaining Capacity", this->remaining_capacity_sensor_);
+	LOG_SENSOR("  ", "Full Capacity", this->full_capacity_sensor_);
+	LOG_SENSOR("  ", "State of Charge", this->state_of_charge_sensor_);
+	LOG_SENSOR("  ", "Min Cell Voltage", this->min_cell_voltage_sensor_);
+	LOG_SENSOR("  ", "Min Cell Voltage Pack", this->min_cell_voltage_pack_sensor_);
+	LOG_SENSOR("  ", "Min Cell Voltage Cell", this->min_cell_voltage_cell_sensor_);
+	LOG_SENSOR("  ", "Max Cell Voltage", this->max_cell_voltage_sensor_);
+	LOG_SENSOR("  ", "Max Cell Voltage Pack", this->max_cell_voltage_pack_sensor_);
+	LOG_SENSOR("  ", "Max Cell Voltage Cell", this->max_cell_voltage_cell_sensor_);
+	LOG_SENSOR("  ", "Max Cell Differential", this->max_cell_differential_sensor_);
+	LOG_SENSOR("  ", "Min Temperature", this->min_temperature_sensor_);
+	LOG_SENSOR("  ", "Min Temperature Pack", this->min_temperature_pack_sensor_);
+	LOG_SENSOR("  ", "Max Temperature", this->max_temperature_sensor_);
+	LOG_SENSOR("  ", "Max Temperature Pack", this->max_temperature_pack_sensor_);
+}
+
+void PaceBmsBankSensor::bank_information_callback(PaceBmsBank::bank_information& bank) {
+	if (this->pack_count_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = bank.pack_count_]() { this->pack_count_sensor_->publish_state(value); });
+	}
+	if (this->alarm_pack_count_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = bank.alarm_pack_count_]() { this->alarm_pack_count_sensor_->publish_state(value); });
+	}
+	if (this->current_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = bank.current_amps_]() { this->current_sensor_->publish_state(value); });
+	}
+	if (this->power_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = bank.power_watts_]() { this->power_sensor_->publish_state(value); });
+	}
+	if (this->voltage_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = bank.voltage_volts_]() { this->voltage_sensor_->publish_state(value); });
+	}
+	if (this->remaining_capacity_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = bank.remaining_capacity_amp_hours_]() { this->remaining_capacity_sensor_->publish_state(value); });
+	}
+	if (this->full_capacity_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = bank.full_capacity_amp_hours_]() { this->full_capacity_sensor_->publish_state(value); });
+	}
+	if (this->state_of_charge_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = bank.state_of_charge_]() { this->state_of_charge_sensor_->publish_state(value); });
+	}
+	if (this->min_cell_voltage_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = bank.min_cell_voltage_volts_]() { this->min_cell_voltage_sensor_->publish_state(value); });
+	}
+	if (this->min_cell_voltage_pack_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = bank.min_cell_voltage_pack_]() { this->min_cell_voltage_pack_sensor_->publish_state(value); });
+	}
+	if (this->min_cell_voltage_cell_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = bank.min_cell_voltage_cell_]() { this->min_cell_voltage_cell_sensor_->publish_state(value); });
+	}
+	if (this->max_cell_voltage_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = bank.max_cell_voltage_volts_]() { this->max_cell_voltage_sensor_->publish_state(value); });
+	}
+	if (this->max_cell_voltage_pack_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = bank.max_cell_voltage_pack_]() { this->max_cell_voltage_pack_sensor_->publish_state(value); });
+	}
+	if (this->max_cell_voltage_cell_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = bank.max_cell_voltage_cell_]() { this->max_cell_voltage_cell_sensor_->publish_state(value); });
+	}
+	if (this->max_cell_differential_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = bank.max_cell_differential_volts_]() { this->max_cell_differential_sensor_->publish_state(value); });
+	}
+	if (this->min_temperature_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = bank.min_temperature_celsius_]() { this->min_temperature_sensor_->publish_state(value); });
+	}
+	if (this->min_temperature_pack_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = bank.min_temperature_pack_]() { this->min_temperature_pack_sensor_->publish_state(value); });
+	}
+	if (this->max_temperature_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = bank.max_temperature_celsius_]() { this->max_temperature_sensor_->publish_state(value); });
+	}
+	if (this->max_temperature_pack_sensor_ != nullptr) {
+		this->parent_->queue_sensor_update([this, value = bank.max_temperature_pack_]() { this->max_temperature_pack_sensor_->publish_state(value); });
+	}
+}
+
+}  // namespace pace_bms
+}  // namespace esphome
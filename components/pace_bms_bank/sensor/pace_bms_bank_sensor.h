@@ -0,0 +1,66 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/components/sensor/sensor.h"
+
+#include "esphome/components/pace_bms_bank/pace_bms_bank.h"
+
+namespace esphome {
+namespace pace_bms {
+
+class PaceBmsBankSensor : public Component {
+public:
+	void set_parent(PaceBmsBank* parent) { parent_ = parent; }
+
+	void set_pack_count_sensor(sensor::Sensor* sens)                 { pack_count_sensor_ = sens; }
+	void set_alarm_pack_count_sensor(sensor::Sensor* sens)           { alarm_pack_count_sensor_ = sens; }
+	void set_current_sensor(sensor::Sensor* sens)                    { current_sensor_ = sens; }
+	void set_power_sensor(sensor::Sensor* sens)                      { power_sensor_ = sens; }
+	void set_voltage_sensor(sensor::Sensor* sens)                    { voltage_sensor_ = sens; }
+	void set_remaining_capacity_sensor(sensor::Sensor* sens)         { remaining_capacity_sensor_ = sens; }
+	void set_full_capacity_sensor(sensor::Sensor* sens)              { full_capacity_sensor_ = sens; }
+	void set_state_of_charge_sensor(sensor::Sensor* sens)            { state_of_charge_sensor_ = sens; }
+	void set_min_cell_voltage_sensor(sensor::Sensor* sens)           { min_cell_voltage_sensor_ = sens; }
+	void set_min_cell_voltage_pack_sensor(sensor::Sensor* sens)      { min_cell_voltage_pack_sensor_ = sens; }
+	void set_min_cell_voltage_cell_sensor(sensor::Sensor* sens)      { min_cell_voltage_cell_sensor_ = sens; }
+	void set_max_cell_voltage_sensor(sensor::Sensor* sens)           { max_cell_voltage_sensor_ = sens; }
+	void set_max_cell_voltage_pack_sensor(sensor::Sensor* sens)      { max_cell_voltage_pack_sensor_ = sens; }
+	void set_max_cell_voltage_cell_sensor(sensor::Sensor* sens)      { max_cell_voltage_cell_sensor_ = sens; }
+	void set_max_cell_differential_sensor(sensor::Sensor* sens)      { max_cell_differential_sensor_ = sens; }
+	void set_min_temperature_sensor(sensor::Sensor* sens)            { min_temperature_sensor_ = sens; }
+	void set_min_temperature_pack_sensor(sensor::Sensor* sens)       { min_temperature_pack_sensor_ = sens; }
+	void set_max_temperature_sensor(sensor::Sensor* sens)            { max_temperature_sensor_ = sens; }
+	void set_max_temperature_pack_sensor(sensor::Sensor* sens)       { max_temperature_pack_sensor_ = sens; }
+
+	void setup() override;
+	float get_setup_priority() const override { return setup_priority::DATA; };
+	void dump_config() override;
+
+protected:
+	PaceBmsBank* parent_;
+
+	sensor::Sensor* pack_count_sensor_{ nullptr };
+	sensor::Sensor* alarm_pack_count_sensor_{ nullptr };
+	sensor::Sensor* current_sensor_{ nullptr };
+	sensor::Sensor* power_sensor_{ nullptr };
+	sensor::Sensor* voltage_sensor_{ nullptr };
+	sensor::Sensor* remaining_capacity_sensor_{ nullptr };
+	sensor::Sensor* full_capacity_sensor_{ nullptr };
+	sensor::Sensor* state_of_charge_sensor_{ nullptr };
+	sensor::Sensor* min_cell_voltage_sensor_{ nullptr };
+	sensor::Sensor* min_cell_voltage_pack_sensor_{ nullptr };
+	sensor::Sensor* min_cell_voltage_cell_sensor_{ nullptr };
+	sensor::Sensor* max_cell_voltage_sensor_{ nullptr };
+	sensor::Sensor* max_cell_voltage_pack_sensor_{ nullptr };
+	sensor::Sensor* max_cell_voltage_cell_sensor_{ nullptr };
+	sensor::Sensor* max_cell_differential_sensor_{ nullptr };
+	sensor::Sensor* min_temperature_sensor_{ nullptr };
+	sensor::Sensor* min_temperature_pack_sensor_{ nullptr };
+	sensor::Sensor* max_temperature_sensor_{ nullptr };
+	sensor::Sensor* max_temperature_pack_sensor_{ nullptr };
+
+	void bank_information_callback(PaceBmsBank::bank_information& bank);
+};
+
+}  // namespace pace_bms
+}  // namespace esphome